@@ -0,0 +1,925 @@
+/**
+ * @file arquivos.hpp
+ * @brief Leitura de músicas direto de pacotes .zip e .sng, sem extração
+ *
+ * O pacote é mapeado em memória e o índice (diretório central do zip ou índice
+ * do .sng) é lido uma única vez. Entradas armazenadas sem compressão são lidas
+ * direto do mapeamento; entradas com deflate são descomprimidas sob demanda, em
+ * pedaços, por um inflador próprio (RFC 1951) com janela de 32 KiB.
+ *
+ * Caminhos atravessam pacotes de forma transparente: "musicas/pack.zip/Banda -
+ * Música/notes.chart" abre a entrada "Banda - Música/notes.chart" de pack.zip.
+ */
+
+#pragma once
+
+#include "log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define RIFF_HERO_MMAP_DISPONIVEL 1
+#else
+#define RIFF_HERO_MMAP_DISPONIVEL 0
+#endif
+
+namespace Arquivos {
+    /**
+     * @brief Arquivo inteiro mapeado somente para leitura
+     *
+     * Sem mmap (Windows), o conteúdo é lido para um buffer; a interface é a mesma.
+     */
+    class Mapeamento {
+    private:
+        const std::uint8_t *dados = nullptr;
+        std::size_t tamanho = 0;
+        std::vector<std::uint8_t> copia;
+
+    public:
+        Mapeamento() = default;
+        Mapeamento(const Mapeamento &) = delete;
+        Mapeamento &operator=(const Mapeamento &) = delete;
+
+        ~Mapeamento() {
+#if RIFF_HERO_MMAP_DISPONIVEL
+            if (dados && copia.empty() && tamanho > 0) {
+                munmap(const_cast<std::uint8_t *>(dados), tamanho);
+            }
+#endif
+        }
+
+        bool abrir(const std::filesystem::path &caminho) {
+#if RIFF_HERO_MMAP_DISPONIVEL
+            const int descritor = ::open(caminho.c_str(), O_RDONLY);
+            if (descritor < 0) return false;
+
+            struct stat informacoes {};
+            if (fstat(descritor, &informacoes) != 0 || informacoes.st_size <= 0) {
+                close(descritor);
+                return false;
+            }
+            tamanho = static_cast<std::size_t>(informacoes.st_size);
+
+            void *mapeamento = mmap(nullptr, tamanho, PROT_READ, MAP_PRIVATE, descritor, 0);
+            close(descritor);
+            if (mapeamento == MAP_FAILED) return false;
+
+            dados = static_cast<const std::uint8_t *>(mapeamento);
+            return true;
+#else
+            std::ifstream arquivo(caminho, std::ios::binary);
+            if (!arquivo) return false;
+            copia.assign(std::istreambuf_iterator<char>(arquivo), std::istreambuf_iterator<char>());
+            dados = copia.data();
+            tamanho = copia.size();
+            return tamanho > 0;
+#endif
+        }
+
+        [[nodiscard]] auto bytes() const -> std::span<const std::uint8_t> {
+            return {dados, tamanho};
+        }
+    };
+
+    /**
+     * @brief Lê inteiros little-endian de posições arbitrárias (sem alinhamento)
+     */
+    template <typename T>
+    [[nodiscard]] T lerLittleEndian(const std::uint8_t *origem) {
+        T valor = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            valor |= static_cast<T>(origem[i]) << (8 * i);
+        }
+        return valor;
+    }
+
+    /**
+     * @brief Verifica que [inicio, inicio + tamanho) cabe em `total` sem estourar a soma
+     *
+     * Deslocamentos e tamanhos vêm do pacote e podem ser qualquer valor de 64 bits.
+     */
+    [[nodiscard]] constexpr bool cabe(const std::uint64_t inicio, const std::uint64_t tamanho, const std::uint64_t total) {
+        return inicio <= total && tamanho <= total - inicio;
+    }
+
+    // ============================= INFLADOR (DEFLATE) =============================
+
+    /**
+     * @brief Decodificador de Huffman canônico com tabela de acesso direto
+     *
+     * Códigos de até BITS_TABELA bits saem da tabela em uma consulta; os mais
+     * longos (raros) caem no caminho lento, bit a bit.
+     */
+    struct Huffman {
+        static constexpr int BITS_TABELA = 10;
+        static constexpr int MAX_BITS = 15;
+
+        std::array<std::uint16_t, 1u << BITS_TABELA> tabela{}; // (símbolo << 4) | comprimento; 0 = fora da tabela
+        std::array<std::uint16_t, MAX_BITS + 1> contagens{};
+        std::array<std::uint16_t, 288> simbolos{};
+
+        /**
+         * @brief Monta o código a partir dos comprimentos de cada símbolo
+         * @return False se o código for superdimensionado (stream inválido)
+         */
+        bool construir(const std::uint8_t *comprimentos, const int quantidade) {
+            contagens.fill(0);
+            tabela.fill(0);
+            for (int s = 0; s < quantidade; ++s) ++contagens[comprimentos[s]];
+            contagens[0] = 0;
+
+            int restantes = 1;
+            for (int bits = 1; bits <= MAX_BITS; ++bits) {
+                restantes = (restantes << 1) - contagens[bits];
+                if (restantes < 0) return false;
+            }
+
+            std::array<std::uint16_t, MAX_BITS + 2> deslocamentos{};
+            std::array<std::uint16_t, MAX_BITS + 1> proximoCodigo{};
+            std::uint16_t codigo = 0;
+            for (int bits = 1; bits <= MAX_BITS; ++bits) {
+                deslocamentos[bits + 1] = deslocamentos[bits] + contagens[bits];
+                codigo = static_cast<std::uint16_t>((codigo + contagens[bits - 1]) << 1);
+                proximoCodigo[bits] = codigo;
+            }
+
+            for (int s = 0; s < quantidade; ++s) {
+                const int bits = comprimentos[s];
+                if (bits == 0) continue;
+                simbolos[deslocamentos[bits]++] = static_cast<std::uint16_t>(s);
+
+                if (bits > BITS_TABELA) {
+                    ++proximoCodigo[bits];
+                    continue;
+                }
+                // O deflate envia os códigos a partir do bit mais significativo
+                std::uint32_t invertido = 0;
+                for (std::uint32_t c = proximoCodigo[bits]++, i = 0; i < static_cast<std::uint32_t>(bits); ++i) {
+                    invertido = (invertido << 1) | ((c >> i) & 1u);
+                }
+                for (std::uint32_t r = invertido; r < tabela.size(); r += 1u << bits) {
+                    tabela[r] = static_cast<std::uint16_t>((s << 4) | bits);
+                }
+            }
+            return true;
+        }
+    };
+
+    /**
+     * @brief Descompressor deflate bruto com saída em pedaços
+     *
+     * Toda a entrada está disponível (vem do mapeamento); a saída é produzida só
+     * até o tamanho pedido, guardando o estado (bloco atual e cópia pendente)
+     * para a próxima chamada.
+     */
+    class Inflador {
+    private:
+        static constexpr std::size_t TAMANHO_JANELA = 32768;
+
+        static constexpr std::array<std::uint16_t, 29> BASE_COMPRIMENTO = {
+            3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+            35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        static constexpr std::array<std::uint8_t, 29> EXTRA_COMPRIMENTO = {
+            0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        static constexpr std::array<std::uint16_t, 30> BASE_DISTANCIA = {
+            1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+            257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+        static constexpr std::array<std::uint8_t, 30> EXTRA_DISTANCIA = {
+            0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+        static constexpr std::array<std::uint8_t, 19> ORDEM_COMPRIMENTOS = {
+            16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+        enum class Estado : std::uint8_t { Cabecalho, Armazenado, Huffman, Fim, Erro };
+
+        std::span<const std::uint8_t> entrada;
+        std::size_t posicaoByte = 0;
+        std::uint64_t bits = 0;
+        int quantidadeBits = 0;
+        int bitsFantasma = 0; // Zeros acrescentados além do fim da entrada
+
+        Estado estado = Estado::Cabecalho;
+        bool ultimoBloco = false;
+        std::size_t restanteArmazenado = 0;
+        std::size_t copiaRestante = 0;
+        std::size_t distanciaCopia = 0;
+
+        std::unique_ptr<std::array<std::uint8_t, TAMANHO_JANELA>> janela =
+            std::make_unique<std::array<std::uint8_t, TAMANHO_JANELA>>();
+        std::uint64_t totalProduzido = 0;
+
+        std::unique_ptr<Huffman> literais = std::make_unique<Huffman>();
+        std::unique_ptr<Huffman> distancias = std::make_unique<Huffman>();
+
+        void garantir(const int quantidade) {
+            while (quantidadeBits < quantidade) {
+                if (posicaoByte < entrada.size()) {
+                    bits |= static_cast<std::uint64_t>(entrada[posicaoByte++]) << quantidadeBits;
+                } else {
+                    bitsFantasma += 8;
+                }
+                quantidadeBits += 8;
+            }
+        }
+
+        void consumir(const int quantidade) {
+            bits >>= quantidade;
+            quantidadeBits -= quantidade;
+            if (quantidadeBits < bitsFantasma) estado = Estado::Erro; // Leu além do fim
+        }
+
+        std::uint32_t lerBits(const int quantidade) {
+            if (quantidade == 0) return 0;
+            garantir(quantidade);
+            const auto valor = static_cast<std::uint32_t>(bits & ((1ull << quantidade) - 1));
+            consumir(quantidade);
+            return valor;
+        }
+
+        int decodificar(const Huffman &codigo) {
+            garantir(Huffman::BITS_TABELA);
+            if (const auto entradaTabela = codigo.tabela[bits & ((1u << Huffman::BITS_TABELA) - 1)]) {
+                consumir(entradaTabela & 0xF);
+                return entradaTabela >> 4;
+            }
+
+            // Caminho lento: código mais longo que a tabela
+            int primeiro = 0;
+            int indice = 0;
+            int valorCodigo = 0;
+            for (int comprimento = 1; comprimento <= Huffman::MAX_BITS; ++comprimento) {
+                valorCodigo |= static_cast<int>(lerBits(1));
+                const int contagem = codigo.contagens[comprimento];
+                if (valorCodigo - contagem < primeiro) {
+                    return codigo.simbolos[indice + (valorCodigo - primeiro)];
+                }
+                indice += contagem;
+                primeiro = (primeiro + contagem) << 1;
+                valorCodigo <<= 1;
+            }
+            estado = Estado::Erro;
+            return -1;
+        }
+
+        void emitir(std::uint8_t *destino, std::size_t &produzidos, const std::uint8_t byte) {
+            destino[produzidos++] = byte;
+            (*janela)[totalProduzido++ & (TAMANHO_JANELA - 1)] = byte;
+        }
+
+        bool montarCodigosFixos() {
+            std::array<std::uint8_t, 288 + 30> comprimentos{};
+            std::fill_n(comprimentos.begin(), 144, 8);
+            std::fill(comprimentos.begin() + 144, comprimentos.begin() + 256, 9);
+            std::fill(comprimentos.begin() + 256, comprimentos.begin() + 280, 7);
+            std::fill(comprimentos.begin() + 280, comprimentos.begin() + 288, 8);
+            std::fill(comprimentos.begin() + 288, comprimentos.end(), 5);
+            return literais->construir(comprimentos.data(), 288) &&
+                   distancias->construir(comprimentos.data() + 288, 30);
+        }
+
+        bool montarCodigosDinamicos() {
+            const int quantidadeLiterais = static_cast<int>(lerBits(5)) + 257;
+            const int quantidadeDistancias = static_cast<int>(lerBits(5)) + 1;
+            const int quantidadeComprimentos = static_cast<int>(lerBits(4)) + 4;
+            if (quantidadeLiterais > 286 || quantidadeDistancias > 30) return false;
+
+            std::array<std::uint8_t, 19> comprimentosCodigo{};
+            for (int i = 0; i < quantidadeComprimentos; ++i) {
+                comprimentosCodigo[ORDEM_COMPRIMENTOS[i]] = static_cast<std::uint8_t>(lerBits(3));
+            }
+            Huffman codigoComprimentos;
+            if (!codigoComprimentos.construir(comprimentosCodigo.data(), 19)) return false;
+
+            std::array<std::uint8_t, 286 + 30> comprimentos{};
+            const int total = quantidadeLiterais + quantidadeDistancias;
+            for (int i = 0; i < total;) {
+                const int simbolo = decodificar(codigoComprimentos);
+                if (simbolo < 0) return false;
+                if (simbolo < 16) {
+                    comprimentos[i++] = static_cast<std::uint8_t>(simbolo);
+                    continue;
+                }
+
+                std::uint8_t repetido = 0;
+                int repeticoes = 0;
+                if (simbolo == 16) {
+                    if (i == 0) return false;
+                    repetido = comprimentos[i - 1];
+                    repeticoes = 3 + static_cast<int>(lerBits(2));
+                } else if (simbolo == 17) {
+                    repeticoes = 3 + static_cast<int>(lerBits(3));
+                } else {
+                    repeticoes = 11 + static_cast<int>(lerBits(7));
+                }
+                if (i + repeticoes > total) return false;
+                std::fill_n(comprimentos.begin() + i, repeticoes, repetido);
+                i += repeticoes;
+            }
+
+            if (comprimentos[256] == 0) return false; // Sem símbolo de fim de bloco
+            return literais->construir(comprimentos.data(), quantidadeLiterais) &&
+                   distancias->construir(comprimentos.data() + quantidadeLiterais, quantidadeDistancias);
+        }
+
+        void lerCabecalhoBloco() {
+            if (ultimoBloco) {
+                estado = Estado::Fim;
+                return;
+            }
+            ultimoBloco = lerBits(1) != 0;
+
+            switch (lerBits(2)) {
+                case 0: {
+                    consumir(quantidadeBits % 8); // Alinha no byte
+                    const auto comprimento = lerBits(16);
+                    const auto complemento = lerBits(16);
+                    if (comprimento != (~complemento & 0xFFFFu)) {
+                        estado = Estado::Erro;
+                        return;
+                    }
+                    restanteArmazenado = comprimento;
+                    estado = Estado::Armazenado;
+                    break;
+                }
+                case 1:
+                    estado = montarCodigosFixos() ? Estado::Huffman : Estado::Erro;
+                    break;
+                case 2:
+                    estado = montarCodigosDinamicos() ? Estado::Huffman : Estado::Erro;
+                    break;
+                default:
+                    estado = Estado::Erro;
+            }
+        }
+
+    public:
+        explicit Inflador(const std::span<const std::uint8_t> comprimido) : entrada(comprimido) {}
+
+        /**
+         * @brief Produz até `tamanho` bytes descomprimidos
+         * @return Bytes produzidos; menos que o pedido só no fim do stream ou em erro
+         */
+        std::size_t ler(std::uint8_t *destino, const std::size_t tamanho) {
+            std::size_t produzidos = 0;
+
+            while (produzidos < tamanho) {
+                if (copiaRestante > 0) {
+                    const auto quantidade = std::min(copiaRestante, tamanho - produzidos);
+                    for (std::size_t i = 0; i < quantidade; ++i) {
+                        emitir(destino, produzidos, (*janela)[(totalProduzido - distanciaCopia) & (TAMANHO_JANELA - 1)]);
+                    }
+                    copiaRestante -= quantidade;
+                    continue;
+                }
+
+                switch (estado) {
+                    case Estado::Cabecalho:
+                        lerCabecalhoBloco();
+                        break;
+
+                    case Estado::Armazenado: {
+                        // Bytes já carregados no acumulador de bits saem primeiro
+                        while (restanteArmazenado > 0 && produzidos < tamanho && quantidadeBits >= 8) {
+                            emitir(destino, produzidos, static_cast<std::uint8_t>(lerBits(8)));
+                            --restanteArmazenado;
+                        }
+                        const auto quantidade = std::min({restanteArmazenado, tamanho - produzidos,
+                                                          entrada.size() - posicaoByte});
+                        for (std::size_t i = 0; i < quantidade; ++i) {
+                            emitir(destino, produzidos, entrada[posicaoByte + i]);
+                        }
+                        posicaoByte += quantidade;
+                        restanteArmazenado -= quantidade;
+                        if (restanteArmazenado == 0) {
+                            estado = Estado::Cabecalho;
+                        } else if (posicaoByte == entrada.size() && quantidadeBits == 0) {
+                            estado = Estado::Erro; // Bloco truncado
+                        }
+                        break;
+                    }
+
+                    case Estado::Huffman: {
+                        const int simbolo = decodificar(*literais);
+                        if (simbolo < 0 || estado == Estado::Erro) break;
+                        if (simbolo < 256) {
+                            emitir(destino, produzidos, static_cast<std::uint8_t>(simbolo));
+                            break;
+                        }
+                        if (simbolo == 256) {
+                            estado = Estado::Cabecalho;
+                            break;
+                        }
+
+                        const auto indiceComprimento = static_cast<std::size_t>(simbolo - 257);
+                        if (indiceComprimento >= BASE_COMPRIMENTO.size()) {
+                            estado = Estado::Erro;
+                            break;
+                        }
+                        const auto comprimento = BASE_COMPRIMENTO[indiceComprimento] +
+                                                 lerBits(EXTRA_COMPRIMENTO[indiceComprimento]);
+                        const int simboloDistancia = decodificar(*distancias);
+                        if (simboloDistancia < 0 || simboloDistancia >= static_cast<int>(BASE_DISTANCIA.size())) {
+                            estado = Estado::Erro;
+                            break;
+                        }
+                        copiaRestante = comprimento;
+                        distanciaCopia = BASE_DISTANCIA[simboloDistancia] + lerBits(EXTRA_DISTANCIA[simboloDistancia]);
+                        if (distanciaCopia > totalProduzido) {
+                            copiaRestante = 0;
+                            estado = Estado::Erro;
+                        }
+                        break;
+                    }
+
+                    case Estado::Fim:
+                    case Estado::Erro:
+                        return produzidos;
+                }
+            }
+            return produzidos;
+        }
+
+        [[nodiscard]] bool falhou() const {
+            return estado == Estado::Erro;
+        }
+    };
+
+    // ============================= PACOTES =============================
+
+    enum class Metodo : std::uint8_t { Armazenado, Deflate, Mascarado };
+
+    // O deflate produz no máximo 258 bytes a cada 2 bits comprimidos
+    constexpr std::uint64_t EXPANSAO_MAXIMA_DEFLATE = 1032;
+
+    /**
+     * @brief Uma entrada do índice do pacote
+     */
+    struct Entrada {
+        std::string nome;
+        std::uint64_t deslocamento = 0;      // Zip: cabeçalho local; sng: início dos dados
+        std::uint64_t tamanhoComprimido = 0;
+        std::uint64_t tamanho = 0;
+        Metodo metodo = Metodo::Armazenado;
+    };
+
+    /**
+     * @brief Chave de busca: nomes de pacotes vêm de Windows, onde maiúsculas não importam
+     */
+    inline std::string normalizarNome(std::string_view nome) {
+        std::string normalizado(nome);
+        std::ranges::replace(normalizado, '\\', '/');
+        std::ranges::transform(normalizado, normalizado.begin(), [](const char c) {
+            return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+        });
+        while (normalizado.starts_with("./")) normalizado.erase(0, 2);
+        return normalizado;
+    }
+
+    class LeitorEntrada;
+
+    /**
+     * @brief Pacote .zip (incluindo zip64) ou .sng mapeado em memória
+     */
+    class Pacote : public std::enable_shared_from_this<Pacote> {
+    private:
+        Mapeamento mapeamento;
+        std::vector<Entrada> entradas;
+        std::unordered_map<std::string, std::size_t> indice;
+        std::array<std::uint8_t, 16> mascaraXor{};
+        std::vector<std::pair<std::string, std::string>> metadados;
+
+        bool indexarZip() {
+            const auto dados = mapeamento.bytes();
+            constexpr std::size_t TAMANHO_FIM_DIRETORIO = 22;
+            if (dados.size() < TAMANHO_FIM_DIRETORIO) return false;
+
+            // O registro de fim do diretório central fica nos últimos 64 KiB (comentário)
+            std::optional<std::size_t> fimDiretorio;
+            const auto limite = dados.size() - std::min<std::size_t>(dados.size(), 65535 + TAMANHO_FIM_DIRETORIO);
+            for (auto p = dados.size() - TAMANHO_FIM_DIRETORIO + 1; p-- > limite;) {
+                if (lerLittleEndian<std::uint32_t>(&dados[p]) == 0x06054b50) {
+                    fimDiretorio = p;
+                    break;
+                }
+            }
+            if (!fimDiretorio) return false;
+
+            std::uint64_t quantidade = lerLittleEndian<std::uint16_t>(&dados[*fimDiretorio + 10]);
+            std::uint64_t tamanhoDiretorio = lerLittleEndian<std::uint32_t>(&dados[*fimDiretorio + 12]);
+            std::uint64_t inicioDiretorio = lerLittleEndian<std::uint32_t>(&dados[*fimDiretorio + 16]);
+
+            // Zip64: o localizador fica logo antes do registro de fim
+            if (*fimDiretorio >= 20 && lerLittleEndian<std::uint32_t>(&dados[*fimDiretorio - 20]) == 0x07064b50) {
+                const auto registro64 = lerLittleEndian<std::uint64_t>(&dados[*fimDiretorio - 20 + 8]);
+                if (!cabe(registro64, 56, dados.size()) ||
+                    lerLittleEndian<std::uint32_t>(&dados[registro64]) != 0x06064b50) {
+                    return false;
+                }
+                quantidade = lerLittleEndian<std::uint64_t>(&dados[registro64 + 32]);
+                tamanhoDiretorio = lerLittleEndian<std::uint64_t>(&dados[registro64 + 40]);
+                inicioDiretorio = lerLittleEndian<std::uint64_t>(&dados[registro64 + 48]);
+            }
+            if (!cabe(inicioDiretorio, tamanhoDiretorio, dados.size())) return false;
+
+            // A quantidade vem do pacote: cada registro ocupa ao menos 46 bytes do diretório
+            constexpr std::uint64_t TAMANHO_REGISTRO_CENTRAL = 46;
+            entradas.reserve(
+                static_cast<std::size_t>(std::min(quantidade, tamanhoDiretorio / TAMANHO_REGISTRO_CENTRAL)));
+            auto p = static_cast<std::size_t>(inicioDiretorio);
+            const auto fim = static_cast<std::size_t>(inicioDiretorio + tamanhoDiretorio);
+            for (std::uint64_t i = 0; i < quantidade; ++i) {
+                if (p + 46 > fim || lerLittleEndian<std::uint32_t>(&dados[p]) != 0x02014b50) return false;
+
+                const auto flags = lerLittleEndian<std::uint16_t>(&dados[p + 8]);
+                const auto metodo = lerLittleEndian<std::uint16_t>(&dados[p + 10]);
+                std::uint64_t tamanhoComprimido = lerLittleEndian<std::uint32_t>(&dados[p + 20]);
+                std::uint64_t tamanho = lerLittleEndian<std::uint32_t>(&dados[p + 24]);
+                const auto tamanhoNome = lerLittleEndian<std::uint16_t>(&dados[p + 28]);
+                const auto tamanhoExtra = lerLittleEndian<std::uint16_t>(&dados[p + 30]);
+                const auto tamanhoComentario = lerLittleEndian<std::uint16_t>(&dados[p + 32]);
+                std::uint64_t deslocamento = lerLittleEndian<std::uint32_t>(&dados[p + 42]);
+                if (p + 46 + tamanhoNome + tamanhoExtra > fim) return false;
+
+                // Campo extra zip64: só os valores saturados no registro aparecem, nesta ordem
+                const auto fimExtra = p + 46 + tamanhoNome + tamanhoExtra;
+                for (auto e = p + 46 + tamanhoNome; e + 4 <= fimExtra;) {
+                    const auto identificador = lerLittleEndian<std::uint16_t>(&dados[e]);
+                    const auto tamanhoCampo = lerLittleEndian<std::uint16_t>(&dados[e + 2]);
+                    if (identificador == 0x0001) {
+                        auto campo = e + 4;
+                        const auto fimCampo = std::min<std::size_t>(campo + tamanhoCampo, fimExtra);
+                        for (auto *valor : {&tamanho, &tamanhoComprimido, &deslocamento}) {
+                            if (*valor == 0xFFFFFFFFu && campo + 8 <= fimCampo) {
+                                *valor = lerLittleEndian<std::uint64_t>(&dados[campo]);
+                                campo += 8;
+                            }
+                        }
+                    }
+                    e += 4 + tamanhoCampo;
+                }
+
+                Entrada entrada;
+                entrada.nome.assign(reinterpret_cast<const char *>(&dados[p + 46]), tamanhoNome);
+                entrada.deslocamento = deslocamento;
+                entrada.tamanhoComprimido = tamanhoComprimido;
+                entrada.tamanho = tamanho;
+                p += 46 + tamanhoNome + tamanhoExtra + tamanhoComentario;
+
+                if (entrada.nome.ends_with('/')) continue; // Diretório
+                if (flags & 1u) {
+                    Log::aviso("Entrada criptografada ignorada: ", entrada.nome);
+                    continue;
+                }
+                if (metodo != 0 && metodo != 8) {
+                    Log::aviso("Método de compressão não suportado (", metodo, "): ", entrada.nome);
+                    continue;
+                }
+                // Armazenada: os bytes lidos são os do pacote, então os dois tamanhos precisam bater
+                if (metodo == 0 && entrada.tamanho != entrada.tamanhoComprimido) {
+                    Log::aviso("Entrada armazenada com tamanhos diferentes ignorada: ", entrada.nome);
+                    continue;
+                }
+                // Comprimida: o tamanho declarado dimensiona o buffer de lerTudo, então não pode
+                // passar do que o deflate consegue produzir a partir de bytes que cabem no pacote
+                if (metodo == 8 && (entrada.tamanhoComprimido > dados.size() ||
+                                    entrada.tamanho / EXPANSAO_MAXIMA_DEFLATE > entrada.tamanhoComprimido)) {
+                    Log::aviso("Entrada comprimida com tamanho impossível ignorada: ", entrada.nome);
+                    continue;
+                }
+                entrada.metodo = metodo == 0 ? Metodo::Armazenado : Metodo::Deflate;
+                entradas.push_back(std::move(entrada));
+            }
+            return true;
+        }
+
+        bool indexarSng() {
+            const auto dados = mapeamento.bytes();
+            std::size_t p = 6 + 4; // "SNGPKG" + versão
+            if (dados.size() < p + 16 + 8) return false;
+            std::copy_n(&dados[p], 16, mascaraXor.begin());
+            p += 16;
+
+            const auto lerU64 = [&](std::uint64_t &valor) {
+                if (p + 8 > dados.size()) return false;
+                valor = lerLittleEndian<std::uint64_t>(&dados[p]);
+                p += 8;
+                return true;
+            };
+            const auto lerTexto = [&](std::string &texto, const std::size_t tamanho) {
+                if (p + tamanho > dados.size()) return false;
+                texto.assign(reinterpret_cast<const char *>(&dados[p]), tamanho);
+                p += tamanho;
+                return true;
+            };
+
+            // Metadados no estilo song.ini
+            std::uint64_t tamanhoSecao = 0;
+            std::uint64_t quantidade = 0;
+            if (!lerU64(tamanhoSecao) || !lerU64(quantidade)) return false;
+            for (std::uint64_t i = 0; i < quantidade; ++i) {
+                std::pair<std::string, std::string> par;
+                if (p + 4 > dados.size()) return false;
+                const auto tamanhoChave = lerLittleEndian<std::uint32_t>(&dados[p]);
+                p += 4;
+                if (!lerTexto(par.first, tamanhoChave) || p + 4 > dados.size()) return false;
+                const auto tamanhoValor = lerLittleEndian<std::uint32_t>(&dados[p]);
+                p += 4;
+                if (!lerTexto(par.second, tamanhoValor)) return false;
+                metadados.push_back(std::move(par));
+            }
+
+            // Índice de arquivos
+            if (!lerU64(tamanhoSecao) || !lerU64(quantidade)) return false;
+            // A quantidade vem do pacote: cada entrada ocupa ao menos 17 bytes (nome vazio e dois u64)
+            constexpr std::uint64_t TAMANHO_MINIMO_ENTRADA_SNG = 1 + 8 + 8;
+            entradas.reserve(static_cast<std::size_t>(
+                std::min<std::uint64_t>(quantidade, (dados.size() - p) / TAMANHO_MINIMO_ENTRADA_SNG)));
+            for (std::uint64_t i = 0; i < quantidade; ++i) {
+                Entrada entrada;
+                if (p + 1 > dados.size()) return false;
+                const auto tamanhoNome = dados[p++];
+                if (!lerTexto(entrada.nome, tamanhoNome) || !lerU64(entrada.tamanho) ||
+                    !lerU64(entrada.deslocamento)) {
+                    return false;
+                }
+                if (!cabe(entrada.deslocamento, entrada.tamanho, dados.size())) return false;
+                entrada.tamanhoComprimido = entrada.tamanho;
+                entrada.metodo = Metodo::Mascarado;
+                entradas.push_back(std::move(entrada));
+            }
+            return true;
+        }
+
+    public:
+        /**
+         * @brief Mapeia e indexa um pacote
+         * @return Nulo se o arquivo não existe ou não é um pacote válido
+         */
+        static auto abrir(const std::filesystem::path &caminho) -> std::shared_ptr<Pacote> {
+            auto pacote = std::make_shared<Pacote>();
+            if (!pacote->mapeamento.abrir(caminho)) {
+                Log::erro("Não foi possível mapear o pacote ", caminho);
+                return nullptr;
+            }
+
+            const auto dados = pacote->mapeamento.bytes();
+            const bool sng = dados.size() >= 6 && std::memcmp(dados.data(), "SNGPKG", 6) == 0;
+            if (!(sng ? pacote->indexarSng() : pacote->indexarZip())) {
+                Log::erro("Pacote inválido ou corrompido: ", caminho);
+                return nullptr;
+            }
+
+            pacote->indice.reserve(pacote->entradas.size());
+            for (std::size_t i = 0; i < pacote->entradas.size(); ++i) {
+                pacote->indice.emplace(normalizarNome(pacote->entradas[i].nome), i);
+            }
+            Log::info("Pacote ", caminho, " indexado: ", pacote->entradas.size(), " entradas");
+            return pacote;
+        }
+
+        [[nodiscard]] const Entrada *procurar(const std::string_view nome) const {
+            const auto it = indice.find(normalizarNome(nome));
+            return it == indice.end() ? nullptr : &entradas[it->second];
+        }
+
+        [[nodiscard]] auto listar() const -> const std::vector<Entrada> & {
+            return entradas;
+        }
+
+        /**
+         * @brief Metadados chave/valor do .sng (vazio em .zip)
+         */
+        [[nodiscard]] auto metadadosSng() const -> const std::vector<std::pair<std::string, std::string>> & {
+            return metadados;
+        }
+
+        /**
+         * @brief Bytes da entrada como estão no pacote (comprimidos ou mascarados)
+         */
+        [[nodiscard]] auto dadosBrutos(const Entrada &entrada) const -> std::optional<std::span<const std::uint8_t>> {
+            const auto dados = mapeamento.bytes();
+            auto inicio = entrada.deslocamento;
+            if (entrada.metodo != Metodo::Mascarado) {
+                // O cabeçalho local pode ter campo extra diferente do diretório central
+                if (!cabe(inicio, 30, dados.size()) || lerLittleEndian<std::uint32_t>(&dados[inicio]) != 0x04034b50) {
+                    return std::nullopt;
+                }
+                inicio += 30 + lerLittleEndian<std::uint16_t>(&dados[inicio + 26]) +
+                          lerLittleEndian<std::uint16_t>(&dados[inicio + 28]);
+            }
+            if (!cabe(inicio, entrada.tamanhoComprimido, dados.size())) return std::nullopt;
+            return dados.subspan(static_cast<std::size_t>(inicio), static_cast<std::size_t>(entrada.tamanhoComprimido));
+        }
+
+        /**
+         * @brief Visão direta de uma entrada armazenada sem compressão (sem cópia)
+         */
+        [[nodiscard]] auto visaoDireta(const Entrada &entrada) const -> std::optional<std::span<const std::uint8_t>> {
+            if (entrada.metodo != Metodo::Armazenado) return std::nullopt;
+            return dadosBrutos(entrada);
+        }
+
+        [[nodiscard]] auto mascara() const -> const std::array<std::uint8_t, 16> & {
+            return mascaraXor;
+        }
+
+        [[nodiscard]] std::optional<LeitorEntrada> abrirEntrada(std::string_view nome) const;
+        [[nodiscard]] std::optional<std::string> lerTudo(std::string_view nome) const;
+    };
+
+    /**
+     * @brief Leitura sequencial com busca sobre uma entrada de pacote
+     *
+     * Mantém o pacote vivo. Buscar para trás em uma entrada comprimida reinicia a
+     * descompressão; para frente, descomprime e descarta.
+     */
+    class LeitorEntrada {
+    private:
+        std::shared_ptr<const Pacote> pacote;
+        Entrada entrada;
+        std::span<const std::uint8_t> bruto;
+        std::unique_ptr<Inflador> inflador;
+        std::uint64_t posicao = 0;
+
+        void desmascarar(std::uint8_t *destino, const std::size_t quantidade) const {
+            const auto &mascara = pacote->mascara();
+            for (std::size_t i = 0; i < quantidade; ++i) {
+                const auto indice = posicao + i;
+                destino[i] = bruto[indice] ^ mascara[indice & 15] ^ static_cast<std::uint8_t>(indice & 0xFF);
+            }
+        }
+
+    public:
+        LeitorEntrada(std::shared_ptr<const Pacote> p, Entrada e, const std::span<const std::uint8_t> dados)
+            : pacote(std::move(p)), entrada(std::move(e)), bruto(dados) {
+            if (entrada.metodo == Metodo::Deflate) {
+                inflador = std::make_unique<Inflador>(bruto);
+            }
+        }
+
+        /**
+         * @brief Lê até `quantidade` bytes a partir da posição atual
+         * @return Bytes lidos, ou nulo se a entrada está corrompida
+         */
+        std::optional<std::size_t> ler(void *destino, std::size_t quantidade) {
+            quantidade = static_cast<std::size_t>(std::min<std::uint64_t>(quantidade, entrada.tamanho - posicao));
+            auto *saida = static_cast<std::uint8_t *>(destino);
+
+            switch (entrada.metodo) {
+                case Metodo::Armazenado:
+                    std::memcpy(saida, bruto.data() + posicao, quantidade);
+                    break;
+                case Metodo::Mascarado:
+                    desmascarar(saida, quantidade);
+                    break;
+                case Metodo::Deflate:
+                    if (inflador->ler(saida, quantidade) != quantidade || inflador->falhou()) {
+                        Log::erro("Entrada corrompida no pacote: ", entrada.nome);
+                        return std::nullopt;
+                    }
+                    break;
+            }
+            posicao += quantidade;
+            return quantidade;
+        }
+
+        std::optional<std::size_t> buscar(const std::size_t destino) {
+            if (destino > entrada.tamanho) return std::nullopt;
+            if (entrada.metodo == Metodo::Deflate) {
+                if (destino < posicao) {
+                    inflador = std::make_unique<Inflador>(bruto);
+                    posicao = 0;
+                }
+                std::array<std::uint8_t, 4096> descarte{};
+                while (posicao < destino) {
+                    if (!ler(descarte.data(), std::min<std::size_t>(descarte.size(), destino - posicao))) {
+                        return std::nullopt;
+                    }
+                }
+            }
+            posicao = destino;
+            return posicao;
+        }
+
+        [[nodiscard]] std::size_t posicaoAtual() const {
+            return static_cast<std::size_t>(posicao);
+        }
+
+        [[nodiscard]] std::size_t tamanho() const {
+            return static_cast<std::size_t>(entrada.tamanho);
+        }
+    };
+
+    inline std::optional<LeitorEntrada> Pacote::abrirEntrada(const std::string_view nome) const {
+        const auto *entrada = procurar(nome);
+        if (!entrada) return std::nullopt;
+        const auto bruto = dadosBrutos(*entrada);
+        if (!bruto) return std::nullopt;
+        return LeitorEntrada(shared_from_this(), *entrada, *bruto);
+    }
+
+    inline std::optional<std::string> Pacote::lerTudo(const std::string_view nome) const {
+        const auto *entrada = procurar(nome);
+        if (!entrada) return std::nullopt;
+        if (const auto direta = visaoDireta(*entrada)) {
+            return std::string(reinterpret_cast<const char *>(direta->data()), direta->size());
+        }
+
+        auto leitor = abrirEntrada(nome);
+        if (!leitor) return std::nullopt;
+        std::string conteudo(leitor->tamanho(), '\0');
+        if (leitor->ler(conteudo.data(), conteudo.size()) != conteudo.size()) return std::nullopt;
+        return conteudo;
+    }
+
+    // ============================= SISTEMA DE ARQUIVOS VIRTUAL =============================
+
+    /**
+     * @brief Resolve caminhos que atravessam pacotes e mantém os pacotes abertos
+     */
+    class SistemaArquivos {
+    private:
+        std::mutex mutex;
+        std::map<std::filesystem::path, std::shared_ptr<Pacote>> pacotes;
+
+        static bool ehPacote(const std::filesystem::path &componente) {
+            const auto extensao = normalizarNome(componente.extension().string());
+            return extensao == ".zip" || extensao == ".sng";
+        }
+
+    public:
+        /**
+         * @brief Divide o caminho em pacote e nome interno
+         * @return Nulo se nenhum componente do caminho é um pacote existente
+         */
+        auto localizar(const std::filesystem::path &caminho)
+            -> std::optional<std::pair<std::shared_ptr<Pacote>, std::string>> {
+            std::filesystem::path acumulado;
+            for (auto it = caminho.begin(); it != caminho.end(); ++it) {
+                acumulado /= *it;
+                if (!ehPacote(*it) || std::next(it) == caminho.end()) continue;
+
+                std::error_code erro;
+                if (!std::filesystem::is_regular_file(acumulado, erro)) continue;
+
+                std::string interno;
+                for (auto resto = std::next(it); resto != caminho.end(); ++resto) {
+                    if (!interno.empty()) interno += '/';
+                    interno += resto->string();
+                }
+
+                std::lock_guard trava(mutex);
+                auto &pacote = pacotes[acumulado];
+                if (!pacote) pacote = Pacote::abrir(acumulado);
+                if (!pacote) {
+                    pacotes.erase(acumulado); // Tenta de novo numa próxima chamada
+                    return std::nullopt;
+                }
+                return std::pair{pacote, std::move(interno)};
+            }
+            return std::nullopt;
+        }
+
+        /**
+         * @brief Lê uma entrada inteira de pacote
+         * @return Nulo se o caminho não passa por um pacote ou a entrada não existe
+         */
+        std::optional<std::string> lerTudo(const std::filesystem::path &caminho) {
+            const auto local = localizar(caminho);
+            if (!local) return std::nullopt;
+            return local->first->lerTudo(local->second);
+        }
+
+        std::optional<LeitorEntrada> abrir(const std::filesystem::path &caminho) {
+            const auto local = localizar(caminho);
+            if (!local) return std::nullopt;
+            return local->first->abrirEntrada(local->second);
+        }
+    };
+
+    /**
+     * @brief Sistema de arquivos virtual do processo
+     */
+    inline SistemaArquivos &sistemaArquivos() {
+        static SistemaArquivos instancia;
+        return instancia;
+    }
+}
@@ -0,0 +1,417 @@
+/**
+ * @file audio.hpp
+ * @brief Reprodução da música por um sf::SoundStream próprio, com relógio contado em quadros
+ *
+ * O sf::Music só expõe getPlayingOffset, sem controle do tamanho dos blocos
+ * entregues ao mixer nem visão da latência de saída. Aqui a thread de áudio
+ * conta os quadros entregues a cada pedido do mixer e, com isso, mede quanto
+ * o mixer lê adiantado (a latência de saída) e quanto o relógio do dispositivo
+ * se afasta do relógio da CPU. O relógio de julgamento do jogo sai dessa conta.
+ * O metrônomo é misturado no mesmo lugar, no quadro exato de cada batida.
+ * Com uma taxa de saída pedida, o áudio é convertido aqui mesmo, uma vez, em
+ * vez de pelo conversor linear do mixer. Uma busca para tempo negativo toca
+ * silêncio antes do primeiro quadro do arquivo, contado no mesmo relógio.
+ */
+
+#pragma once
+
+#include "log.hpp"
+#include "reamostragem.hpp"
+#include "relogio.hpp"
+
+#include <SFML/Audio.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numbers>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace Audio {
+    constexpr std::size_t QUADROS_BLOCO_PADRAO = 512;
+    constexpr std::size_t QUADROS_BLOCO_MINIMO = 64;
+    constexpr std::size_t QUADROS_BLOCO_MAXIMO = 8192;
+    constexpr unsigned TAXA_SAIDA_MINIMA = 8000;
+    constexpr unsigned TAXA_SAIDA_MAXIMA = 384000;
+    constexpr double DURACAO_CLIQUE_SEC = 0.03;
+    constexpr double DECAIMENTO_CLIQUE_SEC = 0.006;
+    constexpr double FREQUENCIA_CLIQUE_HZ = 1000.0;
+    constexpr double FREQUENCIA_CLIQUE_ACENTO_HZ = 1600.0; // Primeira batida do compasso
+    constexpr double AMPLITUDE_CLIQUE = 0.45;
+
+    /**
+     * @brief Clique do metrônomo, no quadro da música em que começa
+     */
+    struct Clique {
+        std::uint64_t quadro;
+        bool acento;
+    };
+
+    /**
+     * @brief Senoide com decaimento exponencial, sintetizada uma vez por taxa de amostragem
+     */
+    inline std::vector<std::int16_t> sintetizarClique(const unsigned taxa, const double frequencia) {
+        std::vector<std::int16_t> som(static_cast<std::size_t>(DURACAO_CLIQUE_SEC * taxa));
+        for (std::size_t i = 0; i < som.size(); ++i) {
+            const auto t = static_cast<double>(i) / taxa;
+            const auto valor = AMPLITUDE_CLIQUE * std::sin(2.0 * std::numbers::pi * frequencia * t) *
+                               std::exp(-t / DECAIMENTO_CLIQUE_SEC);
+            som[i] = static_cast<std::int16_t>(std::lround(valor * 32767.0));
+        }
+        return som;
+    }
+
+    /**
+     * @brief Cliques de uma música, somados aos blocos na thread de áudio
+     *
+     * Os quadros dos cliques são absolutos, então uma busca ou um bloco de
+     * outro tamanho não muda onde eles caem: o clique fica preso ao áudio.
+     */
+    class Metronomo {
+    private:
+        std::vector<Clique> cliques;
+        std::array<std::vector<std::int16_t>, 2> sons; // Normal e acento, do mesmo tamanho
+        unsigned taxaSons = 0;
+
+    public:
+        /**
+         * @brief Troca os cliques (ordenados por quadro); vazio desliga o metrônomo
+         */
+        void definir(std::vector<Clique> novos, const unsigned taxa) {
+            cliques = std::move(novos);
+            if (taxa != taxaSons) {
+                sons = {sintetizarClique(taxa, FREQUENCIA_CLIQUE_HZ), sintetizarClique(taxa, FREQUENCIA_CLIQUE_ACENTO_HZ)};
+                taxaSons = taxa;
+            }
+        }
+
+        [[nodiscard]] bool vazio() const {
+            return cliques.empty();
+        }
+
+        /**
+         * @brief Soma os cliques que soam em um bloco intercalado
+         * @param primeiroQuadro Quadro da música da primeira amostra do bloco
+         */
+        void misturar(std::int16_t *amostras, const std::size_t quadros, const unsigned canais,
+                      const std::uint64_t primeiroQuadro) const {
+            const auto duracao = sons[0].size();
+            if (cliques.empty() || duracao == 0) return;
+
+            // Primeiro clique cujo som ainda não acabou quando o bloco começa
+            const auto desde = primeiroQuadro >= duracao ? primeiroQuadro - duracao + 1 : 0;
+            const auto fimBloco = primeiroQuadro + quadros;
+            for (auto it = std::ranges::lower_bound(cliques, desde, {}, &Clique::quadro);
+                 it != cliques.end() && it->quadro < fimBloco; ++it) {
+                const auto &som = sons[it->acento ? 1 : 0];
+                const auto fim = std::min<std::uint64_t>(it->quadro + duracao, fimBloco);
+                for (auto quadro = std::max(it->quadro, primeiroQuadro); quadro < fim; ++quadro) {
+                    const auto valor = som[quadro - it->quadro];
+                    auto *amostra = amostras + (quadro - primeiroQuadro) * canais;
+                    for (unsigned canal = 0; canal < canais; ++canal) {
+                        amostra[canal] = static_cast<std::int16_t>(std::clamp(amostra[canal] + valor, -32768, 32767));
+                    }
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief Música tocada em blocos de tamanho configurável, com relógio derivado dos quadros entregues
+     *
+     * Os métodos públicos são da thread principal; onGetData e onSeek rodam na
+     * thread de áudio e dividem o estado do arquivo com ela por um mutex, como
+     * no sf::Music.
+     */
+    class Reprodutor : public sf::SoundStream {
+    private:
+        std::mutex mutex;
+        std::unique_ptr<sf::InputStream> fluxo; // Precisa viver mais que o arquivo que o lê
+        sf::InputSoundFile arquivo;
+        std::vector<std::int16_t> bloco;
+        std::size_t quadrosBloco = QUADROS_BLOCO_PADRAO;
+        unsigned taxaPedida = 0;
+        unsigned canais = 0;
+        unsigned taxa = 0; // Do fluxo entregue ao mixer; os quadros do relógio contam nela
+        unsigned taxaEntrada = 0; // Do arquivo
+        std::uint64_t quadrosTotal = 0; // Do arquivo
+        std::optional<Reamostragem::Conversor> conversor;
+        std::vector<std::int16_t> entrada;
+        bool entradaEsgotada = false;
+
+        // Lado da entrega protegido pelo mutex; a posição é só da thread principal
+        RelogioMusica relogio;
+        Metronomo metronomo;
+        std::function<void()> prepararThread; // Roda uma vez em cada thread que chama onGetData
+        std::thread::id threadPreparada;
+
+        /**
+         * @brief Abre o arquivo com a thread de áudio afastada e prepara o fluxo
+         * @param abrirArquivo Abre `arquivo`; chamado com o mutex travado
+         */
+        template<typename Abertura>
+        bool abrirCom(Abertura &&abrirArquivo) {
+            stop();
+            {
+                const std::lock_guard trava(mutex);
+                if (!abrirArquivo()) return false;
+                canais = arquivo.getChannelCount();
+                taxaEntrada = arquivo.getSampleRate();
+                if (canais == 0 || taxaEntrada == 0) return false;
+                quadrosTotal = arquivo.getSampleCount() / canais;
+                prepararConversor();
+                metronomo.definir({}, taxa);
+                bloco.assign(quadrosBloco * canais, 0);
+                relogio.reiniciar();
+            }
+            initialize(canais, taxa, arquivo.getChannelMap());
+            return true;
+        }
+
+        /**
+         * @brief Liga a conversão quando a taxa pedida difere da do arquivo (mutex travado)
+         */
+        void prepararConversor() {
+            taxa = taxaPedida == 0 ? taxaEntrada : taxaPedida;
+            conversor.reset();
+            entrada.clear();
+            entradaEsgotada = false;
+            if (taxa == taxaEntrada) return;
+
+            conversor.emplace(canais, taxaEntrada, taxa);
+            if (!conversor->valido()) {
+                Log::aviso("Conversão de ", taxaEntrada, " para ", taxa, " Hz não suportada; tocando na taxa do arquivo");
+                conversor.reset();
+                taxa = taxaEntrada;
+                return;
+            }
+            entrada.assign(quadrosBloco * canais, 0);
+        }
+
+        /**
+         * @brief Escreve até `maximo` quadros convertidos, lendo do arquivo o que faltar
+         * @return Quadros escritos (menos que `maximo` só no fim da música)
+         */
+        std::size_t lerConvertido(std::int16_t *destino, const std::size_t maximo) {
+            auto prontos = conversor->extrair(destino, maximo);
+            while (prontos < maximo && !entradaEsgotada) {
+                const auto lidas = static_cast<std::size_t>(arquivo.read(entrada.data(), entrada.size()));
+                if (lidas == 0) {
+                    conversor->finalizar();
+                    entradaEsgotada = true;
+                } else {
+                    conversor->empurrar(entrada.data(), lidas / canais);
+                }
+                prontos += conversor->extrair(destino + prontos * canais, maximo - prontos);
+            }
+            return prontos;
+        }
+
+    protected:
+        bool onGetData(Chunk &dados) override {
+            const auto instante = agoraNs();
+            const std::lock_guard trava(mutex);
+            if (prepararThread && std::this_thread::get_id() != threadPreparada) {
+                threadPreparada = std::this_thread::get_id();
+                prepararThread();
+            }
+
+            // Antecedência: o bloco começa com silêncio e o arquivo entra no quadro 0, sem nova âncora
+            const auto silencio = relogio.entregar(instante, taxa, quadrosBloco);
+            std::fill_n(bloco.begin(), silencio * canais, std::int16_t{0});
+            auto *destino = bloco.data() + silencio * canais;
+            const auto livres = quadrosBloco - silencio;
+            const auto lidos = livres == 0 ? 0
+                               : conversor ? lerConvertido(destino, livres)
+                                           : static_cast<std::size_t>(arquivo.read(destino, livres * canais)) / canais;
+            if (lidos > 0) {
+                const auto primeiro = relogio.quadroAtual() + static_cast<std::int64_t>(silencio); // >= 0 quando o arquivo já entrou
+                metronomo.misturar(destino, lidos, canais, static_cast<std::uint64_t>(primeiro));
+            }
+            const auto quadros = silencio + lidos;
+            relogio.avancar(quadros);
+            dados.samples = bloco.data();
+            dados.sampleCount = quadros * canais;
+            return quadros > 0;
+        }
+
+        void onSeek(const sf::Time posicao) override {
+            const std::lock_guard trava(mutex);
+            const auto quadro = static_cast<std::uint64_t>(std::max(0.0, std::round(static_cast<double>(posicao.asSeconds()) * taxa)));
+            if (conversor) {
+                // O conversor devolve o quadro do arquivo e a fase que caem exatamente no quadro de saída
+                arquivo.seek(conversor->reposicionar(quadro) * canais);
+                entradaEsgotada = false;
+            } else {
+                arquivo.seek(quadro * canais);
+            }
+            relogio.aplicarBusca(quadro);
+        }
+
+    public:
+        Reprodutor() = default;
+        Reprodutor(const Reprodutor &) = delete;
+        Reprodutor &operator=(const Reprodutor &) = delete;
+
+        /**
+         * @brief Para a thread de áudio antes que os membros que ela usa sejam destruídos, como o sf::Music
+         */
+        ~Reprodutor() override {
+            stop();
+        }
+
+        /**
+         * @brief Quadros por bloco entregue ao mixer (vale a partir do próximo abrir)
+         */
+        void definirQuadrosPorBloco(const std::size_t quadros) {
+            quadrosBloco = std::clamp(quadros, QUADROS_BLOCO_MINIMO, QUADROS_BLOCO_MAXIMO);
+        }
+
+        [[nodiscard]] std::size_t quadrosPorBloco() const {
+            return quadrosBloco;
+        }
+
+        /**
+         * @brief Função chamada na thread de áudio antes da primeira entrega (agendamento, afinidade)
+         *
+         * A thread é do mixer da SFML e pode mudar quando o dispositivo é reaberto;
+         * a função roda de novo em cada thread nova.
+         */
+        void definirPreparoThread(std::function<void()> preparo) {
+            const std::lock_guard trava(mutex);
+            prepararThread = std::move(preparo);
+            threadPreparada = {};
+        }
+
+        /**
+         * @brief Troca os cliques do metrônomo; vale a partir do próximo bloco
+         */
+        void definirCliques(std::vector<Clique> cliques) {
+            const std::lock_guard trava(mutex);
+            metronomo.definir(std::move(cliques), taxa);
+        }
+
+        /**
+         * @brief Duração do áudio aberto, em segundos (0 se o formato não informa)
+         */
+        [[nodiscard]] double duracaoSegundos() const {
+            return taxaEntrada == 0 ? 0.0 : static_cast<double>(quadrosTotal) / taxaEntrada;
+        }
+
+        /**
+         * @brief Taxa entregue ao mixer (0 segue o arquivo); vale a partir do próximo abrir
+         *
+         * Com a taxa do dispositivo aqui, o mixer não converte mais nada. Fora
+         * de TAXA_SAIDA_MINIMA..TAXA_SAIDA_MAXIMA a taxa é limitada à borda.
+         */
+        void definirTaxaSaida(const unsigned taxaSaida) {
+            taxaPedida = taxaSaida == 0 ? 0 : std::clamp(taxaSaida, TAXA_SAIDA_MINIMA, TAXA_SAIDA_MAXIMA);
+        }
+
+        [[nodiscard]] unsigned taxaArquivo() const {
+            return taxaEntrada;
+        }
+
+        /**
+         * @brief Memória do bloco entregue ao mixer e da conversão de taxa
+         */
+        [[nodiscard]] std::size_t bytesBuffers() {
+            const std::lock_guard trava(mutex);
+            return (bloco.capacity() + entrada.capacity()) * sizeof(std::int16_t) + (conversor ? conversor->bytes() : 0);
+        }
+
+        bool abrir(const std::filesystem::path &caminho) {
+            return abrirCom([&] { return arquivo.openFromFile(caminho); });
+        }
+
+        /**
+         * @brief Abre a partir de um fluxo (entrada de pacote), que passa a ser deste objeto
+         *
+         * O fluxo anterior só é trocado depois que o arquivo deixou de lê-lo.
+         */
+        bool abrir(std::unique_ptr<sf::InputStream> novoFluxo) {
+            return abrirCom([&] {
+                if (!arquivo.openFromStream(*novoFluxo)) return false;
+                fluxo = std::move(novoFluxo);
+                return true;
+            });
+        }
+
+        /**
+         * @brief Toca; o primeiro pedido do mixer depois disso ancora o relógio
+         *
+         * Com uma busca ainda não aplicada, a época dela já serve: o primeiro
+         * pedido depois da busca é o primeiro pedido depois do play.
+         */
+        void play() override {
+            if (getStatus() != Status::Playing) {
+                const std::lock_guard trava(mutex);
+                relogio.tocar();
+            }
+            sf::SoundStream::play();
+        }
+
+        void pause() override {
+            relogio.pausar(getStatus() == Status::Playing, taxa, agoraNs());
+            sf::SoundStream::pause();
+        }
+
+        void stop() override {
+            sf::SoundStream::stop();
+            relogio.parar();
+        }
+
+        /**
+         * @brief Busca; uma posição negativa começa em silêncio e chega ao início do arquivo no quadro 0
+         *
+         * A SFML só recebe posições a partir de zero; o silêncio é contado aqui e
+         * fica guardado até onSeek consumi-lo, como a época da busca.
+         * A época da busca nasce aqui e vai junto com ela para onSeek, então o
+         * relógio só volta a andar com a âncora da posição nova, rode onSeek
+         * dentro desta chamada ou depois, na thread de áudio.
+         */
+        void setPlayingOffset(const sf::Time posicao) {
+            const auto segundos = static_cast<double>(posicao.asSeconds());
+            {
+                const std::lock_guard trava(mutex);
+                relogio.pedirBusca(segundos, taxa);
+            }
+            sf::SoundStream::setPlayingOffset(std::max(posicao, sf::Time::Zero));
+        }
+
+        /**
+         * @brief Posição audível da música, em segundos (negativa na antecedência)
+         *
+         * É a do quadro que sai do dispositivo, supondo que a saída começa no
+         * primeiro pedido do mixer; o que sobra (conversor, caixas) fica para
+         * OFFSET_LATENCIA_AUDIO_SEC. Entre entregas a posição avança pelo relógio
+         * da CPU e a média das entregas corrige a deriva. Parada, pausada ou à
+         * espera do primeiro pedido depois de play, ela fica congelada e nunca
+         * volta para trás sem uma busca.
+         */
+        [[nodiscard]] double posicaoSegundos() {
+            return relogio.posicao(getStatus() == Status::Playing, taxa, agoraNs());
+        }
+
+        /**
+         * @brief Quanto o mixer lê adiantado, medido no início da reprodução
+         */
+        [[nodiscard]] double latenciaSegundos() const {
+            return relogio.latenciaSegundos();
+        }
+
+        /**
+         * @brief Quanto o relógio do dispositivo se afastou do relógio da CPU desde a âncora
+         */
+        [[nodiscard]] double derivaSegundos() const {
+            return relogio.derivaSegundos();
+        }
+    };
+}
@@ -0,0 +1,1296 @@
+/**
+ * @file chart.hpp
+ * @brief Estruturas de chart, leitura e gravação de .chart e conversão de ticks em segundos
+ *
+ * Usado pelo jogo e pelo riff-convert.
+ */
+
+#pragma once
+
+#include "log.hpp"
+#include "memoria.hpp"
+#include "texto.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <regex>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace Chart {
+    /**
+     * @brief Representa uma mudança de tempo no chart
+     */
+    struct MudancaTempo {
+        int tick;
+        int valorBruto;
+
+        constexpr MudancaTempo(const int t, const int val) : tick(t), valorBruto(val) {}
+
+        /**
+         * @brief Obtém o BPM (Batidas Por Minuto)
+         * @return BPM como double
+         */
+        [[nodiscard]] constexpr auto obterBPM() const -> double {
+            return static_cast<double>(valorBruto) / 1000.0;
+        }
+
+        /**
+         * @brief Obtém microssegundos por batida
+         * @return Microssegundos por batida
+         */
+        [[nodiscard]] constexpr auto obterMicrossegundosPorBatida() const -> double {
+            const auto bpm = obterBPM();
+            if (bpm <= 0) return 0;
+            return 60'000'000.0 / bpm;
+        }
+    };
+
+    /**
+     * @brief Representa uma assinatura de tempo no chart
+     */
+    struct AssinaturaTempo {
+        int tick;
+        int numerador;
+        int denominador;
+
+        constexpr AssinaturaTempo(const int t, const int n, const int d)
+            : tick(t), numerador(n), denominador(d) {}
+    };
+
+    /**
+     * @brief Representa uma nota no chart
+     */
+    struct NotaChart {
+        int tick;
+        int traste;
+        int comprimento;
+
+        constexpr NotaChart(const int t, const int tr, const int comp)
+            : tick(t), traste(tr), comprimento(comp) {}
+    };
+
+    /**
+     * @brief Metadados de uma música, vindos do [Song] do chart ou do song.ini
+     */
+    struct MetadadosMusica {
+        sf::String nome, artista, streamMusica;
+        sf::String criadorChart, album, ano, genero, tipoMidia;
+        double offset = 0.0;
+        int dificuldade = 0;
+        double inicioPreview = 0.0;
+        double fimPreview = 0.0;
+        sf::String jogador2;
+    };
+
+    /**
+     * @brief Contém todos os dados de um chart
+     */
+    struct DadosChart : MetadadosMusica {
+        int resolucao = 192;
+        Memoria::Mapa<int, MudancaTempo, Memoria::Subsistema::Chart> mudancasTempo;
+        Memoria::Mapa<int, AssinaturaTempo, Memoria::Subsistema::Chart> assinaturasTempo;
+        Memoria::Vetor<NotaChart, Memoria::Subsistema::Chart> notas;
+    };
+
+    /**
+     * @brief Leitura só dos metadados, sem converter notas
+     *
+     * Aceita as chaves do song.ini (Clone Hero, tempos em milissegundos) e as do
+     * [Song] de um .chart (tempos em segundos); maiúsculas não importam.
+     */
+    class LeitorMetadados {
+    public:
+        /**
+         * @brief Aplica um par chave/valor aos metadados
+         * @return False se a chave não é conhecida
+         */
+        static bool aplicarCampo(const std::string_view chave, const std::string_view valor, MetadadosMusica &m) {
+            using Ini::iguaisSemCaixa;
+            double numero = 0.0;
+
+            if (iguaisSemCaixa(chave, "name")) m.nome = utf8ParaSfString(valor);
+            else if (iguaisSemCaixa(chave, "artist")) m.artista = utf8ParaSfString(valor);
+            else if (iguaisSemCaixa(chave, "album")) m.album = utf8ParaSfString(valor);
+            else if (iguaisSemCaixa(chave, "genre")) m.genero = utf8ParaSfString(valor);
+            else if (iguaisSemCaixa(chave, "charter") || iguaisSemCaixa(chave, "frets")) {
+                m.criadorChart = utf8ParaSfString(valor);
+            }
+            else if (iguaisSemCaixa(chave, "year")) {
+                // Charts antigos gravam o ano como ", 2005"
+                auto ano = valor;
+                while (!ano.empty() && (ano.front() == ',' || ano.front() == ' ')) ano.remove_prefix(1);
+                m.ano = utf8ParaSfString(ano);
+            }
+            else if (iguaisSemCaixa(chave, "mediatype")) m.tipoMidia = utf8ParaSfString(valor);
+            else if (iguaisSemCaixa(chave, "player2")) m.jogador2 = utf8ParaSfString(valor);
+            else if (iguaisSemCaixa(chave, "musicstream")) m.streamMusica = utf8ParaSfString(valor);
+            else if (iguaisSemCaixa(chave, "offset")) Ini::lerNumero(valor, m.offset);
+            else if (iguaisSemCaixa(chave, "delay")) {
+                if (Ini::lerNumero(valor, numero)) m.offset = numero / 1000.0;
+            }
+            else if (iguaisSemCaixa(chave, "difficulty") || iguaisSemCaixa(chave, "diff_guitar")) {
+                Ini::lerNumero(valor, m.dificuldade);
+            }
+            else if (iguaisSemCaixa(chave, "previewstart")) Ini::lerNumero(valor, m.inicioPreview);
+            else if (iguaisSemCaixa(chave, "previewend")) Ini::lerNumero(valor, m.fimPreview);
+            else if (iguaisSemCaixa(chave, "preview_start_time")) {
+                if (Ini::lerNumero(valor, numero)) m.inicioPreview = numero / 1000.0;
+            }
+            else if (iguaisSemCaixa(chave, "preview_end_time")) {
+                if (Ini::lerNumero(valor, numero)) m.fimPreview = numero / 1000.0;
+            }
+            else return false;
+            return true;
+        }
+
+        /**
+         * @brief Aplica a seção [song] de um song.ini
+         * @return True se a seção existe
+         */
+        static bool aplicarSongIni(const std::string_view texto, MetadadosMusica &m) {
+            bool encontrada = false;
+            Ini::percorrer(texto, [&](const std::string_view secao, const std::string_view chave,
+                                      const std::string_view valor) {
+                if (Ini::iguaisSemCaixa(secao, "song")) {
+                    encontrada = true;
+                    aplicarCampo(chave, valor, m);
+                }
+                return true;
+            });
+            return encontrada;
+        }
+
+        /**
+         * @brief Lê só o [Song] de um .chart, parando na primeira seção seguinte
+         */
+        static void aplicarSecaoSongChart(const std::string_view texto, MetadadosMusica &m) {
+            Ini::percorrer(texto, [&](const std::string_view secao, const std::string_view chave,
+                                      const std::string_view valor) {
+                if (secao != "Song") return secao.empty();
+                aplicarCampo(chave, valor, m);
+                return true;
+            });
+        }
+    };
+
+    /**
+     * @brief Parser para arquivos de chart
+     */
+    class ParserChart {
+    public:
+        /**
+         * @brief Faz o parsing de um arquivo de chart
+         * @param caminhoArquivo Caminho para o arquivo .chart
+         * @return DadosChart opcional (std::nullopt se houver erro)
+         */
+        [[nodiscard]] static auto fazerParsingChart(const std::string &caminhoArquivo) -> std::optional<DadosChart> {
+            // Lê arquivo com suporte UTF-8
+            const std::string conteudoUtf8 = lerArquivoUtf8(caminhoArquivo);
+            if (conteudoUtf8.empty()) {
+                Log::erro("Não foi possível abrir o arquivo de chart: ", caminhoArquivo);
+                return std::nullopt;
+            }
+            return fazerParsingConteudo(conteudoUtf8);
+        }
+
+        /**
+         * @brief Faz o parsing de um chart já carregado (texto UTF-8 sem BOM)
+         */
+        [[nodiscard]] static auto fazerParsingConteudo(const std::string &conteudoUtf8) -> DadosChart {
+            DadosChart dadosChart;
+            std::istringstream streamArquivo(conteudoUtf8);
+            std::string linhaAtual, secaoAtual;
+            const std::regex padraoSecao(R"(\[(.+)\])");
+            const std::regex padraoChaveValor(R"(\s*(.+?)\s*=\s*(.+))");
+            const std::regex padraoNota(R"((\d+)\s*=\s*N\s+(\d+)\s+(\d+))");
+            const std::regex padraoTempo(R"((\d+)\s*=\s*B\s+(\d+))");
+            const std::regex padraoAssinaturaTempo(R"((\d+)\s*=\s*TS\s+(\d+)(?:\s+(\d+))?)");
+            std::smatch correspondencia;
+
+            while (std::getline(streamArquivo, linhaAtual)) {
+                // Remove espaços em branco no início e fim
+                const auto primeiroChar = linhaAtual.find_first_not_of(" \t\r\n");
+                if (primeiroChar == std::string::npos) {
+                    linhaAtual.clear();
+                } else {
+                    linhaAtual.erase(0, primeiroChar);
+                    const auto ultimoChar = linhaAtual.find_last_not_of(" \t\r\n");
+                    if (ultimoChar != std::string::npos) {
+                        linhaAtual.erase(ultimoChar + 1);
+                    }
+                }
+
+                // Pula linhas vazias e comentários
+                if (linhaAtual.empty() || linhaAtual.rfind("//", 0) == 0) {
+                    continue;
+                }
+
+                // Identifica seções
+                if (std::regex_match(linhaAtual, correspondencia, padraoSecao)) {
+                    secaoAtual = correspondencia[1].str();
+                    continue;
+                }
+
+                // Pula chaves
+                if (linhaAtual == "{" || linhaAtual == "}") {
+                    continue;
+                }
+
+                // Processa linha na seção atual
+                if (!secaoAtual.empty()) {
+                    // Sempre processa Song e SyncTrack
+                    if (secaoAtual == "Song" || secaoAtual == "SyncTrack") {
+                        processarLinhaNaSecao(dadosChart, secaoAtual, linhaAtual, padraoChaveValor,
+                                            padraoNota, padraoTempo, padraoAssinaturaTempo);
+                    }
+                    // Só processa a dificuldade desejada
+                    else if (secaoAtual == "HardSingle") {
+                        processarLinhaNaSecao(dadosChart, secaoAtual, linhaAtual, padraoChaveValor,
+                                            padraoNota, padraoTempo, padraoAssinaturaTempo);
+                    }
+                }
+            }
+
+            // Ordena notas por tick, mantendo a ordem do arquivo dentro do mesmo tick
+            std::ranges::stable_sort(dadosChart.notas, [](const auto &a, const auto &b) {
+                return a.tick < b.tick;
+            });
+
+            return dadosChart;
+        }
+
+    private:
+        /**
+         * @brief Processa uma linha dentro de uma seção específica
+         */
+        static void processarLinhaNaSecao(DadosChart &chart, const std::string &secao,
+                                        const std::string &linha, const std::regex &padraoCV,
+                                        const std::regex &padraoN, const std::regex &padraoT,
+                                        const std::regex &padraoAT) {
+            std::smatch correspondencia;
+
+            if (secao == "Song") {
+                if (std::regex_match(linha, correspondencia, padraoCV)) {
+                    auto chave = correspondencia[1].str();
+                    auto valor = correspondencia[2].str();
+
+                    // Remove aspas se presentes
+                    if (valor.length() >= 2 && valor.front() == '"' && valor.back() == '"') {
+                        valor = valor.substr(1, valor.length() - 2);
+                    }
+
+                    // Mapeia chaves para campos da estrutura (convertendo para sf::String)
+                    if (chave == "Name") chart.nome = utf8ParaSfString(valor);
+                    else if (chave == "Artist") chart.artista = utf8ParaSfString(valor);
+                    else if (chave == "Charter") chart.criadorChart = utf8ParaSfString(valor);
+                    else if (chave == "Album") chart.album = utf8ParaSfString(valor);
+                    else if (chave == "Year") chart.ano = utf8ParaSfString(valor);
+                    else if (chave == "Genre") chart.genero = utf8ParaSfString(valor);
+                    else if (chave == "MediaType") chart.tipoMidia = utf8ParaSfString(valor);
+                    else if (chave == "Player2") chart.jogador2 = utf8ParaSfString(valor);
+                    else if (chave == "MusicStream") chart.streamMusica = utf8ParaSfString(valor);
+                    else if (chave == "Offset") chart.offset = std::stod(valor);
+                    else if (chave == "Resolution") chart.resolucao = std::stoi(valor);
+                    else if (chave == "Difficulty") chart.dificuldade = std::stoi(valor);
+                    else if (chave == "PreviewStart") chart.inicioPreview = std::stod(valor);
+                    else if (chave == "PreviewEnd") chart.fimPreview = std::stod(valor);
+                }
+            }
+            else if (secao == "SyncTrack") {
+                if (std::regex_match(linha, correspondencia, padraoT)) {
+                    chart.mudancasTempo.emplace(std::stoi(correspondencia[1].str()),
+                                              MudancaTempo(std::stoi(correspondencia[1].str()),
+                                                         std::stoi(correspondencia[2].str())));
+                }
+                else if (std::regex_match(linha, correspondencia, padraoAT)) {
+                    // O terceiro número é o expoente do denominador (3 = oitavas); sem ele, 4/4
+                    const auto expoente = correspondencia[3].matched ? std::stoi(correspondencia[3].str()) : 2;
+                    const auto denominador = 1 << std::clamp(expoente, 0, 6);
+                    chart.assinaturasTempo.emplace(std::stoi(correspondencia[1].str()),
+                                                 AssinaturaTempo(std::stoi(correspondencia[1].str()),
+                                                               std::stoi(correspondencia[2].str()),
+                                                               denominador));
+                }
+            }
+            else if (secao == "ExpertSingle" || secao == "HardSingle" ||
+                     secao == "MediumSingle" || secao == "EasySingle") {
+                if (std::regex_match(linha, correspondencia, padraoN)) {
+                    chart.notas.emplace_back(NotaChart(std::stoi(correspondencia[1].str()),
+                                                     std::stoi(correspondencia[2].str()),
+                                                     std::stoi(correspondencia[3].str())));
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief Gravação de DadosChart no formato .chart
+     *
+     * Tudo é formatado com std::to_chars num único buffer, gravado de uma vez
+     * num arquivo temporário que depois substitui o original. O resultado lido
+     * de volta pelo ParserChart é igual ao que foi gravado.
+     *
+     * O parser só entende [Song], [SyncTrack] e [HardSingle]. Quando o texto
+     * original é passado, as outras seções (eventos, outras dificuldades e
+     * instrumentos) são copiadas como estão, e as linhas que o parser ignora
+     * dentro dessas três (star power, âncoras, chaves desconhecidas do [Song])
+     * voltam para o mesmo tick.
+     */
+    class EscritorChart {
+    private:
+        static constexpr std::string_view SECAO_NOTAS = "HardSingle";
+
+        /**
+         * @brief Buffer de saída que cresce em dobro; os números são escritos no próprio buffer
+         */
+        class Saida {
+        private:
+            std::string dados;
+            std::size_t usado = 0;
+
+            char *reservar(const std::size_t bytes) {
+                if (usado + bytes > dados.size()) dados.resize(std::max(dados.size() * 2, usado + bytes));
+                return dados.data() + usado;
+            }
+
+        public:
+            explicit Saida(const std::size_t estimativa) {
+                dados.resize(estimativa);
+            }
+
+            Saida &operator<<(const std::string_view texto) {
+                std::memcpy(reservar(texto.size()), texto.data(), texto.size());
+                usado += texto.size();
+                return *this;
+            }
+
+            Saida &operator<<(const char caractere) {
+                *reservar(1) = caractere;
+                ++usado;
+                return *this;
+            }
+
+            Saida &operator<<(const int numero) {
+                auto *inicio = reservar(16);
+                usado = static_cast<std::size_t>(std::to_chars(inicio, inicio + 16, numero).ptr - dados.data());
+                return *this;
+            }
+
+            // Representação mais curta que volta exatamente ao mesmo double
+            Saida &operator<<(const double numero) {
+                auto *inicio = reservar(32);
+                usado = static_cast<std::size_t>(std::to_chars(inicio, inicio + 32, numero).ptr - dados.data());
+                return *this;
+            }
+
+            [[nodiscard]] std::string concluir() && {
+                dados.resize(usado);
+                return std::move(dados);
+            }
+        };
+
+        /**
+         * @brief Linha do original que o parser não lê, a ser devolvida ao seu tick
+         */
+        struct LinhaPreservada {
+            int tick;
+            std::string_view texto;
+        };
+
+        struct Secao {
+            std::string_view nome;
+            std::string_view corpo; // Entre as chaves, com as quebras de linha
+            std::string_view completa; // Do cabeçalho até a chave de fechamento, inclusive
+        };
+
+        static std::string_view aparar(std::string_view texto) {
+            while (!texto.empty() && (texto.front() == ' ' || texto.front() == '\t')) texto.remove_prefix(1);
+            while (!texto.empty() && (texto.back() == ' ' || texto.back() == '\t' || texto.back() == '\r')) {
+                texto.remove_suffix(1);
+            }
+            return texto;
+        }
+
+        /**
+         * @brief Chama f(linha aparada) para cada linha não vazia
+         */
+        template<typename Funcao>
+        static void paraCadaLinha(std::string_view texto, Funcao &&f) {
+            while (!texto.empty()) {
+                const auto fim = std::min(texto.find('\n'), texto.size());
+                if (const auto linha = aparar(texto.substr(0, fim)); !linha.empty()) f(linha);
+                texto.remove_prefix(std::min(fim + 1, texto.size()));
+            }
+        }
+
+        /**
+         * @brief Divide o texto em seções "[Nome] { ... }"
+         */
+        static std::vector<Secao> dividirSecoes(const std::string_view texto) {
+            std::vector<Secao> secoes;
+            std::size_t inicioSecao = 0, inicioCorpo = 0;
+            std::string_view nome;
+            bool dentro = false;
+
+            for (std::size_t posicao = 0; posicao < texto.size();) {
+                const auto fim = std::min(texto.find('\n', posicao), texto.size());
+                const auto linha = aparar(texto.substr(posicao, fim - posicao));
+                if (!dentro && linha.size() >= 2 && linha.front() == '[' && linha.back() == ']') {
+                    nome = linha.substr(1, linha.size() - 2);
+                    inicioSecao = posicao;
+                } else if (!dentro && linha == "{" && !nome.empty()) {
+                    inicioCorpo = fim + 1;
+                    dentro = true;
+                } else if (dentro && linha == "}") {
+                    secoes.push_back({nome, texto.substr(inicioCorpo, posicao - inicioCorpo),
+                                      aparar(texto.substr(inicioSecao, fim - inicioSecao))});
+                    nome = {};
+                    dentro = false;
+                }
+                posicao = fim + 1;
+            }
+            return secoes;
+        }
+
+        /**
+         * @brief Linhas "<tick> = <tipo> ..." cujo tipo não é regravado a partir do DadosChart
+         */
+        static std::vector<LinhaPreservada> linhasPreservadas(const std::string_view corpo,
+                                                              const std::initializer_list<std::string_view> tiposGravados) {
+            std::vector<LinhaPreservada> linhas;
+            paraCadaLinha(corpo, [&](const std::string_view linha) {
+                int tick = 0;
+                const auto [fimTick, erro] = std::from_chars(linha.data(), linha.data() + linha.size(), tick);
+                if (erro != std::errc{}) return;
+                const auto igual = linha.find('=');
+                if (igual == std::string_view::npos) return;
+                auto resto = aparar(linha.substr(igual + 1));
+                const auto tipo = resto.substr(0, resto.find(' '));
+                if (std::ranges::find(tiposGravados, tipo) == tiposGravados.end()) linhas.push_back({tick, linha});
+            });
+            std::ranges::stable_sort(linhas, {}, &LinhaPreservada::tick);
+            return linhas;
+        }
+
+        /**
+         * @brief Escreve as linhas preservadas com tick menor que o limite
+         */
+        static void escreverPreservadasAte(Saida &saida, const std::span<const LinhaPreservada> linhas,
+                                           std::size_t &proxima, const int tickLimite) {
+            for (; proxima < linhas.size() && linhas[proxima].tick < tickLimite; ++proxima) {
+                saida << "  " << linhas[proxima].texto << '\n';
+            }
+        }
+
+        static void escreverTexto(Saida &saida, const std::string_view chave, const sf::String &valor, const bool aspas = true) {
+            if (valor.isEmpty()) return;
+            saida << "  " << chave << " = ";
+            if (aspas) saida << '"';
+            saida << std::string_view(sfStringParaUtf8(valor));
+            if (aspas) saida << '"';
+            saida << '\n';
+        }
+
+        static void escreverSong(Saida &saida, const DadosChart &chart, const std::optional<Secao> &original) {
+            saida << "[Song]\n{\n";
+            escreverTexto(saida, "Name", chart.nome);
+            escreverTexto(saida, "Artist", chart.artista);
+            escreverTexto(saida, "Charter", chart.criadorChart);
+            escreverTexto(saida, "Album", chart.album);
+            escreverTexto(saida, "Year", chart.ano);
+            saida << "  Offset = " << chart.offset << '\n';
+            saida << "  Resolution = " << chart.resolucao << '\n';
+            escreverTexto(saida, "Player2", chart.jogador2, false);
+            if (chart.dificuldade != 0) saida << "  Difficulty = " << chart.dificuldade << '\n';
+            if (chart.inicioPreview != 0.0) saida << "  PreviewStart = " << chart.inicioPreview << '\n';
+            if (chart.fimPreview != 0.0) saida << "  PreviewEnd = " << chart.fimPreview << '\n';
+            escreverTexto(saida, "Genre", chart.genero);
+            escreverTexto(saida, "MediaType", chart.tipoMidia);
+            escreverTexto(saida, "MusicStream", chart.streamMusica);
+
+            // Chaves que o parser não conhece (GuitarStream, BassStream...)
+            if (original) {
+                constexpr std::array conhecidas = {"Name", "Artist", "Charter", "Album", "Year", "Offset", "Resolution",
+                                                   "Player2", "Difficulty", "PreviewStart", "PreviewEnd", "Genre",
+                                                   "MediaType", "MusicStream"};
+                paraCadaLinha(original->corpo, [&](const std::string_view linha) {
+                    const auto chave = aparar(linha.substr(0, linha.find('=')));
+                    if (std::ranges::find(conhecidas, chave) == conhecidas.end()) saida << "  " << linha << '\n';
+                });
+            }
+            saida << "}\n";
+        }
+
+        static void escreverSyncTrack(Saida &saida, const DadosChart &chart, const std::optional<Secao> &original) {
+            const auto preservadas = original ? linhasPreservadas(original->corpo, {"B", "TS"})
+                                              : std::vector<LinhaPreservada>{};
+            std::size_t proxima = 0;
+
+            saida << "[SyncTrack]\n{\n";
+            auto tempo = chart.mudancasTempo.begin();
+            auto assinatura = chart.assinaturasTempo.begin();
+            while (tempo != chart.mudancasTempo.end() || assinatura != chart.assinaturasTempo.end()) {
+                // No mesmo tick, a assinatura vem antes do tempo, como nos charts do Moonscraper
+                if (assinatura != chart.assinaturasTempo.end() &&
+                    (tempo == chart.mudancasTempo.end() || assinatura->first <= tempo->first)) {
+                    escreverPreservadasAte(saida, preservadas, proxima, assinatura->first);
+                    const auto &[tick, numerador, denominador] = assinatura->second;
+                    saida << "  " << tick << " = TS " << numerador;
+                    if (denominador != 4) saida << ' ' << static_cast<int>(std::bit_width(static_cast<unsigned>(std::max(denominador, 1)))) - 1;
+                    saida << '\n';
+                    ++assinatura;
+                } else {
+                    escreverPreservadasAte(saida, preservadas, proxima, tempo->first);
+                    saida << "  " << tempo->second.tick << " = B " << tempo->second.valorBruto << '\n';
+                    ++tempo;
+                }
+            }
+            escreverPreservadasAte(saida, preservadas, proxima, std::numeric_limits<int>::max());
+            saida << "}\n";
+        }
+
+        static void escreverNotas(Saida &saida, const DadosChart &chart, const std::optional<Secao> &original) {
+            const auto preservadas = original ? linhasPreservadas(original->corpo, {"N"})
+                                              : std::vector<LinhaPreservada>{};
+            std::size_t proxima = 0;
+
+            // O parser ordena por tick de forma estável; notas fora de ordem são gravadas na mesma ordem
+            std::span<const NotaChart> notas(chart.notas);
+            std::vector<NotaChart> ordenadas;
+            if (!std::ranges::is_sorted(notas, {}, &NotaChart::tick)) {
+                ordenadas.assign(notas.begin(), notas.end());
+                std::ranges::stable_sort(ordenadas, {}, &NotaChart::tick);
+                notas = ordenadas;
+            }
+
+            saida << '[' << SECAO_NOTAS << "]\n{\n";
+            for (const auto &[tick, traste, comprimento] : notas) {
+                escreverPreservadasAte(saida, preservadas, proxima, tick);
+                saida << "  " << tick << " = N " << traste << ' ' << comprimento << '\n';
+            }
+            escreverPreservadasAte(saida, preservadas, proxima, std::numeric_limits<int>::max());
+            saida << "}\n";
+        }
+
+    public:
+        /**
+         * @brief Formata o chart como texto .chart
+         * @param original Texto do arquivo original, para preservar o que o parser não lê
+         */
+        [[nodiscard]] static std::string serializar(const DadosChart &chart, const std::string_view original = {}) {
+            const auto secoes = dividirSecoes(original);
+            const auto encontrar = [&](const std::string_view nome) -> std::optional<Secao> {
+                const auto it = std::ranges::find(secoes, nome, &Secao::nome);
+                return it != secoes.end() ? std::optional(*it) : std::nullopt;
+            };
+
+            // Uma nota ocupa por volta de 20 bytes ("  123456 = N 0 192\n")
+            Saida saida(original.size() + 24 * (chart.notas.size() + chart.mudancasTempo.size() +
+                                                chart.assinaturasTempo.size()) + 1024);
+            escreverSong(saida, chart, encontrar("Song"));
+            escreverSyncTrack(saida, chart, encontrar("SyncTrack"));
+
+            bool notasEscritas = false;
+            for (const auto &secao : secoes) {
+                if (secao.nome == "Song" || secao.nome == "SyncTrack") continue;
+                if (secao.nome == SECAO_NOTAS) {
+                    if (!notasEscritas) escreverNotas(saida, chart, secao);
+                    notasEscritas = true;
+                } else {
+                    saida << secao.completa << '\n';
+                }
+            }
+            if (!notasEscritas) escreverNotas(saida, chart, std::nullopt);
+            return std::move(saida).concluir();
+        }
+
+        /**
+         * @brief Grava o chart num arquivo, substituindo-o só depois de escrito por inteiro
+         * @return False se não foi possível gravar (o arquivo anterior fica intacto)
+         */
+        static bool gravar(const std::filesystem::path &caminho, const DadosChart &chart,
+                           const std::string_view original = {}) {
+            const auto texto = serializar(chart, original);
+            auto temporario = caminho;
+            temporario += ".tmp";
+            {
+                std::ofstream arquivo(temporario, std::ios::binary | std::ios::trunc);
+                arquivo.write(texto.data(), static_cast<std::streamsize>(texto.size()));
+                if (!arquivo) {
+                    Log::erro("Não foi possível gravar o chart: ", temporario.string());
+                    return false;
+                }
+            }
+            std::error_code erro;
+            std::filesystem::rename(temporario, caminho, erro);
+            if (erro) {
+                Log::erro("Não foi possível substituir o chart: ", caminho.string(), " (", erro.message(), ")");
+                std::filesystem::remove(temporario, erro);
+                return false;
+            }
+            return true;
+        }
+    };
+
+    /**
+     * @brief Leitura e gravação de MIDI no formato do Clone Hero/Rock Band
+     *
+     * Só a faixa "PART GUITAR" no Hard (notas 84 a 88), o mapa de tempo e as
+     * assinaturas; o nome da música vai no nome da primeira faixa e os outros
+     * metadados ficam no song.ini. Como no Clone Hero, sustains de até 1/3 de
+     * batida viram notas curtas, e um sustain que passa da próxima nota da
+     * mesma pista é cortado nela. representavel() diz o que sobrevive a uma ida
+     * e volta; é contra isso que uma conversão deve ser conferida.
+     */
+    class ConversorMidi {
+    private:
+        static constexpr std::string_view NOME_FAIXA_GUITARRA = "PART GUITAR";
+        static constexpr int NOTA_VERDE_DIFICIL = 84; // Easy 60, Medium 72, Hard 84, Expert 96
+        static constexpr int TRASTES_MIDI = 5;
+        static constexpr std::uint8_t VELOCIDADE_NOTA = 100;
+        static constexpr double MICROSSEGUNDOS_POR_MINUTO = 60'000'000.0;
+
+        /**
+         * @brief Leitura big-endian com verificação de limites; um erro marca o leitor como inválido
+         */
+        struct LeitorBytes {
+            std::string_view dados;
+            std::size_t posicao = 0;
+            bool valido = true;
+
+            [[nodiscard]] bool fim() const {
+                return posicao >= dados.size();
+            }
+
+            std::string_view trecho(const std::size_t tamanho) {
+                if (tamanho > dados.size() - posicao) {
+                    valido = false;
+                    posicao = dados.size();
+                    return {};
+                }
+                const auto resultado = dados.substr(posicao, tamanho);
+                posicao += tamanho;
+                return resultado;
+            }
+
+            std::uint32_t inteiro(const std::size_t bytes) {
+                std::uint32_t valor = 0;
+                for (const char byte : trecho(bytes)) valor = valor << 8 | static_cast<unsigned char>(byte);
+                return valor;
+            }
+
+            // Quantidade de tamanho variável: 7 bits por byte, até 4 bytes
+            std::uint32_t variavel() {
+                std::uint32_t valor = 0;
+                for (int i = 0; i < 4 && !fim(); ++i) {
+                    const auto byte = static_cast<unsigned char>(dados[posicao++]);
+                    valor = valor << 7 | (byte & 0x7F);
+                    if (!(byte & 0x80)) return valor;
+                }
+                valido = false;
+                return valor;
+            }
+        };
+
+        static void anexarInteiro(std::string &saida, const std::uint32_t valor, const int bytes) {
+            for (int i = bytes - 1; i >= 0; --i) saida += static_cast<char>(valor >> (8 * i) & 0xFF);
+        }
+
+        static void anexarVariavel(std::string &saida, std::uint32_t valor) {
+            char bytes[4];
+            int quantidade = 0;
+            do {
+                bytes[quantidade++] = static_cast<char>(valor & 0x7F);
+                valor >>= 7;
+            } while (valor > 0 && quantidade < 4);
+            while (quantidade > 1) saida += static_cast<char>(bytes[--quantidade] | 0x80);
+            saida += bytes[0];
+        }
+
+        static void anexarFaixa(std::string &saida, const std::string_view eventos) {
+            saida += "MTrk";
+            anexarInteiro(saida, static_cast<std::uint32_t>(eventos.size()), 4);
+            saida += eventos;
+        }
+
+        static void anexarNomeFaixa(std::string &eventos, const std::string_view nome) {
+            anexarVariavel(eventos, 0);
+            eventos += "\xFF\x03";
+            anexarVariavel(eventos, static_cast<std::uint32_t>(nome.size()));
+            eventos += nome;
+        }
+
+        [[nodiscard]] static std::uint32_t microssegundosPorBatida(const int valorBruto) {
+            return static_cast<std::uint32_t>(
+                std::clamp<long long>(std::llround(MICROSSEGUNDOS_POR_MINUTO * 1000.0 / valorBruto), 1, 0xFFFFFF));
+        }
+
+        [[nodiscard]] static int valorBrutoDe(const std::uint32_t microssegundos) {
+            return static_cast<int>(std::llround(MICROSSEGUNDOS_POR_MINUTO * 1000.0 / microssegundos));
+        }
+
+        /**
+         * @brief Ordena por (tick, traste), descarta repetidas, corta sustains sobrepostos e aplica o limiar
+         */
+        static void normalizarNotas(Memoria::Vetor<NotaChart, Memoria::Subsistema::Chart> &notas, const int resolucao) {
+            const auto antes = [](const NotaChart &a, const NotaChart &b) {
+                return a.tick != b.tick ? a.tick < b.tick : a.traste < b.traste;
+            };
+            std::ranges::stable_sort(notas, antes);
+            const auto repetidas = std::ranges::unique(notas, [](const NotaChart &a, const NotaChart &b) {
+                return a.tick == b.tick && a.traste == b.traste;
+            });
+            notas.erase(repetidas.begin(), repetidas.end());
+
+            std::array<int, TRASTES_MIDI> proximoTick;
+            proximoTick.fill(std::numeric_limits<int>::max());
+            for (auto it = notas.rbegin(); it != notas.rend(); ++it) {
+                auto &proximo = proximoTick[static_cast<std::size_t>(it->traste)];
+                if (proximo != std::numeric_limits<int>::max()) {
+                    it->comprimento = std::min(it->comprimento, proximo - it->tick);
+                }
+                if (it->comprimento <= resolucao / 3) it->comprimento = 0;
+                proximo = it->tick;
+            }
+        }
+
+    public:
+        /**
+         * @brief O que resta do chart depois de gravado e lido de volta como MIDI
+         */
+        [[nodiscard]] static DadosChart representavel(const DadosChart &chart) {
+            DadosChart resultado;
+            resultado.nome = chart.nome;
+            resultado.resolucao = chart.resolucao;
+            for (const auto &[tick, mudanca] : chart.mudancasTempo) {
+                if (mudanca.valorBruto <= 0) continue;
+                resultado.mudancasTempo.emplace(
+                    tick, MudancaTempo(tick, valorBrutoDe(microssegundosPorBatida(mudanca.valorBruto))));
+            }
+            for (const auto &[tick, assinatura] : chart.assinaturasTempo) {
+                const auto expoente = std::min(6, static_cast<int>(std::bit_width(
+                                                      static_cast<unsigned>(std::max(assinatura.denominador, 1)))) - 1);
+                resultado.assinaturasTempo.emplace(
+                    tick, AssinaturaTempo(tick, std::clamp(assinatura.numerador, 1, 255), 1 << expoente));
+            }
+            for (const auto &nota : chart.notas) {
+                if (nota.traste >= 0 && nota.traste < TRASTES_MIDI && nota.tick >= 0) {
+                    resultado.notas.emplace_back(nota.tick, nota.traste, std::max(0, nota.comprimento));
+                }
+            }
+            normalizarNotas(resultado.notas, resultado.resolucao);
+            return resultado;
+        }
+
+        /**
+         * @brief Lê um arquivo MIDI (formato 0 ou 1, divisão em ticks por semínima)
+         * @return Nulo se o arquivo não é um MIDI válido
+         */
+        [[nodiscard]] static std::optional<DadosChart> ler(const std::string_view bytes) {
+            LeitorBytes leitor{bytes};
+            if (leitor.trecho(4) != "MThd" || leitor.inteiro(4) != 6) return std::nullopt;
+            const auto formato = leitor.inteiro(2);
+            const auto quantidadeFaixas = leitor.inteiro(2);
+            const auto divisao = leitor.inteiro(2);
+            if (!leitor.valido || formato > 1 || divisao == 0 || (divisao & 0x8000)) return std::nullopt;
+
+            DadosChart chart;
+            chart.resolucao = static_cast<int>(divisao);
+            for (std::uint32_t faixa = 0; faixa < quantidadeFaixas && !leitor.fim(); ++faixa) {
+                if (leitor.trecho(4) != "MTrk") return std::nullopt;
+                LeitorBytes eventos{leitor.trecho(leitor.inteiro(4))};
+                if (!leitor.valido) return std::nullopt;
+
+                int tick = 0;
+                std::uint8_t status = 0;
+                bool guitarra = false;
+                std::array<std::deque<std::size_t>, TRASTES_MIDI> abertas; // Índices das notas sem note-off
+                while (!eventos.fim() && eventos.valido) {
+                    tick += static_cast<int>(eventos.variavel());
+                    const auto byte = static_cast<std::uint8_t>(eventos.inteiro(1));
+
+                    if (byte == 0xFF) {
+                        const auto tipo = eventos.inteiro(1);
+                        const auto dados = eventos.trecho(eventos.variavel());
+                        if (tipo == 0x2F) break;
+                        if (tipo == 0x03) {
+                            guitarra = dados == NOME_FAIXA_GUITARRA;
+                            if (faixa == 0) chart.nome = utf8ParaSfString(dados);
+                        } else if (tipo == 0x51 && dados.size() == 3) {
+                            LeitorBytes tempo{dados};
+                            const auto microssegundos = tempo.inteiro(3);
+                            if (microssegundos > 0) {
+                                chart.mudancasTempo.insert_or_assign(tick, MudancaTempo(tick, valorBrutoDe(microssegundos)));
+                            }
+                        } else if (tipo == 0x58 && dados.size() >= 2) {
+                            const auto numerador = static_cast<unsigned char>(dados[0]);
+                            const auto expoente = std::min(6, static_cast<int>(static_cast<unsigned char>(dados[1])));
+                            chart.assinaturasTempo.insert_or_assign(
+                                tick, AssinaturaTempo(tick, std::max<int>(1, numerador), 1 << expoente));
+                        }
+                        continue;
+                    }
+                    if (byte == 0xF0 || byte == 0xF7) {
+                        eventos.trecho(eventos.variavel());
+                        continue;
+                    }
+
+                    // Evento de canal, possivelmente com status corrente (running status)
+                    std::uint8_t primeiro = byte;
+                    if (byte & 0x80) {
+                        status = byte;
+                        primeiro = static_cast<std::uint8_t>(eventos.inteiro(1));
+                    } else if (status == 0) {
+                        return std::nullopt;
+                    }
+                    const auto tipo = status & 0xF0;
+                    const auto segundo = tipo == 0xC0 || tipo == 0xD0 ? 0u : eventos.inteiro(1);
+                    if (!guitarra || (tipo != 0x80 && tipo != 0x90)) continue;
+
+                    const auto traste = static_cast<int>(primeiro) - NOTA_VERDE_DIFICIL;
+                    if (traste < 0 || traste >= TRASTES_MIDI) continue;
+                    auto &abertasTraste = abertas[static_cast<std::size_t>(traste)];
+                    if (tipo == 0x90 && segundo > 0) {
+                        abertasTraste.push_back(chart.notas.size());
+                        chart.notas.emplace_back(tick, traste, 0);
+                    } else if (!abertasTraste.empty()) {
+                        auto &nota = chart.notas[abertasTraste.front()];
+                        nota.comprimento = tick - nota.tick;
+                        abertasTraste.pop_front();
+                    }
+                }
+                if (!eventos.valido) return std::nullopt;
+            }
+
+            normalizarNotas(chart.notas, chart.resolucao);
+            return chart;
+        }
+
+        /**
+         * @brief Grava como MIDI de formato 1 (faixa de tempo + PART GUITAR)
+         * @return Nulo se a resolução não cabe no cabeçalho MIDI
+         */
+        [[nodiscard]] static std::optional<std::string> escrever(const DadosChart &original) {
+            if (original.resolucao <= 0 || original.resolucao > 0x7FFF) return std::nullopt;
+            const auto chart = representavel(original);
+
+            std::string saida;
+            saida.reserve(64 + 8 * (chart.mudancasTempo.size() + chart.assinaturasTempo.size()) + 9 * chart.notas.size());
+            saida += "MThd";
+            anexarInteiro(saida, 6, 4);
+            anexarInteiro(saida, 1, 2);
+            anexarInteiro(saida, 2, 2);
+            anexarInteiro(saida, static_cast<std::uint32_t>(chart.resolucao), 2);
+
+            // Faixa 0: nome da música, assinaturas e tempos (a assinatura vem antes no mesmo tick)
+            std::string eventos;
+            anexarNomeFaixa(eventos, sfStringParaUtf8(chart.nome));
+            int tickAnterior = 0;
+            auto tempo = chart.mudancasTempo.begin();
+            auto assinatura = chart.assinaturasTempo.begin();
+            while (tempo != chart.mudancasTempo.end() || assinatura != chart.assinaturasTempo.end()) {
+                if (assinatura != chart.assinaturasTempo.end() &&
+                    (tempo == chart.mudancasTempo.end() || assinatura->first <= tempo->first)) {
+                    anexarVariavel(eventos, static_cast<std::uint32_t>(assinatura->first - tickAnterior));
+                    tickAnterior = assinatura->first;
+                    eventos += "\xFF\x58\x04";
+                    eventos += static_cast<char>(assinatura->second.numerador);
+                    eventos += static_cast<char>(std::bit_width(static_cast<unsigned>(assinatura->second.denominador)) - 1);
+                    eventos += "\x18\x08"; // 24 pulsos de relógio por batida, 8 fusas por semínima
+                    ++assinatura;
+                } else {
+                    anexarVariavel(eventos, static_cast<std::uint32_t>(tempo->first - tickAnterior));
+                    tickAnterior = tempo->first;
+                    eventos += "\xFF\x51\x03";
+                    anexarInteiro(eventos, microssegundosPorBatida(tempo->second.valorBruto), 3);
+                    ++tempo;
+                }
+            }
+            eventos += std::string_view("\x00\xFF\x2F\x00", 4);
+            anexarFaixa(saida, eventos);
+
+            // Faixa 1: notas. Num mesmo tick, note-offs de notas anteriores vêm antes dos note-ons, e o
+            // note-off de uma nota curta vem depois do seu note-on
+            struct EventoNota {
+                int tick;
+                std::uint8_t ordem; // 0: fim de sustain, 1: início, 2: fim de nota curta
+                std::uint8_t nota;
+            };
+            std::vector<EventoNota> eventosNotas;
+            eventosNotas.reserve(chart.notas.size() * 2);
+            std::array<int, TRASTES_MIDI> proximoTick;
+            proximoTick.fill(std::numeric_limits<int>::max());
+            for (auto it = chart.notas.rbegin(); it != chart.notas.rend(); ++it) {
+                const auto nota = static_cast<std::uint8_t>(NOTA_VERDE_DIFICIL + it->traste);
+                auto &proximo = proximoTick[static_cast<std::size_t>(it->traste)];
+                // Nota curta dura 1/12 de batida (abaixo do limiar de sustain), sem encostar na próxima
+                const auto duracao = it->comprimento > 0 ? it->comprimento
+                                                         : std::min(chart.resolucao / 12, proximo - it->tick);
+                eventosNotas.push_back({it->tick, 1, nota});
+                eventosNotas.push_back({it->tick + duracao, static_cast<std::uint8_t>(duracao > 0 ? 0 : 2), nota});
+                proximo = it->tick;
+            }
+            std::ranges::sort(eventosNotas, [](const EventoNota &a, const EventoNota &b) {
+                return std::tie(a.tick, a.ordem, a.nota) < std::tie(b.tick, b.ordem, b.nota);
+            });
+
+            eventos.clear();
+            anexarNomeFaixa(eventos, NOME_FAIXA_GUITARRA);
+            tickAnterior = 0;
+            for (const auto &evento : eventosNotas) {
+                anexarVariavel(eventos, static_cast<std::uint32_t>(evento.tick - tickAnterior));
+                tickAnterior = evento.tick;
+                const bool inicio = evento.ordem == 1;
+                eventos += static_cast<char>(inicio ? 0x90 : 0x80);
+                eventos += static_cast<char>(evento.nota);
+                eventos += static_cast<char>(inicio ? VELOCIDADE_NOTA : 0);
+            }
+            eventos += std::string_view("\x00\xFF\x2F\x00", 4);
+            anexarFaixa(saida, eventos);
+            return saida;
+        }
+    };
+
+    /**
+     * @brief Cache binário de um chart já interpretado
+     *
+     * Guarda o DadosChart inteiro em campos de tamanho fixo (little-endian),
+     * com o hash do arquivo de origem: carregar é só copiar, e um cache de uma
+     * versão anterior do chart é recusado.
+     */
+    class CacheBinario {
+    private:
+        static constexpr std::uint32_t MAGICA = 0x54524843; // "CHRT"
+        static constexpr std::uint32_t VERSAO = 1;
+        static constexpr std::size_t TAMANHO_CABECALHO = 4 + 4 + 8 + 4 + 4 + 3 * 8 + 3 * 4;
+
+        template <typename T>
+        static void anexar(std::string &saida, const T valor) {
+            const auto bits = static_cast<std::uint64_t>(valor);
+            for (std::size_t i = 0; i < sizeof(T); ++i) saida += static_cast<char>(bits >> (8 * i) & 0xFF);
+        }
+
+        static void anexarTexto(std::string &saida, const sf::String &texto) {
+            const auto utf8 = sfStringParaUtf8(texto);
+            anexar(saida, static_cast<std::uint32_t>(utf8.size()));
+            saida += utf8;
+        }
+
+        static std::array<sf::String *, 9> textos(MetadadosMusica &m) {
+            return {&m.nome, &m.artista, &m.streamMusica, &m.criadorChart, &m.album, &m.ano, &m.genero, &m.tipoMidia,
+                    &m.jogador2};
+        }
+
+    public:
+        static constexpr std::string_view EXTENSAO = ".rhc";
+
+        /**
+         * @param hashOrigem hashConteudo() do arquivo de onde o chart veio
+         */
+        [[nodiscard]] static std::string escrever(const DadosChart &chart, const std::uint64_t hashOrigem) {
+            std::string saida;
+            saida.reserve(TAMANHO_CABECALHO + 256 + 8 * chart.mudancasTempo.size() +
+                          12 * (chart.assinaturasTempo.size() + chart.notas.size()));
+            anexar(saida, MAGICA);
+            anexar(saida, VERSAO);
+            anexar(saida, hashOrigem);
+            anexar(saida, static_cast<std::uint32_t>(chart.resolucao));
+            anexar(saida, static_cast<std::uint32_t>(chart.dificuldade));
+            for (const auto valor : {chart.offset, chart.inicioPreview, chart.fimPreview}) {
+                anexar(saida, std::bit_cast<std::uint64_t>(valor));
+            }
+            anexar(saida, static_cast<std::uint32_t>(chart.mudancasTempo.size()));
+            anexar(saida, static_cast<std::uint32_t>(chart.assinaturasTempo.size()));
+            anexar(saida, static_cast<std::uint32_t>(chart.notas.size()));
+
+            auto metadados = static_cast<MetadadosMusica>(chart);
+            for (const auto *texto : textos(metadados)) anexarTexto(saida, *texto);
+            for (const auto &[tick, mudanca] : chart.mudancasTempo) {
+                anexar(saida, static_cast<std::uint32_t>(tick));
+                anexar(saida, static_cast<std::uint32_t>(mudanca.valorBruto));
+            }
+            for (const auto &[tick, assinatura] : chart.assinaturasTempo) {
+                anexar(saida, static_cast<std::uint32_t>(tick));
+                anexar(saida, static_cast<std::uint32_t>(assinatura.numerador));
+                anexar(saida, static_cast<std::uint32_t>(assinatura.denominador));
+            }
+            for (const auto &nota : chart.notas) {
+                anexar(saida, static_cast<std::uint32_t>(nota.tick));
+                anexar(saida, static_cast<std::uint32_t>(nota.traste));
+                anexar(saida, static_cast<std::uint32_t>(nota.comprimento));
+            }
+            return saida;
+        }
+
+        /**
+         * @brief Hash do arquivo de origem gravado no cache (nulo se não é um cache desta versão)
+         */
+        [[nodiscard]] static std::optional<std::uint64_t> hashOrigem(const std::string_view bytes) {
+            if (bytes.size() < TAMANHO_CABECALHO) return std::nullopt;
+            const auto *dados = reinterpret_cast<const std::uint8_t *>(bytes.data());
+            if (Arquivos::lerLittleEndian<std::uint32_t>(dados) != MAGICA ||
+                Arquivos::lerLittleEndian<std::uint32_t>(dados + 4) != VERSAO) {
+                return std::nullopt;
+            }
+            return Arquivos::lerLittleEndian<std::uint64_t>(dados + 8);
+        }
+
+        /**
+         * @param hashEsperado Se dado, o cache só vale para um arquivo de origem com esse hash
+         * @return Nulo se o cache é inválido, de outra versão ou de outra origem
+         */
+        [[nodiscard]] static std::optional<DadosChart> ler(const std::string_view bytes,
+                                                          const std::optional<std::uint64_t> hashEsperado = std::nullopt) {
+            const auto hash = hashOrigem(bytes);
+            if (!hash || (hashEsperado && *hash != *hashEsperado)) return std::nullopt;
+
+            const auto *dados = reinterpret_cast<const std::uint8_t *>(bytes.data());
+            std::size_t posicao = 16;
+            bool valido = true;
+            const auto lerU32 = [&] {
+                if (posicao + 4 > bytes.size()) {
+                    valido = false;
+                    return 0u;
+                }
+                posicao += 4;
+                return Arquivos::lerLittleEndian<std::uint32_t>(dados + posicao - 4);
+            };
+            const auto lerInt = [&] { return static_cast<int>(lerU32()); };
+            const auto lerDouble = [&] {
+                const std::uint64_t baixo = lerU32();
+                return std::bit_cast<double>(baixo | static_cast<std::uint64_t>(lerU32()) << 32);
+            };
+
+            DadosChart chart;
+            chart.resolucao = lerInt();
+            chart.dificuldade = lerInt();
+            chart.offset = lerDouble();
+            chart.inicioPreview = lerDouble();
+            chart.fimPreview = lerDouble();
+            const auto quantidadeTempos = lerU32();
+            const auto quantidadeAssinaturas = lerU32();
+            const auto quantidadeNotas = lerU32();
+            for (auto *texto : textos(chart)) {
+                const auto tamanho = lerU32();
+                if (!valido || tamanho > bytes.size() - posicao) return std::nullopt;
+                *texto = utf8ParaSfString(bytes.substr(posicao, tamanho));
+                posicao += tamanho;
+            }
+
+            const auto restante = static_cast<std::uint64_t>(bytes.size() - posicao);
+            // Cada contagem é alargada antes da soma: em 32 bits, assinaturas + notas dá a volta
+            if (8ull * quantidadeTempos + 12ull * quantidadeAssinaturas + 12ull * quantidadeNotas != restante) {
+                return std::nullopt;
+            }
+            for (std::uint32_t i = 0; i < quantidadeTempos; ++i) {
+                const auto tick = lerInt();
+                chart.mudancasTempo.emplace_hint(chart.mudancasTempo.end(), tick, MudancaTempo(tick, lerInt()));
+            }
+            for (std::uint32_t i = 0; i < quantidadeAssinaturas; ++i) {
+                const auto tick = lerInt();
+                const auto numerador = lerInt();
+                chart.assinaturasTempo.emplace_hint(chart.assinaturasTempo.end(), tick,
+                                                    AssinaturaTempo(tick, numerador, lerInt()));
+            }
+            chart.notas.reserve(quantidadeNotas);
+            for (std::uint32_t i = 0; i < quantidadeNotas; ++i) {
+                const auto tick = lerInt();
+                const auto traste = lerInt();
+                chart.notas.emplace_back(tick, traste, lerInt());
+            }
+            if (!valido) return std::nullopt;
+            return chart;
+        }
+    };
+
+    /**
+     * @brief Calculadora de tempo baseada em mudanças de tempo do chart
+     *
+     * Guarda o instante de início de cada segmento de tempo, então cada conversão
+     * é uma busca binária. Uma mudança de tempo editada só recalcula os inícios a
+     * partir do próprio segmento; as notas não precisam ser convertidas de novo.
+     */
+    class CalculadoraTempo {
+    private:
+        const DadosChart &referenciaChart;
+        std::vector<MudancaTempo> mudancasTempoOrdenadas;
+        std::vector<double> segundosInicioSegmento; // Sem o offset do chart
+
+        [[nodiscard]] auto segundosPorTick(const MudancaTempo &mudanca) const -> double {
+            return mudanca.obterMicrossegundosPorBatida() / static_cast<double>(referenciaChart.resolucao) / 1'000'000.0;
+        }
+
+        /**
+         * @brief Índice do segmento que contém o tick
+         */
+        [[nodiscard]] auto indiceSegmento(const int tick) const -> std::size_t {
+            const auto it = std::ranges::upper_bound(mudancasTempoOrdenadas, tick, {}, &MudancaTempo::tick);
+            return it == mudancasTempoOrdenadas.begin() ? 0 : static_cast<std::size_t>(it - mudancasTempoOrdenadas.begin()) - 1;
+        }
+
+        /**
+         * @brief Recalcula o início dos segmentos a partir de um índice
+         */
+        void recalcularAPartirDe(const std::size_t indice) {
+            segundosInicioSegmento.resize(mudancasTempoOrdenadas.size());
+            if (referenciaChart.resolucao == 0) return;
+            for (auto i = std::max<std::size_t>(indice, 1); i < mudancasTempoOrdenadas.size(); ++i) {
+                const auto &anterior = mudancasTempoOrdenadas[i - 1];
+                segundosInicioSegmento[i] = segundosInicioSegmento[i - 1] +
+                    static_cast<double>(mudancasTempoOrdenadas[i].tick - anterior.tick) * segundosPorTick(anterior);
+            }
+        }
+
+    public:
+        /**
+         * @brief Construtor da calculadora de tempo
+         * @param chart Referência para os dados do chart
+         */
+        explicit CalculadoraTempo(const DadosChart &chart) : referenciaChart(chart) {
+            // Copia e ordena mudanças de tempo
+            for (const auto &mudanca: referenciaChart.mudancasTempo | std::views::values) {
+                mudancasTempoOrdenadas.push_back(mudanca);
+            }
+
+            std::ranges::sort(mudancasTempoOrdenadas, [](const auto &a, const auto &b) {
+                return a.tick < b.tick;
+            });
+
+            // Garante que há uma mudança de tempo no tick 0
+            if (mudancasTempoOrdenadas.empty() || mudancasTempoOrdenadas.front().tick != 0) {
+                mudancasTempoOrdenadas.insert(mudancasTempoOrdenadas.begin(), MudancaTempo(0, 120000));
+            }
+            recalcularAPartirDe(0);
+        }
+
+        /**
+         * @brief Converte ticks para segundos
+         * @param tickAlvo Tick a ser convertido
+         * @return Tempo em segundos
+         */
+        [[nodiscard]] auto ticksParaSegundos(const int tickAlvo) const -> double {
+            if (referenciaChart.resolucao == 0) {
+                Log::erro("Resolução do chart é 0. Não é possível calcular tempo a partir de ticks.");
+                return referenciaChart.offset;
+            }
+            if (tickAlvo <= 0) return referenciaChart.offset;
+
+            const auto indice = indiceSegmento(tickAlvo);
+            const auto &mudanca = mudancasTempoOrdenadas[indice];
+            return segundosInicioSegmento[indice] +
+                   static_cast<double>(tickAlvo - mudanca.tick) * segundosPorTick(mudanca) + referenciaChart.offset;
+        }
+
+        /**
+         * @brief Converte segundos para ticks (inversa de ticksParaSegundos, fracionária)
+         */
+        [[nodiscard]] auto segundosParaTicks(const double segundos) const -> double {
+            if (referenciaChart.resolucao == 0) return 0.0;
+            const auto semOffset = segundos - referenciaChart.offset;
+            if (semOffset <= 0.0) return 0.0;
+
+            const auto it = std::ranges::upper_bound(segundosInicioSegmento, semOffset);
+            const auto indice = static_cast<std::size_t>(it - segundosInicioSegmento.begin()) - 1;
+            const auto &mudanca = mudancasTempoOrdenadas[indice];
+            const auto porTick = segundosPorTick(mudanca);
+            if (porTick <= 0.0) return mudanca.tick;
+            return mudanca.tick + (semOffset - segundosInicioSegmento[indice]) / porTick;
+        }
+
+        /**
+         * @brief Mudança de tempo em vigor no tick
+         */
+        [[nodiscard]] auto mudancaEm(const int tick) const -> const MudancaTempo & {
+            return mudancasTempoOrdenadas[indiceSegmento(tick)];
+        }
+
+        /**
+         * @brief Insere ou altera uma mudança de tempo, recalculando só os segmentos seguintes
+         */
+        void definirMudanca(const MudancaTempo &mudanca) {
+            const auto it = std::ranges::lower_bound(mudancasTempoOrdenadas, mudanca.tick, {}, &MudancaTempo::tick);
+            const auto indice = static_cast<std::size_t>(it - mudancasTempoOrdenadas.begin());
+            if (it != mudancasTempoOrdenadas.end() && it->tick == mudanca.tick) {
+                *it = mudanca;
+            } else {
+                mudancasTempoOrdenadas.insert(it, mudanca);
+            }
+            recalcularAPartirDe(indice);
+        }
+
+        /**
+         * @brief Remove a mudança de tempo do tick (a do tick 0 volta a 120 BPM)
+         */
+        void removerMudanca(const int tick) {
+            if (tick == 0) {
+                definirMudanca(MudancaTempo(0, 120000));
+                return;
+            }
+            const auto it = std::ranges::lower_bound(mudancasTempoOrdenadas, tick, {}, &MudancaTempo::tick);
+            if (it == mudancasTempoOrdenadas.end() || it->tick != tick) return;
+            const auto indice = static_cast<std::size_t>(it - mudancasTempoOrdenadas.begin());
+            mudancasTempoOrdenadas.erase(it);
+            recalcularAPartirDe(indice);
+        }
+    };
+
+    /**
+     * @brief Batida do mapa de tempo
+     */
+    struct Batida {
+        double segundos;
+        bool inicioCompasso;
+    };
+
+    /**
+     * @brief Todas as batidas do chart até um instante, com o início de cada compasso marcado
+     *
+     * A batida vale uma semínima dividida pelo denominador da assinatura, e os
+     * compassos recomeçam em cada assinatura, como na grade do editor. Cada
+     * instante sai direto da calculadora, sem somar intervalos, então centenas
+     * de mudanças de tempo não acumulam erro.
+     */
+    inline std::vector<Batida> batidas(const DadosChart &chart, const CalculadoraTempo &calculadora,
+                                       const double fimSegundos) {
+        std::vector<Batida> resultado;
+        if (chart.resolucao <= 0) return resultado;
+
+        const auto tickFim = calculadora.segundosParaTicks(fimSegundos);
+        auto proximaAssinatura = chart.assinaturasTempo.begin();
+        int numerador = 4;
+        int denominador = 4;
+        int batidaNoSegmento = 0;
+        for (int tick = 0; tick <= tickFim;) {
+            // Uma assinatura fora da batida recomeça a contagem no próprio tick
+            if (proximaAssinatura != chart.assinaturasTempo.end() && proximaAssinatura->first <= tick) {
+                tick = std::max(0, proximaAssinatura->first);
+                numerador = std::max(1, proximaAssinatura->second.numerador);
+                denominador = std::max(1, proximaAssinatura->second.denominador);
+                batidaNoSegmento = 0;
+                ++proximaAssinatura;
+                continue;
+            }
+            resultado.push_back({calculadora.ticksParaSegundos(tick), batidaNoSegmento % numerador == 0});
+            ++batidaNoSegmento;
+            tick += std::max(1, chart.resolucao * 4 / denominador);
+        }
+        return resultado;
+    }
+}
@@ -0,0 +1,679 @@
+/**
+ * @file lan.hpp
+ * @brief Lobby na rede local e transferência da música entre os jogadores
+ *
+ * O anfitrião anuncia o lobby por broadcast UDP e serve os arquivos da música
+ * (chart, song.ini, áudio...) por TCP, divididos em pedaços de 256 KiB com
+ * SHA-256 individual. Quem entra pede o manifesto, confere o que já tem em
+ * disco e pede só os pedaços que faltam, vários de cada vez na mesma conexão.
+ *
+ * A ordem dos pedidos privilegia o início da partida: primeiro os arquivos
+ * essenciais (chart e song.ini), depois os áudios intercalados pedaço a pedaço,
+ * por último o resto (capa, vídeo). Assim que os essenciais e o começo de cada
+ * áudio chegam, o receptor sinaliza que a partida pode começar; o restante do
+ * áudio chega bem mais rápido do que é tocado.
+ *
+ * O progresso de cada arquivo fica em "<arquivo>.progresso" até ele ficar
+ * completo; uma transferência interrompida continua de onde parou.
+ *
+ * Os sockets TCP ficam em modo não bloqueante e toda leitura ou escrita tem
+ * limite de tempo: um par que para no meio de uma mensagem, ou que para de
+ * ler, derruba só a própria conexão e não impede o lobby de fechar.
+ */
+
+#pragma once
+
+#include "log.hpp"
+#include "sha256.hpp"
+
+#include <SFML/Network.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Lan {
+    constexpr unsigned short PORTA_DESCOBERTA = 47777;
+    constexpr unsigned short PORTA_TRANSFERENCIA_PADRAO = 47778;
+    constexpr std::uint32_t MAGIA_ANUNCIO = 0x4E4C4652; // "RFLN"
+    constexpr std::uint8_t VERSAO_PROTOCOLO = 1;
+    constexpr std::uint32_t TAMANHO_PEDACO = 256 * 1024;
+    constexpr std::size_t PEDIDOS_EM_VOO = 8;
+    constexpr std::uint64_t PREFIXO_AUDIO_INICIAL = 1024 * 1024; // ~1 min de Vorbis a 128 kbps
+    constexpr int TENTATIVAS_POR_PEDACO = 3;
+    constexpr auto INTERVALO_ANUNCIO = std::chrono::seconds(1);
+    constexpr auto INTERVALO_ESPERA = sf::milliseconds(200);
+    constexpr auto TEMPO_LIMITE_CONEXAO = sf::seconds(5);
+    constexpr auto TEMPO_LIMITE_RESPOSTA = std::chrono::seconds(10);
+    constexpr auto INTERVALO_REENVIO = std::chrono::milliseconds(2);
+
+    enum class TipoMensagem : std::uint8_t { PedirManifesto = 1, Manifesto, PedirPedaco, Pedaco, Erro };
+
+    /**
+     * @brief Prioridade do arquivo na transferência
+     */
+    enum class Categoria : std::uint8_t { Essencial, Audio, Extra };
+
+    inline Categoria classificar(const std::filesystem::path &nome) {
+        auto extensao = nome.extension().string();
+        std::ranges::transform(extensao, extensao.begin(), [](const unsigned char c) { return std::tolower(c); });
+        if (extensao == ".chart" || extensao == ".ini" || extensao == ".mid") return Categoria::Essencial;
+        if (extensao == ".ogg" || extensao == ".opus" || extensao == ".mp3" || extensao == ".wav" ||
+            extensao == ".flac") {
+            return Categoria::Audio;
+        }
+        return Categoria::Extra;
+    }
+
+    /**
+     * @brief Nome vindo da rede vira caminho local: só nomes simples, sem diretórios
+     */
+    inline bool nomeSeguro(const std::string_view nome) {
+        return !nome.empty() && nome != "." && nome != ".." && nome.find_first_of("/\\:") == std::string_view::npos &&
+               nome.find('\0') == std::string_view::npos;
+    }
+
+    struct ArquivoManifesto {
+        std::string nome;
+        std::uint64_t tamanho = 0;
+        std::vector<Sha256::Resumo> resumos; // Um por pedaço
+
+        [[nodiscard]] std::size_t quantidadePedacos() const {
+            return static_cast<std::size_t>((tamanho + TAMANHO_PEDACO - 1) / TAMANHO_PEDACO);
+        }
+
+        [[nodiscard]] std::uint64_t inicioPedaco(const std::size_t pedaco) const {
+            return static_cast<std::uint64_t>(pedaco) * TAMANHO_PEDACO;
+        }
+
+        [[nodiscard]] std::size_t tamanhoPedaco(const std::size_t pedaco) const {
+            return static_cast<std::size_t>(std::min<std::uint64_t>(TAMANHO_PEDACO, tamanho - inicioPedaco(pedaco)));
+        }
+    };
+
+    struct Manifesto {
+        std::vector<ArquivoManifesto> arquivos;
+
+        /**
+         * @brief Identifica a música pelo conteúdo: dois lobbies com o mesmo identificador têm os mesmos arquivos
+         */
+        [[nodiscard]] std::string identificador() const {
+            Sha256::Calculadora calculadora;
+            for (const auto &arquivo : arquivos) {
+                calculadora.atualizar(arquivo.nome);
+                for (const auto &resumo : arquivo.resumos) calculadora.atualizar(resumo.data(), resumo.size());
+            }
+            return Sha256::paraHex(calculadora.finalizar());
+        }
+
+        void escrever(sf::Packet &pacote) const {
+            pacote << static_cast<std::uint32_t>(arquivos.size());
+            for (const auto &arquivo : arquivos) {
+                // Resumos concatenados como bytes crus
+                pacote << arquivo.nome << arquivo.tamanho
+                       << std::string(reinterpret_cast<const char *>(arquivo.resumos.data()),
+                                      arquivo.resumos.size() * sizeof(Sha256::Resumo));
+            }
+        }
+
+        static std::optional<Manifesto> ler(sf::Packet &pacote) {
+            Manifesto manifesto;
+            std::uint32_t quantidade = 0;
+            if (!(pacote >> quantidade)) return std::nullopt;
+
+            for (std::uint32_t i = 0; i < quantidade; ++i) {
+                ArquivoManifesto arquivo;
+                std::string resumos;
+                if (!(pacote >> arquivo.nome >> arquivo.tamanho >> resumos) || !nomeSeguro(arquivo.nome) ||
+                    resumos.size() != arquivo.quantidadePedacos() * sizeof(Sha256::Resumo)) {
+                    return std::nullopt;
+                }
+                arquivo.resumos.resize(arquivo.quantidadePedacos());
+                std::memcpy(arquivo.resumos.data(), resumos.data(), resumos.size());
+                manifesto.arquivos.push_back(std::move(arquivo));
+            }
+            return manifesto;
+        }
+    };
+
+    /**
+     * @brief Lobby anunciado na rede
+     */
+    struct Lobby {
+        std::string nome;
+        sf::IpAddress endereco = sf::IpAddress::LocalHost;
+        unsigned short porta = PORTA_TRANSFERENCIA_PADRAO;
+        std::string identificadorMusica;
+        std::string nomeMusica;
+        std::string artista;
+    };
+
+    /**
+     * @brief Escuta anúncios por um tempo e devolve os lobbies encontrados
+     *
+     * Só um processo por máquina consegue escutar a porta de descoberta; quem
+     * já sabe o endereço do anfitrião pode conectar direto.
+     */
+    inline std::vector<Lobby> procurarLobbies(const std::chrono::milliseconds duracao) {
+        std::vector<Lobby> lobbies;
+        sf::UdpSocket socket;
+        if (socket.bind(PORTA_DESCOBERTA) != sf::Socket::Status::Done) {
+            Log::erro("Não foi possível escutar a porta de descoberta ", PORTA_DESCOBERTA);
+            return lobbies;
+        }
+        sf::SocketSelector seletor;
+        seletor.add(socket);
+
+        const auto fim = std::chrono::steady_clock::now() + duracao;
+        while (std::chrono::steady_clock::now() < fim) {
+            if (!seletor.wait(INTERVALO_ESPERA)) continue;
+
+            sf::Packet pacote;
+            std::optional<sf::IpAddress> remetente;
+            unsigned short portaRemetente = 0;
+            if (socket.receive(pacote, remetente, portaRemetente) != sf::Socket::Status::Done || !remetente) continue;
+
+            std::uint32_t magia = 0;
+            std::uint8_t versao = 0;
+            std::uint16_t porta = 0;
+            Lobby lobby;
+            if (!(pacote >> magia >> versao >> lobby.nome >> porta >> lobby.identificadorMusica >> lobby.nomeMusica >>
+                  lobby.artista) ||
+                magia != MAGIA_ANUNCIO || versao != VERSAO_PROTOCOLO) {
+                continue;
+            }
+            lobby.endereco = *remetente;
+            lobby.porta = porta;
+
+            const bool repetido = std::ranges::any_of(lobbies, [&](const Lobby &outro) {
+                return outro.endereco == lobby.endereco && outro.porta == lobby.porta;
+            });
+            if (!repetido) lobbies.push_back(std::move(lobby));
+        }
+        return lobbies;
+    }
+
+    /**
+     * @brief Espera uma mensagem inteira, com limite de tempo (socket não bloqueante)
+     *
+     * Uma mensagem que chega aos poucos fica guardada no socket entre as
+     * chamadas a receive(); o limite vale para a mensagem toda.
+     */
+    inline bool receberComLimite(sf::TcpSocket &socket, sf::Packet &pacote, const std::stop_token &parar) {
+        sf::SocketSelector seletor;
+        seletor.add(socket);
+        const auto limite = std::chrono::steady_clock::now() + TEMPO_LIMITE_RESPOSTA;
+        while (!parar.stop_requested() && std::chrono::steady_clock::now() < limite) {
+            if (!seletor.wait(INTERVALO_ESPERA)) continue;
+            const auto status = socket.receive(pacote);
+            if (status == sf::Socket::Status::Done) return true;
+            if (status != sf::Socket::Status::NotReady && status != sf::Socket::Status::Partial) return false;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Envia uma mensagem inteira, com limite de tempo (socket não bloqueante)
+     *
+     * Com o buffer do sistema cheio o envio fica parcial; o pacote guarda até
+     * onde foi e o reenvio continua dali.
+     */
+    inline bool enviarComLimite(sf::TcpSocket &socket, sf::Packet &pacote, const std::stop_token &parar) {
+        const auto limite = std::chrono::steady_clock::now() + TEMPO_LIMITE_RESPOSTA;
+        while (!parar.stop_requested() && std::chrono::steady_clock::now() < limite) {
+            const auto status = socket.send(pacote);
+            if (status == sf::Socket::Status::Done) return true;
+            if (status != sf::Socket::Status::NotReady && status != sf::Socket::Status::Partial) return false;
+            std::this_thread::sleep_for(INTERVALO_REENVIO);
+        }
+        return false;
+    }
+
+    /**
+     * @brief Anuncia o lobby e serve os arquivos da música a quem conectar
+     */
+    class Anfitriao {
+    private:
+        struct Cliente {
+            std::jthread thread;
+            std::atomic<bool> terminou{false};
+        };
+
+        std::filesystem::path origem;
+        std::vector<std::filesystem::path> caminhos; // Mesma ordem do manifesto
+        Manifesto manifesto;
+        sf::TcpListener ouvinte;
+        std::jthread threadAnfitriao;
+
+        /**
+         * @brief Lista os arquivos da pasta (ou o próprio pacote) e calcula os resumos
+         */
+        bool montarManifesto() {
+            std::vector<std::filesystem::path> encontrados;
+            std::error_code erro;
+            if (std::filesystem::is_directory(origem, erro)) {
+                for (const auto &entrada : std::filesystem::directory_iterator(origem, erro)) {
+                    const auto extensao = entrada.path().extension();
+                    if (entrada.is_regular_file() && extensao != ".progresso" && extensao != ".parcial") {
+                        encontrados.push_back(entrada.path());
+                    }
+                }
+            } else if (std::filesystem::is_regular_file(origem, erro)) {
+                encontrados.push_back(origem); // Pacote .zip/.sng inteiro
+            }
+
+            std::ranges::sort(encontrados, [](const auto &a, const auto &b) {
+                return std::pair(classificar(a), a.filename()) < std::pair(classificar(b), b.filename());
+            });
+
+            std::vector<char> buffer(TAMANHO_PEDACO);
+            for (const auto &caminho : encontrados) {
+                std::ifstream arquivo(caminho, std::ios::binary);
+                ArquivoManifesto entrada{caminho.filename().string(), std::filesystem::file_size(caminho, erro), {}};
+                if (!arquivo || erro || !nomeSeguro(entrada.nome)) continue;
+
+                for (std::size_t i = 0; i < entrada.quantidadePedacos(); ++i) {
+                    arquivo.read(buffer.data(), static_cast<std::streamsize>(entrada.tamanhoPedaco(i)));
+                    entrada.resumos.push_back(Sha256::calcular({buffer.data(), static_cast<std::size_t>(arquivo.gcount())}));
+                }
+                caminhos.push_back(caminho);
+                manifesto.arquivos.push_back(std::move(entrada));
+            }
+            return !manifesto.arquivos.empty();
+        }
+
+        void anunciar(sf::UdpSocket &socket, const sf::Packet &anuncio) const {
+            auto copia = anuncio;
+            (void)socket.send(copia, sf::IpAddress::Broadcast, PORTA_DESCOBERTA);
+            // Broadcast nem sempre volta pela interface de loopback; garante os processos locais
+            (void)socket.send(copia, sf::IpAddress::LocalHost, PORTA_DESCOBERTA);
+        }
+
+        /**
+         * @brief Responde os pedidos de um cliente, na ordem em que chegam
+         */
+        void atender(const std::stop_token &parar, sf::TcpSocket &socket) const {
+            std::vector<std::ifstream> abertos(manifesto.arquivos.size());
+            std::vector<char> buffer(TAMANHO_PEDACO);
+
+            while (!parar.stop_requested()) {
+                sf::Packet pedido;
+                if (!receberComLimite(socket, pedido, parar)) return;
+
+                std::uint8_t tipo = 0;
+                pedido >> tipo;
+                sf::Packet resposta;
+
+                if (static_cast<TipoMensagem>(tipo) == TipoMensagem::PedirManifesto) {
+                    resposta << static_cast<std::uint8_t>(TipoMensagem::Manifesto);
+                    manifesto.escrever(resposta);
+                } else if (static_cast<TipoMensagem>(tipo) == TipoMensagem::PedirPedaco) {
+                    std::uint32_t indiceArquivo = 0;
+                    std::uint32_t pedaco = 0;
+                    pedido >> indiceArquivo >> pedaco;
+                    if (!pedido || indiceArquivo >= manifesto.arquivos.size() ||
+                        pedaco >= manifesto.arquivos[indiceArquivo].quantidadePedacos()) {
+                        resposta << static_cast<std::uint8_t>(TipoMensagem::Erro) << std::string("pedido inválido");
+                        (void)enviarComLimite(socket, resposta, parar);
+                        return;
+                    }
+
+                    const auto &arquivo = manifesto.arquivos[indiceArquivo];
+                    auto &leitor = abertos[indiceArquivo];
+                    if (!leitor.is_open()) leitor.open(caminhos[indiceArquivo], std::ios::binary);
+                    leitor.clear();
+                    leitor.seekg(static_cast<std::streamoff>(arquivo.inicioPedaco(pedaco)));
+                    leitor.read(buffer.data(), static_cast<std::streamsize>(arquivo.tamanhoPedaco(pedaco)));
+
+                    // Se o arquivo mudou no disco o resumo não confere e o cliente pede de novo
+                    resposta << static_cast<std::uint8_t>(TipoMensagem::Pedaco) << indiceArquivo << pedaco;
+                    resposta.append(buffer.data(), static_cast<std::size_t>(leitor.gcount()));
+                } else {
+                    return;
+                }
+
+                if (!enviarComLimite(socket, resposta, parar)) return;
+            }
+        }
+
+        void executar(const std::stop_token &parar, const std::string &nomeLobby, const std::string &nomeMusica,
+                      const std::string &artista) {
+            if (!montarManifesto()) {
+                Log::erro("Nada para servir em ", origem);
+                return;
+            }
+            Log::info("Lobby \"", nomeLobby, "\" aberto na porta ", ouvinte.getLocalPort(), " com ",
+                      manifesto.arquivos.size(), " arquivos");
+
+            sf::Packet anuncio;
+            anuncio << MAGIA_ANUNCIO << VERSAO_PROTOCOLO << nomeLobby << static_cast<std::uint16_t>(ouvinte.getLocalPort())
+                    << manifesto.identificador() << nomeMusica << artista;
+            sf::UdpSocket socketAnuncio;
+
+            sf::SocketSelector seletor;
+            seletor.add(ouvinte);
+            std::vector<std::unique_ptr<Cliente>> clientes;
+            auto proximoAnuncio = std::chrono::steady_clock::now();
+
+            while (!parar.stop_requested()) {
+                if (std::chrono::steady_clock::now() >= proximoAnuncio) {
+                    anunciar(socketAnuncio, anuncio);
+                    proximoAnuncio += INTERVALO_ANUNCIO;
+                }
+                std::erase_if(clientes, [](const auto &cliente) { return cliente->terminou.load(); });
+
+                if (!seletor.wait(INTERVALO_ESPERA)) continue;
+                auto socket = std::make_unique<sf::TcpSocket>();
+                if (ouvinte.accept(*socket) != sf::Socket::Status::Done) continue;
+                socket->setBlocking(false);
+
+                auto cliente = std::make_unique<Cliente>();
+                cliente->thread = std::jthread([this, socket = std::move(socket), estado = cliente.get()](
+                                                   const std::stop_token &pararCliente) {
+                    atender(pararCliente, *socket);
+                    estado->terminou = true;
+                });
+                clientes.push_back(std::move(cliente));
+            }
+        }
+
+    public:
+        /**
+         * @brief Abre a porta e inicia o lobby em segundo plano
+         * @param caminho Pasta da música ou pacote .zip/.sng
+         * @param porta Porta TCP (0 escolhe uma livre)
+         * @return True se a porta foi aberta
+         */
+        bool iniciar(const std::filesystem::path &caminho, std::string nomeLobby, std::string nomeMusica,
+                     std::string artista, const unsigned short porta = PORTA_TRANSFERENCIA_PADRAO) {
+            if (ouvinte.listen(porta) != sf::Socket::Status::Done) return false;
+            origem = caminho;
+            // Os resumos são calculados na thread: não atrasa quem chamou
+            threadAnfitriao = std::jthread([this, nomeLobby = std::move(nomeLobby), nomeMusica = std::move(nomeMusica),
+                                            artista = std::move(artista)](const std::stop_token &parar) {
+                executar(parar, nomeLobby, nomeMusica, artista);
+            });
+            return true;
+        }
+    };
+
+    /**
+     * @brief Baixa a música de um anfitrião para uma pasta local
+     */
+    class Receptor {
+    private:
+        struct EstadoArquivo {
+            std::filesystem::path caminho;
+            std::filesystem::path caminhoProgresso;
+            std::fstream arquivo;
+            std::string completos; // '1' por pedaço completo
+            std::size_t prefixoCompleto = 0; // Pedaços completos contíguos desde o início
+        };
+
+        std::filesystem::path destino;
+        Manifesto manifesto;
+        std::vector<EstadoArquivo> estados;
+        std::atomic<bool> pronto{false};
+        std::atomic<std::uint64_t> bytesCompletos{0};
+        std::atomic<std::uint64_t> bytesTotais{0};
+
+        /**
+         * @brief Descobre o que já está em disco: pelo arquivo de progresso ou conferindo os resumos
+         */
+        bool prepararArquivo(const ArquivoManifesto &entrada, EstadoArquivo &estado) {
+            estado.caminho = destino / entrada.nome;
+            estado.caminhoProgresso = estado.caminho;
+            estado.caminhoProgresso += ".progresso";
+            estado.completos.assign(entrada.quantidadePedacos(), '0');
+
+            std::error_code erro;
+            const bool existe = std::filesystem::exists(estado.caminho, erro);
+            const bool temProgresso = std::filesystem::exists(estado.caminhoProgresso, erro);
+            if (!existe) std::ofstream(estado.caminho, std::ios::binary);
+            if (std::filesystem::file_size(estado.caminho, erro) != entrada.tamanho) {
+                std::filesystem::resize_file(estado.caminho, entrada.tamanho, erro);
+                if (erro) {
+                    Log::erro("Não foi possível criar ", estado.caminho, ": ", erro.message());
+                    return false;
+                }
+            }
+
+            estado.arquivo.open(estado.caminho, std::ios::binary | std::ios::in | std::ios::out);
+            if (!estado.arquivo) return false;
+
+            if (temProgresso) {
+                std::string salvo;
+                if (std::ifstream(estado.caminhoProgresso) >> salvo && salvo.size() == estado.completos.size()) {
+                    estado.completos = salvo;
+                }
+            } else if (existe) {
+                // Versão anterior ou cópia de outra fonte: aproveita os pedaços que conferem
+                std::vector<char> buffer(TAMANHO_PEDACO);
+                for (std::size_t i = 0; i < entrada.quantidadePedacos(); ++i) {
+                    estado.arquivo.seekg(static_cast<std::streamoff>(entrada.inicioPedaco(i)));
+                    estado.arquivo.read(buffer.data(), static_cast<std::streamsize>(entrada.tamanhoPedaco(i)));
+                    const std::string_view lido(buffer.data(), static_cast<std::size_t>(estado.arquivo.gcount()));
+                    if (Sha256::calcular(lido) == entrada.resumos[i]) estado.completos[i] = '1';
+                }
+                estado.arquivo.clear();
+            }
+
+            for (std::size_t i = 0; i < entrada.quantidadePedacos(); ++i) {
+                if (estado.completos[i] == '1') bytesCompletos += entrada.tamanhoPedaco(i);
+            }
+            avancarPrefixo(estado);
+            salvarProgresso(estado);
+            return true;
+        }
+
+        static void avancarPrefixo(EstadoArquivo &estado) {
+            while (estado.prefixoCompleto < estado.completos.size() && estado.completos[estado.prefixoCompleto] == '1') {
+                ++estado.prefixoCompleto;
+            }
+        }
+
+        static void salvarProgresso(const EstadoArquivo &estado) {
+            std::error_code erro;
+            if (estado.prefixoCompleto == estado.completos.size()) {
+                std::filesystem::remove(estado.caminhoProgresso, erro);
+            } else {
+                std::ofstream(estado.caminhoProgresso, std::ios::trunc) << estado.completos;
+            }
+        }
+
+        /**
+         * @brief A partida pode começar com os essenciais completos e o início de cada áudio
+         */
+        void atualizarPronto() {
+            for (std::size_t i = 0; i < manifesto.arquivos.size(); ++i) {
+                const auto &entrada = manifesto.arquivos[i];
+                const auto &estado = estados[i];
+                const auto categoria = classificar(entrada.nome);
+                const auto prefixoBytes = std::min<std::uint64_t>(entrada.tamanho,
+                                                                  estado.prefixoCompleto * std::uint64_t{TAMANHO_PEDACO});
+                if (categoria == Categoria::Essencial && estado.prefixoCompleto < estado.completos.size()) return;
+                if (categoria == Categoria::Audio && prefixoBytes < std::min(entrada.tamanho, PREFIXO_AUDIO_INICIAL)) {
+                    return;
+                }
+            }
+            pronto = true;
+        }
+
+        /**
+         * @brief Pedaços que faltam, na ordem de prioridade (áudios intercalados)
+         */
+        [[nodiscard]] std::vector<std::pair<std::uint32_t, std::uint32_t>> ordenarPendentes() const {
+            std::vector<std::pair<std::uint32_t, std::uint32_t>> pendentes;
+            const auto adicionar = [&](const std::size_t arquivo, const std::size_t pedaco) {
+                if (estados[arquivo].completos[pedaco] == '0') {
+                    pendentes.emplace_back(static_cast<std::uint32_t>(arquivo), static_cast<std::uint32_t>(pedaco));
+                }
+            };
+
+            for (const auto categoria : {Categoria::Essencial, Categoria::Audio, Categoria::Extra}) {
+                std::vector<std::size_t> doGrupo;
+                std::size_t maiorQuantidade = 0;
+                for (std::size_t i = 0; i < manifesto.arquivos.size(); ++i) {
+                    if (classificar(manifesto.arquivos[i].nome) != categoria) continue;
+                    doGrupo.push_back(i);
+                    maiorQuantidade = std::max(maiorQuantidade, manifesto.arquivos[i].quantidadePedacos());
+                }
+                if (categoria == Categoria::Audio) {
+                    for (std::size_t pedaco = 0; pedaco < maiorQuantidade; ++pedaco) {
+                        for (const auto i : doGrupo) {
+                            if (pedaco < manifesto.arquivos[i].quantidadePedacos()) adicionar(i, pedaco);
+                        }
+                    }
+                } else {
+                    for (const auto i : doGrupo) {
+                        for (std::size_t pedaco = 0; pedaco < manifesto.arquivos[i].quantidadePedacos(); ++pedaco) {
+                            adicionar(i, pedaco);
+                        }
+                    }
+                }
+            }
+            return pendentes;
+        }
+
+        static bool enviarPedido(sf::TcpSocket &socket, const std::pair<std::uint32_t, std::uint32_t> &pedido,
+                                 const std::stop_token &parar) {
+            sf::Packet pacote;
+            pacote << static_cast<std::uint8_t>(TipoMensagem::PedirPedaco) << pedido.first << pedido.second;
+            return enviarComLimite(socket, pacote, parar);
+        }
+
+    public:
+        explicit Receptor(std::filesystem::path pastaDestino) : destino(std::move(pastaDestino)) {}
+
+        /**
+         * @brief Conecta, baixa o que falta e confere cada pedaço
+         * @return True se todos os arquivos ficaram completos; em caso de falha, chamar de novo retoma
+         */
+        bool executar(const sf::IpAddress endereco, const unsigned short porta, const std::stop_token &parar = {}) {
+            sf::TcpSocket socket;
+            if (socket.connect(endereco, porta, TEMPO_LIMITE_CONEXAO) != sf::Socket::Status::Done) {
+                Log::erro("Não foi possível conectar a ", endereco.toString(), ":", porta);
+                return false;
+            }
+            socket.setBlocking(false);
+
+            sf::Packet pacote;
+            pacote << static_cast<std::uint8_t>(TipoMensagem::PedirManifesto);
+            std::uint8_t tipo = 0;
+            if (!enviarComLimite(socket, pacote, parar) || !receberComLimite(socket, pacote, parar) ||
+                !(pacote >> tipo) || static_cast<TipoMensagem>(tipo) != TipoMensagem::Manifesto) {
+                Log::erro("Anfitrião não enviou o manifesto");
+                return false;
+            }
+            auto recebido = Manifesto::ler(pacote);
+            if (!recebido) {
+                Log::erro("Manifesto inválido");
+                return false;
+            }
+
+            manifesto = std::move(*recebido);
+            pronto = false;
+            std::error_code erro;
+            std::filesystem::create_directories(destino, erro);
+            estados = std::vector<EstadoArquivo>(manifesto.arquivos.size());
+            bytesCompletos = 0;
+            bytesTotais = 0;
+            for (std::size_t i = 0; i < manifesto.arquivos.size(); ++i) {
+                bytesTotais += manifesto.arquivos[i].tamanho;
+                if (!prepararArquivo(manifesto.arquivos[i], estados[i])) return false;
+            }
+            atualizarPronto();
+
+            // Mantém vários pedidos em voo; o anfitrião responde na ordem
+            auto pendentes = ordenarPendentes();
+            std::deque<std::pair<std::uint32_t, std::uint32_t>> emVoo;
+            std::map<std::pair<std::uint32_t, std::uint32_t>, int> falhas;
+            std::size_t proximo = 0;
+
+            while (proximo < pendentes.size() || !emVoo.empty()) {
+                while (emVoo.size() < PEDIDOS_EM_VOO && proximo < pendentes.size()) {
+                    if (!enviarPedido(socket, pendentes[proximo], parar)) return false;
+                    emVoo.push_back(pendentes[proximo++]);
+                }
+
+                sf::Packet resposta;
+                std::uint32_t indiceArquivo = 0;
+                std::uint32_t pedaco = 0;
+                if (!receberComLimite(socket, resposta, parar) || !(resposta >> tipo)) return false;
+                if (static_cast<TipoMensagem>(tipo) == TipoMensagem::Erro) {
+                    std::string mensagem;
+                    resposta >> mensagem;
+                    Log::erro("Anfitrião recusou o pedido: ", mensagem);
+                    return false;
+                }
+                if (static_cast<TipoMensagem>(tipo) != TipoMensagem::Pedaco || !(resposta >> indiceArquivo >> pedaco) ||
+                    std::pair(indiceArquivo, pedaco) != emVoo.front()) {
+                    Log::erro("Resposta fora de ordem do anfitrião");
+                    return false;
+                }
+                emVoo.pop_front();
+
+                const auto &entrada = manifesto.arquivos[indiceArquivo];
+                auto &estado = estados[indiceArquivo];
+                const std::string_view dados(static_cast<const char *>(resposta.getData()) + resposta.getReadPosition(),
+                                             resposta.getDataSize() - resposta.getReadPosition());
+                if (dados.size() != entrada.tamanhoPedaco(pedaco) || Sha256::calcular(dados) != entrada.resumos[pedaco]) {
+                    if (++falhas[{indiceArquivo, pedaco}] >= TENTATIVAS_POR_PEDACO) {
+                        Log::erro("Pedaço ", pedaco, " de ", entrada.nome, " não confere");
+                        return false;
+                    }
+                    pendentes.emplace_back(indiceArquivo, pedaco);
+                    continue;
+                }
+
+                estado.arquivo.seekp(static_cast<std::streamoff>(entrada.inicioPedaco(pedaco)));
+                estado.arquivo.write(dados.data(), static_cast<std::streamsize>(dados.size()));
+                estado.arquivo.flush(); // Dados antes do progresso: o progresso nunca marca um pedaço não gravado
+                if (!estado.arquivo) {
+                    Log::erro("Falha ao gravar ", estado.caminho);
+                    return false;
+                }
+                estado.completos[pedaco] = '1';
+                avancarPrefixo(estado);
+                salvarProgresso(estado);
+                bytesCompletos += dados.size();
+                if (!pronto) atualizarPronto();
+            }
+
+            for (auto &estado : estados) {
+                estado.arquivo.close();
+                salvarProgresso(estado); // Remove os .progresso restantes
+            }
+            return true;
+        }
+
+        /**
+         * @brief Chart e início dos áudios já chegaram (pode ser lido de outra thread)
+         */
+        [[nodiscard]] bool prontoParaIniciar() const {
+            return pronto.load();
+        }
+
+        [[nodiscard]] std::uint64_t recebidos() const {
+            return bytesCompletos.load();
+        }
+
+        [[nodiscard]] std::uint64_t total() const {
+            return bytesTotais.load();
+        }
+    };
+}
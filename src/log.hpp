@@ -0,0 +1,304 @@
+/**
+ * @file log.hpp
+ * @brief Logger assíncrono que nunca bloqueia o jogo
+ *
+ * As mensagens são formatadas direto em slots pré-alocados de um anel sem trava
+ * (fila limitada de Vyukov, vários produtores) e escritas em std::cerr por uma
+ * thread em segundo plano. Se o anel enche, a mensagem é descartada e contada.
+ * Cada texto-modelo (o primeiro argumento, um literal) tem limite de mensagens
+ * por segundo; repetições além do limite são resumidas em uma única linha.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+namespace Log {
+    enum class Nivel : std::uint8_t { Depuracao, Info, Aviso, Erro };
+
+    constexpr std::size_t CAPACIDADE_ANEL = 1024;          // Potência de 2
+    constexpr std::size_t TAMANHO_MENSAGEM = 240;
+    constexpr std::size_t CAPACIDADE_LIMITADOR = 256;      // Potência de 2
+    constexpr std::uint32_t MENSAGENS_POR_SEGUNDO_POR_MODELO = 5;
+    constexpr auto INTERVALO_DRENAGEM = std::chrono::milliseconds(5);
+
+    /**
+     * @brief Mensagem pronta para escrita; o texto não precisa terminar em '\0'
+     */
+    struct Slot {
+        std::atomic<std::size_t> sequencia{0};
+        Nivel nivel = Nivel::Info;
+        std::uint16_t tamanho = 0;
+        std::uint32_t suprimidas = 0;
+        std::int64_t timestampUs = 0;
+        std::array<char, TAMANHO_MENSAGEM> texto{};
+    };
+
+    /**
+     * @brief Acumula texto em um buffer fixo, truncando ao encher
+     */
+    struct Escritor {
+        char *destino;
+        std::size_t capacidade;
+        std::size_t tamanho = 0;
+
+        void anexar(const std::string_view texto) {
+            const auto copiar = std::min(texto.size(), capacidade - tamanho);
+            std::memcpy(destino + tamanho, texto.data(), copiar);
+            tamanho += copiar;
+        }
+
+        void anexar(const char *texto) {
+            anexar(std::string_view(texto ? texto : "(null)"));
+        }
+
+        void anexar(const std::string &texto) {
+            anexar(std::string_view(texto));
+        }
+
+        void anexar(const std::filesystem::path &caminho) {
+            anexar(caminho.string());
+        }
+
+        void anexar(const char caractere) {
+            anexar(std::string_view(&caractere, 1));
+        }
+
+        void anexar(const bool valor) {
+            anexar(valor ? std::string_view("true") : std::string_view("false"));
+        }
+
+        template <typename T>
+            requires std::is_arithmetic_v<T>
+        void anexar(const T valor) {
+            std::array<char, 32> numero{};
+            std::to_chars_result resultado;
+            if constexpr (std::is_floating_point_v<T>) {
+                resultado = std::to_chars(numero.data(), numero.data() + numero.size(), valor,
+                                          std::chars_format::fixed, 3);
+            } else {
+                resultado = std::to_chars(numero.data(), numero.data() + numero.size(), valor);
+            }
+            anexar(std::string_view(numero.data(), resultado.ptr - numero.data()));
+        }
+    };
+
+    /**
+     * @brief Anel de mensagens e thread que o drena
+     */
+    class Registrador {
+    private:
+        struct EntradaLimitador {
+            std::atomic<const char *> modelo{nullptr};
+            std::atomic<std::int64_t> inicioJanelaUs{0};
+            std::atomic<std::uint32_t> contagem{0};
+            std::atomic<std::uint32_t> suprimidas{0};
+        };
+
+        std::array<Slot, CAPACIDADE_ANEL> anel;
+        alignas(64) std::atomic<std::size_t> posicaoEscrita{0};
+        alignas(64) std::size_t posicaoLeitura = 0;
+        std::array<EntradaLimitador, CAPACIDADE_LIMITADOR> limitador;
+        std::atomic<std::uint64_t> descartadas{0};
+        std::atomic<Nivel> nivelMinimo{Nivel::Info};
+        std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+        std::jthread threadEscrita;
+
+        [[nodiscard]] auto agoraUs() const -> std::int64_t {
+            return std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - inicio).count();
+        }
+
+        /**
+         * @brief Decide se a mensagem passa pelo limite do seu modelo
+         * @param modelo Texto-modelo (chave por endereço)
+         * @param suprimidas Recebe quantas mensagens do modelo foram suprimidas antes desta
+         */
+        bool permitir(const char *modelo, std::uint32_t &suprimidas) {
+            const auto hash = (reinterpret_cast<std::uintptr_t>(modelo) >> 3) * 0x9E3779B97F4A7C15ull;
+            auto &entrada = limitador[hash & (CAPACIDADE_LIMITADOR - 1)];
+
+            const auto agora = agoraUs();
+            const char *esperado = entrada.modelo.load(std::memory_order_relaxed);
+            if (esperado != modelo) {
+                // Colisão ou primeiro uso: a entrada passa a ser deste modelo
+                entrada.modelo.store(modelo, std::memory_order_relaxed);
+                entrada.inicioJanelaUs.store(agora, std::memory_order_relaxed);
+                entrada.contagem.store(0, std::memory_order_relaxed);
+                entrada.suprimidas.store(0, std::memory_order_relaxed);
+            } else if (agora - entrada.inicioJanelaUs.load(std::memory_order_relaxed) >= 1'000'000) {
+                entrada.inicioJanelaUs.store(agora, std::memory_order_relaxed);
+                entrada.contagem.store(0, std::memory_order_relaxed);
+            }
+
+            if (entrada.contagem.fetch_add(1, std::memory_order_relaxed) >= MENSAGENS_POR_SEGUNDO_POR_MODELO) {
+                entrada.suprimidas.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            suprimidas = entrada.suprimidas.exchange(0, std::memory_order_relaxed);
+            return true;
+        }
+
+        /**
+         * @brief Escreve um texto escapando bytes de controle (exceto UTF-8)
+         */
+        static void escreverSeguro(std::string &saida, const std::string_view texto) {
+            constexpr char hex[] = "0123456789abcdef";
+            for (const char caractere : texto) {
+                const auto byte = static_cast<unsigned char>(caractere);
+                if (byte < 0x20 || byte == 0x7F) {
+                    saida += "\\x";
+                    saida += hex[byte >> 4];
+                    saida += hex[byte & 0xF];
+                } else {
+                    saida += caractere;
+                }
+            }
+        }
+
+        /**
+         * @brief Escreve todas as mensagens prontas (thread de escrita)
+         */
+        void drenar() {
+            static constexpr std::array<std::string_view, 4> nomesNiveis = {"DEPURACAO", "INFO", "AVISO", "ERRO"};
+            std::string linhas;
+
+            while (true) {
+                auto &slot = anel[posicaoLeitura & (CAPACIDADE_ANEL - 1)];
+                if (slot.sequencia.load(std::memory_order_acquire) != posicaoLeitura + 1) break;
+
+                std::array<char, 24> tempo{};
+                const auto resultado = std::to_chars(tempo.data(), tempo.data() + tempo.size(),
+                                                     static_cast<double>(slot.timestampUs) / 1'000'000.0,
+                                                     std::chars_format::fixed, 6);
+                linhas += '[';
+                linhas.append(tempo.data(), resultado.ptr);
+                linhas += "] ";
+                linhas += nomesNiveis[static_cast<std::size_t>(slot.nivel)];
+                linhas += ": ";
+                escreverSeguro(linhas, std::string_view(slot.texto.data(), slot.tamanho));
+                if (slot.suprimidas > 0) {
+                    linhas += " (+" + std::to_string(slot.suprimidas) + " repetidas suprimidas)";
+                }
+                linhas += '\n';
+
+                slot.sequencia.store(posicaoLeitura + CAPACIDADE_ANEL, std::memory_order_release);
+                ++posicaoLeitura;
+            }
+
+            if (const auto perdidas = descartadas.exchange(0, std::memory_order_relaxed); perdidas > 0) {
+                linhas += "[log] " + std::to_string(perdidas) + " mensagens descartadas (anel cheio)\n";
+            }
+
+            if (!linhas.empty()) {
+                std::cerr << linhas << std::flush;
+            }
+        }
+
+    public:
+        Registrador() {
+            for (std::size_t i = 0; i < CAPACIDADE_ANEL; ++i) {
+                anel[i].sequencia.store(i, std::memory_order_relaxed);
+            }
+            threadEscrita = std::jthread([this](const std::stop_token &parar) {
+                while (!parar.stop_requested()) {
+                    drenar();
+                    std::this_thread::sleep_for(INTERVALO_DRENAGEM);
+                }
+                drenar();
+            });
+        }
+
+        Registrador(const Registrador &) = delete;
+        Registrador &operator=(const Registrador &) = delete;
+
+        ~Registrador() {
+            threadEscrita = std::jthread(); // Para a thread e escreve o que restou
+        }
+
+        void definirNivelMinimo(const Nivel nivel) {
+            nivelMinimo.store(nivel, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Formata e enfileira uma mensagem; nunca bloqueia
+         * @param nivel Nível da mensagem
+         * @param modelo Texto inicial, usado também como chave do limitador
+         * @param argumentos Demais partes da mensagem
+         */
+        template <typename... Argumentos>
+        void registrar(const Nivel nivel, const char *modelo, const Argumentos &...argumentos) {
+            if (nivel < nivelMinimo.load(std::memory_order_relaxed)) return;
+
+            std::uint32_t suprimidas = 0;
+            if (!permitir(modelo, suprimidas)) return;
+
+            // Reserva um slot (fila limitada de Vyukov)
+            auto posicao = posicaoEscrita.load(std::memory_order_relaxed);
+            Slot *slot = nullptr;
+            while (true) {
+                slot = &anel[posicao & (CAPACIDADE_ANEL - 1)];
+                const auto sequencia = slot->sequencia.load(std::memory_order_acquire);
+                const auto diferenca = static_cast<std::intptr_t>(sequencia) - static_cast<std::intptr_t>(posicao);
+                if (diferenca == 0) {
+                    if (posicaoEscrita.compare_exchange_weak(posicao, posicao + 1, std::memory_order_relaxed)) break;
+                } else if (diferenca < 0) {
+                    descartadas.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                } else {
+                    posicao = posicaoEscrita.load(std::memory_order_relaxed);
+                }
+            }
+
+            Escritor escritor{slot->texto.data(), slot->texto.size()};
+            escritor.anexar(modelo);
+            (escritor.anexar(argumentos), ...);
+
+            slot->nivel = nivel;
+            slot->tamanho = static_cast<std::uint16_t>(escritor.tamanho);
+            slot->suprimidas = suprimidas;
+            slot->timestampUs = agoraUs();
+            slot->sequencia.store(posicao + 1, std::memory_order_release);
+        }
+    };
+
+    /**
+     * @brief Registrador global do processo
+     */
+    inline Registrador &registrador() {
+        static Registrador instancia;
+        return instancia;
+    }
+
+    template <typename... Argumentos>
+    void depuracao(const char *modelo, const Argumentos &...argumentos) {
+        registrador().registrar(Nivel::Depuracao, modelo, argumentos...);
+    }
+
+    template <typename... Argumentos>
+    void info(const char *modelo, const Argumentos &...argumentos) {
+        registrador().registrar(Nivel::Info, modelo, argumentos...);
+    }
+
+    template <typename... Argumentos>
+    void aviso(const char *modelo, const Argumentos &...argumentos) {
+        registrador().registrar(Nivel::Aviso, modelo, argumentos...);
+    }
+
+    template <typename... Argumentos>
+    void erro(const char *modelo, const Argumentos &...argumentos) {
+        registrador().registrar(Nivel::Erro, modelo, argumentos...);
+    }
+}
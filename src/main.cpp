@@ -27,6 +27,18 @@
 
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
+#include <SFML/Network.hpp>
+
+#include "arquivos.hpp"
+#include "audio.hpp"
+#include "chart.hpp"
+#include "lan.hpp"
+#include "log.hpp"
+#include "memoria.hpp"
+#include "metricas.hpp"
+#include "sonoridade.hpp"
+#include "telemetria.hpp"
+#include "texto.hpp"
 
 #include <iostream>
 #include <vector>
@@ -48,11 +60,59 @@
 #include <locale>
 #include <stack>
 #include <queue>
+#include <deque>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <cstdlib>
+#include <atomic>
+#include <new>
+#include <condition_variable>
+#include <chrono>
+#include <filesystem>
+#include <charconv>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/input.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <ctime>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
 
 // ============================= CONSTANTES GLOBAIS =============================
 
 // Configurações de arquivo e janela
 constexpr auto CAMINHO_ARQUIVO_CHART = "notes.chart";
+constexpr auto CAMINHO_ARQUIVO_MIDI = "notes.mid";       // Usado quando não há notes.chart
+constexpr auto CAMINHO_ARQUIVO_CACHE_CHART = "notes.rhc"; // Gerado pelo riff-convert; vale se o hash conferir
+constexpr auto VARIAVEL_AMBIENTE_MUSICA = "RIFF_HERO_MUSICA"; // Pasta ou pacote .zip/.sng da música
+constexpr auto VARIAVEL_AMBIENTE_BIBLIOTECA = "RIFF_HERO_BIBLIOTECA"; // Raiz da biblioteca de músicas
 constexpr auto LARGURA_JANELA = 800;
 constexpr auto ALTURA_JANELA = 600;
 
@@ -67,12 +127,89 @@ constexpr auto ALTURA_NOTA = 45;
 constexpr auto Y_ZONA_ACERTO = ALTURA_JANELA - 200;
 constexpr auto ALTURA_ZONA_ACERTO = 150;
 constexpr auto VELOCIDADE_QUEDA_NOTA_PPS = 800.0f;
+constexpr auto ANTECEDENCIA_ENTRADA_NOTA_SEC = (Y_ZONA_ACERTO + ALTURA_NOTA) / VELOCIDADE_QUEDA_NOTA_PPS;
+constexpr auto ESPERA_PRIMEIRA_NOTA_SEC = ANTECEDENCIA_ENTRADA_NOTA_SEC + 0.5; // Do início da partida à primeira nota, no mínimo
 
 // Configurações de timing
 constexpr auto FPS_JOGO = 165;
 constexpr auto ATUALIZACAO_JOGO_MS = 1000 / FPS_JOGO;
 constexpr auto TOLERANCIA_ACERTO_MS = 200L;
-constexpr auto OFFSET_LATENCIA_AUDIO_SEC = 0.0;
+constexpr auto OFFSET_LATENCIA_AUDIO_SEC = 0.0; // Só o que o relógio do áudio não mede (conversor, caixas)
+constexpr auto CONTAGEM_RETOMADA_SEC = 3.0; // Ao continuar, a música volta esse tanto antes do ponto da pausa
+constexpr auto VARIAVEL_AMBIENTE_BLOCO_AUDIO = "RIFF_HERO_BLOCO_AUDIO"; // Quadros por bloco entregue ao mixer
+constexpr auto VARIAVEL_AMBIENTE_TAXA_AUDIO = "RIFF_HERO_TAXA_AUDIO"; // Taxa do dispositivo, para converter uma vez só
+
+// Entrada evdev (Linux): "auto" usa todos os teclados; uma lista "disp1,disp2" liga cada
+// dispositivo a um jogador
+constexpr auto VARIAVEL_AMBIENTE_EVDEV = "RIFF_HERO_EVDEV";
+constexpr auto INTERVALO_POLL_EVDEV_MS = 100;
+
+// Agendamento de threads (Linux): "fifo:<prioridade>" ou "nice:<nível>", opcionalmente "@<cpu>,<cpu>"
+constexpr auto VARIAVEL_AMBIENTE_AGENDAMENTO_JOGO = "RIFF_HERO_SCHED_JOGO";
+constexpr auto VARIAVEL_AMBIENTE_AGENDAMENTO_ENTRADA = "RIFF_HERO_SCHED_ENTRADA";
+constexpr auto VARIAVEL_AMBIENTE_AGENDAMENTO_AUDIO = "RIFF_HERO_SCHED_AUDIO";
+constexpr auto VARIAVEL_AMBIENTE_AGENDAMENTO_TRABALHO = "RIFF_HERO_SCHED_TRABALHO"; // Capas e forma de onda
+constexpr auto VARIAVEL_AMBIENTE_MLOCK = "RIFF_HERO_MLOCK";
+
+// Telemetria em memória compartilhada: nome POSIX do segmento, ou "1" para o padrão (desligada sem a variável)
+constexpr auto VARIAVEL_AMBIENTE_TELEMETRIA = "RIFF_HERO_TELEMETRIA";
+
+// Endpoint de métricas no formato texto do Prometheus (porta TCP)
+constexpr auto VARIAVEL_AMBIENTE_METRICAS_PORTA = "RIFF_HERO_METRICAS_PORTA";
+// Interface do endpoint; sem a variável, só a própria máquina (127.0.0.1) alcança as métricas
+constexpr auto VARIAVEL_AMBIENTE_METRICAS_ENDERECO = "RIFF_HERO_METRICAS_ENDERECO";
+
+// Lobby na rede local: nome anunciado; a música atual é servida a quem entrar
+constexpr auto VARIAVEL_AMBIENTE_LAN = "RIFF_HERO_LAN";
+
+// Níveis de julgamento (o nível "bom" vai até TOLERANCIA_ACERTO_MS)
+constexpr auto JANELA_PERFEITO_MS = 50.0;
+constexpr auto JANELA_OTIMO_MS = 100.0;
+
+// Editor de charts
+constexpr auto NOTAS_POR_BLOCO_EDITOR = 256;   // Blocos ordenados do armazém de notas (divididos com o dobro)
+constexpr auto LIMITE_HISTORICO_EDITOR = 1000; // Edições que podem ser desfeitas
+constexpr std::array DIVISOES_GRADE_EDITOR = {4, 8, 12, 16, 24, 32, 48, 64}; // Notas por semibreve
+
+// Estatísticas de travamento
+constexpr auto LIMIAR_TRAVAMENTO_QUADRO = sf::milliseconds(25);
+
+// Gravador de voo: últimas zonas de tempo, despejadas em disco quando um quadro trava
+constexpr auto CAPACIDADE_GRAVADOR_VOO = 16384; // ~5 s a 165 quadros com 18 zonas por quadro
+constexpr auto INTERVALO_MINIMO_DESPEJOS = sf::seconds(10.f);
+constexpr auto MAX_DESPEJOS_POR_SESSAO = 20;
+// Vigia fora da thread principal: um quadro que não termina nunca passa pela verificação do laço
+constexpr auto LIMIAR_SEM_RESPOSTA = sf::seconds(1.f);
+constexpr auto INTERVALO_VIGIA = std::chrono::milliseconds(100);
+constexpr auto VARIAVEL_AMBIENTE_DIRETORIO_TRAVAMENTOS = "RIFF_HERO_TRAVAMENTOS_DIR";
+constexpr auto DIRETORIO_TRAVAMENTOS_PADRAO = "travamentos";
+
+// Consultas de tempo na GPU: resultados lidos alguns quadros depois, sem esperar a GPU
+constexpr auto QUADROS_CONSULTA_GPU = 4;
+
+// Convenção de chamada das funções OpenGL carregadas em tempo de execução
+#if defined(_WIN32)
+#define RIFF_HERO_GL_API __stdcall
+#else
+#define RIFF_HERO_GL_API
+#endif
+
+// Capas de álbum: miniaturas decodificadas em segundo plano e guardadas em disco
+constexpr auto TAMANHO_MINIATURA_CAPA = 128u;
+constexpr auto LADO_CAPA_PAINEL = 72.f;
+constexpr auto THREADS_DECODIFICACAO_CAPAS = 2;
+constexpr auto ENVIOS_CAPAS_POR_QUADRO = 2;     // Texturas criadas na GPU por quadro, no máximo
+constexpr auto CAPACIDADE_CACHE_CAPAS = 256u;   // Texturas residentes (~16 MiB)
+constexpr auto VARIAVEL_AMBIENTE_CACHE_CAPAS = "RIFF_HERO_CACHE_CAPAS";
+constexpr auto DIRETORIO_CACHE_CAPAS_PADRAO = "cache_capas";
+constexpr std::array<std::string_view, 3> NOMES_ARQUIVO_CAPA = {"album.png", "album.jpg", "album.jpeg"};
+
+// Forma de onda: pirâmide de resumos montada em segundo plano e guardada em disco
+constexpr auto QUADROS_BLOCO_ONDA = 64u;        // Nível 0: 1,5 ms a 44,1 kHz, menos que um pixel da pista
+constexpr auto BLOCOS_POR_LEITURA_ONDA = 1024u;
+constexpr auto ALTURA_VISAO_GERAL_ONDA = 36.f;
+constexpr auto VARIAVEL_AMBIENTE_CACHE_ONDAS = "RIFF_HERO_CACHE_ONDAS";
+constexpr auto DIRETORIO_CACHE_ONDAS_PADRAO = "cache_ondas";
 
 // Configurações de partículas
 constexpr auto PARTICULAS_POR_ACERTO = 8;
@@ -90,9 +227,13 @@ constexpr auto MAX_PARTICULAS_ATIVAS = 200;
 constexpr auto ALTURA_PAINEL_PONTUACAO = 60.f;
 constexpr auto OFFSET_Y_PAINEL_PONTUACAO = 5.f;
 
-// Configurações de combo
+// Configurações de combo (multiplicadores em ponto fixo, ESCALA_PONTO_FIXO = 1.0x)
 constexpr auto MAX_HISTORICO_COMBO = 20;
-constexpr auto COMBO_BASE_MULTIPLIER = 0.1f;  // Cada combo adiciona 10% de bônus
+constexpr std::int64_t ESCALA_PONTO_FIXO = 1000;
+constexpr std::int64_t INCREMENTO_MULTIPLICADOR_COMBO = 100;        // Cada combo adiciona 10% de bônus
+constexpr std::int64_t MULTIPLICADOR_COMBO_MAXIMO = 10 * ESCALA_PONTO_FIXO; // Teto de 10.0x
+// "incremento=0.1,maximo=4" ou "faixas=10:2/20:3/30:4,maximo=4" (multiplicadores com até 3 decimais)
+constexpr auto VARIAVEL_AMBIENTE_PONTUACAO = "RIFF_HERO_PONTUACAO";
 
 // Nomes de uniformes para shaders
 const auto UNIFORM_RESOLUCAO = "Resolucao";
@@ -101,61 +242,315 @@ const auto UNIFORM_LARGURA_RETANGULO = "LarguraRetangulo";
 const auto UNIFORM_ALTURA_RETANGULO = "AlturaRetangulo";
 const auto UNIFORM_TEXTURA = "texture";
 
-// ============================= UTILITÁRIOS UTF-8/UTF-32 =============================
+// ============================= CONTAGEM DE ALOCAÇÕES =============================
 
 /**
- * @brief Converte string UTF-8 para sf::String (UTF-32)
- * @param utf8Str String em UTF-8
- * @return sf::String em UTF-32
+ * @brief Total de alocações feitas pelo processo, exposto na telemetria
  */
-sf::String utf8ParaSfString(const std::string& utf8Str) {
-    return sf::String::fromUtf8(utf8Str.begin(), utf8Str.end());
+std::atomic<std::uint64_t> totalAlocacoes{0};
+
+void *operator new(const std::size_t tamanho) {
+    totalAlocacoes.fetch_add(1, std::memory_order_relaxed);
+    if (void *ponteiro = std::malloc(tamanho ? tamanho : 1)) {
+        return ponteiro;
+    }
+    throw std::bad_alloc();
 }
 
-/**
- * @brief Converte std::wstring para sf::String (UTF-32)
- * @param wideStr String wide
- * @return sf::String em UTF-32
- */
-sf::String wstringParaSfString(const std::wstring& wideStr) {
-    return sf::String(wideStr);
+void *operator new[](const std::size_t tamanho) {
+    return operator new(tamanho);
+}
+
+void *operator new(const std::size_t tamanho, const std::nothrow_t &) noexcept {
+    totalAlocacoes.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(tamanho ? tamanho : 1);
+}
+
+void *operator new[](const std::size_t tamanho, const std::nothrow_t &naoLancar) noexcept {
+    return operator new(tamanho, naoLancar);
+}
+
+// Alinhamento acima do padrão (alignas grande): aligned_alloc pede tamanho múltiplo do alinhamento
+void *operator new(const std::size_t tamanho, const std::align_val_t alinhamento, const std::nothrow_t &) noexcept {
+    totalAlocacoes.fetch_add(1, std::memory_order_relaxed);
+    const auto bytes = static_cast<std::size_t>(alinhamento);
+    const auto arredondado = (std::max<std::size_t>(tamanho, 1) + bytes - 1) / bytes * bytes;
+#if defined(_WIN32)
+    return _aligned_malloc(arredondado, bytes);
+#else
+    return std::aligned_alloc(bytes, arredondado);
+#endif
+}
+
+void *operator new[](const std::size_t tamanho, const std::align_val_t alinhamento,
+                     const std::nothrow_t &naoLancar) noexcept {
+    return operator new(tamanho, alinhamento, naoLancar);
+}
+
+void *operator new(const std::size_t tamanho, const std::align_val_t alinhamento) {
+    if (void *ponteiro = operator new(tamanho, alinhamento, std::nothrow)) {
+        return ponteiro;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](const std::size_t tamanho, const std::align_val_t alinhamento) {
+    return operator new(tamanho, alinhamento);
+}
+
+void operator delete(void *ponteiro) noexcept {
+    std::free(ponteiro);
+}
+
+void operator delete[](void *ponteiro) noexcept {
+    std::free(ponteiro);
+}
+
+void operator delete(void *ponteiro, std::size_t) noexcept {
+    std::free(ponteiro);
+}
+
+void operator delete[](void *ponteiro, std::size_t) noexcept {
+    std::free(ponteiro);
+}
+
+void operator delete(void *ponteiro, const std::align_val_t) noexcept {
+#if defined(_WIN32)
+    _aligned_free(ponteiro);
+#else
+    std::free(ponteiro);
+#endif
+}
+
+void operator delete[](void *ponteiro, const std::align_val_t alinhamento) noexcept {
+    operator delete(ponteiro, alinhamento);
+}
+
+void operator delete(void *ponteiro, std::size_t, const std::align_val_t alinhamento) noexcept {
+    operator delete(ponteiro, alinhamento);
+}
+
+void operator delete[](void *ponteiro, std::size_t, const std::align_val_t alinhamento) noexcept {
+    operator delete(ponteiro, alinhamento);
+}
+
+void operator delete(void *ponteiro, const std::align_val_t alinhamento, const std::nothrow_t &) noexcept {
+    operator delete(ponteiro, alinhamento);
+}
+
+void operator delete[](void *ponteiro, const std::align_val_t alinhamento, const std::nothrow_t &) noexcept {
+    operator delete(ponteiro, alinhamento);
 }
 
+// ============================= FLUXO DE PACOTES =============================
+
 /**
- * @brief Converte sf::String para std::string UTF-8
- * @param sfStr sf::String em UTF-32
- * @return String em UTF-8
+ * @brief Adapta uma entrada de pacote para sf::InputStream, lido em streaming pelo reprodutor da música
  */
-std::string sfStringParaUtf8(const sf::String& sfStr) {
-    std::string utf8Str;
-    sf::Utf32::toUtf8(sfStr.begin(), sfStr.end(), std::back_inserter(utf8Str));
-    return utf8Str;
-}
+class FluxoPacote : public sf::InputStream {
+private:
+    Arquivos::LeitorEntrada leitor;
+
+public:
+    explicit FluxoPacote(Arquivos::LeitorEntrada l) : leitor(std::move(l)) {}
+
+    std::optional<std::size_t> read(void *dados, const std::size_t tamanho) override {
+        return leitor.ler(dados, tamanho);
+    }
+
+    std::optional<std::size_t> seek(const std::size_t posicao) override {
+        return leitor.buscar(posicao);
+    }
+
+    std::optional<std::size_t> tell() override {
+        return leitor.posicaoAtual();
+    }
+
+    std::optional<std::size_t> getSize() override {
+        return leitor.tamanho();
+    }
+};
+
+// ============================= SISTEMA DE PONTUAÇÃO =============================
 
 /**
- * @brief Lê arquivo texto com suporte a UTF-8
- * @param caminhoArquivo Caminho para o arquivo
- * @return Conteúdo do arquivo em UTF-8
+ * @brief Regras de pontuação em ponto fixo de 64 bits
+ *
+ * Multiplicadores são inteiros em milésimos (ESCALA_PONTO_FIXO = 1.0x), então o
+ * resultado não depende de arredondamento de float e é idêntico em qualquer
+ * compilador ou plataforma (replays, partidas em rede e placares concordam).
  */
-std::string lerArquivoUtf8(const std::string& caminhoArquivo) {
-    std::ifstream arquivo(caminhoArquivo, std::ios::binary);
-    if (!arquivo.is_open()) {
-        return "";
+namespace Pontuacao {
+    using PontoFixo = std::int64_t;
+
+    /**
+     * @brief Faixa de multiplicador ativada a partir de um combo mínimo
+     */
+    struct FaixaMultiplicador {
+        int comboMinimo;
+        PontoFixo multiplicador;
+    };
+
+    /**
+     * @brief Configuração do multiplicador de combo
+     *
+     * Sem faixas, o multiplicador cresce linearmente a cada nota do combo.
+     * Com faixas (em ordem crescente de combo), vale a última faixa alcançada.
+     * Em ambos os casos o valor é limitado por multiplicadorMaximo.
+     */
+    struct Configuracao {
+        PontoFixo incrementoPorCombo = INCREMENTO_MULTIPLICADOR_COMBO;
+        PontoFixo multiplicadorMaximo = MULTIPLICADOR_COMBO_MAXIMO;
+        std::vector<FaixaMultiplicador> faixas;
+
+        /**
+         * @brief Lê um multiplicador decimal ("2", "1.25") direto em ponto fixo, sem float
+         */
+        [[nodiscard]] static auto interpretarMultiplicador(const std::string_view texto) -> std::optional<PontoFixo> {
+            const auto ponto = texto.find('.');
+            const auto inteira = texto.substr(0, ponto);
+            const auto decimais = ponto == std::string_view::npos ? std::string_view{} : texto.substr(ponto + 1);
+            if (inteira.empty() || decimais.size() > 3) return std::nullopt;
+
+            PontoFixo valor = 0;
+            const auto [fim, erro] = std::from_chars(inteira.data(), inteira.data() + inteira.size(), valor);
+            if (erro != std::errc{} || fim != inteira.data() + inteira.size() || valor < 0 ||
+                valor > std::numeric_limits<int>::max()) {
+                return std::nullopt;
+            }
+            valor *= ESCALA_PONTO_FIXO;
+            PontoFixo casa = ESCALA_PONTO_FIXO / 10;
+            for (const auto digito : decimais) {
+                if (digito < '0' || digito > '9') return std::nullopt;
+                valor += (digito - '0') * casa;
+                casa /= 10;
+            }
+            return valor;
+        }
+
+        /**
+         * @brief Interpreta "incremento=0.1,maximo=4" ou "faixas=10:2/20:3,maximo=4"
+         *
+         * O teto não pode ficar abaixo de 1.0x, e as faixas precisam de combos
+         * crescentes e multiplicadores entre 1.0x e o teto.
+         * @return Configuração, ou std::nullopt se o texto for inválido
+         */
+        [[nodiscard]] static auto interpretar(const std::string &especificacao) -> std::optional<Configuracao> {
+            Configuracao config;
+            std::istringstream itens(especificacao);
+            std::string item;
+            while (std::getline(itens, item, ',')) {
+                const auto igual = item.find('=');
+                if (igual == std::string::npos) return std::nullopt;
+                const auto chave = item.substr(0, igual);
+                const auto valor = std::string_view(item).substr(igual + 1);
+
+                if (chave == "incremento" || chave == "maximo") {
+                    const auto multiplicador = interpretarMultiplicador(valor);
+                    if (!multiplicador) return std::nullopt;
+                    (chave == "incremento" ? config.incrementoPorCombo : config.multiplicadorMaximo) = *multiplicador;
+                } else if (chave == "faixas") {
+                    std::istringstream faixas{std::string(valor)};
+                    std::string faixa;
+                    while (std::getline(faixas, faixa, '/')) {
+                        const auto doisPontos = faixa.find(':');
+                        if (doisPontos == std::string::npos) return std::nullopt;
+                        int comboMinimo = 0;
+                        const auto *fimCombo = faixa.data() + doisPontos;
+                        const auto [fim, erro] = std::from_chars(faixa.data(), fimCombo, comboMinimo);
+                        const auto multiplicador = interpretarMultiplicador(std::string_view(faixa).substr(doisPontos + 1));
+                        if (erro != std::errc{} || fim != fimCombo || comboMinimo < 0 || !multiplicador) return std::nullopt;
+                        config.faixas.push_back({comboMinimo, *multiplicador});
+                    }
+                } else {
+                    return std::nullopt;
+                }
+            }
+
+            // std::clamp em multiplicadorParaCombo exige teto >= 1.0x
+            if (config.multiplicadorMaximo < ESCALA_PONTO_FIXO) return std::nullopt;
+            for (std::size_t i = 0; i < config.faixas.size(); ++i) {
+                const auto &faixa = config.faixas[i];
+                if (faixa.multiplicador < ESCALA_PONTO_FIXO || faixa.multiplicador > config.multiplicadorMaximo) {
+                    return std::nullopt;
+                }
+                if (i > 0 && faixa.comboMinimo <= config.faixas[i - 1].comboMinimo) return std::nullopt;
+            }
+            return config;
+        }
+
+        /**
+         * @brief Lê a configuração de uma variável de ambiente
+         * @return Configuração, ou std::nullopt se ausente ou inválida
+         */
+        [[nodiscard]] static auto lerDoAmbiente(const char *variavel) -> std::optional<Configuracao> {
+            const char *valor = std::getenv(variavel);
+            if (!valor) return std::nullopt;
+
+            auto config = interpretar(valor);
+            if (!config) {
+                Log::erro("Valor inválido em ", variavel, ": ", valor, " (usando a pontuação padrão)");
+            }
+            return config;
+        }
+    };
+
+    /**
+     * @brief Calcula o multiplicador para um combo
+     * @param config Configuração de pontuação
+     * @param combo Combo atual
+     * @return Multiplicador em ponto fixo
+     */
+    [[nodiscard]] inline auto multiplicadorParaCombo(const Configuracao &config, const int combo) -> PontoFixo {
+        PontoFixo multiplicador = ESCALA_PONTO_FIXO;
+
+        if (config.faixas.empty()) {
+            // Evita overflow antes de aplicar o teto
+            const auto passosAteTeto = config.incrementoPorCombo > 0
+                ? (config.multiplicadorMaximo - ESCALA_PONTO_FIXO) / config.incrementoPorCombo + 1
+                : 0;
+            multiplicador += std::min<PontoFixo>(combo, passosAteTeto) * config.incrementoPorCombo;
+        } else {
+            for (const auto &faixa : config.faixas) {
+                if (combo < faixa.comboMinimo) break;
+                multiplicador = faixa.multiplicador;
+            }
+        }
+
+        return std::clamp<PontoFixo>(multiplicador, ESCALA_PONTO_FIXO, config.multiplicadorMaximo);
     }
 
-    std::string conteudo((std::istreambuf_iterator<char>(arquivo)),
-                         std::istreambuf_iterator<char>());
-    arquivo.close();
+    /**
+     * @brief Soma com saturação para que a pontuação nunca dê a volta
+     */
+    [[nodiscard]] constexpr auto somarSaturado(const std::int64_t a, const std::int64_t b) -> std::int64_t {
+        if (b > 0 && a > std::numeric_limits<std::int64_t>::max() - b) {
+            return std::numeric_limits<std::int64_t>::max();
+        }
+        if (b < 0 && a < std::numeric_limits<std::int64_t>::min() - b) {
+            return std::numeric_limits<std::int64_t>::min();
+        }
+        return a + b;
+    }
 
-    // Remove BOM UTF-8 se presente
-    if (conteudo.size() >= 3 &&
-        static_cast<unsigned char>(conteudo[0]) == 0xEF &&
-        static_cast<unsigned char>(conteudo[1]) == 0xBB &&
-        static_cast<unsigned char>(conteudo[2]) == 0xBF) {
-        conteudo.erase(0, 3);
+    /**
+     * @brief Aplica um multiplicador em ponto fixo a uma pontuação base
+     * @param pontos Pontos base
+     * @param multiplicador Multiplicador em ponto fixo
+     * @return Pontos com bônus (truncados)
+     */
+    [[nodiscard]] constexpr auto aplicarMultiplicador(const int pontos, const PontoFixo multiplicador) -> std::int64_t {
+        // pontos cabe em 32 bits e o multiplicador é limitado, então o produto cabe em 64 bits
+        return static_cast<std::int64_t>(pontos) * multiplicador / ESCALA_PONTO_FIXO;
     }
 
-    return conteudo;
+    /**
+     * @brief Formata um multiplicador em ponto fixo (ex: "1.3x") sem passar por float
+     */
+    [[nodiscard]] inline auto formatarMultiplicador(const PontoFixo multiplicador) -> std::string {
+        const auto decimos = multiplicador * 10 / ESCALA_PONTO_FIXO;
+        return std::to_string(decimos / 10) + "." + std::to_string(decimos % 10) + "x";
+    }
 }
 
 // ============================= ESTRUTURAS DE DADOS =============================
@@ -175,7 +570,7 @@ struct Particula {
  * @brief Representa um jogador com suas configurações e estado
  */
 struct Jogador {
-    int pontuacao = 0;
+    std::int64_t pontuacao = 0;
     std::map<sf::Keyboard::Key, int> mapeamentoTeclaPista;
     int offsetAreaJogadorX = 0;
     sf::String nome;
@@ -186,7 +581,8 @@ struct Jogador {
     std::stack<std::pair<int, sf::Time>> historicoNotasAcertadas; // pista e timestamp
     int comboAtual = 0;
     int maiorCombo = 0;
-    float multiplicadorCombo = 1.0f;
+    Pontuacao::PontoFixo multiplicadorCombo = ESCALA_PONTO_FIXO;
+    Pontuacao::Configuracao configuracaoPontuacao;
 
     /**
      * @brief Construtor do jogador
@@ -206,8 +602,8 @@ struct Jogador {
      * @param pontos Quantidade de pontos base a adicionar
      */
     void adicionarPontuacao(const int pontos) {
-        const int pontosComBonus = static_cast<int>(pontos * multiplicadorCombo);
-        pontuacao += pontosComBonus;
+        const auto pontosComBonus = Pontuacao::aplicarMultiplicador(pontos, multiplicadorCombo);
+        pontuacao = Pontuacao::somarSaturado(pontuacao, pontosComBonus);
     }
 
     /**
@@ -223,8 +619,8 @@ struct Jogador {
             maiorCombo = comboAtual;
         }
 
-        // Atualiza multiplicador de combo: 1.0x -> 1.1x -> 1.2x -> 1.3x...
-        multiplicadorCombo = 1.0f + (comboAtual * COMBO_BASE_MULTIPLIER);
+        // Atualiza multiplicador de combo: 1.0x -> 1.1x -> 1.2x -> 1.3x... (até o teto)
+        multiplicadorCombo = Pontuacao::multiplicadorParaCombo(configuracaoPontuacao, comboAtual);
 
         // Limita o tamanho do histórico na stack
         if (historicoNotasAcertadas.size() > MAX_HISTORICO_COMBO) {
@@ -246,7 +642,7 @@ struct Jogador {
      */
     void quebrarCombo() {
         comboAtual = 0;
-        multiplicadorCombo = 1.0f;
+        multiplicadorCombo = ESCALA_PONTO_FIXO;
     }
 
     /**
@@ -271,395 +667,2565 @@ struct Jogador {
      * @return String formatada do multiplicador (ex: "1.3x")
      */
     std::string obterMultiplicadorFormatado() const {
-        std::ostringstream oss;
-        oss << std::fixed << std::setprecision(1) << multiplicadorCombo << "x";
-        return oss.str();
+        return Pontuacao::formatarMultiplicador(multiplicadorCombo);
     }
 };
 
-// ============================= NAMESPACE CHART =============================
+// ============================= BIBLIOTECA DE MÚSICAS =============================
 
 /**
- * @brief Namespace contendo estruturas e classes relacionadas ao parsing de charts
+ * @brief Varredura de pastas de músicas no estilo Clone Hero
+ *
+ * Uma música é uma pasta (ou um pacote .zip/.sng) com notes.chart (numa pasta
+ * comum, também notes.mid com song.ini). Os metadados
+ * vêm do song.ini quando ele existe; só na falta dele o [Song] do chart é lido.
  */
-namespace Chart {
-    /**
-     * @brief Representa uma mudança de tempo no chart
-     */
-    struct MudancaTempo {
-        int tick;
-        int valorBruto;
+namespace Biblioteca {
+    constexpr auto NOME_SONG_INI = "song.ini";
 
-        constexpr MudancaTempo(const int t, const int val) : tick(t), valorBruto(val) {}
+    struct Musica {
+        std::filesystem::path pasta;  // Pode atravessar um pacote
+        Chart::MetadadosMusica metadados;
+    };
 
-        /**
-         * @brief Obtém o BPM (Batidas Por Minuto)
-         * @return BPM como double
-         */
-        [[nodiscard]] constexpr auto obterBPM() const -> double {
-            return static_cast<double>(valorBruto) / 1000.0;
+    /**
+     * @brief Lê os metadados de uma pasta de música
+     * @param pasta Pasta (ou caminho dentro de pacote) com notes.chart
+     * @return Nulo se não há chart na pasta
+     */
+    inline std::optional<Musica> lerMusica(const std::filesystem::path &pasta) {
+        Musica musica{pasta, {}};
+        const auto songIni = lerArquivoUtf8((pasta / NOME_SONG_INI).string());
+        if (!songIni.empty() && Chart::LeitorMetadados::aplicarSongIni(songIni, musica.metadados)) {
+            return musica;
         }
 
-        /**
-         * @brief Obtém microssegundos por batida
-         * @return Microssegundos por batida
-         */
-        [[nodiscard]] constexpr auto obterMicrossegundosPorBatida() const -> double {
-            const auto bpm = obterBPM();
-            if (bpm <= 0) return 0;
-            return 60'000'000.0 / bpm;
-        }
-    };
+        const auto chart = lerArquivoUtf8((pasta / CAMINHO_ARQUIVO_CHART).string());
+        if (chart.empty()) return std::nullopt;
+        Chart::LeitorMetadados::aplicarSecaoSongChart(chart, musica.metadados);
+        return musica;
+    }
 
     /**
-     * @brief Representa uma assinatura de tempo no chart
+     * @brief Lê um .sng: os metadados estão no próprio cabeçalho do pacote
      */
-    struct AssinaturaTempo {
-        int tick;
-        int numerador;
-        int denominador;
+    inline std::optional<Musica> lerPacoteSng(const std::filesystem::path &caminho) {
+        const auto local = Arquivos::sistemaArquivos().localizar(caminho / CAMINHO_ARQUIVO_CHART);
+        if (!local || local->first->metadadosSng().empty()) return lerMusica(caminho);
 
-        constexpr AssinaturaTempo(const int t, const int n, const int d)
-            : tick(t), numerador(n), denominador(d) {}
-    };
+        Musica musica{caminho, {}};
+        for (const auto &[chave, valor] : local->first->metadadosSng()) {
+            Chart::LeitorMetadados::aplicarCampo(chave, valor, musica.metadados);
+        }
+        return musica;
+    }
 
     /**
-     * @brief Representa uma nota no chart
+     * @brief Percorre a árvore e lista as músicas encontradas
+     * @param raiz Pasta raiz da biblioteca
      */
-    struct NotaChart {
-        int tick;
-        int traste;
-        int comprimento;
+    inline std::vector<Musica> escanear(const std::filesystem::path &raiz) {
+        std::vector<Musica> musicas;
+        std::error_code erro;
+
+        for (auto it = std::filesystem::recursive_directory_iterator(
+                 raiz, std::filesystem::directory_options::skip_permission_denied, erro);
+             it != std::filesystem::recursive_directory_iterator(); it.increment(erro)) {
+            if (erro) break;
+            const auto &caminho = it->path();
+            const auto extensao = Arquivos::normalizarNome(caminho.extension().string());
+
+            std::optional<Musica> musica;
+            if (it->is_directory(erro)) {
+                if (std::filesystem::exists(caminho / CAMINHO_ARQUIVO_CHART, erro) ||
+                    std::filesystem::exists(caminho / CAMINHO_ARQUIVO_MIDI, erro)) {
+                    musica = lerMusica(caminho);
+                }
+            } else if (extensao == ".sng") {
+                musica = lerPacoteSng(caminho);
+            } else if (extensao == ".zip") {
+                // Cada pasta do zip com um chart é uma música
+                if (const auto local = Arquivos::sistemaArquivos().localizar(caminho / CAMINHO_ARQUIVO_CHART)) {
+                    for (const auto &entrada : local->first->listar()) {
+                        const std::filesystem::path interno(entrada.nome);
+                        if (Arquivos::normalizarNome(interno.filename().string()) != CAMINHO_ARQUIVO_CHART) continue;
+                        if (auto musicaPacote = lerMusica(caminho / interno.parent_path())) {
+                            musicas.push_back(std::move(*musicaPacote));
+                        }
+                    }
+                }
+            }
+            if (musica) musicas.push_back(std::move(*musica));
+        }
+        return musicas;
+    }
+}
 
-        constexpr NotaChart(const int t, const int tr, const int comp)
-            : tick(t), traste(tr), comprimento(comp) {}
-    };
+// ============================= AGENDAMENTO DE THREADS =============================
+
+/**
+ * @brief Política de agendamento e afinidade de uma thread
+ */
+struct ConfiguracaoAgendamento {
+    bool tempoReal = false;   // SCHED_FIFO em vez de SCHED_OTHER com nice
+    int prioridade = 0;       // Prioridade FIFO (1-99) ou nível nice (-20 a 19)
+    std::vector<int> cpus;    // Vazio = sem restrição de afinidade
 
     /**
-     * @brief Contém todos os dados de um chart
-     */
-    struct DadosChart {
-        sf::String nome, artista, streamMusica;
-        sf::String criadorChart, album, ano, genero, tipoMidia;
-        double offset = 0.0;
-        int resolucao = 192;
-        int dificuldade = 0;
-        double inicioPreview = 0.0;
-        double fimPreview = 0.0;
-        sf::String jogador2;
-        std::map<int, MudancaTempo> mudancasTempo;
-        std::map<int, AssinaturaTempo> assinaturasTempo;
-        std::vector<NotaChart> notas;
-    };
+     * @brief Interpreta uma especificação "fifo:80@2,3" ou "nice:-10@1"
+     * @param especificacao Texto da especificação
+     * @return Configuração, ou std::nullopt se o texto for inválido
+     */
+    [[nodiscard]] static auto interpretar(const std::string &especificacao) -> std::optional<ConfiguracaoAgendamento> {
+        ConfiguracaoAgendamento config;
+
+        const auto posicaoArroba = especificacao.find('@');
+        const auto politica = especificacao.substr(0, posicaoArroba);
+        const auto posicaoDoisPontos = politica.find(':');
+        const auto nomePolitica = politica.substr(0, posicaoDoisPontos);
+
+        if (nomePolitica == "fifo") config.tempoReal = true;
+        else if (nomePolitica != "nice") return std::nullopt;
+
+        // O campo inteiro precisa ser o número: "80abc" é inválido, não 80
+        const auto lerInteiro = [](const std::string &texto, int &valor) {
+            const auto *fim = texto.data() + texto.size();
+            const auto [resto, erro] = std::from_chars(texto.data(), fim, valor);
+            return erro == std::errc() && resto == fim;
+        };
+        if (posicaoDoisPontos != std::string::npos &&
+            !lerInteiro(politica.substr(posicaoDoisPontos + 1), config.prioridade)) {
+            return std::nullopt;
+        }
+        if (posicaoArroba != std::string::npos) {
+            std::istringstream listaCpus(especificacao.substr(posicaoArroba + 1));
+            std::string cpu;
+            while (std::getline(listaCpus, cpu, ',')) {
+                if (cpu.empty()) continue;
+                int indice = 0;
+                if (!lerInteiro(cpu, indice) || indice < 0) return std::nullopt;
+                config.cpus.push_back(indice);
+            }
+        }
+
+        return config;
+    }
 
     /**
-     * @brief Parser para arquivos de chart
+     * @brief Lê a configuração de uma variável de ambiente
+     * @param variavel Nome da variável
+     * @return Configuração, ou std::nullopt se ausente ou inválida
      */
-    class ParserChart {
-    public:
-        /**
-         * @brief Faz o parsing de um arquivo de chart
-         * @param caminhoArquivo Caminho para o arquivo .chart
-         * @return DadosChart opcional (std::nullopt se houver erro)
-         */
-        [[nodiscard]] static auto fazerParsingChart(const std::string &caminhoArquivo) -> std::optional<DadosChart> {
-            DadosChart dadosChart;
+    [[nodiscard]] static auto lerDoAmbiente(const char *variavel) -> std::optional<ConfiguracaoAgendamento> {
+        const char *valor = std::getenv(variavel);
+        if (!valor) return std::nullopt;
 
-            // Lê arquivo com suporte UTF-8
-            const std::string conteudoUtf8 = lerArquivoUtf8(caminhoArquivo);
-            if (conteudoUtf8.empty()) {
-                std::cerr << "Erro: Não foi possível abrir o arquivo de chart: " << caminhoArquivo << "\n";
-                return std::nullopt;
-            }
+        auto config = interpretar(valor);
+        if (!config) {
+            Log::erro("Valor inválido em ", variavel, ": ", valor);
+        }
+        return config;
+    }
+};
 
-            std::istringstream streamArquivo(conteudoUtf8);
-            std::string linhaAtual, secaoAtual;
-            const std::regex padraoSecao(R"(\[(.+)\])");
-            const std::regex padraoChaveValor(R"(\s*(.+?)\s*=\s*(.+))");
-            const std::regex padraoNota(R"((\d+)\s*=\s*N\s+(\d+)\s+(\d+))");
-            const std::regex padraoTempo(R"((\d+)\s*=\s*B\s+(\d+))");
-            const std::regex padraoAssinaturaTempo(R"((\d+)\s*=\s*TS\s+(\d+)(?:\s+(\d+))?)");
-            std::smatch correspondencia;
-
-            while (std::getline(streamArquivo, linhaAtual)) {
-                // Remove espaços em branco no início e fim
-                const auto primeiroChar = linhaAtual.find_first_not_of(" \t\r\n");
-                if (primeiroChar == std::string::npos) {
-                    linhaAtual.clear();
-                } else {
-                    linhaAtual.erase(0, primeiroChar);
-                    const auto ultimoChar = linhaAtual.find_last_not_of(" \t\r\n");
-                    if (ultimoChar != std::string::npos) {
-                        linhaAtual.erase(ultimoChar + 1);
-                    }
-                }
+/**
+ * @brief Aplica a configuração de agendamento à thread atual
+ *
+ * Falhas (ex: sem CAP_SYS_NICE para SCHED_FIFO) só geram aviso; o jogo segue
+ * com o agendamento padrão. Em sistemas que não são Linux não faz nada.
+ * @param config Configuração desejada
+ * @param nomeThread Nome usado nas mensagens
+ */
+inline void aplicarAgendamento(const ConfiguracaoAgendamento &config, const char *nomeThread) {
+#if defined(__linux__)
+    if (config.tempoReal) {
+        sched_param parametros{};
+        parametros.sched_priority = std::clamp(config.prioridade, sched_get_priority_min(SCHED_FIFO),
+                                               sched_get_priority_max(SCHED_FIFO));
+        if (const int erro = pthread_setschedparam(pthread_self(), SCHED_FIFO, &parametros); erro != 0) {
+            Log::aviso("SCHED_FIFO não permitido para a thread ", nomeThread, ": ", std::strerror(erro));
+        }
+    } else if (config.prioridade != 0) {
+        // No Linux, setpriority com o tid altera apenas a thread
+        const auto tid = static_cast<id_t>(syscall(SYS_gettid));
+        if (setpriority(PRIO_PROCESS, tid, config.prioridade) != 0) {
+            Log::aviso("Não foi possível ajustar nice da thread ", nomeThread, ": ", std::strerror(errno));
+        }
+    }
 
-                // Pula linhas vazias e comentários
-                if (linhaAtual.empty() || linhaAtual.rfind("//", 0) == 0) {
-                    continue;
-                }
+    if (!config.cpus.empty()) {
+        cpu_set_t conjunto;
+        CPU_ZERO(&conjunto);
+        for (const auto cpu : config.cpus) {
+            if (cpu < CPU_SETSIZE) CPU_SET(cpu, &conjunto);
+        }
+        if (const int erro = pthread_setaffinity_np(pthread_self(), sizeof(conjunto), &conjunto); erro != 0) {
+            Log::aviso("Não foi possível fixar a thread ", nomeThread, " nas CPUs pedidas: ", std::strerror(erro));
+        }
+    }
+#else
+    (void)config;
+    (void)nomeThread;
+#endif
+}
 
-                // Identifica seções
-                if (std::regex_match(linhaAtual, correspondencia, padraoSecao)) {
-                    secaoAtual = correspondencia[1].str();
-                    continue;
-                }
+/**
+ * @brief Aplica RIFF_HERO_SCHED_TRABALHO à thread de trabalho atual
+ *
+ * Lida uma vez só. O uso esperado é "nice:10", para que capas e forma de onda
+ * cedam a CPU à simulação, à entrada e ao áudio.
+ * @param nomeThread Nome usado nas mensagens
+ */
+inline void aplicarAgendamentoTrabalho(const char *nomeThread) {
+    static const auto config = ConfiguracaoAgendamento::lerDoAmbiente(VARIAVEL_AMBIENTE_AGENDAMENTO_TRABALHO);
+    if (config) aplicarAgendamento(*config, nomeThread);
+}
 
-                // Pula chaves
-                if (linhaAtual == "{" || linhaAtual == "}") {
-                    continue;
-                }
+/**
+ * @brief Trava a memória do processo para evitar page faults durante a música
+ *
+ * MCL_FUTURE cobre as notas e buffers alocados depois da carga. Se o limite
+ * RLIMIT_MEMLOCK não permitir, trava ao menos o que já está residente.
+ */
+inline void travarMemoriaProcesso() {
+#if defined(__linux__)
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0) return;
+    if (mlockall(MCL_CURRENT) == 0) {
+        Log::aviso("mlockall(MCL_FUTURE) falhou; apenas a memória atual foi travada.");
+        return;
+    }
+    Log::aviso("mlockall falhou: ", std::strerror(errno));
+#endif
+}
 
-                // Processa linha na seção atual
-                if (!secaoAtual.empty()) {
-                    // Sempre processa Song e SyncTrack
-                    if (secaoAtual == "Song" || secaoAtual == "SyncTrack") {
-                        processarLinhaNaSecao(dadosChart, secaoAtual, linhaAtual, padraoChaveValor,
-                                            padraoNota, padraoTempo, padraoAssinaturaTempo);
-                    }
-                    // Só processa a dificuldade desejada
-                    else if (secaoAtual == "HardSingle") {
-                        processarLinhaNaSecao(dadosChart, secaoAtual, linhaAtual, padraoChaveValor,
-                                            padraoNota, padraoTempo, padraoAssinaturaTempo);
-                    }
-                }
-            }
+/**
+ * @brief Contabiliza quadros que passaram do limiar de travamento
+ */
+struct EstatisticasTravamento {
+    std::int64_t quadros = 0;
+    std::int64_t travamentos = 0;
+    sf::Time piorQuadro = sf::Time::Zero;
+    sf::Time piorAtrasoEntrada = sf::Time::Zero;
+
+    void registrarQuadro(const sf::Time duracao) {
+        ++quadros;
+        if (duracao > LIMIAR_TRAVAMENTO_QUADRO) ++travamentos;
+        piorQuadro = std::max(piorQuadro, duracao);
+    }
 
-            // Ordena notas por tick
-            std::ranges::sort(dadosChart.notas, [](const auto &a, const auto &b) {
-                return a.tick < b.tick;
-            });
+    void registrarAtrasoEntrada(const sf::Time atraso) {
+        piorAtrasoEntrada = std::max(piorAtrasoEntrada, atraso);
+    }
 
-            return dadosChart;
-        }
+    void reiniciar() {
+        *this = EstatisticasTravamento{};
+    }
 
-    private:
-        /**
-         * @brief Processa uma linha dentro de uma seção específica
-         */
-        static void processarLinhaNaSecao(DadosChart &chart, const std::string &secao,
-                                        const std::string &linha, const std::regex &padraoCV,
-                                        const std::regex &padraoN, const std::regex &padraoT,
-                                        const std::regex &padraoAT) {
-            std::smatch correspondencia;
-
-            if (secao == "Song") {
-                if (std::regex_match(linha, correspondencia, padraoCV)) {
-                    auto chave = correspondencia[1].str();
-                    auto valor = correspondencia[2].str();
-
-                    // Remove aspas se presentes
-                    if (valor.length() >= 2 && valor.front() == '"' && valor.back() == '"') {
-                        valor = valor.substr(1, valor.length() - 2);
-                    }
+    /**
+     * @brief Resumo de uma linha para o operador
+     */
+    [[nodiscard]] auto resumo() const -> std::string {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2)
+            << "Travamentos: " << travamentos << " de " << quadros << " quadros acima de "
+            << LIMIAR_TRAVAMENTO_QUADRO.asMilliseconds() << " ms (pior quadro: "
+            << piorQuadro.asMicroseconds() / 1000.0 << " ms, pior atraso de entrada: "
+            << piorAtrasoEntrada.asMicroseconds() / 1000.0 << " ms)";
+        return oss.str();
+    }
+};
+
+// ============================= CAPAS DE ÁLBUM =============================
+
+/**
+ * @brief Miniaturas de capas decodificadas fora da thread principal
+ *
+ * Threads de trabalho leem a imagem (de disco ou de pacote), calculam o hash do
+ * conteúdo e procuram a miniatura pronta no cache em disco; na falta dela,
+ * decodificam, reduzem por média de área e gravam no cache. A thread principal
+ * só cria as texturas, um número limitado por quadro, para que rolar uma lista
+ * com milhares de capas nunca trave a renderização.
+ */
+namespace Capas {
+    constexpr std::uint32_t MAGICA_CACHE = 0x41504143; // "CAPA"
+
+    /**
+     * @brief Pixels RGBA de uma miniatura, prontos para a GPU
+     */
+    struct Miniatura {
+        unsigned largura = 0;
+        unsigned altura = 0;
+        std::vector<std::uint8_t> rgba;
+    };
+
+    /**
+     * @brief Pesos de um eixo do filtro de área: cada saída cobre [i*escala, (i+1)*escala) da origem
+     */
+    struct PesosEixo {
+        std::vector<unsigned> inicio;    // Primeiro índice de origem de cada saída
+        std::vector<unsigned> quantidade;
+        std::vector<float> pesos;        // Concatenados, já normalizados
+    };
+
+    inline PesosEixo calcularPesos(const unsigned tamanhoOrigem, const unsigned tamanhoDestino) {
+        PesosEixo eixo;
+        const auto escala = static_cast<double>(tamanhoOrigem) / tamanhoDestino;
+        for (unsigned i = 0; i < tamanhoDestino; ++i) {
+            const auto a = i * escala;
+            const auto b = std::min((i + 1) * escala, static_cast<double>(tamanhoOrigem));
+            const auto primeiro = static_cast<unsigned>(a);
+            const auto ultimo = std::min(static_cast<unsigned>(std::ceil(b)), tamanhoOrigem);
+            eixo.inicio.push_back(primeiro);
+            eixo.quantidade.push_back(ultimo - primeiro);
+            for (unsigned j = primeiro; j < ultimo; ++j) {
+                const auto cobertura = std::min(b, j + 1.0) - std::max(a, static_cast<double>(j));
+                eixo.pesos.push_back(static_cast<float>(cobertura / (b - a)));
+            }
+        }
+        return eixo;
+    }
 
-                    // Mapeia chaves para campos da estrutura (convertendo para sf::String)
-                    if (chave == "Name") chart.nome = utf8ParaSfString(valor);
-                    else if (chave == "Artist") chart.artista = utf8ParaSfString(valor);
-                    else if (chave == "Charter") chart.criadorChart = utf8ParaSfString(valor);
-                    else if (chave == "Album") chart.album = utf8ParaSfString(valor);
-                    else if (chave == "Year") chart.ano = utf8ParaSfString(valor);
-                    else if (chave == "Genre") chart.genero = utf8ParaSfString(valor);
-                    else if (chave == "MediaType") chart.tipoMidia = utf8ParaSfString(valor);
-                    else if (chave == "Player2") chart.jogador2 = utf8ParaSfString(valor);
-                    else if (chave == "MusicStream") chart.streamMusica = utf8ParaSfString(valor);
-                    else if (chave == "Offset") chart.offset = std::stod(valor);
-                    else if (chave == "Resolution") chart.resolucao = std::stoi(valor);
-                    else if (chave == "Difficulty") chart.dificuldade = std::stoi(valor);
-                    else if (chave == "PreviewStart") chart.inicioPreview = std::stod(valor);
-                    else if (chave == "PreviewEnd") chart.fimPreview = std::stod(valor);
+    /**
+     * @brief Reduz uma imagem RGBA por média de área (filtro box), de forma separável
+     *
+     * O passo vertical acumula linhas inteiras da origem: o laço interno percorre
+     * memória contígua e o compilador o vetoriza. O passo horizontal roda sobre a
+     * imagem já reduzida na vertical, bem menor.
+     * @param ladoMaximo Maior lado da miniatura; imagens menores não são ampliadas
+     */
+    inline Miniatura reduzirPorArea(const std::uint8_t *origem, const unsigned largura, const unsigned altura,
+                                    const unsigned ladoMaximo) {
+        const auto maiorLado = std::max(largura, altura);
+        const auto escala = std::min(1.0, static_cast<double>(ladoMaximo) / maiorLado);
+        Miniatura miniatura;
+        miniatura.largura = std::max(1u, static_cast<unsigned>(std::lround(largura * escala)));
+        miniatura.altura = std::max(1u, static_cast<unsigned>(std::lround(altura * escala)));
+
+        const auto pesosX = calcularPesos(largura, miniatura.largura);
+        const auto pesosY = calcularPesos(altura, miniatura.altura);
+        const std::size_t larguraLinha = static_cast<std::size_t>(largura) * 4;
+
+        // Passo vertical: altura de destino x largura de origem
+        std::vector<float> intermediaria(static_cast<std::size_t>(miniatura.altura) * larguraLinha, 0.f);
+        for (unsigned y = 0, p = 0; y < miniatura.altura; ++y) {
+            float *destino = &intermediaria[y * larguraLinha];
+            for (unsigned k = 0; k < pesosY.quantidade[y]; ++k, ++p) {
+                const float peso = pesosY.pesos[p];
+                const std::uint8_t *linha = origem + (pesosY.inicio[y] + k) * larguraLinha;
+                for (std::size_t i = 0; i < larguraLinha; ++i) {
+                    destino[i] += peso * static_cast<float>(linha[i]);
                 }
             }
-            else if (secao == "SyncTrack") {
-                if (std::regex_match(linha, correspondencia, padraoT)) {
-                    chart.mudancasTempo.emplace(std::stoi(correspondencia[1].str()),
-                                              MudancaTempo(std::stoi(correspondencia[1].str()),
-                                                         std::stoi(correspondencia[2].str())));
+        }
+
+        // Passo horizontal
+        miniatura.rgba.resize(static_cast<std::size_t>(miniatura.largura) * miniatura.altura * 4);
+        for (unsigned y = 0; y < miniatura.altura; ++y) {
+            const float *linha = &intermediaria[y * larguraLinha];
+            std::uint8_t *destino = &miniatura.rgba[static_cast<std::size_t>(y) * miniatura.largura * 4];
+            for (unsigned x = 0, p = 0; x < miniatura.largura; ++x) {
+                std::array<float, 4> soma{};
+                for (unsigned k = 0; k < pesosX.quantidade[x]; ++k, ++p) {
+                    const float *pixel = linha + (pesosX.inicio[x] + k) * 4;
+                    for (int c = 0; c < 4; ++c) soma[c] += pesosX.pesos[p] * pixel[c];
                 }
-                else if (std::regex_match(linha, correspondencia, padraoAT)) {
-                    auto denominador = correspondencia[3].matched ? std::stoi(correspondencia[3].str()) : 4;
-                    if (denominador == 0) denominador = 4;
-                    chart.assinaturasTempo.emplace(std::stoi(correspondencia[1].str()),
-                                                 AssinaturaTempo(std::stoi(correspondencia[1].str()),
-                                                               std::stoi(correspondencia[2].str()),
-                                                               denominador));
+                for (int c = 0; c < 4; ++c) {
+                    destino[x * 4 + c] = static_cast<std::uint8_t>(std::clamp(soma[c] + 0.5f, 0.f, 255.f));
                 }
             }
-            else if (secao == "ExpertSingle" || secao == "HardSingle" ||
-                     secao == "MediumSingle" || secao == "EasySingle") {
-                if (std::regex_match(linha, correspondencia, padraoN)) {
-                    chart.notas.emplace_back(NotaChart(std::stoi(correspondencia[1].str()),
-                                                     std::stoi(correspondencia[2].str()),
-                                                     std::stoi(correspondencia[3].str())));
-                }
+        }
+        return miniatura;
+    }
+
+    /**
+     * @brief Procura a capa de uma pasta de música (album.png/jpg)
+     * @return Caminho da capa, ou vazio se não há
+     */
+    inline std::string encontrarCapa(const std::filesystem::path &pasta) {
+        for (const auto nome : NOMES_ARQUIVO_CAPA) {
+            const auto caminho = pasta / nome;
+            if (const auto local = Arquivos::sistemaArquivos().localizar(caminho)) {
+                if (local->first->procurar(local->second)) return caminho.string();
+                continue;
             }
+            std::error_code erro;
+            if (std::filesystem::is_regular_file(caminho, erro)) return caminho.string();
         }
-    };
+        return "";
+    }
 
     /**
-     * @brief Calculadora de tempo baseada em mudanças de tempo do chart
+     * @brief Cache de capas: threads de decodificação, cache em disco e texturas LRU
      */
-    class CalculadoraTempo {
+    class CacheCapas {
     private:
-        const DadosChart &referenciaChart;
-        std::vector<MudancaTempo> mudancasTempoOrdenadas;
+        enum class Estado : std::uint8_t { Pendente, Pronta, Falha };
 
-    public:
-        /**
-         * @brief Construtor da calculadora de tempo
-         * @param chart Referência para os dados do chart
-         */
-        explicit CalculadoraTempo(const DadosChart &chart) : referenciaChart(chart) {
-            // Copia e ordena mudanças de tempo
-            for (const auto &mudanca: referenciaChart.mudancasTempo | std::views::values) {
-                mudancasTempoOrdenadas.push_back(mudanca);
+        struct Textura {
+            sf::Texture textura;
+            std::list<std::string>::iterator posicaoUso;
+            std::int64_t bytes = 0;
+        };
+
+        std::filesystem::path diretorioCache;
+
+        std::mutex mutex;
+        std::condition_variable_any sinal;
+        std::deque<std::string> pedidos;
+        std::deque<std::pair<std::string, Miniatura>> prontas;
+        std::unordered_map<std::string, Estado> estados;
+
+        // Só a thread principal mexe nas texturas
+        std::unordered_map<std::string, Textura> texturas;
+        std::list<std::string> usoRecente; // Mais recente na frente
+
+        std::vector<std::jthread> trabalhadores; // Por último: param antes do resto ser destruído
+
+        [[nodiscard]] std::filesystem::path caminhoCache(const std::uint64_t hash) const {
+            std::array<char, 17> hex{};
+            std::to_chars(hex.data(), hex.data() + 16, hash, 16);
+            return diretorioCache / (std::string(hex.data()) + "_" + std::to_string(TAMANHO_MINIATURA_CAPA) + ".rgba");
+        }
+
+        [[nodiscard]] std::optional<Miniatura> lerCacheDisco(const std::uint64_t hash) const {
+            std::ifstream arquivo(caminhoCache(hash), std::ios::binary);
+            if (!arquivo) return std::nullopt;
+
+            std::array<std::uint32_t, 3> cabecalho{};
+            arquivo.read(reinterpret_cast<char *>(cabecalho.data()), sizeof(cabecalho));
+            if (!arquivo || cabecalho[0] != MAGICA_CACHE || cabecalho[1] == 0 || cabecalho[2] == 0 ||
+                cabecalho[1] > TAMANHO_MINIATURA_CAPA || cabecalho[2] > TAMANHO_MINIATURA_CAPA) {
+                return std::nullopt;
             }
 
-            std::ranges::sort(mudancasTempoOrdenadas, [](const auto &a, const auto &b) {
-                return a.tick < b.tick;
-            });
+            Miniatura miniatura{cabecalho[1], cabecalho[2], {}};
+            miniatura.rgba.resize(static_cast<std::size_t>(miniatura.largura) * miniatura.altura * 4);
+            arquivo.read(reinterpret_cast<char *>(miniatura.rgba.data()), static_cast<std::streamsize>(miniatura.rgba.size()));
+            if (!arquivo) return std::nullopt;
+            return miniatura;
+        }
 
-            // Garante que há uma mudança de tempo no tick 0
-            if (mudancasTempoOrdenadas.empty() || mudancasTempoOrdenadas.front().tick != 0) {
-                mudancasTempoOrdenadas.insert(mudancasTempoOrdenadas.begin(), MudancaTempo(0, 120000));
+        void gravarCacheDisco(const std::uint64_t hash, const Miniatura &miniatura) const {
+            std::error_code erro;
+            std::filesystem::create_directories(diretorioCache, erro);
+
+            // Grava em arquivo temporário e renomeia: outra thread nunca lê um arquivo pela metade
+            const auto destino = caminhoCache(hash);
+            auto temporario = destino;
+            temporario += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+            {
+                std::ofstream arquivo(temporario, std::ios::binary);
+                const std::array<std::uint32_t, 3> cabecalho = {MAGICA_CACHE, miniatura.largura, miniatura.altura};
+                arquivo.write(reinterpret_cast<const char *>(cabecalho.data()), sizeof(cabecalho));
+                arquivo.write(reinterpret_cast<const char *>(miniatura.rgba.data()),
+                              static_cast<std::streamsize>(miniatura.rgba.size()));
+                if (!arquivo) return;
             }
+            std::filesystem::rename(temporario, destino, erro);
         }
 
         /**
-         * @brief Converte ticks para segundos
-         * @param tickAlvo Tick a ser convertido
-         * @return Tempo em segundos
+         * @brief Produz a miniatura de uma imagem (thread de trabalho)
          */
-        [[nodiscard]] auto ticksParaSegundos(const int tickAlvo) const -> double {
-            auto tempoEmSegundos = 0.0;
-            auto tickAtual = 0;
-
-            for (size_t i = 0; i < mudancasTempoOrdenadas.size(); ++i) {
-                const auto &eventoTempoAtual = mudancasTempoOrdenadas[i];
-                const auto proximoTickTempo = (i + 1 < mudancasTempoOrdenadas.size())
-                                                 ? mudancasTempoOrdenadas[i + 1].tick
-                                                 : std::numeric_limits<int>::max();
-                const auto tickFinalSegmento = std::min(tickAlvo, proximoTickTempo);
-                const auto ticksNoSegmento = tickFinalSegmento - tickAtual;
-
-                if (ticksNoSegmento <= 0 && tickAlvo > 0) {
-                    if (tickAtual >= tickAlvo) break;
-                } else if (ticksNoSegmento < 0) {
-                    break;
-                }
+        [[nodiscard]] std::optional<Miniatura> processar(const std::string &caminho) const {
+            const auto dados = lerArquivoBruto(caminho);
+            if (dados.empty()) return std::nullopt;
 
-                const auto microssegundosPorBatida = eventoTempoAtual.obterMicrossegundosPorBatida();
-                if (referenciaChart.resolucao == 0) {
-                    std::cerr << "Erro: Resolução do chart é 0. Não é possível calcular tempo a partir de ticks.\n";
-                    return tempoEmSegundos + referenciaChart.offset;
-                }
+            const auto hash = hashConteudo(dados);
+            if (auto miniatura = lerCacheDisco(hash)) return miniatura;
 
-                const auto microssegundosPorTick = microssegundosPorBatida / static_cast<double>(referenciaChart.resolucao);
-                const auto segundosPorTick = microssegundosPorTick / 1'000'000.0;
-                const auto duracaoSegmentoSegundos = static_cast<double>(ticksNoSegmento) * segundosPorTick;
+            sf::Image imagem;
+            if (!imagem.loadFromMemory(dados.data(), dados.size())) {
+                Log::aviso("Capa inválida: ", caminho);
+                return std::nullopt;
+            }
+            auto miniatura = reduzirPorArea(imagem.getPixelsPtr(), imagem.getSize().x, imagem.getSize().y,
+                                            TAMANHO_MINIATURA_CAPA);
+            gravarCacheDisco(hash, miniatura);
+            return miniatura;
+        }
+
+        void executar(const std::stop_token &parar) {
+            aplicarAgendamentoTrabalho("de capas");
+            while (true) {
+                std::string caminho;
+                {
+                    std::unique_lock trava(mutex);
+                    if (!sinal.wait(trava, parar, [this] { return !pedidos.empty(); })) return;
+                    // O pedido mais novo primeiro: ao rolar a lista, é o que está na tela
+                    caminho = std::move(pedidos.back());
+                    pedidos.pop_back();
+                }
 
-                tempoEmSegundos += duracaoSegmentoSegundos;
-                tickAtual = tickFinalSegmento;
+                auto miniatura = processar(caminho);
 
-                if (tickAtual >= tickAlvo) {
-                    break;
+                std::lock_guard trava(mutex);
+                if (miniatura) {
+                    estados[caminho] = Estado::Pronta;
+                    prontas.emplace_back(std::move(caminho), std::move(*miniatura));
+                } else {
+                    estados[caminho] = Estado::Falha;
                 }
             }
-
-            return tempoEmSegundos + referenciaChart.offset;
         }
-    };
+
+    public:
+        CacheCapas() = default;
+        CacheCapas(const CacheCapas &) = delete;
+        CacheCapas &operator=(const CacheCapas &) = delete;
+
+        ~CacheCapas() {
+            trabalhadores.clear();
+            for (const auto &[caminho, textura] : texturas) {
+                Memoria::registrarLiberacao(Memoria::Subsistema::Texturas, textura.bytes);
+            }
+        }
+
+        /**
+         * @brief Inicia as threads de decodificação
+         * @param diretorio Onde guardar as miniaturas prontas
+         */
+        void iniciar(const std::filesystem::path &diretorio) {
+            diretorioCache = diretorio;
+            for (int i = 0; i < THREADS_DECODIFICACAO_CAPAS; ++i) {
+                trabalhadores.emplace_back([this](const std::stop_token &parar) { executar(parar); });
+            }
+        }
+
+        /**
+         * @brief Textura da capa, ou nulo enquanto ela não ficou pronta
+         *
+         * A primeira chamada para um caminho enfileira a decodificação.
+         */
+        const sf::Texture *obter(const std::string &caminho) {
+            if (const auto it = texturas.find(caminho); it != texturas.end()) {
+                usoRecente.splice(usoRecente.begin(), usoRecente, it->second.posicaoUso);
+                return &it->second.textura;
+            }
+
+            std::lock_guard trava(mutex);
+            if (trabalhadores.empty() || estados.contains(caminho)) return nullptr;
+            estados.emplace(caminho, Estado::Pendente);
+            pedidos.push_back(caminho);
+            sinal.notify_one();
+            return nullptr;
+        }
+
+        /**
+         * @brief Cria texturas das miniaturas prontas, no máximo `maximo` por chamada (thread principal)
+         */
+        void enviarPendentes(const int maximo) {
+            for (int enviadas = 0; enviadas < maximo; ++enviadas) {
+                std::pair<std::string, Miniatura> pronta;
+                {
+                    std::lock_guard trava(mutex);
+                    if (prontas.empty()) return;
+                    pronta = std::move(prontas.front());
+                    prontas.pop_front();
+                }
+
+                auto &[caminho, miniatura] = pronta;
+                Textura textura;
+                if (!textura.textura.resize({miniatura.largura, miniatura.altura})) {
+                    // Sem textura a capa nunca aparece: Falha tira a entrada de Pronta, e os pixels saem com `pronta`
+                    Log::aviso("Não foi possível criar a textura da capa ", caminho);
+                    std::lock_guard trava(mutex);
+                    estados[caminho] = Estado::Falha;
+                    continue;
+                }
+                textura.textura.update(miniatura.rgba.data());
+                textura.textura.setSmooth(true);
+                textura.bytes = static_cast<std::int64_t>(miniatura.rgba.size());
+                Memoria::registrarAlocacao(Memoria::Subsistema::Texturas, textura.bytes);
+
+                usoRecente.push_front(caminho);
+                textura.posicaoUso = usoRecente.begin();
+                texturas.insert_or_assign(std::move(caminho), std::move(textura));
+
+                // Descarta a menos usada; um novo obter() a decodifica de novo (do cache em disco)
+                if (texturas.size() > CAPACIDADE_CACHE_CAPAS) {
+                    const auto &antiga = usoRecente.back();
+                    const auto it = texturas.find(antiga);
+                    Memoria::registrarLiberacao(Memoria::Subsistema::Texturas, it->second.bytes);
+                    {
+                        std::lock_guard trava(mutex);
+                        estados.erase(antiga);
+                    }
+                    texturas.erase(it);
+                    usoRecente.pop_back();
+                }
+            }
+        }
+    };
+}
+
+// ============================= FORMA DE ONDA =============================
+
+/**
+ * @brief Pirâmide de resumos da forma de onda, para desenhar a música em qualquer zoom
+ *
+ * O nível 0 guarda mínimo, máximo e média dos quadrados de cada bloco de
+ * QUADROS_BLOCO_ONDA quadros (todos os canais juntos); cada nível acima junta
+ * pares do nível de baixo. A consulta escolhe o nível cujo bloco ainda cabe em
+ * uma coluna de pixels, então desenhar custa O(pixels), não O(amostras). Uma
+ * thread de trabalho decodifica o áudio uma vez e guarda o nível 0 em disco,
+ * indexado pelo hash do arquivo; os níveis de cima são refeitos na leitura.
+ */
+namespace FormaOnda {
+    constexpr std::uint32_t MAGICA_CACHE = 0x41444E4F; // "ONDA"
+    constexpr std::uint32_t VERSAO_CACHE = 1;
+    constexpr double ESCALA_QUADRADOS = 32768.0 * 32768.0;
+
+    /**
+     * @brief Resumo de um bloco: extremos e energia média
+     */
+    struct Resumo {
+        std::int16_t minimo = 0;
+        std::int16_t maximo = 0;
+        float mediaQuadrados = 0.f; // Em unidades de fundo de escala ao quadrado
+
+        [[nodiscard]] float rms() const { return std::sqrt(mediaQuadrados); }
+    };
+    static_assert(sizeof(Resumo) == 8 && std::is_trivially_copyable_v<Resumo>);
+
+    struct Extremos {
+        std::int16_t minimo;
+        std::int16_t maximo;
+        std::uint64_t somaQuadrados;
+    };
+
+    /**
+     * @brief Mínimo, máximo e soma dos quadrados de amostras de 16 bits
+     *
+     * Com SSE2 (sempre presente em x86-64) trata 8 amostras por instrução.
+     * _mm_madd_epi16 soma os quadrados aos pares; o par chega a 2^31, que só
+     * cabe sem sinal, então cada soma é estendida com zeros para 64 bits.
+     */
+    inline Extremos resumirAmostras(const std::int16_t *amostras, const std::size_t quantidade) {
+        Extremos extremos{std::numeric_limits<std::int16_t>::max(), std::numeric_limits<std::int16_t>::min(), 0};
+        std::size_t i = 0;
+#if defined(__SSE2__)
+        if (quantidade >= 8) {
+            const auto zero = _mm_setzero_si128();
+            auto minimos = _mm_set1_epi16(extremos.minimo);
+            auto maximos = _mm_set1_epi16(extremos.maximo);
+            auto somas = zero;
+            for (; i + 8 <= quantidade; i += 8) {
+                const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(amostras + i));
+                minimos = _mm_min_epi16(minimos, v);
+                maximos = _mm_max_epi16(maximos, v);
+                const auto quadrados = _mm_madd_epi16(v, v);
+                somas = _mm_add_epi64(somas, _mm_unpacklo_epi32(quadrados, zero));
+                somas = _mm_add_epi64(somas, _mm_unpackhi_epi32(quadrados, zero));
+            }
+
+            std::array<std::int16_t, 8> faixaMinimos{};
+            std::array<std::int16_t, 8> faixaMaximos{};
+            std::array<std::uint64_t, 2> faixaSomas{};
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(faixaMinimos.data()), minimos);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(faixaMaximos.data()), maximos);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(faixaSomas.data()), somas);
+            extremos.minimo = std::ranges::min(faixaMinimos);
+            extremos.maximo = std::ranges::max(faixaMaximos);
+            extremos.somaQuadrados = faixaSomas[0] + faixaSomas[1];
+        }
+#endif
+        for (; i < quantidade; ++i) {
+            const auto amostra = amostras[i];
+            extremos.minimo = std::min(extremos.minimo, amostra);
+            extremos.maximo = std::max(extremos.maximo, amostra);
+            extremos.somaQuadrados += static_cast<std::uint64_t>(static_cast<std::int32_t>(amostra) * amostra);
+        }
+        return extremos;
+    }
+
+    /**
+     * @brief Resumos de uma música em todos os níveis de zoom
+     */
+    class Piramide {
+    private:
+        unsigned taxaAmostragem = 0;
+        std::uint64_t totalQuadros = 0;
+        std::vector<std::vector<Resumo>> niveis; // niveis[k]: blocos de QUADROS_BLOCO_ONDA << k quadros
+
+    public:
+        /**
+         * @param base Nível 0; os outros são montados juntando pares
+         */
+        Piramide(const unsigned taxa, const std::uint64_t quadros, std::vector<Resumo> base)
+            : taxaAmostragem(taxa), totalQuadros(quadros) {
+            niveis.push_back(std::move(base));
+            while (niveis.back().size() > 1) {
+                const auto &abaixo = niveis.back();
+                std::vector<Resumo> nivel((abaixo.size() + 1) / 2);
+                for (std::size_t i = 0; i < nivel.size(); ++i) {
+                    const auto &a = abaixo[2 * i];
+                    if (2 * i + 1 == abaixo.size()) {
+                        nivel[i] = a; // Bloco final sem par
+                        continue;
+                    }
+                    const auto &b = abaixo[2 * i + 1];
+                    nivel[i] = {std::min(a.minimo, b.minimo), std::max(a.maximo, b.maximo),
+                                (a.mediaQuadrados + b.mediaQuadrados) / 2.f};
+                }
+                niveis.push_back(std::move(nivel));
+            }
+        }
+
+        [[nodiscard]] unsigned taxa() const { return taxaAmostragem; }
+        [[nodiscard]] std::uint64_t quadros() const { return totalQuadros; }
+        [[nodiscard]] const std::vector<Resumo> &base() const { return niveis.front(); }
+
+        [[nodiscard]] double duracaoSegundos() const {
+            return taxaAmostragem ? static_cast<double>(totalQuadros) / taxaAmostragem : 0.0;
+        }
+
+        [[nodiscard]] std::int64_t bytes() const {
+            std::int64_t total = 0;
+            for (const auto &nivel : niveis) total += static_cast<std::int64_t>(nivel.size() * sizeof(Resumo));
+            return total;
+        }
+
+        /**
+         * @brief Resume [inicioSeg, fimSeg) em colunas.size() colunas iguais
+         *
+         * No nível escolhido cada coluna cobre entre um e dois blocos, então lê
+         * no máximo três. Fora da música as colunas ficam em silêncio.
+         */
+        void consultar(const double inicioSeg, const double fimSeg, const std::span<Resumo> colunas) const {
+            std::ranges::fill(colunas, Resumo{});
+            if (niveis.front().empty() || colunas.empty() || fimSeg <= inicioSeg) return;
+
+            const auto blocosPorSegundo = static_cast<double>(taxaAmostragem) / QUADROS_BLOCO_ONDA;
+            const auto segundosPorColuna = (fimSeg - inicioSeg) / static_cast<double>(colunas.size());
+            std::size_t nivel = 0;
+            while (nivel + 1 < niveis.size() &&
+                   static_cast<double>(std::uint64_t{1} << (nivel + 1)) <= segundosPorColuna * blocosPorSegundo) {
+                ++nivel;
+            }
+
+            const auto &blocos = niveis[nivel];
+            const auto escala = blocosPorSegundo / static_cast<double>(std::uint64_t{1} << nivel);
+            const auto total = static_cast<std::int64_t>(blocos.size());
+            for (std::size_t c = 0; c < colunas.size(); ++c) {
+                const auto t0 = inicioSeg + segundosPorColuna * static_cast<double>(c);
+                const auto primeiro = static_cast<std::int64_t>(std::floor(t0 * escala));
+                const auto ultimo = std::max(primeiro + 1,
+                                             static_cast<std::int64_t>(std::ceil((t0 + segundosPorColuna) * escala)));
+                const auto inicio = std::max<std::int64_t>(primeiro, 0);
+                const auto fim = std::min(ultimo, total);
+                if (inicio >= fim) continue;
+
+                Resumo resumo{std::numeric_limits<std::int16_t>::max(), std::numeric_limits<std::int16_t>::min(), 0.f};
+                for (auto i = inicio; i < fim; ++i) {
+                    resumo.minimo = std::min(resumo.minimo, blocos[i].minimo);
+                    resumo.maximo = std::max(resumo.maximo, blocos[i].maximo);
+                    resumo.mediaQuadrados += blocos[i].mediaQuadrados;
+                }
+                resumo.mediaQuadrados /= static_cast<float>(fim - inicio);
+                colunas[c] = resumo;
+            }
+        }
+    };
+
+    /**
+     * @brief Decodifica o áudio inteiro e monta a pirâmide
+     * @param cancelado Consultado entre leituras; abandona o trabalho se verdadeiro
+     * @return Pirâmide, ou vazio se cancelado
+     */
+    template<typename Cancelado>
+    std::optional<Piramide> decodificar(sf::InputSoundFile &arquivo, Cancelado &&cancelado) {
+        const auto canais = arquivo.getChannelCount();
+        const std::size_t amostrasBloco = static_cast<std::size_t>(QUADROS_BLOCO_ONDA) * canais;
+        std::vector<std::int16_t> amostras(amostrasBloco * BLOCOS_POR_LEITURA_ONDA);
+        std::vector<Resumo> base;
+        base.reserve(arquivo.getSampleCount() / amostrasBloco + 1);
+
+        // O total vem do que foi decodificado: a contagem do cabeçalho nem sempre é exata
+        std::uint64_t totalAmostras = 0;
+        while (!cancelado()) {
+            // Enche o buffer inteiro: só a última leitura deixa um bloco incompleto
+            std::size_t lidas = 0;
+            while (lidas < amostras.size()) {
+                const auto n = arquivo.read(amostras.data() + lidas, amostras.size() - lidas);
+                if (n == 0) break;
+                lidas += n;
+            }
+            for (std::size_t i = 0; i < lidas; i += amostrasBloco) {
+                const auto quantidade = std::min(amostrasBloco, lidas - i);
+                const auto extremos = resumirAmostras(amostras.data() + i, quantidade);
+                base.push_back({extremos.minimo, extremos.maximo,
+                                static_cast<float>(static_cast<double>(extremos.somaQuadrados) /
+                                                   (static_cast<double>(quantidade) * ESCALA_QUADRADOS))});
+            }
+            totalAmostras += lidas;
+            if (lidas < amostras.size()) return Piramide(arquivo.getSampleRate(), totalAmostras / canais, std::move(base));
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Monta a pirâmide da música atual numa thread de trabalho
+     *
+     * Só a música pedida por último interessa: um pedido novo cancela a
+     * decodificação em andamento. O hash do conteúdo, calculado aqui de
+     * qualquer forma, também fica disponível para identificar a música.
+     */
+    class Carregador {
+    private:
+        std::filesystem::path diretorioCache;
+
+        std::mutex mutex;
+        std::condition_variable_any sinal;
+        std::string pedido;                     // Ainda não atendido (vazio: nenhum)
+        std::shared_ptr<const Piramide> pronta; // Da música pedida por último
+        std::optional<std::uint64_t> hashPronto; // Conteúdo da música pedida por último
+        bool leituraFalhou = false;              // O arquivo da música pedida por último não pôde ser lido
+        std::atomic<std::uint64_t> geracao{0};  // Muda a cada pedido
+
+        std::jthread trabalhador; // Por último: para antes do resto ser destruído
+
+        [[nodiscard]] std::filesystem::path caminhoCache(const std::uint64_t hash) const {
+            std::array<char, 17> hex{};
+            std::to_chars(hex.data(), hex.data() + 16, hash, 16);
+            return diretorioCache / (std::string(hex.data()) + "_" + std::to_string(QUADROS_BLOCO_ONDA) + ".onda");
+        }
+
+        [[nodiscard]] std::shared_ptr<const Piramide> lerCacheDisco(const std::uint64_t hash) const {
+            const auto caminho = caminhoCache(hash);
+            std::ifstream arquivo(caminho, std::ios::binary);
+            if (!arquivo) return nullptr;
+
+            std::array<std::uint32_t, 4> cabecalho{}; // Mágica, versão, taxa, blocos
+            std::uint64_t quadros = 0;
+            arquivo.read(reinterpret_cast<char *>(cabecalho.data()), sizeof(cabecalho));
+            arquivo.read(reinterpret_cast<char *>(&quadros), sizeof(quadros));
+            if (!arquivo || cabecalho[0] != MAGICA_CACHE || cabecalho[1] != VERSAO_CACHE || cabecalho[2] == 0 ||
+                cabecalho[3] == 0 || cabecalho[3] > quadros / QUADROS_BLOCO_ONDA + 1) {
+                return nullptr;
+            }
+            // Os quadros vêm do mesmo arquivo e não limitam nada: só o tamanho real garante que os blocos existem
+            std::error_code erro;
+            const auto tamanhoArquivo = std::filesystem::file_size(caminho, erro);
+            if (erro || tamanhoArquivo != sizeof(cabecalho) + sizeof(quadros) +
+                                          static_cast<std::uint64_t>(cabecalho[3]) * sizeof(Resumo)) {
+                return nullptr;
+            }
+
+            std::vector<Resumo> base(cabecalho[3]);
+            arquivo.read(reinterpret_cast<char *>(base.data()), static_cast<std::streamsize>(base.size() * sizeof(Resumo)));
+            if (!arquivo) return nullptr;
+            return std::make_shared<const Piramide>(cabecalho[2], quadros, std::move(base));
+        }
+
+        void gravarCacheDisco(const std::uint64_t hash, const Piramide &piramide) const {
+            std::error_code erro;
+            std::filesystem::create_directories(diretorioCache, erro);
+
+            const auto destino = caminhoCache(hash);
+            auto temporario = destino;
+            temporario += ".tmp";
+            {
+                std::ofstream arquivo(temporario, std::ios::binary);
+                const auto &base = piramide.base();
+                const std::array<std::uint32_t, 4> cabecalho = {MAGICA_CACHE, VERSAO_CACHE, piramide.taxa(),
+                                                                static_cast<std::uint32_t>(base.size())};
+                const auto quadros = piramide.quadros();
+                arquivo.write(reinterpret_cast<const char *>(cabecalho.data()), sizeof(cabecalho));
+                arquivo.write(reinterpret_cast<const char *>(&quadros), sizeof(quadros));
+                arquivo.write(reinterpret_cast<const char *>(base.data()),
+                              static_cast<std::streamsize>(base.size() * sizeof(Resumo)));
+                if (!arquivo) return;
+            }
+            std::filesystem::rename(temporario, destino, erro);
+        }
+
+        /**
+         * @brief Produz a pirâmide de um arquivo de áudio (thread de trabalho)
+         */
+        [[nodiscard]] std::shared_ptr<const Piramide> processar(const std::string &caminho, const std::stop_token &parar,
+                                                                const std::uint64_t minhaGeracao) {
+            const auto dados = lerArquivoBruto(caminho);
+            if (dados.empty()) {
+                // Quem espera o hash precisa saber que ele não vem
+                std::lock_guard trava(mutex);
+                if (geracao.load(std::memory_order_relaxed) == minhaGeracao) leituraFalhou = true;
+                return nullptr;
+            }
+
+            const auto hash = hashConteudo(dados);
+            {
+                std::lock_guard trava(mutex);
+                if (geracao.load(std::memory_order_relaxed) == minhaGeracao) hashPronto = hash;
+            }
+            if (auto piramide = lerCacheDisco(hash)) return piramide;
+
+            sf::Clock relogio;
+            sf::InputSoundFile arquivo;
+            if (!arquivo.openFromMemory(dados.data(), dados.size()) || arquivo.getChannelCount() == 0) {
+                Log::aviso("Áudio inválido para a forma de onda: ", caminho);
+                return nullptr;
+            }
+            auto decodificada = decodificar(arquivo, [&] {
+                return parar.stop_requested() || geracao.load(std::memory_order_relaxed) != minhaGeracao;
+            });
+            if (!decodificada) return nullptr;
+
+            auto piramide = std::make_shared<const Piramide>(std::move(*decodificada));
+            gravarCacheDisco(hash, *piramide);
+            Log::info("Forma de onda de ", caminho, " em ", relogio.getElapsedTime().asMilliseconds(), " ms");
+            return piramide;
+        }
+
+        void executar(const std::stop_token &parar) {
+            aplicarAgendamentoTrabalho("da forma de onda");
+            while (true) {
+                std::string caminho;
+                std::uint64_t minhaGeracao = 0;
+                {
+                    std::unique_lock trava(mutex);
+                    if (!sinal.wait(trava, parar, [this] { return !pedido.empty(); })) return;
+                    caminho = std::exchange(pedido, {});
+                    minhaGeracao = geracao.load(std::memory_order_relaxed);
+                }
+
+                auto piramide = processar(caminho, parar, minhaGeracao);
+
+                std::lock_guard trava(mutex);
+                if (!piramide || geracao.load(std::memory_order_relaxed) != minhaGeracao) continue;
+                Memoria::registrarAlocacao(Memoria::Subsistema::Caches, piramide->bytes());
+                pronta = std::move(piramide);
+            }
+        }
+
+        void descartarPronta() {
+            if (!pronta) return;
+            Memoria::registrarLiberacao(Memoria::Subsistema::Caches, pronta->bytes());
+            pronta.reset();
+        }
+
+    public:
+        Carregador() = default;
+        Carregador(const Carregador &) = delete;
+        Carregador &operator=(const Carregador &) = delete;
+
+        ~Carregador() {
+            trabalhador = {};
+            descartarPronta();
+        }
+
+        /**
+         * @brief Inicia a thread de trabalho
+         * @param diretorio Onde guardar o nível 0 das músicas já decodificadas
+         */
+        void iniciar(const std::filesystem::path &diretorio) {
+            diretorioCache = diretorio;
+            trabalhador = std::jthread([this](const std::stop_token &parar) { executar(parar); });
+        }
+
+        /**
+         * @brief Troca a música; a pirâmide anterior deixa de ser devolvida na hora
+         */
+        void pedir(const std::string &caminho) {
+            std::lock_guard trava(mutex);
+            geracao.fetch_add(1, std::memory_order_relaxed);
+            descartarPronta();
+            hashPronto.reset();
+            leituraFalhou = false;
+            pedido = caminho;
+            sinal.notify_one();
+        }
+
+        /**
+         * @brief Hash do conteúdo da música pedida, ou vazio enquanto o arquivo não foi lido
+         */
+        [[nodiscard]] std::optional<std::uint64_t> hashMusica() {
+            std::lock_guard trava(mutex);
+            return hashPronto;
+        }
+
+        /**
+         * @brief True se o arquivo da música pedida não pôde ser lido; o hash nunca vai chegar
+         */
+        [[nodiscard]] bool falhouLeitura() {
+            std::lock_guard trava(mutex);
+            return leituraFalhou;
+        }
+
+        /**
+         * @brief Pirâmide da música pedida, ou nulo enquanto ela não ficou pronta
+         */
+        [[nodiscard]] std::shared_ptr<const Piramide> obter() {
+            std::lock_guard trava(mutex);
+            return pronta;
+        }
+    };
+}
+
+// ============================= ESTRUTURA NOTA =============================
+
+/**
+ * @brief Cor de cada pista (verde, vermelho, amarelo, azul, laranja)
+ */
+inline sf::Color corDaPista(const int pista) {
+    switch (pista) {
+        case 0: return sf::Color::Green;
+        case 1: return sf::Color::Red;
+        case 2: return sf::Color(255, 255, 0); // Amarelo
+        case 3: return sf::Color::Blue;
+        case 4: return sf::Color(255, 165, 0); // Laranja
+        default: return sf::Color::White;
+    }
+}
+
+/**
+ * @brief Representa uma nota no jogo durante a execução
+ */
+struct Nota {
+    double timestampSec = 0.0;
+    int tickOriginal = 0;
+    int pista = 0;
+    int traste = 0;
+    float posicaoY = 0.0f;
+    bool naTela = false;
+    bool acertada = false;
+    bool perdida = false;
+    Jogador *dono = nullptr;
+    sf::Color cor = sf::Color::White;
+    bool ehNotaLonga = false;
+    double tempoFimSustainSec = 0.0;
+    bool sustainAtivo = false;
+    bool sustainCompleto = false;
+    sf::Time tempoAtePróximaParticulaSustain = sf::Time::Zero;
+
+    /**
+     * @brief Construtor da nota
+     * @param notaChart Nota do chart original
+     * @param timestampSeg Timestamp em segundos
+     * @param fimSustainSeg Fim do sustain em segundos
+     * @param proprietario Ponteiro para o jogador dono da nota
+     */
+    Nota(const Chart::NotaChart &notaChart, const double timestampSeg,
+         const double fimSustainSeg, Jogador *proprietario)
+        : tickOriginal(notaChart.tick), traste(notaChart.traste), timestampSec(timestampSeg),
+          tempoFimSustainSec(fimSustainSeg), ehNotaLonga(notaChart.comprimento > 0), dono(proprietario) {
+
+        pista = notaChart.traste;
+        cor = corDaPista(pista);
+    }
+
+    /**
+     * @brief Obtém a posição onde a nota deve ser acertada
+     * @return Posição do centro da nota quando acertada
+     */
+    [[nodiscard]] auto obterPosicaoAcerto() const -> sf::Vector2f {
+        if (!dono) return {0.f, 0.f};
+
+        const auto larguraVisualCabeca = static_cast<float>(LARGURA_PISTA - 12);
+        const auto xBaseNota = static_cast<float>(dono->offsetAreaJogadorX + pista * LARGURA_PISTA);
+        const auto xVisualCabeca = xBaseNota + (LARGURA_PISTA - larguraVisualCabeca) / 2.f;
+        const auto xCentro = xVisualCabeca + larguraVisualCabeca / 2.f;
+
+        return {xCentro, posicaoY};
+    }
+
+    /**
+     * @brief Obtém a posição onde spawnar partículas de sustain
+     * @return Posição para partículas de sustain
+     */
+    [[nodiscard]] auto obterPosicaoParticulaSustain() const -> sf::Vector2f {
+        if (!dono) return {0.f, 0.f};
+
+        const auto larguraVisualCabeca = static_cast<float>(LARGURA_PISTA - 12);
+        const auto xBaseNota = static_cast<float>(dono->offsetAreaJogadorX + pista * LARGURA_PISTA);
+        const auto xVisualCabeca = xBaseNota + (LARGURA_PISTA - larguraVisualCabeca) / 2.f;
+        const auto xCentro = xVisualCabeca + larguraVisualCabeca / 2.f;
+
+        return {xCentro, static_cast<float>(Y_ZONA_ACERTO + ALTURA_ZONA_ACERTO / 2.f)};
+    }
+
+    /**
+     * @brief Obtém os limites da nota para detecção de colisão
+     * @param offsetAreaJogadorX Offset X da área do jogador
+     * @return Retângulo representando os limites da nota
+     */
+    [[nodiscard]] auto obterLimites(const int offsetAreaJogadorX) const -> sf::FloatRect {
+        const auto x = static_cast<float>(offsetAreaJogadorX + pista * LARGURA_PISTA);
+        const auto larguraEfetiva = static_cast<float>(LARGURA_PISTA);
+        return {{x, posicaoY - ALTURA_NOTA / 2.f}, {larguraEfetiva, static_cast<float>(ALTURA_NOTA)}};
+    }
+};
+
+/**
+ * @brief Linha do tempo de notas de um jogador (contabilizada como "notas")
+ */
+using VetorNotas = Memoria::Vetor<Nota, Memoria::Subsistema::Notas>;
+
+// ============================= JANELA DE NOTAS =============================
+
+/**
+ * @brief Janela deslizante sobre as notas de um jogador, com índice de sustains
+ *
+ * As notas são ordenadas por timestamp, então as cabeças entram e saem da tela
+ * na mesma ordem e basta um par de cursores [inicio, fim). Notas longas cuja
+ * cabeça já saiu por baixo mas cuja cauda continua na tela vão para um heap de
+ * mínimo ordenado pelo fim do sustain, de onde saem na ordem em que as caudas
+ * deixam a tela. Cada quadro custa O(log n + k) em vez de O(n).
+ */
+class JanelaNotas {
+private:
+    std::size_t inicio = 0;
+    std::size_t fim = 0;
+    std::vector<std::size_t> sustainsPendentes; // Heap de índices por tempoFimSustainSec
+
+public:
+    /**
+     * @brief Volta a janela para o início da música
+     */
+    void reiniciar() {
+        inicio = 0;
+        fim = 0;
+        sustainsPendentes.clear();
+    }
+
+    /**
+     * @brief Inclui na janela as notas que estão prestes a entrar na tela
+     * @param notas Notas do jogador (ordenadas por timestamp)
+     * @param tempoMusicaSec Tempo atual da música
+     */
+    void avancar(const VetorNotas &notas, const double tempoMusicaSec) {
+        while (fim < notas.size() &&
+               notas[fim].timestampSec - tempoMusicaSec <= ANTECEDENCIA_ENTRADA_NOTA_SEC) {
+            ++fim;
+        }
+    }
+
+    /**
+     * @brief Remove da janela as notas cuja cabeça já saiu da tela
+     *
+     * Deve ser chamado depois de atualizar as posições. Notas longas com cauda
+     * ainda visível passam para o heap de sustains pendentes.
+     * @param notas Notas do jogador
+     */
+    void descartarNotasQueSairam(const VetorNotas &notas) {
+        const auto terminaAntes = [&](const std::size_t a, const std::size_t b) {
+            return notas[a].tempoFimSustainSec > notas[b].tempoFimSustainSec;
+        };
+
+        constexpr float raioCabeca = ALTURA_NOTA / 2.f;
+        while (inicio < fim && notas[inicio].posicaoY - raioCabeca > ALTURA_JANELA) {
+            if (notas[inicio].ehNotaLonga && notas[inicio].naTela) {
+                sustainsPendentes.push_back(inicio);
+                std::ranges::push_heap(sustainsPendentes, terminaAntes);
+            }
+            ++inicio;
+        }
+
+        while (!sustainsPendentes.empty() && !notas[sustainsPendentes.front()].naTela) {
+            std::ranges::pop_heap(sustainsPendentes, terminaAntes);
+            sustainsPendentes.pop_back();
+        }
+    }
+
+    /**
+     * @brief Recoloca a janela num tempo qualquer da música (continuação depois da pausa)
+     *
+     * Os limites saem de buscas binárias com as mesmas condições de avancar e
+     * descartarNotasQueSairam; os sustains pendentes são as notas longas antes
+     * da janela com a cauda ainda visível. As notas da janela antiga perdem
+     * naTela e as da nova já ficam na posição do tempo pedido, com naTela
+     * calculado só pela geometria: sem isso, uma nota que sobe para fora da
+     * tela seria dada como perdida, e o quadro da retomada mostraria a pista
+     * como a pausa a deixou.
+     * @param notas Notas do jogador (ordenadas por timestamp)
+     * @param tempoMusicaSec Tempo da música a partir do qual a janela volta a avançar
+     */
+    void reposicionar(VetorNotas &notas, const double tempoMusicaSec) {
+        paraCadaNota([&](const std::size_t indice) { notas[indice].naTela = false; });
+
+        // Cabeça abaixo da tela: posicaoY - ALTURA_NOTA / 2 > ALTURA_JANELA
+        const auto limiteCabecaSec =
+            tempoMusicaSec - (ALTURA_JANELA + ALTURA_NOTA / 2.0 - Y_ZONA_ACERTO) / VELOCIDADE_QUEDA_NOTA_PPS;
+        inicio = static_cast<std::size_t>(std::ranges::partition_point(notas, [&](const Nota &nota) {
+            return nota.timestampSec < limiteCabecaSec;
+        }) - notas.begin());
+        fim = static_cast<std::size_t>(std::ranges::partition_point(notas, [&](const Nota &nota) {
+            return nota.timestampSec - tempoMusicaSec <= ANTECEDENCIA_ENTRADA_NOTA_SEC;
+        }) - notas.begin());
+        fim = std::max(fim, inicio);
+
+        // Cauda ainda visível: o topo dela não passou de ALTURA_JANELA
+        const auto limiteCaudaSec = tempoMusicaSec - (ALTURA_JANELA - Y_ZONA_ACERTO) / VELOCIDADE_QUEDA_NOTA_PPS;
+        sustainsPendentes.clear();
+        for (std::size_t indice = 0; indice < inicio; ++indice) {
+            if (notas[indice].ehNotaLonga && notas[indice].tempoFimSustainSec > limiteCaudaSec) {
+                sustainsPendentes.push_back(indice);
+            }
+        }
+        std::ranges::make_heap(sustainsPendentes, [&](const std::size_t a, const std::size_t b) {
+            return notas[a].tempoFimSustainSec > notas[b].tempoFimSustainSec;
+        });
+
+        constexpr float raioCabeca = ALTURA_NOTA / 2.f;
+        paraCadaNota([&](const std::size_t indice) {
+            auto &nota = notas[indice];
+            const auto tempoAteAcerto = nota.timestampSec - tempoMusicaSec;
+            nota.posicaoY = static_cast<float>(Y_ZONA_ACERTO - tempoAteAcerto * VELOCIDADE_QUEDA_NOTA_PPS);
+            const auto pixelsSustain = static_cast<float>(
+                (nota.tempoFimSustainSec - nota.timestampSec) * VELOCIDADE_QUEDA_NOTA_PPS);
+            const auto comprimento = nota.ehNotaLonga ? std::max(0.f, pixelsSustain) : raioCabeca;
+            nota.naTela = nota.posicaoY + raioCabeca > 0 && nota.posicaoY - comprimento < ALTURA_JANELA;
+        });
+    }
+
+    /**
+     * @brief Visita os índices das notas relevantes (sustains pendentes e janela)
+     * @param visitante Função chamada com o índice de cada nota
+     */
+    template <typename Visitante>
+    void paraCadaNota(Visitante &&visitante) const {
+        for (const auto indice : sustainsPendentes) {
+            visitante(indice);
+        }
+        for (auto indice = inicio; indice < fim; ++indice) {
+            visitante(indice);
+        }
+    }
+};
+
+// ============================= EDITOR DE CHARTS =============================
+
+/**
+ * @brief Edição de notas, tempos e assinaturas dentro do jogo
+ *
+ * As notas ficam em blocos ordenados por (tick, traste): inserir, remover e
+ * buscar custam uma busca binária entre blocos e outra dentro de um bloco
+ * pequeno, e percorrer um intervalo visita só as notas dele. Os segundos das
+ * notas não são guardados; a tela converte apenas as visíveis, então editar um
+ * tempo custa o recálculo dos segmentos seguintes, e não do chart inteiro.
+ */
+namespace Editor {
+    using Chart::NotaChart;
+
+    /**
+     * @brief Notas ordenadas por (tick, traste) em blocos de tamanho limitado
+     */
+    class ArmazemNotas {
+    private:
+        using Bloco = Memoria::Vetor<NotaChart, Memoria::Subsistema::Chart>;
+
+        std::vector<Bloco> blocos; // Nunca vazios
+        std::size_t quantidade = 0;
+        int maiorComprimento = 0;  // Limite superior; não diminui ao remover
+
+        static bool antes(const NotaChart &a, const NotaChart &b) {
+            return std::tie(a.tick, a.traste) < std::tie(b.tick, b.traste);
+        }
+
+        /**
+         * @brief Primeiro bloco cujo último elemento não vem antes da chave (ou o último bloco)
+         */
+        [[nodiscard]] std::size_t indiceBloco(const NotaChart &chave) const {
+            const auto it = std::ranges::partition_point(blocos, [&](const Bloco &bloco) {
+                return antes(bloco.back(), chave);
+            });
+            return std::min(static_cast<std::size_t>(it - blocos.begin()), blocos.size() - 1);
+        }
+
+    public:
+        /**
+         * @brief Substitui o conteúdo; notas repetidas (mesmo tick e traste) são descartadas
+         */
+        void carregar(const std::span<const NotaChart> notas) {
+            std::vector<NotaChart> ordenadas(notas.begin(), notas.end());
+            std::ranges::stable_sort(ordenadas, antes);
+            const auto repetidas = std::ranges::unique(ordenadas, [](const NotaChart &a, const NotaChart &b) {
+                return a.tick == b.tick && a.traste == b.traste;
+            });
+            ordenadas.erase(repetidas.begin(), repetidas.end());
+
+            blocos.clear();
+            maiorComprimento = 0;
+            for (std::size_t i = 0; i < ordenadas.size(); i += NOTAS_POR_BLOCO_EDITOR) {
+                const auto fim = std::min(ordenadas.size(), i + NOTAS_POR_BLOCO_EDITOR);
+                blocos.emplace_back(ordenadas.begin() + static_cast<std::ptrdiff_t>(i),
+                                    ordenadas.begin() + static_cast<std::ptrdiff_t>(fim));
+            }
+            for (const auto &nota : ordenadas) maiorComprimento = std::max(maiorComprimento, nota.comprimento);
+            quantidade = ordenadas.size();
+        }
+
+        /**
+         * @brief Copia todas as notas, em ordem, para o vetor do chart
+         */
+        template <typename Vetor>
+        void exportar(Vetor &destino) const {
+            destino.clear();
+            destino.reserve(quantidade);
+            for (const auto &bloco : blocos) destino.insert(destino.end(), bloco.begin(), bloco.end());
+        }
+
+        /**
+         * @brief Insere uma nota
+         * @return False se já existe nota no mesmo tick e traste
+         */
+        bool inserir(const NotaChart &nota) {
+            if (blocos.empty()) {
+                blocos.emplace_back(1, nota);
+            } else {
+                auto &bloco = blocos[indiceBloco(nota)];
+                const auto it = std::ranges::lower_bound(bloco, nota, antes);
+                if (it != bloco.end() && it->tick == nota.tick && it->traste == nota.traste) return false;
+                bloco.insert(it, nota);
+
+                if (bloco.size() > 2 * NOTAS_POR_BLOCO_EDITOR) {
+                    const auto indice = static_cast<std::size_t>(&bloco - blocos.data());
+                    Bloco metade(bloco.begin() + NOTAS_POR_BLOCO_EDITOR, bloco.end());
+                    bloco.erase(bloco.begin() + NOTAS_POR_BLOCO_EDITOR, bloco.end());
+                    blocos.insert(blocos.begin() + static_cast<std::ptrdiff_t>(indice) + 1, std::move(metade));
+                }
+            }
+            ++quantidade;
+            maiorComprimento = std::max(maiorComprimento, nota.comprimento);
+            return true;
+        }
+
+        /**
+         * @brief Remove a nota do tick e traste
+         * @return A nota removida, se existia
+         */
+        std::optional<NotaChart> remover(const int tick, const int traste) {
+            if (blocos.empty()) return std::nullopt;
+            const NotaChart chave(tick, traste, 0);
+            const auto indice = indiceBloco(chave);
+            auto &bloco = blocos[indice];
+            const auto it = std::ranges::lower_bound(bloco, chave, antes);
+            if (it == bloco.end() || it->tick != tick || it->traste != traste) return std::nullopt;
+
+            const auto removida = *it;
+            bloco.erase(it);
+            if (bloco.empty()) blocos.erase(blocos.begin() + static_cast<std::ptrdiff_t>(indice));
+            --quantidade;
+            return removida;
+        }
+
+        [[nodiscard]] const NotaChart *procurar(const int tick, const int traste) const {
+            if (blocos.empty()) return nullptr;
+            const NotaChart chave(tick, traste, 0);
+            const auto &bloco = blocos[indiceBloco(chave)];
+            const auto it = std::ranges::lower_bound(bloco, chave, antes);
+            return it != bloco.end() && it->tick == tick && it->traste == traste ? &*it : nullptr;
+        }
+
+        /**
+         * @brief Visita, em ordem, as notas com tick em [tickInicio, tickFim)
+         */
+        template <typename Visitante>
+        void paraCadaNoIntervalo(const int tickInicio, const int tickFim, Visitante &&visitante) const {
+            if (blocos.empty()) return;
+            const NotaChart chave(tickInicio, std::numeric_limits<int>::min(), 0);
+            for (auto indice = indiceBloco(chave); indice < blocos.size(); ++indice) {
+                const auto &bloco = blocos[indice];
+                for (auto it = std::ranges::lower_bound(bloco, chave, antes); it != bloco.end(); ++it) {
+                    if (it->tick >= tickFim) return;
+                    visitante(*it);
+                }
+            }
+        }
+
+        [[nodiscard]] std::vector<NotaChart> notasNoTick(const int tick) const {
+            std::vector<NotaChart> notas;
+            paraCadaNoIntervalo(tick, tick + 1, [&](const NotaChart &nota) { notas.push_back(nota); });
+            return notas;
+        }
+
+        [[nodiscard]] std::size_t tamanho() const {
+            return quantidade;
+        }
+
+        [[nodiscard]] int comprimentoMaximo() const {
+            return maiorComprimento;
+        }
+    };
+
+    struct AlteracaoTempo {
+        int tick;
+        std::optional<int> anterior; // Valor bruto (BPM * 1000); vazio = sem marcador
+        std::optional<int> novo;
+    };
+
+    struct AlteracaoAssinatura {
+        int tick;
+        std::optional<std::pair<int, int>> anterior; // (numerador, denominador)
+        std::optional<std::pair<int, int>> novo;
+    };
+
+    /**
+     * @brief Uma edição e o necessário para desfazê-la
+     */
+    struct Edicao {
+        std::vector<NotaChart> removidas;
+        std::vector<NotaChart> inseridas;
+        std::vector<AlteracaoTempo> tempos;
+        std::vector<AlteracaoAssinatura> assinaturas;
+        int tickCursor = 0;
+
+        [[nodiscard]] bool vazia() const {
+            return removidas.empty() && inseridas.empty() && tempos.empty() && assinaturas.empty();
+        }
+    };
+
+    /**
+     * @brief Estado do editor: cursor, grade, notas e histórico de edições
+     *
+     * As notas vivem no armazém enquanto o editor está aberto; tempos e
+     * assinaturas são alterados direto no chart e na calculadora de tempo.
+     */
+    class Sessao {
+    private:
+        Chart::DadosChart &chart;
+        Chart::CalculadoraTempo &calculadora;
+        ArmazemNotas armazem;
+        std::deque<Edicao> historicoDesfazer;
+        std::deque<Edicao> historicoRefazer;
+        int tickCursor = 0;
+        std::size_t indiceDivisao = 3; // 1/16
+        bool modificado = false;
+        bool naoGravado = false;
+
+        void definirTempo(const int tick, const std::optional<int> valorBruto) {
+            if (valorBruto) {
+                const Chart::MudancaTempo mudanca(tick, *valorBruto);
+                chart.mudancasTempo.insert_or_assign(tick, mudanca);
+                calculadora.definirMudanca(mudanca);
+            } else {
+                chart.mudancasTempo.erase(tick);
+                calculadora.removerMudanca(tick);
+            }
+        }
+
+        void definirAssinatura(const int tick, const std::optional<std::pair<int, int>> valor) {
+            if (valor) {
+                chart.assinaturasTempo.insert_or_assign(tick, Chart::AssinaturaTempo(tick, valor->first, valor->second));
+            } else {
+                chart.assinaturasTempo.erase(tick);
+            }
+        }
+
+        void aplicar(const Edicao &edicao, const bool inverso) {
+            for (const auto &nota : inverso ? edicao.inseridas : edicao.removidas) armazem.remover(nota.tick, nota.traste);
+            for (const auto &nota : inverso ? edicao.removidas : edicao.inseridas) armazem.inserir(nota);
+            for (const auto &alteracao : edicao.tempos) {
+                definirTempo(alteracao.tick, inverso ? alteracao.anterior : alteracao.novo);
+            }
+            for (const auto &alteracao : edicao.assinaturas) {
+                definirAssinatura(alteracao.tick, inverso ? alteracao.anterior : alteracao.novo);
+            }
+        }
+
+        void executar(Edicao edicao) {
+            if (edicao.vazia()) return;
+            edicao.tickCursor = tickCursor;
+            aplicar(edicao, false);
+            historicoDesfazer.push_back(std::move(edicao));
+            if (historicoDesfazer.size() > LIMITE_HISTORICO_EDITOR) historicoDesfazer.pop_front();
+            historicoRefazer.clear();
+            modificado = true;
+            naoGravado = true;
+        }
+
+        [[nodiscard]] std::optional<int> tempoNoTick(const int tick) const {
+            const auto it = chart.mudancasTempo.find(tick);
+            return it != chart.mudancasTempo.end() ? std::optional(it->second.valorBruto) : std::nullopt;
+        }
+
+        [[nodiscard]] std::optional<std::pair<int, int>> assinaturaNoTick(const int tick) const {
+            const auto it = chart.assinaturasTempo.find(tick);
+            if (it == chart.assinaturasTempo.end()) return std::nullopt;
+            return std::pair(it->second.numerador, it->second.denominador);
+        }
+
+    public:
+        Sessao(Chart::DadosChart &dados, Chart::CalculadoraTempo &calculadoraTempo)
+            : chart(dados), calculadora(calculadoraTempo) {
+            armazem.carregar(chart.notas);
+        }
+
+        /**
+         * @brief Devolve as notas editadas ao chart (também antes de gravar; a sessão continua válida)
+         */
+        void concluir() {
+            armazem.exportar(chart.notas);
+        }
+
+        // ----- Cursor e grade -----
+
+        [[nodiscard]] int passoGrade() const {
+            return std::max(1, chart.resolucao * 4 / DIVISOES_GRADE_EDITOR[indiceDivisao]);
+        }
+
+        void alterarDivisao(const int delta) {
+            const auto novo = static_cast<int>(indiceDivisao) + delta;
+            indiceDivisao = static_cast<std::size_t>(std::clamp(novo, 0, static_cast<int>(DIVISOES_GRADE_EDITOR.size()) - 1));
+        }
+
+        /**
+         * @brief Anda pela grade; um cursor fora da grade primeiro encaixa na direção do movimento
+         */
+        void moverCursor(const int passos) {
+            const auto passo = passoGrade();
+            const auto abaixo = tickCursor / passo * passo;
+            const auto base = passos > 0 || abaixo == tickCursor ? abaixo : abaixo + passo;
+            tickCursor = std::max(0, base + passos * passo);
+        }
+
+        void moverCursorCompasso(const int compassos) {
+            const auto [numerador, denominador] = assinaturaEm(tickCursor);
+            tickCursor = std::max(0, tickCursor + compassos * (numerador * chart.resolucao * 4 / denominador));
+        }
+
+        void posicionarCursor(const int tick) {
+            tickCursor = std::max(0, tick);
+        }
+
+        /**
+         * @brief Segue o áudio durante a reprodução (fora da grade)
+         */
+        void posicionarEmSegundos(const double segundos) {
+            tickCursor = static_cast<int>(calculadora.segundosParaTicks(segundos));
+        }
+
+        void encaixarNaGrade() {
+            const auto passo = passoGrade();
+            tickCursor = (tickCursor + passo / 2) / passo * passo;
+        }
+
+        /**
+         * @brief Assinatura em vigor no tick (4/4 antes da primeira)
+         */
+        [[nodiscard]] std::pair<int, int> assinaturaEm(const int tick) const {
+            auto it = chart.assinaturasTempo.upper_bound(tick);
+            if (it == chart.assinaturasTempo.begin()) return {4, 4};
+            --it;
+            return {std::max(1, it->second.numerador), std::max(1, it->second.denominador)};
+        }
+
+        [[nodiscard]] bool ehInicioCompasso(const int tick) const {
+            auto it = chart.assinaturasTempo.upper_bound(tick);
+            const auto inicio = it == chart.assinaturasTempo.begin() ? 0 : std::prev(it)->first;
+            const auto [numerador, denominador] = assinaturaEm(tick);
+            const auto comprimento = std::max(1, numerador * chart.resolucao * 4 / denominador);
+            return (tick - inicio) % comprimento == 0;
+        }
+
+        // ----- Edições -----
+
+        /**
+         * @brief Coloca uma nota no cursor, ou remove a que já está lá
+         */
+        void alternarNota(const int traste) {
+            Edicao edicao;
+            if (const auto *existente = armazem.procurar(tickCursor, traste)) {
+                edicao.removidas.push_back(*existente);
+            } else {
+                edicao.inseridas.emplace_back(tickCursor, traste, 0);
+            }
+            executar(std::move(edicao));
+        }
+
+        /**
+         * @brief Move as notas do cursor alguns passos da grade; o cursor vai junto
+         */
+        void moverNotasNoCursor(const int passos) {
+            const auto destino = tickCursor + passos * passoGrade();
+            const auto notas = armazem.notasNoTick(tickCursor);
+            if (destino < 0 || notas.empty()) return;
+
+            Edicao edicao;
+            for (const auto &nota : notas) {
+                edicao.removidas.push_back(nota);
+                // Nota que já ocupava o destino é substituída
+                if (const auto *ocupante = armazem.procurar(destino, nota.traste)) edicao.removidas.push_back(*ocupante);
+                edicao.inseridas.emplace_back(destino, nota.traste, nota.comprimento);
+            }
+            executar(std::move(edicao));
+            tickCursor = destino;
+        }
+
+        void ajustarSustain(const int passos) {
+            Edicao edicao;
+            for (const auto &nota : armazem.notasNoTick(tickCursor)) {
+                if (nota.traste >= NUMERO_PISTAS) continue; // Marcadores (force, tap)
+                const auto comprimento = std::max(0, nota.comprimento + passos * passoGrade());
+                if (comprimento == nota.comprimento) continue;
+                edicao.removidas.push_back(nota);
+                edicao.inseridas.emplace_back(nota.tick, nota.traste, comprimento);
+            }
+            executar(std::move(edicao));
+        }
+
+        /**
+         * @brief Muda o BPM a partir do cursor (cria um marcador nele se preciso)
+         * @param deltaBruto Variação em milésimos de BPM
+         */
+        void ajustarBpm(const int deltaBruto) {
+            const auto atual = calculadora.mudancaEm(tickCursor).valorBruto;
+            const auto novo = std::max(1000, atual + deltaBruto);
+            if (novo == atual) return;
+            Edicao edicao;
+            edicao.tempos.push_back({tickCursor, tempoNoTick(tickCursor), novo});
+            executar(std::move(edicao));
+        }
+
+        void ajustarNumeradorAssinatura(const int delta) {
+            const auto [numerador, denominador] = assinaturaEm(tickCursor);
+            const auto novo = std::clamp(numerador + delta, 1, 32);
+            if (novo == numerador) return;
+            Edicao edicao;
+            edicao.assinaturas.push_back({tickCursor, assinaturaNoTick(tickCursor), std::pair(novo, denominador)});
+            executar(std::move(edicao));
+        }
+
+        /**
+         * @brief Remove os marcadores de tempo e assinatura que estão no cursor
+         */
+        void removerMarcadoresNoCursor() {
+            Edicao edicao;
+            if (const auto tempo = tempoNoTick(tickCursor)) edicao.tempos.push_back({tickCursor, tempo, std::nullopt});
+            if (const auto assinatura = assinaturaNoTick(tickCursor)) {
+                edicao.assinaturas.push_back({tickCursor, assinatura, std::nullopt});
+            }
+            executar(std::move(edicao));
+        }
+
+        bool desfazer() {
+            if (historicoDesfazer.empty()) return false;
+            auto edicao = std::move(historicoDesfazer.back());
+            historicoDesfazer.pop_back();
+            aplicar(edicao, true);
+            tickCursor = edicao.tickCursor;
+            historicoRefazer.push_back(std::move(edicao));
+            modificado = true;
+            naoGravado = true;
+            return true;
+        }
+
+        bool refazer() {
+            if (historicoRefazer.empty()) return false;
+            auto edicao = std::move(historicoRefazer.back());
+            historicoRefazer.pop_back();
+            aplicar(edicao, false);
+            tickCursor = edicao.tickCursor;
+            historicoDesfazer.push_back(std::move(edicao));
+            modificado = true;
+            naoGravado = true;
+            return true;
+        }
+
+        // ----- Consulta -----
+
+        [[nodiscard]] const ArmazemNotas &notas() const {
+            return armazem;
+        }
+
+        [[nodiscard]] const Chart::DadosChart &dados() const {
+            return chart;
+        }
+
+        [[nodiscard]] const Chart::CalculadoraTempo &tempo() const {
+            return calculadora;
+        }
+
+        [[nodiscard]] int cursor() const {
+            return tickCursor;
+        }
+
+        [[nodiscard]] int divisao() const {
+            return DIVISOES_GRADE_EDITOR[indiceDivisao];
+        }
+
+        [[nodiscard]] std::size_t edicoesParaDesfazer() const {
+            return historicoDesfazer.size();
+        }
+
+        [[nodiscard]] std::size_t edicoesParaRefazer() const {
+            return historicoRefazer.size();
+        }
+
+        [[nodiscard]] bool foiModificado() const {
+            return modificado;
+        }
+
+        [[nodiscard]] bool temAlteracoesNaoGravadas() const {
+            return naoGravado;
+        }
+
+        void marcarGravado() {
+            naoGravado = false;
+        }
+    };
+}
+
+// ============================= MÉTRICAS (PROMETHEUS) =============================
+
+/**
+ * @brief Métricas agregadas para monitoramento da frota
+ *
+ * O caminho quente só faz incrementos atômicos relaxados; a formatação em
+ * texto acontece na thread do servidor, no momento da coleta.
+ */
+namespace Metricas {
+    constexpr std::array<double, 9> LIMITES_QUADRO_SEC = {0.002, 0.004, 0.008, 0.016, 0.025, 0.033, 0.05, 0.1, 0.25};
+
+    enum class FaseCarga { Parsing, ConversaoNotas, Audio, Total };
+    constexpr std::array<std::string_view, 4> NOMES_FASES_CARGA = {"parsing", "conversao_notas", "audio", "total"};
+
+    enum class Julgamento { Perfeito, Otimo, Bom, Erro };
+    constexpr std::array<std::string_view, 4> NOMES_JULGAMENTOS = {"perfeito", "otimo", "bom", "erro"};
+
+    /**
+     * @brief Classifica um acerto pelo erro de tempo
+     * @param erroMs Diferença absoluta entre o tempo da nota e o da tecla
+     */
+    [[nodiscard]] constexpr auto julgarAcerto(const double erroMs) -> Julgamento {
+        if (erroMs <= JANELA_PERFEITO_MS) return Julgamento::Perfeito;
+        if (erroMs <= JANELA_OTIMO_MS) return Julgamento::Otimo;
+        return Julgamento::Bom;
+    }
+
+    /**
+     * @brief Lê a memória residente do processo (0 se indisponível)
+     */
+    [[nodiscard]] inline auto memoriaResidenteBytes() -> std::uint64_t {
+#if defined(__linux__)
+        std::ifstream statm("/proc/self/statm");
+        std::uint64_t paginasTotais = 0, paginasResidentes = 0;
+        if (statm >> paginasTotais >> paginasResidentes) {
+            return paginasResidentes * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+        }
+#endif
+        return 0;
+    }
+
+    /**
+     * @brief Contadores atômicos alimentados pelo jogo
+     */
+    class Registro {
+    private:
+        std::array<std::atomic<std::uint64_t>, LIMITES_QUADRO_SEC.size() + 1> baldesQuadro{};
+        std::atomic<std::uint64_t> somaQuadroUs{0};
+        std::atomic<std::uint64_t> travamentos{0};
+        std::atomic<std::uint64_t> musicasTocadas{0};
+        std::array<std::atomic<std::int64_t>, NOMES_FASES_CARGA.size()> tempoCargaUs{};
+        std::array<std::atomic<std::uint64_t>, NOMES_JULGAMENTOS.size()> julgamentos{};
+
+    public:
+        void registrarQuadro(const sf::Time duracao) {
+            const auto segundos = static_cast<double>(duracao.asMicroseconds()) / 1'000'000.0;
+            const auto balde = std::ranges::lower_bound(LIMITES_QUADRO_SEC, segundos) - LIMITES_QUADRO_SEC.begin();
+            baldesQuadro[balde].fetch_add(1, std::memory_order_relaxed);
+            somaQuadroUs.fetch_add(static_cast<std::uint64_t>(std::max<std::int64_t>(0, duracao.asMicroseconds())),
+                                   std::memory_order_relaxed);
+            if (duracao > LIMIAR_TRAVAMENTO_QUADRO) {
+                travamentos.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        void registrarMusicaTocada() {
+            musicasTocadas.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void registrarCarga(const FaseCarga fase, const sf::Time duracao) {
+            tempoCargaUs[static_cast<size_t>(fase)].store(duracao.asMicroseconds(), std::memory_order_relaxed);
+        }
+
+        void registrarJulgamento(const Julgamento julgamento) {
+            julgamentos[static_cast<size_t>(julgamento)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Gera o texto no formato de exposição do Prometheus
+         */
+        [[nodiscard]] auto formatar() const -> std::string {
+            std::ostringstream oss;
+            oss.imbue(std::locale::classic());
+
+            oss << "# HELP riff_hero_quadro_segundos Duração dos quadros.\n"
+                << "# TYPE riff_hero_quadro_segundos histogram\n";
+            std::uint64_t acumulado = 0;
+            for (size_t i = 0; i < LIMITES_QUADRO_SEC.size(); ++i) {
+                acumulado += baldesQuadro[i].load(std::memory_order_relaxed);
+                oss << "riff_hero_quadro_segundos_bucket{le=\"" << LIMITES_QUADRO_SEC[i] << "\"} " << acumulado << "\n";
+            }
+            acumulado += baldesQuadro.back().load(std::memory_order_relaxed);
+            oss << "riff_hero_quadro_segundos_bucket{le=\"+Inf\"} " << acumulado << "\n"
+                << "riff_hero_quadro_segundos_sum "
+                << static_cast<double>(somaQuadroUs.load(std::memory_order_relaxed)) / 1'000'000.0 << "\n"
+                << "riff_hero_quadro_segundos_count " << acumulado << "\n";
+
+            oss << "# HELP riff_hero_travamentos_total Quadros acima de "
+                << LIMIAR_TRAVAMENTO_QUADRO.asMilliseconds() << " ms.\n"
+                << "# TYPE riff_hero_travamentos_total counter\n"
+                << "riff_hero_travamentos_total " << travamentos.load(std::memory_order_relaxed) << "\n";
+
+            oss << "# HELP riff_hero_musicas_tocadas_total Músicas iniciadas.\n"
+                << "# TYPE riff_hero_musicas_tocadas_total counter\n"
+                << "riff_hero_musicas_tocadas_total " << musicasTocadas.load(std::memory_order_relaxed) << "\n";
+
+            oss << "# HELP riff_hero_carga_segundos Duração de cada fase da última carga de música.\n"
+                << "# TYPE riff_hero_carga_segundos gauge\n";
+            for (size_t i = 0; i < NOMES_FASES_CARGA.size(); ++i) {
+                oss << "riff_hero_carga_segundos{fase=\"" << NOMES_FASES_CARGA[i] << "\"} "
+                    << static_cast<double>(tempoCargaUs[i].load(std::memory_order_relaxed)) / 1'000'000.0 << "\n";
+            }
+
+            oss << "# HELP riff_hero_julgamentos_total Notas julgadas por nível.\n"
+                << "# TYPE riff_hero_julgamentos_total counter\n";
+            for (size_t i = 0; i < NOMES_JULGAMENTOS.size(); ++i) {
+                oss << "riff_hero_julgamentos_total{nivel=\"" << NOMES_JULGAMENTOS[i] << "\"} "
+                    << julgamentos[i].load(std::memory_order_relaxed) << "\n";
+            }
+
+            oss << "# HELP riff_hero_memoria_residente_bytes Memória residente do processo.\n"
+                << "# TYPE riff_hero_memoria_residente_bytes gauge\n"
+                << "riff_hero_memoria_residente_bytes " << memoriaResidenteBytes() << "\n";
+
+            oss << "# HELP riff_hero_memoria_subsistema_bytes Memória atual por subsistema.\n"
+                << "# TYPE riff_hero_memoria_subsistema_bytes gauge\n";
+            for (size_t i = 0; i < Memoria::NOMES_SUBSISTEMAS.size(); ++i) {
+                oss << "riff_hero_memoria_subsistema_bytes{subsistema=\"" << Memoria::NOMES_SUBSISTEMAS[i] << "\"} "
+                    << Memoria::atual(static_cast<Memoria::Subsistema>(i)) << "\n";
+            }
+            oss << "# HELP riff_hero_memoria_subsistema_pico_bytes Pico de memória por subsistema.\n"
+                << "# TYPE riff_hero_memoria_subsistema_pico_bytes gauge\n";
+            for (size_t i = 0; i < Memoria::NOMES_SUBSISTEMAS.size(); ++i) {
+                oss << "riff_hero_memoria_subsistema_pico_bytes{subsistema=\"" << Memoria::NOMES_SUBSISTEMAS[i] << "\"} "
+                    << Memoria::pico(static_cast<Memoria::Subsistema>(i)) << "\n";
+            }
+
+            return oss.str();
+        }
+    };
+}
+
+// ============================= GRAVADOR DE VOO =============================
+
+/**
+ * @brief Gravação contínua de zonas de tempo para diagnosticar travamentos raros
+ */
+namespace Rastreamento {
+    /**
+     * @brief Zona de tempo (ou evento instantâneo, com duração negativa)
+     */
+    struct Zona {
+        const char *nome = ""; // Sempre um literal: o anel não aloca
+        std::int64_t inicioUs = 0;
+        std::int64_t duracaoUs = 0;
+        std::int64_t quadro = 0;
+        std::uint8_t trilha = 0; // 0 = CPU, 1 = GPU
+    };
+
+    /**
+     * @brief Anel de tamanho fixo com as zonas mais recentes e um despejo assíncrono
+     *
+     * O registro no anel não aloca nem espera: a trava só é disputada durante a
+     * cópia de um despejo. Quando um travamento é detectado, o anel é copiado para
+     * um buffer pré-alocado e uma thread em segundo plano grava o arquivo no
+     * formato Chrome Trace (abre em chrome://tracing ou Perfetto).
+     *
+     * Há dois detectores. O laço principal pede o despejo depois de um quadro
+     * acima de LIMIAR_TRAVAMENTO_QUADRO; a thread de despejo vigia o batimento
+     * de novoQuadro e despeja sozinha quando o laço passa de LIMIAR_SEM_RESPOSTA
+     * sem bater, o caso de um quadro que nunca termina (deadlock, driver preso).
+     */
+    class GravadorVoo {
+    private:
+        std::vector<Zona> anel = std::vector<Zona>(CAPACIDADE_GRAVADOR_VOO); // No heap: Jogo vive na pilha
+        std::atomic_flag travaAnel; // Protege anel, proximo, ocupadas e quadroAtual
+        std::size_t proximo = 0;
+        std::size_t ocupadas = 0;
+        std::int64_t quadroAtual = 0;
+        std::atomic<std::int64_t> batimentoUs{-1}; // Início do quadro atual; negativo antes do primeiro
+        sf::Clock relogioBase;
+
+        // Da thread que ganhou `gravando`, até a gravação terminar
+        std::filesystem::path diretorio;
+        std::vector<Zona> copiaDespejo;
+        std::int64_t duracaoTravamentoUs = 0;
+        std::int64_t quadroTravamento = 0;
+        bool travamentoSemResposta = false;
+        sf::Clock relogioDespejos;
+        int despejosFeitos = 0;
+
+        std::mutex mutexDespejo;
+        std::condition_variable_any sinalDespejo;
+        bool despejoPendente = false;
+        std::atomic<bool> gravando{false};
+        std::jthread threadDespejo;
+
+        /**
+         * @brief Grava a cópia do anel em disco (thread de despejo)
+         */
+        void gravarArquivo() {
+            std::error_code erro;
+            std::filesystem::create_directories(diretorio, erro);
+
+            const auto caminho = diretorio / ("travamento_q" + std::to_string(quadroTravamento) + ".json");
+            std::ofstream arquivo(caminho);
+            if (!arquivo) {
+                Log::erro("Não foi possível gravar ", caminho);
+                return;
+            }
+
+            arquivo << "{\"otherData\":{\"quadro\":" << quadroTravamento << ",\"duracao_us\":" << duracaoTravamentoUs
+                    << ",\"sem_resposta\":" << (travamentoSemResposta ? "true" : "false") << "},\"traceEvents\":["
+                    << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},"
+                    << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+            for (const auto &zona : copiaDespejo) {
+                arquivo << ",{\"name\":\"" << zona.nome << "\",\"pid\":1,\"tid\":" << zona.trilha + 1 << ",\"ts\":"
+                        << zona.inicioUs;
+                if (zona.duracaoUs >= 0) {
+                    arquivo << ",\"ph\":\"X\",\"dur\":" << zona.duracaoUs;
+                } else {
+                    arquivo << ",\"ph\":\"i\",\"s\":\"t\"";
+                }
+                arquivo << ",\"args\":{\"quadro\":" << zona.quadro << "}}";
+            }
+            arquivo << "]}\n";
+
+            Log::aviso(travamentoSemResposta ? "Laço principal sem resposta, gravado em " : "Travamento gravado em ",
+                       caminho, " (", duracaoTravamentoUs / 1000.0, " ms)");
+        }
+
+        template <typename Funcao>
+        void comAnelTravado(Funcao &&funcao) {
+            while (travaAnel.test_and_set(std::memory_order_acquire)) {
+                travaAnel.wait(true, std::memory_order_relaxed);
+            }
+            funcao();
+            travaAnel.clear(std::memory_order_release);
+            travaAnel.notify_one();
+        }
+
+        void gravarNoAnel(const Zona &zona) {
+            comAnelTravado([&] {
+                anel[proximo] = zona;
+                proximo = (proximo + 1) % anel.size();
+                ocupadas = std::min(ocupadas + 1, anel.size());
+            });
+        }
+
+        /**
+         * @brief Copia o anel para o despejo se a gravação estiver livre e fora do intervalo mínimo
+         * @return True se a cópia foi feita; a thread de despejo grava e libera `gravando`
+         */
+        bool capturar(const sf::Time duracao, const bool semResposta) {
+            if (gravando.exchange(true, std::memory_order_acquire)) return false;
+            if (despejosFeitos >= MAX_DESPEJOS_POR_SESSAO ||
+                (despejosFeitos > 0 && relogioDespejos.getElapsedTime() < INTERVALO_MINIMO_DESPEJOS)) {
+                gravando.store(false, std::memory_order_release);
+                return false;
+            }
+
+            // Copia em ordem cronológica; a capacidade já está reservada
+            comAnelTravado([&] {
+                copiaDespejo.clear();
+                const auto inicio = (proximo + anel.size() - ocupadas) % anel.size();
+                for (std::size_t i = 0; i < ocupadas; ++i) {
+                    copiaDespejo.push_back(anel[(inicio + i) % anel.size()]);
+                }
+                quadroTravamento = quadroAtual;
+            });
+            duracaoTravamentoUs = duracao.asMicroseconds();
+            travamentoSemResposta = semResposta;
+            ++despejosFeitos;
+            relogioDespejos.restart();
+            return true;
+        }
+
+        void executarDespejos(const std::stop_token &parar) {
+            std::int64_t batimentoDespejado = -1;
+            while (true) {
+                bool pedido = false;
+                {
+                    std::unique_lock trava(mutexDespejo);
+                    sinalDespejo.wait_for(trava, parar, INTERVALO_VIGIA, [this] { return despejoPendente; });
+                    if (parar.stop_requested()) return;
+                    pedido = std::exchange(despejoPendente, false);
+                }
+                if (!pedido) {
+                    // Um despejo por quadro preso: o próximo só depois que o laço voltar a bater
+                    const auto batimento = batimentoUs.load(std::memory_order_acquire);
+                    const auto semBaterUs = agoraUs() - batimento;
+                    if (batimento < 0 || batimento == batimentoDespejado ||
+                        semBaterUs < LIMIAR_SEM_RESPOSTA.asMicroseconds() ||
+                        !capturar(sf::microseconds(semBaterUs), true)) {
+                        continue;
+                    }
+                    batimentoDespejado = batimento;
+                }
+                gravarArquivo();
+                gravando.store(false, std::memory_order_release);
+            }
+        }
+
+    public:
+        /**
+         * @brief Inicia a thread de despejo
+         * @param diretorioSaida Onde gravar os arquivos de travamento
+         */
+        void iniciar(const std::filesystem::path &diretorioSaida) {
+            diretorio = diretorioSaida;
+            copiaDespejo.reserve(anel.size());
+            threadDespejo = std::jthread([this](const std::stop_token &parar) { executarDespejos(parar); });
+        }
+
+        [[nodiscard]] auto agoraUs() const -> std::int64_t {
+            return relogioBase.getElapsedTime().asMicroseconds();
+        }
+
+        /**
+         * @brief Começa um quadro; também é o batimento que a thread de despejo vigia
+         */
+        void novoQuadro() {
+            comAnelTravado([this] { ++quadroAtual; });
+            batimentoUs.store(agoraUs(), std::memory_order_release);
+        }
+
+        // Só a thread principal escreve quadroAtual, então ela lê sem trava
+        [[nodiscard]] auto quadro() const -> std::int64_t {
+            return quadroAtual;
+        }
+
+        void registrar(const char *nome, const std::int64_t inicioUs, const std::int64_t duracaoUs) {
+            gravarNoAnel({nome, inicioUs, duracaoUs, quadroAtual});
+        }
+
+        /**
+         * @brief Registra uma zona medida na GPU, chegada alguns quadros depois
+         * @param nome Nome da zona (literal)
+         * @param inicioUs Instante em que o passo foi submetido pela CPU
+         * @param duracaoUs Tempo de execução na GPU
+         * @param quadroOrigem Quadro em que o passo foi submetido
+         */
+        void registrarGpu(const char *nome, const std::int64_t inicioUs, const std::int64_t duracaoUs,
+                          const std::int64_t quadroOrigem) {
+            gravarNoAnel({nome, inicioUs, duracaoUs, quadroOrigem, 1});
+        }
+
+        void registrarEvento(const char *nome) {
+            registrar(nome, agoraUs(), -1);
+        }
+
+        /**
+         * @brief Pede o despejo do anel se a thread estiver livre e fora do intervalo mínimo
+         * @param duracaoQuadro Duração do quadro que travou
+         */
+        void solicitarDespejo(const sf::Time duracaoQuadro) {
+            if (!threadDespejo.joinable() || !capturar(duracaoQuadro, false)) return;
+
+            {
+                std::lock_guard trava(mutexDespejo);
+                despejoPendente = true;
+            }
+            sinalDespejo.notify_one();
+        }
+    };
+
+    /**
+     * @brief Registra no gravador o tempo entre construção e destruição
+     */
+    class ZonaTempo {
+    private:
+        GravadorVoo &gravador;
+        const char *nome;
+        std::int64_t inicioUs;
+
+    public:
+        ZonaTempo(GravadorVoo &g, const char *n) : gravador(g), nome(n), inicioUs(g.agoraUs()) {}
+        ZonaTempo(const ZonaTempo &) = delete;
+        ZonaTempo &operator=(const ZonaTempo &) = delete;
+
+        ~ZonaTempo() {
+            gravador.registrar(nome, inicioUs, gravador.agoraUs() - inicioUs);
+        }
+    };
+
+    /**
+     * @brief Passos de renderização medidos separadamente
+     */
+    enum class Passo : std::uint8_t { Fundo, Notas, Texto, Particulas, Painel, Quantidade };
+
+    constexpr auto QUANTIDADE_PASSOS = static_cast<std::size_t>(Passo::Quantidade);
+    constexpr std::array<const char *, QUANTIDADE_PASSOS> NOMES_PASSOS = {
+        "Fundo", "Notas", "Texto", "Partículas", "Painel"};
+    constexpr std::array<const char *, QUANTIDADE_PASSOS> ZONAS_PASSOS_CPU = {
+        "passo_fundo", "passo_notas", "passo_texto", "passo_particulas", "passo_painel"};
+    constexpr std::array<const char *, QUANTIDADE_PASSOS> ZONAS_PASSOS_GPU = {
+        "gpu_fundo", "gpu_notas", "gpu_texto", "gpu_particulas", "gpu_painel"};
+
+    /**
+     * @brief Mede o tempo de GPU de cada passo com consultas GL_TIME_ELAPSED
+     *
+     * Cada quadro usa um conjunto de consultas de um anel de QUADROS_CONSULTA_GPU
+     * conjuntos. O resultado só é lido quando o conjunto volta a ser usado, alguns
+     * quadros depois, e só se a GPU já o tiver disponível: a leitura nunca bloqueia.
+     * Se a GPU estiver mais atrasada que o anel, o quadro simplesmente não é medido.
+     */
+    class TemporizadorGpu {
+    private:
+        using GlGenQueries = void(RIFF_HERO_GL_API *)(int, unsigned int *);
+        using GlDeleteQueries = void(RIFF_HERO_GL_API *)(int, const unsigned int *);
+        using GlBeginQuery = void(RIFF_HERO_GL_API *)(unsigned int, unsigned int);
+        using GlEndQuery = void(RIFF_HERO_GL_API *)(unsigned int);
+        using GlGetQueryObjectiv = void(RIFF_HERO_GL_API *)(unsigned int, unsigned int, int *);
+        using GlGetQueryObjectui64v = void(RIFF_HERO_GL_API *)(unsigned int, unsigned int, std::uint64_t *);
+
+        static constexpr unsigned int GL_TEMPO_DECORRIDO = 0x88BF;   // GL_TIME_ELAPSED
+        static constexpr unsigned int GL_RESULTADO = 0x8866;         // GL_QUERY_RESULT
+        static constexpr unsigned int GL_RESULTADO_PRONTO = 0x8867;  // GL_QUERY_RESULT_AVAILABLE
+
+        struct ConjuntoConsultas {
+            std::array<unsigned int, QUANTIDADE_PASSOS> ids{};
+            std::array<std::int64_t, QUANTIDADE_PASSOS> inicioCpuUs{};
+            std::array<bool, QUANTIDADE_PASSOS> emitida{};
+            std::int64_t quadro = 0;
+            bool pendente = false;
+        };
+
+        GlGenQueries glGenQueries = nullptr;
+        GlDeleteQueries glDeleteQueries = nullptr;
+        GlBeginQuery glBeginQuery = nullptr;
+        GlEndQuery glEndQuery = nullptr;
+        GlGetQueryObjectiv glGetQueryObjectiv = nullptr;
+        GlGetQueryObjectui64v glGetQueryObjectui64v = nullptr;
+
+        std::array<ConjuntoConsultas, QUADROS_CONSULTA_GPU> conjuntos;
+        std::size_t indiceAtual = 0;
+        ConjuntoConsultas *conjuntoAtual = nullptr; // Nulo quando o quadro não é medido
+        bool disponivel = false;
+
+        std::array<double, QUANTIDADE_PASSOS> ultimoCpuMs{};
+        std::array<double, QUANTIDADE_PASSOS> ultimoGpuMs{};
+
+        template <typename Funcao>
+        static Funcao carregar(const char *nome) {
+            return reinterpret_cast<Funcao>(sf::Context::getFunction(nome));
+        }
+
+        /**
+         * @brief Lê os resultados de um conjunto se a GPU já terminou
+         * @return True se o conjunto ficou livre para reuso
+         */
+        bool colher(ConjuntoConsultas &conjunto, GravadorVoo &gravador) {
+            // As consultas terminam em ordem: basta checar a última emitida
+            std::optional<std::size_t> ultima;
+            for (std::size_t i = 0; i < QUANTIDADE_PASSOS; ++i) {
+                if (conjunto.emitida[i]) ultima = i;
+            }
+            if (ultima) {
+                int pronto = 0;
+                glGetQueryObjectiv(conjunto.ids[*ultima], GL_RESULTADO_PRONTO, &pronto);
+                if (!pronto) return false;
+            }
+
+            for (std::size_t i = 0; i < QUANTIDADE_PASSOS; ++i) {
+                if (!conjunto.emitida[i]) continue;
+                std::uint64_t nanossegundos = 0;
+                glGetQueryObjectui64v(conjunto.ids[i], GL_RESULTADO, &nanossegundos);
+                ultimoGpuMs[i] = static_cast<double>(nanossegundos) / 1'000'000.0;
+                gravador.registrarGpu(ZONAS_PASSOS_GPU[i], conjunto.inicioCpuUs[i],
+                                      static_cast<std::int64_t>(nanossegundos / 1000), conjunto.quadro);
+            }
+            conjunto.pendente = false;
+            return true;
+        }
+
+    public:
+        TemporizadorGpu() = default;
+        TemporizadorGpu(const TemporizadorGpu &) = delete;
+        TemporizadorGpu &operator=(const TemporizadorGpu &) = delete;
+
+        ~TemporizadorGpu() {
+            if (!disponivel) return;
+            for (auto &conjunto : conjuntos) {
+                glDeleteQueries(static_cast<int>(conjunto.ids.size()), conjunto.ids.data());
+            }
+        }
+
+        /**
+         * @brief Carrega as funções de consulta; o contexto da janela deve estar ativo
+         * @param configuracao Configuração do contexto OpenGL criado
+         * @return True se a GPU suporta consultas de tempo (OpenGL 3.3 ou ARB_timer_query)
+         */
+        bool iniciar(const sf::ContextSettings &configuracao) {
+            const bool versaoSuficiente = configuracao.majorVersion > 3 ||
+                                          (configuracao.majorVersion == 3 && configuracao.minorVersion >= 3);
+            if (!versaoSuficiente && !sf::Context::isExtensionAvailable("GL_ARB_timer_query")) return false;
+
+            glGenQueries = carregar<GlGenQueries>("glGenQueries");
+            glDeleteQueries = carregar<GlDeleteQueries>("glDeleteQueries");
+            glBeginQuery = carregar<GlBeginQuery>("glBeginQuery");
+            glEndQuery = carregar<GlEndQuery>("glEndQuery");
+            glGetQueryObjectiv = carregar<GlGetQueryObjectiv>("glGetQueryObjectiv");
+            glGetQueryObjectui64v = carregar<GlGetQueryObjectui64v>("glGetQueryObjectui64v");
+            if (!glGenQueries || !glDeleteQueries || !glBeginQuery || !glEndQuery || !glGetQueryObjectiv ||
+                !glGetQueryObjectui64v) {
+                return false;
+            }
+
+            for (auto &conjunto : conjuntos) {
+                glGenQueries(static_cast<int>(conjunto.ids.size()), conjunto.ids.data());
+            }
+            disponivel = true;
+            return true;
+        }
+
+        /**
+         * @brief Escolhe o conjunto do quadro, colhendo antes o resultado antigo dele
+         */
+        void iniciarQuadro(GravadorVoo &gravador) {
+            conjuntoAtual = nullptr;
+            if (!disponivel) return;
+
+            indiceAtual = (indiceAtual + 1) % conjuntos.size();
+            auto &conjunto = conjuntos[indiceAtual];
+            if (conjunto.pendente && !colher(conjunto, gravador)) return;
+
+            conjunto.emitida.fill(false);
+            conjunto.quadro = gravador.quadro();
+            conjuntoAtual = &conjunto;
+        }
+
+        void iniciarPasso(const Passo passo, const std::int64_t inicioCpuUs) {
+            if (!conjuntoAtual) return;
+            const auto i = static_cast<std::size_t>(passo);
+            glBeginQuery(GL_TEMPO_DECORRIDO, conjuntoAtual->ids[i]);
+            conjuntoAtual->emitida[i] = true;
+            conjuntoAtual->inicioCpuUs[i] = inicioCpuUs;
+        }
+
+        void terminarPasso(const Passo passo, const std::int64_t duracaoCpuUs) {
+            const auto i = static_cast<std::size_t>(passo);
+            ultimoCpuMs[i] = static_cast<double>(duracaoCpuUs) / 1000.0;
+            if (conjuntoAtual && conjuntoAtual->emitida[i]) {
+                glEndQuery(GL_TEMPO_DECORRIDO);
+            }
+        }
+
+        void concluirQuadro() {
+            if (conjuntoAtual) {
+                conjuntoAtual->pendente = std::ranges::any_of(conjuntoAtual->emitida, [](bool e) { return e; });
+            }
+            conjuntoAtual = nullptr;
+        }
+
+        [[nodiscard]] bool ativo() const {
+            return disponivel;
+        }
+
+        [[nodiscard]] double cpuMs(const Passo passo) const {
+            return ultimoCpuMs[static_cast<std::size_t>(passo)];
+        }
+
+        [[nodiscard]] double gpuMs(const Passo passo) const {
+            return ultimoGpuMs[static_cast<std::size_t>(passo)];
+        }
+    };
+
+    /**
+     * @brief Mede um passo de renderização na CPU (gravador de voo) e na GPU
+     */
+    class EscopoPasso {
+    private:
+        GravadorVoo &gravador;
+        TemporizadorGpu &temporizador;
+        Passo passo;
+        std::int64_t inicioUs;
+
+    public:
+        EscopoPasso(GravadorVoo &g, TemporizadorGpu &t, const Passo p)
+            : gravador(g), temporizador(t), passo(p), inicioUs(g.agoraUs()) {
+            temporizador.iniciarPasso(passo, inicioUs);
+        }
+        EscopoPasso(const EscopoPasso &) = delete;
+        EscopoPasso &operator=(const EscopoPasso &) = delete;
+
+        ~EscopoPasso() {
+            const auto duracaoUs = gravador.agoraUs() - inicioUs;
+            temporizador.terminarPasso(passo, duracaoUs);
+            gravador.registrar(ZONAS_PASSOS_CPU[static_cast<std::size_t>(passo)], inicioUs, duracaoUs);
+        }
+    };
 }
 
-// ============================= ESTRUTURA NOTA =============================
+// ============================= ENTRADA EVDEV (LINUX) =============================
 
 /**
- * @brief Representa uma nota no jogo durante a execução
+ * @brief Evento de tecla lido diretamente do kernel
  */
-struct Nota {
-    double timestampSec = 0.0;
-    int tickOriginal = 0;
-    int pista = 0;
-    int traste = 0;
-    float posicaoY = 0.0f;
-    bool naTela = false;
-    bool acertada = false;
-    bool perdida = false;
-    Jogador *dono = nullptr;
-    sf::Color cor = sf::Color::White;
-    bool ehNotaLonga = false;
-    double tempoFimSustainSec = 0.0;
-    bool sustainAtivo = false;
-    bool sustainCompleto = false;
-    sf::Time tempoAtePróximaParticulaSustain = sf::Time::Zero;
+struct EventoTeclaBruto {
+    sf::Keyboard::Key tecla = sf::Keyboard::Key::Unknown;
+    bool pressionada = false;
+    std::int64_t timestampUs = 0; // CLOCK_MONOTONIC, atribuído pelo kernel
+    int dispositivo = 0;          // Índice do dispositivo na lista aberta
+};
+
+#if defined(__linux__)
+
+/**
+ * @brief Backend de entrada que lê /dev/input/event* em uma thread dedicada
+ *
+ * Evita a fila de eventos da janela (X11/Wayland + pollEvent), que só é drenada
+ * uma vez por quadro. Cada evento carrega o timestamp do kernel, de modo que o
+ * jogo julga o acerto no instante em que a tecla foi de fato pressionada.
+ * Dispositivos virtuais criados com uinput aparecem como /dev/input/event* e
+ * funcionam da mesma forma, o que permite reproduzir sequências de teclas.
+ */
+class EntradaEvdev {
+private:
+    std::vector<int> descritores; // -1 depois que a thread de leitura fecha um dispositivo desconectado
+    std::vector<std::string> caminhos;
+    bool dispositivosPorJogador = false;
+    std::optional<ConfiguracaoAgendamento> agendamentoThread;
+    std::mutex mutexEventos;
+    std::vector<EventoTeclaBruto> eventosPendentes;
+    std::jthread threadLeitura;
 
     /**
-     * @brief Construtor da nota
-     * @param notaChart Nota do chart original
-     * @param timestampSeg Timestamp em segundos
-     * @param fimSustainSeg Fim do sustain em segundos
-     * @param proprietario Ponteiro para o jogador dono da nota
+     * @brief Converte um código KEY_* do Linux para sf::Keyboard::Key
      */
-    Nota(const Chart::NotaChart &notaChart, const double timestampSeg,
-         const double fimSustainSeg, Jogador *proprietario)
-        : tickOriginal(notaChart.tick), traste(notaChart.traste), timestampSec(timestampSeg),
-          tempoFimSustainSec(fimSustainSeg), ehNotaLonga(notaChart.comprimento > 0), dono(proprietario) {
+    [[nodiscard]] static auto converterCodigo(const unsigned short codigo) -> sf::Keyboard::Key {
+        using Tecla = sf::Keyboard::Key;
+        static const std::map<unsigned short, Tecla> tabela = {
+            {KEY_A, Tecla::A}, {KEY_B, Tecla::B}, {KEY_C, Tecla::C}, {KEY_D, Tecla::D},
+            {KEY_E, Tecla::E}, {KEY_F, Tecla::F}, {KEY_G, Tecla::G}, {KEY_H, Tecla::H},
+            {KEY_I, Tecla::I}, {KEY_J, Tecla::J}, {KEY_K, Tecla::K}, {KEY_L, Tecla::L},
+            {KEY_M, Tecla::M}, {KEY_N, Tecla::N}, {KEY_O, Tecla::O}, {KEY_P, Tecla::P},
+            {KEY_Q, Tecla::Q}, {KEY_R, Tecla::R}, {KEY_S, Tecla::S}, {KEY_T, Tecla::T},
+            {KEY_U, Tecla::U}, {KEY_V, Tecla::V}, {KEY_W, Tecla::W}, {KEY_X, Tecla::X},
+            {KEY_Y, Tecla::Y}, {KEY_Z, Tecla::Z},
+            {KEY_0, Tecla::Num0}, {KEY_1, Tecla::Num1}, {KEY_2, Tecla::Num2}, {KEY_3, Tecla::Num3},
+            {KEY_4, Tecla::Num4}, {KEY_5, Tecla::Num5}, {KEY_6, Tecla::Num6}, {KEY_7, Tecla::Num7},
+            {KEY_8, Tecla::Num8}, {KEY_9, Tecla::Num9},
+            {KEY_SEMICOLON, Tecla::Semicolon}, {KEY_APOSTROPHE, Tecla::Apostrophe},
+            {KEY_COMMA, Tecla::Comma}, {KEY_DOT, Tecla::Period}, {KEY_SLASH, Tecla::Slash},
+            {KEY_SPACE, Tecla::Space}, {KEY_ENTER, Tecla::Enter}, {KEY_ESC, Tecla::Escape},
+            {KEY_UP, Tecla::Up}, {KEY_DOWN, Tecla::Down}, {KEY_LEFT, Tecla::Left}, {KEY_RIGHT, Tecla::Right},
+        };
+        const auto it = tabela.find(codigo);
+        return it != tabela.end() ? it->second : Tecla::Unknown;
+    }
 
-        pista = notaChart.traste;
+    /**
+     * @brief Verifica se um dispositivo aberto se comporta como teclado
+     */
+    [[nodiscard]] static auto ehTeclado(const int descritor) -> bool {
+        std::array<unsigned long, (KEY_MAX + 1 + 8 * sizeof(unsigned long) - 1) / (8 * sizeof(unsigned long))> bitsTeclas{};
+        if (ioctl(descritor, EVIOCGBIT(EV_KEY, sizeof(bitsTeclas)), bitsTeclas.data()) < 0) {
+            return false;
+        }
+        constexpr auto bitsPorPalavra = 8 * sizeof(unsigned long);
+        const auto temTecla = [&](const unsigned codigo) {
+            return (bitsTeclas[codigo / bitsPorPalavra] >> (codigo % bitsPorPalavra)) & 1UL;
+        };
+        return temTecla(KEY_A) && temTecla(KEY_SPACE);
+    }
+
+    /**
+     * @brief Laço da thread de leitura
+     */
+    void lerEventos(const std::stop_token &parar) {
+        if (agendamentoThread) {
+            aplicarAgendamento(*agendamentoThread, "de entrada");
+        }
+
+        std::vector<pollfd> entradasPoll;
+        for (const auto descritor : descritores) {
+            entradasPoll.push_back({descritor, POLLIN, 0});
+        }
+        std::vector<std::set<sf::Keyboard::Key>> teclasSeguradas(descritores.size());
+
+        // Dispositivo desconectado: sai do poll (fd negativo é ignorado) e solta o que estava seguro
+        const auto desconectar = [&](const size_t i) {
+            Log::aviso("Entrada evdev desconectada: ", caminhos[i]);
+            close(entradasPoll[i].fd);
+            entradasPoll[i].fd = -1;
+            descritores[i] = -1;
+            const auto agora = agoraMonotonicoUs();
+            std::lock_guard trava(mutexEventos);
+            for (const auto tecla : teclasSeguradas[i]) {
+                eventosPendentes.push_back({tecla, false, agora, static_cast<int>(i)});
+            }
+            teclasSeguradas[i].clear();
+        };
 
-        // Define cor baseada na pista
-        switch (pista) {
-            case 0: cor = sf::Color::Green; break;
-            case 1: cor = sf::Color::Red; break;
-            case 2: cor = sf::Color(255, 255, 0); break; // Amarelo
-            case 3: cor = sf::Color::Blue; break;
-            case 4: cor = sf::Color(255, 165, 0); break; // Laranja
-            default: cor = sf::Color::White; break;
+        std::array<input_event, 64> buffer{};
+        while (!parar.stop_requested()) {
+            if (poll(entradasPoll.data(), entradasPoll.size(), INTERVALO_POLL_EVDEV_MS) <= 0) {
+                continue;
+            }
+
+            for (size_t i = 0; i < entradasPoll.size(); ++i) {
+                if (entradasPoll[i].fd < 0) continue;
+                if (entradasPoll[i].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+                    desconectar(i);
+                    continue;
+                }
+                if (!(entradasPoll[i].revents & POLLIN)) continue;
+
+                const auto bytesLidos = read(entradasPoll[i].fd, buffer.data(), sizeof(buffer));
+                if (bytesLidos < 0 && errno == ENODEV) {
+                    desconectar(i);
+                    continue;
+                }
+                if (bytesLidos <= 0) continue;
+
+                const auto quantidade = static_cast<size_t>(bytesLidos) / sizeof(input_event);
+                std::lock_guard trava(mutexEventos);
+                for (size_t j = 0; j < quantidade; ++j) {
+                    const auto &evento = buffer[j];
+                    // value: 0 = solta, 1 = pressiona, 2 = repetição automática (ignorada)
+                    if (evento.type != EV_KEY || evento.value == 2) continue;
+
+                    const auto tecla = converterCodigo(evento.code);
+                    if (tecla == sf::Keyboard::Key::Unknown) continue;
+
+                    if (evento.value == 1) {
+                        teclasSeguradas[i].insert(tecla);
+                    } else {
+                        teclasSeguradas[i].erase(tecla);
+                    }
+                    eventosPendentes.push_back({
+                        tecla, evento.value == 1,
+                        static_cast<std::int64_t>(evento.input_event_sec) * 1'000'000 + evento.input_event_usec,
+                        static_cast<int>(i)
+                    });
+                }
+            }
+        }
+    }
+
+public:
+    EntradaEvdev() = default;
+    EntradaEvdev(const EntradaEvdev &) = delete;
+    EntradaEvdev &operator=(const EntradaEvdev &) = delete;
+
+    ~EntradaEvdev() {
+        threadLeitura = std::jthread(); // Pede parada e aguarda antes de fechar os descritores
+        for (const auto descritor : descritores) {
+            if (descritor >= 0) close(descritor); // -1: desconectado e já fechado pela thread
         }
     }
 
     /**
-     * @brief Obtém a posição onde a nota deve ser acertada
-     * @return Posição do centro da nota quando acertada
+     * @brief Abre os dispositivos e inicia a thread de leitura
+     * @param especificacao "auto" ou lista de caminhos separados por vírgula
+     * @param agendamento Agendamento opcional da thread de leitura
+     * @return True se ao menos um teclado foi aberto
      */
-    [[nodiscard]] auto obterPosicaoAcerto() const -> sf::Vector2f {
-        if (!dono) return {0.f, 0.f};
+    bool iniciar(const std::string &especificacao,
+                 const std::optional<ConfiguracaoAgendamento> &agendamento = std::nullopt) {
+        agendamentoThread = agendamento;
+
+        std::vector<std::string> candidatos;
+        const bool automatico = especificacao == "auto";
+
+        if (automatico) {
+            std::error_code erro;
+            for (const auto &entrada : std::filesystem::directory_iterator("/dev/input", erro)) {
+                if (entrada.path().filename().string().starts_with("event")) {
+                    candidatos.push_back(entrada.path().string());
+                }
+            }
+            std::ranges::sort(candidatos);
+        } else {
+            std::istringstream lista(especificacao);
+            std::string caminho;
+            while (std::getline(lista, caminho, ',')) {
+                if (!caminho.empty()) candidatos.push_back(caminho);
+            }
+        }
 
-        const auto larguraVisualCabeca = static_cast<float>(LARGURA_PISTA - 12);
-        const auto xBaseNota = static_cast<float>(dono->offsetAreaJogadorX + pista * LARGURA_PISTA);
-        const auto xVisualCabeca = xBaseNota + (LARGURA_PISTA - larguraVisualCabeca) / 2.f;
-        const auto xCentro = xVisualCabeca + larguraVisualCabeca / 2.f;
+        for (const auto &caminho : candidatos) {
+            const int descritor = open(caminho.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+            if (descritor < 0) {
+                if (!automatico) {
+                    Log::erro("Não foi possível abrir ", caminho, ": ", std::strerror(errno));
+                }
+                continue;
+            }
+            if (automatico && !ehTeclado(descritor)) {
+                close(descritor);
+                continue;
+            }
 
-        return {xCentro, posicaoY};
+            // Timestamps no mesmo relógio usado por agoraMonotonicoUs()
+            int relogio = CLOCK_MONOTONIC;
+            ioctl(descritor, EVIOCSCLOCKID, &relogio);
+
+            descritores.push_back(descritor);
+            caminhos.push_back(caminho);
+        }
+
+        if (descritores.empty()) {
+            return false;
+        }
+
+        // Dois dispositivos listados explicitamente: um teclado por jogador
+        dispositivosPorJogador = !automatico && descritores.size() == 2;
+
+        threadLeitura = std::jthread([this](const std::stop_token &parar) { lerEventos(parar); });
+        return true;
     }
 
     /**
-     * @brief Obtém a posição onde spawnar partículas de sustain
-     * @return Posição para partículas de sustain
+     * @brief Move os eventos acumulados pela thread para o vetor de saída
+     * @param saida Vetor que recebe os eventos (é limpo antes)
      */
-    [[nodiscard]] auto obterPosicaoParticulaSustain() const -> sf::Vector2f {
-        if (!dono) return {0.f, 0.f};
+    void drenar(std::vector<EventoTeclaBruto> &saida) {
+        saida.clear();
+        std::lock_guard trava(mutexEventos);
+        saida.swap(eventosPendentes);
+    }
 
-        const auto larguraVisualCabeca = static_cast<float>(LARGURA_PISTA - 12);
-        const auto xBaseNota = static_cast<float>(dono->offsetAreaJogadorX + pista * LARGURA_PISTA);
-        const auto xVisualCabeca = xBaseNota + (LARGURA_PISTA - larguraVisualCabeca) / 2.f;
-        const auto xCentro = xVisualCabeca + larguraVisualCabeca / 2.f;
+    /**
+     * @brief Descarta eventos pendentes (ex: janela sem foco)
+     */
+    void descartarPendentes() {
+        std::lock_guard trava(mutexEventos);
+        eventosPendentes.clear();
+    }
 
-        return {xCentro, static_cast<float>(Y_ZONA_ACERTO + ALTURA_ZONA_ACERTO / 2.f)};
+    [[nodiscard]] auto quantidadeDispositivos() const -> int {
+        return static_cast<int>(descritores.size());
+    }
+
+    [[nodiscard]] auto caminhoDispositivo(const int indice) const -> const std::string & {
+        return caminhos[indice];
     }
 
     /**
-     * @brief Obtém os limites da nota para detecção de colisão
-     * @param offsetAreaJogadorX Offset X da área do jogador
-     * @return Retângulo representando os limites da nota
+     * @brief Jogador ao qual o dispositivo pertence
+     * @param dispositivo Índice do dispositivo
+     * @return 0 ou 1, ou -1 se o dispositivo é compartilhado pelos dois jogadores
      */
-    [[nodiscard]] auto obterLimites(const int offsetAreaJogadorX) const -> sf::FloatRect {
-        const auto x = static_cast<float>(offsetAreaJogadorX + pista * LARGURA_PISTA);
-        const auto larguraEfetiva = static_cast<float>(LARGURA_PISTA);
-        return {{x, posicaoY - ALTURA_NOTA / 2.f}, {larguraEfetiva, static_cast<float>(ALTURA_NOTA)}};
+    [[nodiscard]] auto indiceJogadorDoDispositivo(const int dispositivo) const -> int {
+        return dispositivosPorJogador ? dispositivo : -1;
+    }
+
+    /**
+     * @brief Tempo monotônico atual, na mesma base dos timestamps do kernel
+     */
+    [[nodiscard]] static auto agoraMonotonicoUs() -> std::int64_t {
+        timespec agora{};
+        clock_gettime(CLOCK_MONOTONIC, &agora);
+        return static_cast<std::int64_t>(agora.tv_sec) * 1'000'000 + agora.tv_nsec / 1000;
     }
 };
 
+#endif
+
 // ============================= CLASSE PRINCIPAL DO JOGO =============================
 
 /**
@@ -671,14 +3237,36 @@ private:
     sf::RenderWindow janela;
     sf::Font fonte;
     std::optional<Chart::DadosChart> dadosChartOpt;
+    Chart::MetadadosMusica metadadosChart; // O [Song] do próprio chart, sem o song.ini por cima (para gravar)
     std::optional<Chart::CalculadoraTempo> calculadoraTempoOpt;
 
+    std::vector<Biblioteca::Musica> biblioteca;
+    Capas::CacheCapas cacheCapas;
+    std::string caminhoCapa;
+
+    // Forma de onda (buffers reaproveitados entre quadros)
+    FormaOnda::Carregador cargaOnda;
+    std::vector<FormaOnda::Resumo> colunasOnda;
+    sf::VertexArray verticesOnda{sf::PrimitiveType::Lines};
+
     // Audio
-    sf::Music musica;
+    std::filesystem::path diretorioMusica = ".";
+    Audio::Reprodutor musica;
+    std::string caminhoAudio;
+    bool metronomoAtivo = false;
+    Sonoridade::Indice indiceSonoridade;
+    bool ganhoSonoridadePendente = false; // Esperando o hash do áudio, que vem da carga da forma de onda
+
+#if defined(__linux__)
+    // Entrada evdev opcional (Linux)
+    std::optional<EntradaEvdev> entradaEvdev;
+    std::vector<EventoTeclaBruto> eventosEvdev;
+    bool janelaComFoco = true;
+#endif
 
     // Sistema de partículas usando queue (FIFO - First In, First Out)
-    std::queue<Particula> particulasAtivas;
-    std::queue<Particula> particulasReutilizaveis; // Pool de partículas para reutilizar
+    Memoria::Fila<Particula, Memoria::Subsistema::Particulas> particulasAtivas;
+    Memoria::Fila<Particula, Memoria::Subsistema::Caches> particulasReutilizaveis; // Pool de partículas para reutilizar
     std::mt19937 motorRandomico;
     std::uniform_real_distribution<float> distribuicaoAnguloParticula;
     std::uniform_real_distribution<float> distribuicaoVelocidadeParticula;
@@ -698,20 +3286,53 @@ private:
     bool chartCarregado = false;
     sf::String mensagemStatus;
 
+    // Pausa (Esc): ao continuar, o áudio pré-rola e a contagem acaba quando o relógio do áudio volta à pausa
+    enum class EstadoPausa { Jogando, Pausado, Contagem };
+    EstadoPausa estadoPausa = EstadoPausa::Jogando;
+    double posicaoPausaSec = 0.0; // No relógio do áudio
+
+    // Editor de charts (F2), aberto sobre o chart e a calculadora de tempo carregados
+    std::optional<Editor::Sessao> editor;
+
     // Jogadores
     Jogador jogador1;
     Jogador jogador2;
 
     // Notas
-    std::vector<Nota> todasNotasMusicaMestre;
-    std::vector<Nota> notasJ1;
-    std::vector<Nota> notasJ2;
+    VetorNotas todasNotasMusicaMestre;
+    VetorNotas notasJ1;
+    VetorNotas notasJ2;
+    JanelaNotas janelaNotasJ1;
+    JanelaNotas janelaNotasJ2;
 
     // Timing
     sf::Clock relogioLoopJogo;
     sf::Clock relogioAnimacaoShader;
     sf::Time tempoDesdeUltimaAtualizacao = sf::Time::Zero;
     const sf::Time tempoPorFrame = sf::microseconds(ATUALIZACAO_JOGO_MS * 1000);
+    EstatisticasTravamento estatisticasTravamento;
+
+    // Gravador de voo e vigia de travamentos
+    Rastreamento::GravadorVoo gravadorVoo;
+    Rastreamento::TemporizadorGpu temporizadorGpu;
+
+    // Métricas para a frota (declaradas antes do servidor, que as referencia)
+    Metricas::Registro registroMetricas;
+    Metricas::Servidor servidorMetricas;
+
+    // Lobby na rede local
+    Lan::Anfitriao anfitriaoLan;
+
+    // Telemetria ao vivo
+    Telemetria::Publicador publicadorTelemetria;
+    std::int64_t numeroQuadro = 0;
+    std::int64_t chamadasDesenhoQuadro = 0;
+    std::int64_t notasProcessadasQuadro = 0;
+
+    // Painel de desempenho (F3)
+    bool painelDesempenhoVisivel = false;
+    sf::Time ultimoTempoQuadro = sf::Time::Zero;
+    sf::Time ultimoTempoAtualizacao = sf::Time::Zero;
 
 public:
     /**
@@ -738,25 +3359,63 @@ public:
 
         inicializarRecursos();
         carregarDadosChart();
+
+        // Sim e renderização rodam na thread principal
+        if (const auto agendamento = ConfiguracaoAgendamento::lerDoAmbiente(VARIAVEL_AMBIENTE_AGENDAMENTO_JOGO)) {
+            aplicarAgendamento(*agendamento, "principal");
+        }
+        if (const auto agendamento = ConfiguracaoAgendamento::lerDoAmbiente(VARIAVEL_AMBIENTE_AGENDAMENTO_AUDIO)) {
+            musica.definirPreparoThread([config = *agendamento] { aplicarAgendamento(config, "de áudio"); });
+        }
+        if (std::getenv(VARIAVEL_AMBIENTE_MLOCK)) {
+            travarMemoriaProcesso();
+        }
     }
 
     /**
      * @brief Loop principal do jogo
      */
     void executar() {
+        // O relógio conta desde a construção; sem isso o primeiro quadro levaria a carga inteira
+        relogioLoopJogo.restart();
         while (janela.isOpen()) {
             const auto dt = relogioLoopJogo.restart();
             tempoDesdeUltimaAtualizacao += dt;
+            if (jogoRodando && estadoPausa != EstadoPausa::Pausado) {
+                estatisticasTravamento.registrarQuadro(dt);
+            }
+            registroMetricas.registrarQuadro(dt);
+
+            // O anel ainda contém as zonas do quadro que acabou de travar
+            if (dt > LIMIAR_TRAVAMENTO_QUADRO) {
+                gravadorVoo.solicitarDespejo(dt);
+            }
+            gravadorVoo.novoQuadro();
+            const Rastreamento::ZonaTempo zonaQuadro(gravadorVoo, "quadro");
+
+            {
+                const Rastreamento::ZonaTempo zona(gravadorVoo, "eventos");
+                processarEventos();
+            }
+
+            if (ganhoSonoridadePendente) aplicarGanhoSonoridade();
 
-            processarEventos();
+            // Durante a reprodução no editor o cursor acompanha o áudio
+            if (editor && musica.getStatus() == sf::SoundSource::Status::Playing) {
+                editor->posicionarEmSegundos(musica.posicaoSegundos() + OFFSET_LATENCIA_AUDIO_SEC);
+            }
 
-            // Loop de atualização com timestep fixo
+            // Loop de atualização com timestep fixo; pausado, o acumulador escoa sem simular
+            sf::Clock relogioAtualizacao;
+            notasProcessadasQuadro = 0;
             while (tempoDesdeUltimaAtualizacao >= tempoPorFrame) {
                 tempoDesdeUltimaAtualizacao -= tempoPorFrame;
-                if (jogoRodando) {
+                if (jogoRodando && estadoPausa != EstadoPausa::Pausado) {
+                    const Rastreamento::ZonaTempo zona(gravadorVoo, "atualizacao");
                     atualizar(tempoPorFrame);
                 }
             }
+            const auto tempoAtualizacao = relogioAtualizacao.getElapsedTime();
 
             // Verifica fim de jogo
             if (jogoIniciado && !jogoRodando && !mensagemStatus.toAnsiString().starts_with("Fim de Jogo!")) {
@@ -765,51 +3424,238 @@ public:
                                "\nPressione ESPAÇO para Reiniciar.");
                 mensagemStatus = mensagemFim;
                 jogoIniciado = false;
+                gravadorVoo.registrarEvento("fim_musica");
+                Log::info("Fim da música. ", estatisticasTravamento.resumo());
+            }
+
+            chamadasDesenhoQuadro = 0;
+            renderizar();
+            publicarTelemetria(dt, tempoAtualizacao);
+        }
+    }
+
+private:
+    /**
+     * @brief Publica os contadores do quadro na memória compartilhada
+     * @param tempoQuadro Duração do quadro
+     * @param tempoAtualizacao Tempo gasto nas atualizações de timestep fixo
+     */
+    void publicarTelemetria(const sf::Time tempoQuadro, const sf::Time tempoAtualizacao) {
+        ultimoTempoQuadro = tempoQuadro;
+        ultimoTempoAtualizacao = tempoAtualizacao;
+        if (!publicadorTelemetria.ativo()) return;
+
+        // Deriva: quanto o relógio do dispositivo de áudio se afastou do relógio da CPU desde o play
+        std::int64_t derivaUs = 0;
+        if (musica.getStatus() == sf::SoundSource::Status::Playing) {
+            derivaUs = std::llround(musica.derivaSegundos() * 1e6);
+        }
+
+        publicadorTelemetria.publicar({
+            ++numeroQuadro,
+            tempoQuadro.asMicroseconds(),
+            tempoAtualizacao.asMicroseconds(),
+            chamadasDesenhoQuadro,
+            static_cast<std::int64_t>(particulasAtivas.size()),
+            notasProcessadasQuadro,
+            derivaUs,
+            static_cast<std::int64_t>(totalAlocacoes.load(std::memory_order_relaxed))
+        });
+    }
+
+    /**
+     * @brief Desenha na janela contabilizando a chamada na telemetria
+     */
+    void desenhar(const sf::Drawable &objeto, const sf::RenderStates &estados = sf::RenderStates::Default) {
+        janela.draw(objeto, estados);
+        ++chamadasDesenhoQuadro;
+    }
+
+    /**
+     * @brief Inicializa recursos básicos (fonte, sons, shaders)
+     */
+    void inicializarRecursos() {
+        // Carrega fonte
+        if (!fonte.openFromFile("fonte.ttf")) {
+            mensagemStatus = utf8ParaSfString("Erro: Não foi possível carregar a fonte fonte.ttf");
+            Log::erro("Não foi possível carregar a fonte fonte.ttf");
+        }
+
+        // Inicializa shaders
+        shadersDisponiveis = sf::Shader::isAvailable();
+        if (shadersDisponiveis) {
+            if (!shaderNota.loadFromFile("shader_notas.vsh", "shader_notas.fsh")) {
+                Log::erro("Erro ao carregar shader de nota. Usando renderização padrão.");
+            }
+            if (!shaderFundo.loadFromFile("shader_fundo.vsh", "shader_fundo.fsh")) {
+                Log::erro("Erro ao carregar shader de fundo. Usando cor sólida.");
+            }
+        } else {
+            Log::aviso("Shaders não estão disponíveis neste sistema.");
+        }
+
+        // Carrega texturas
+        if (!texturaBranca.loadFromFile("branco.png")) {
+            Log::erro("Erro ao carregar textura branco.png.");
+        }
+
+        // Inicializa sprites
+        spriteBranco.emplace(texturaBranca);
+        Memoria::definir(Memoria::Subsistema::Texturas,
+                         static_cast<std::int64_t>(texturaBranca.getSize().x) * texturaBranca.getSize().y * 4);
+
+        // Configura forma de preenchimento do fundo
+        formaPreenchimentoFundo.setSize({static_cast<float>(LARGURA_JANELA),
+                                        static_cast<float>(ALTURA_JANELA)});
+        formaPreenchimentoFundo.setPosition({0.f, 0.f});
+
+        // Configurações da janela
+        janela.setVerticalSyncEnabled(true);
+
+        // Tempo de GPU por passo de renderização (painel F3 e arquivos de travamento)
+        if (!temporizadorGpu.iniciar(janela.getSettings())) {
+            Log::info("Consultas de tempo na GPU indisponíveis; painel mostra só o tempo de CPU");
+        }
+
+        // Faixas e teto do multiplicador de combo
+        if (const auto pontuacao = Pontuacao::Configuracao::lerDoAmbiente(VARIAVEL_AMBIENTE_PONTUACAO)) {
+            jogador1.configuracaoPontuacao = *pontuacao;
+            jogador2.configuracaoPontuacao = *pontuacao;
+        }
+
+        // Endpoint de métricas opcional
+        if (const char *portaMetricas = std::getenv(VARIAVEL_AMBIENTE_METRICAS_PORTA)) {
+            const auto porta = static_cast<unsigned short>(std::atoi(portaMetricas));
+            const char *enderecoMetricas = std::getenv(VARIAVEL_AMBIENTE_METRICAS_ENDERECO);
+            const auto endereco = enderecoMetricas ? sf::IpAddress::resolve(enderecoMetricas) : sf::IpAddress::LocalHost;
+            if (!endereco) {
+                Log::erro("Endereço de métricas inválido: ", enderecoMetricas);
+            } else if (servidorMetricas.iniciar(porta, [this] { return registroMetricas.formatar(); }, *endereco)) {
+                Log::info("Métricas disponíveis em ", endereco->toString(), ":", porta);
+            } else {
+                Log::erro("Não foi possível abrir a porta de métricas ", portaMetricas);
+            }
+        }
+
+        // Capas de álbum
+        const char *diretorioCacheCapas = std::getenv(VARIAVEL_AMBIENTE_CACHE_CAPAS);
+        cacheCapas.iniciar(diretorioCacheCapas ? diretorioCacheCapas : DIRETORIO_CACHE_CAPAS_PADRAO);
+
+        // Forma de onda
+        const char *diretorioCacheOndas = std::getenv(VARIAVEL_AMBIENTE_CACHE_ONDAS);
+        cargaOnda.iniciar(diretorioCacheOndas ? diretorioCacheOndas : DIRETORIO_CACHE_ONDAS_PADRAO);
+
+        // Blocos menores baixam a latência de saída; maiores aguentam melhor uma thread de áudio atrasada
+        if (const char *quadrosBloco = std::getenv(VARIAVEL_AMBIENTE_BLOCO_AUDIO)) {
+            musica.definirQuadrosPorBloco(static_cast<std::size_t>(std::max(0L, std::atol(quadrosBloco))));
+        }
+        if (const char *taxaAudio = std::getenv(VARIAVEL_AMBIENTE_TAXA_AUDIO)) {
+            musica.definirTaxaSaida(static_cast<unsigned>(
+                std::clamp(std::atol(taxaAudio), 0L, static_cast<long>(Audio::TAXA_SAIDA_MAXIMA))));
+        }
+
+        // Biblioteca de músicas opcional
+        if (const char *raizBiblioteca = std::getenv(VARIAVEL_AMBIENTE_BIBLIOTECA)) {
+            sf::Clock relogioEscaneamento;
+            biblioteca = Biblioteca::escanear(raizBiblioteca);
+            Log::info("Biblioteca: ", biblioteca.size(), " músicas em ",
+                      relogioEscaneamento.getElapsedTime().asMicroseconds() / 1000.0, " ms");
+        }
+
+        // Sonoridade medida pelo riff-volume, na raiz da biblioteca (ou na pasta atual)
+        const char *raizSonoridade = std::getenv(VARIAVEL_AMBIENTE_BIBLIOTECA);
+        if (indiceSonoridade.carregar(std::filesystem::path(raizSonoridade ? raizSonoridade : ".") /
+                                      Sonoridade::NOME_INDICE)) {
+            Log::info("Índice de sonoridade: ", indiceSonoridade.tamanho(), " músicas");
+        }
+
+        // Vigia de travamentos
+        const char *diretorioTravamentos = std::getenv(VARIAVEL_AMBIENTE_DIRETORIO_TRAVAMENTOS);
+        gravadorVoo.iniciar(diretorioTravamentos ? diretorioTravamentos : DIRETORIO_TRAVAMENTOS_PADRAO);
+
+        // Telemetria ao vivo opcional (leitura com riff-monitor); um valor sem '/' usa o nome padrão
+        if (const char *nomeTelemetria = std::getenv(VARIAVEL_AMBIENTE_TELEMETRIA)) {
+            const std::string nome = nomeTelemetria[0] == '/' ? nomeTelemetria : Telemetria::NOME_SEGMENTO_PADRAO;
+            if (publicadorTelemetria.abrir(nome)) {
+                Log::info("Telemetria em ", nome);
+            } else {
+                Log::aviso("Não foi possível criar o segmento de telemetria ", nome);
             }
+        }
 
-            renderizar();
+#if defined(__linux__)
+        // Backend de entrada evdev opcional
+        if (const char *especificacaoEvdev = std::getenv(VARIAVEL_AMBIENTE_EVDEV)) {
+            entradaEvdev.emplace();
+            if (entradaEvdev->iniciar(especificacaoEvdev,
+                                      ConfiguracaoAgendamento::lerDoAmbiente(VARIAVEL_AMBIENTE_AGENDAMENTO_ENTRADA))) {
+                for (int i = 0; i < entradaEvdev->quantidadeDispositivos(); ++i) {
+                    Log::info("Entrada evdev: ", entradaEvdev->caminhoDispositivo(i));
+                }
+            } else {
+                Log::erro("Nenhum teclado evdev disponível. Usando eventos da janela.");
+                entradaEvdev.reset();
+            }
         }
+#endif
     }
 
-private:
     /**
-     * @brief Inicializa recursos básicos (fonte, sons, shaders)
+     * @brief Anuncia a música atual na rede local, se pedido pelo ambiente
      */
-    void inicializarRecursos() {
-        // Carrega fonte
-        if (!fonte.openFromFile("fonte.ttf")) {
-            mensagemStatus = utf8ParaSfString("Erro: Não foi possível carregar a fonte fonte.ttf");
-            std::cerr << "Erro: Não foi possível carregar a fonte fonte.ttf" << std::endl;
+    void abrirLobbyLan() {
+        const char *nomeLobby = std::getenv(VARIAVEL_AMBIENTE_LAN);
+        if (!nomeLobby) return;
+
+        // Música dentro de um pacote: o pacote inteiro é servido
+        auto origem = diretorioMusica;
+        std::error_code erro;
+        while (origem.has_relative_path() && !std::filesystem::exists(origem, erro)) {
+            origem = origem.parent_path();
         }
-
-        // Inicializa shaders
-        shadersDisponiveis = sf::Shader::isAvailable();
-        if (shadersDisponiveis) {
-            if (!shaderNota.loadFromFile("shader_notas.vsh", "shader_notas.fsh")) {
-                std::cerr << "Erro ao carregar shader de nota. Usando renderização padrão." << std::endl;
-            }
-            if (!shaderFundo.loadFromFile("shader_fundo.vsh", "shader_fundo.fsh")) {
-                std::cerr << "Erro ao carregar shader de fundo. Usando cor sólida." << std::endl;
-            }
+        if (anfitriaoLan.iniciar(origem, nomeLobby, sfStringParaUtf8(dadosChartOpt->nome),
+                                 sfStringParaUtf8(dadosChartOpt->artista))) {
+            Log::info("Lobby \"", nomeLobby, "\" aberto para ", origem);
         } else {
-            std::cerr << "Shaders não estão disponíveis neste sistema." << std::endl;
+            Log::erro("Não foi possível abrir a porta do lobby ", Lan::PORTA_TRANSFERENCIA_PADRAO);
         }
+    }
 
-        // Carrega texturas
-        if (!texturaBranca.loadFromFile("branco.png")) {
-            std::cerr << "Erro ao carregar textura branco.png." << std::endl;
+    /**
+     * @brief Lê o chart da música: notes.chart ou, na falta dele, notes.mid
+     *
+     * Um notes.rhc gerado pelo riff-convert a partir do mesmo arquivo (mesmo
+     * hash) é usado no lugar do parsing.
+     */
+    std::optional<Chart::DadosChart> lerChart() const {
+        auto caminho = diretorioMusica / CAMINHO_ARQUIVO_CHART;
+        auto bytes = lerArquivoBruto(caminho.string());
+        const bool midi = bytes.empty();
+        if (midi) {
+            caminho = diretorioMusica / CAMINHO_ARQUIVO_MIDI;
+            bytes = lerArquivoBruto(caminho.string());
+        }
+        if (bytes.empty()) {
+            Log::erro("Não foi possível abrir o arquivo de chart: ", caminho.string());
+            return std::nullopt;
         }
 
-        // Inicializa sprites
-        spriteBranco.emplace(texturaBranca);
-
-        // Configura forma de preenchimento do fundo
-        formaPreenchimentoFundo.setSize({static_cast<float>(LARGURA_JANELA),
-                                        static_cast<float>(ALTURA_JANELA)});
-        formaPreenchimentoFundo.setPosition({0.f, 0.f});
+        const auto cache = lerArquivoBruto((diretorioMusica / CAMINHO_ARQUIVO_CACHE_CHART).string());
+        if (!cache.empty()) {
+            if (auto chart = Chart::CacheBinario::ler(cache, hashConteudo(bytes))) {
+                Log::info("Chart lido do cache: ", CAMINHO_ARQUIVO_CACHE_CHART);
+                return chart;
+            }
+            Log::aviso("Cache do chart desatualizado; fazendo parsing de ", caminho.string());
+        }
 
-        // Configurações da janela
-        janela.setVerticalSyncEnabled(true);
+        if (midi) {
+            auto chart = Chart::ConversorMidi::ler(bytes);
+            if (!chart) Log::erro("MIDI inválido: ", caminho.string());
+            return chart;
+        }
+        if (bytes.starts_with("\xEF\xBB\xBF")) bytes.erase(0, 3);
+        return Chart::ParserChart::fazerParsingConteudo(bytes);
     }
 
     /**
@@ -818,17 +3664,45 @@ private:
     void carregarDadosChart() {
         mensagemStatus = utf8ParaSfString("Fazendo parsing do arquivo de chart...");
 
-        const auto chartProcessado = Chart::ParserChart::fazerParsingChart(CAMINHO_ARQUIVO_CHART);
+        sf::Clock relogioCargaTotal;
+        sf::Clock relogioFaseCarga;
+        if (const char *musicaAmbiente = std::getenv(VARIAVEL_AMBIENTE_MUSICA)) {
+            diretorioMusica = musicaAmbiente;
+        }
+        const auto chartProcessado = lerChart();
+        registroMetricas.registrarCarga(Metricas::FaseCarga::Parsing, relogioFaseCarga.restart());
         if (!chartProcessado) {
-            mensagemStatus = utf8ParaSfString("Erro: Falha no parsing do chart para " + std::string(CAMINHO_ARQUIVO_CHART));
+            mensagemStatus = utf8ParaSfString("Erro: Falha no parsing do chart para " +
+                                              (diretorioMusica / CAMINHO_ARQUIVO_CHART).string());
             chartCarregado = false;
             return;
         }
 
         dadosChartOpt = *chartProcessado;
+        metadadosChart = *chartProcessado;
+
+        // Como no Clone Hero, o song.ini tem prioridade sobre o [Song] do chart
+        const auto songIni = lerArquivoUtf8((diretorioMusica / Biblioteca::NOME_SONG_INI).string());
+        if (!songIni.empty()) {
+            Chart::LeitorMetadados::aplicarSongIni(songIni, *dadosChartOpt);
+        }
+        caminhoCapa = Capas::encontrarCapa(diretorioMusica);
         calculadoraTempoOpt.emplace(*dadosChartOpt);
+        abrirLobbyLan();
 
         mensagemStatus = utf8ParaSfString("Convertendo notas...");
+        converterNotas();
+        registroMetricas.registrarCarga(Metricas::FaseCarga::ConversaoNotas, relogioFaseCarga.restart());
+
+        carregarAudio();
+        registroMetricas.registrarCarga(Metricas::FaseCarga::Audio, relogioFaseCarga.restart());
+        registroMetricas.registrarCarga(Metricas::FaseCarga::Total, relogioCargaTotal.getElapsedTime());
+    }
+
+    /**
+     * @brief Converte as notas do chart em notas de jogo para os dois jogadores
+     */
+    void converterNotas() {
         todasNotasMusicaMestre.clear();
 
         if (dadosChartOpt) {
@@ -853,8 +3727,77 @@ private:
         std::ranges::sort(todasNotasMusicaMestre, [](const auto &a, const auto &b) {
             return a.timestampSec < b.timestampSec;
         });
+    }
 
-        carregarAudio();
+    /**
+     * @brief Abre o áudio de um arquivo comum ou de uma entrada de pacote
+     * @param caminho Caminho, possivelmente atravessando um .zip/.sng
+     * @return True se a música foi aberta
+     */
+    bool abrirMusica(const std::string &caminho) {
+        auto leitor = Arquivos::sistemaArquivos().abrir(caminho);
+        const auto aberta = leitor ? musica.abrir(std::make_unique<FluxoPacote>(std::move(*leitor)))
+                                   : musica.abrir(std::filesystem::path(caminho));
+        if (!aberta) return false;
+        caminhoAudio = caminho;
+        return true;
+    }
+
+    /**
+     * @brief Ajusta o volume pela sonoridade medida no índice, quando a música está nele
+     *
+     * O SFML não amplifica acima de 100, então só as músicas mais altas que o
+     * alvo mudam; as mais baixas tocam como estão. O índice é chaveado pelo
+     * hash do conteúdo, que a thread da forma de onda calcula ao ler o
+     * arquivo: chamada a cada quadro enquanto ganhoSonoridadePendente, aplica
+     * o ganho assim que o hash chega, sem ler o áudio na thread principal.
+     */
+    void aplicarGanhoSonoridade() {
+        const auto hash = cargaOnda.hashMusica();
+        if (!hash) {
+            // Sem o arquivo não há hash: a música fica no volume neutro
+            if (cargaOnda.falhouLeitura()) ganhoSonoridadePendente = false;
+            return;
+        }
+        ganhoSonoridadePendente = false;
+
+        const auto *entrada = indiceSonoridade.procurar(*hash);
+        if (!entrada) {
+            Log::aviso("Música fora do índice de sonoridade; rode o riff-volume na biblioteca");
+            return;
+        }
+        const auto ganho = std::min(1.0, Sonoridade::ganho(entrada->integradaLufs, entrada->pico));
+        musica.setVolume(static_cast<float>(100.0 * ganho));
+        Log::info("Sonoridade ", entrada->integradaLufs, " LUFS: volume ajustado em ", 20.0 * std::log10(ganho), " dB");
+    }
+
+    /**
+     * @brief Recalcula os cliques do metrônomo a partir do mapa de tempo (ou os tira)
+     *
+     * Cada batida vira um quadro absoluto do áudio; a thread de áudio soma o
+     * clique nesse quadro, então ele não deriva da música.
+     */
+    void atualizarMetronomo() {
+        if (!metronomoAtivo || !chartCarregado || !calculadoraTempoOpt) {
+            musica.definirCliques({});
+            return;
+        }
+
+        const auto taxa = static_cast<double>(musica.getSampleRate());
+        const auto batidas = Chart::batidas(*dadosChartOpt, *calculadoraTempoOpt, musica.duracaoSegundos());
+        std::vector<Audio::Clique> cliques;
+        cliques.reserve(batidas.size());
+        for (const auto &batida : batidas) {
+            if (batida.segundos < 0.0) continue;
+            cliques.push_back({static_cast<std::uint64_t>(std::llround(batida.segundos * taxa)), batida.inicioCompasso});
+        }
+        musica.definirCliques(std::move(cliques));
+    }
+
+    void alternarMetronomo() {
+        metronomoAtivo = !metronomoAtivo;
+        atualizarMetronomo();
+        Log::info("Metrônomo ", metronomoAtivo ? "ligado" : "desligado");
     }
 
     /**
@@ -863,10 +3806,10 @@ private:
     void carregarAudio() {
         mensagemStatus = utf8ParaSfString("Carregando áudio...");
 
-        std::string nomeArquivoAudio = dadosChartOpt->streamMusica.isEmpty() ?
-                                      "song.ogg" : sfStringParaUtf8(dadosChartOpt->streamMusica);
+        std::string nomeArquivoAudio = (diretorioMusica / (dadosChartOpt->streamMusica.isEmpty() ?
+                                      "song.ogg" : sfStringParaUtf8(dadosChartOpt->streamMusica))).string();
 
-        if (!musica.openFromFile(nomeArquivoAudio)) {
+        if (!abrirMusica(nomeArquivoAudio)) {
             // Tenta extensões alternativas
             const auto posicaoPonto = nomeArquivoAudio.rfind('.');
             const std::string nomeBase = (posicaoPonto == std::string::npos) ?
@@ -875,20 +3818,26 @@ private:
             constexpr std::array<std::string_view, 4> extensoes = {".ogg", ".wav", ".flac", ".mp3"};
 
             const bool encontrado = std::ranges::any_of(extensoes, [&](const std::string_view ext) {
-                return musica.openFromFile(nomeBase + std::string(ext));
+                return abrirMusica(nomeBase + std::string(ext));
             });
 
             if (!encontrado) {
                 mensagemStatus = utf8ParaSfString("Erro: Arquivo de áudio não encontrado. Tentou: " +
                                nomeArquivoAudio + " e variantes.");
-                std::cerr << "Erro: Arquivo de áudio não encontrado. Tentou: " <<
-                          nomeArquivoAudio << " e variantes." << std::endl;
+                Log::erro("Arquivo de áudio não encontrado. Tentou: ", nomeArquivoAudio, " e variantes.");
                 chartCarregado = false;
                 return;
             }
         }
 
         chartCarregado = true;
+        cargaOnda.pedir(caminhoAudio);
+        musica.setVolume(100.f);
+        ganhoSonoridadePendente = indiceSonoridade.tamanho() > 0;
+        atualizarMetronomo();
+
+        // Um bloco de amostras de 16 bits entregue ao mixer por vez, mais a conversão de taxa
+        Memoria::definir(Memoria::Subsistema::Audio, static_cast<std::int64_t>(musica.bytesBuffers()));
 
         if (fonte.getInfo().family.empty()) {
             mensagemStatus = utf8ParaSfString("Erro: Fonte não carregada. Texto não será exibido.");
@@ -897,9 +3846,9 @@ private:
             mensagemStatus = utf8ParaSfString(textoStatus);
         }
 
-        std::cout << "Chart carregado. Notas: " << todasNotasMusicaMestre.size() / 2
-                  << ". Música: " << sfStringParaUtf8(dadosChartOpt->nome) << " por "
-                  << sfStringParaUtf8(dadosChartOpt->artista) << std::endl;
+        Log::info("Chart carregado. Notas: ", todasNotasMusicaMestre.size() / 2,
+                  ". Música: ", sfStringParaUtf8(dadosChartOpt->nome), " por ",
+                  sfStringParaUtf8(dadosChartOpt->artista));
     }
 
     /**
@@ -917,7 +3866,7 @@ private:
         jogador1.pontuacao = 0;
         jogador1.comboAtual = 0;
         jogador1.maiorCombo = 0;
-        jogador1.multiplicadorCombo = 1.0f;
+        jogador1.multiplicadorCombo = ESCALA_PONTO_FIXO;
         jogador1.teclasPresionadas.clear();
         jogador1.historicoNotasAcertadas = std::stack<std::pair<int, sf::Time>>(); // Limpa a stack
         for (auto &entrada : jogador1.pistaPermiteAcertoNotaCurta) entrada.second = true;
@@ -925,7 +3874,7 @@ private:
         jogador2.pontuacao = 0;
         jogador2.comboAtual = 0;
         jogador2.maiorCombo = 0;
-        jogador2.multiplicadorCombo = 1.0f;
+        jogador2.multiplicadorCombo = ESCALA_PONTO_FIXO;
         jogador2.teclasPresionadas.clear();
         jogador2.historicoNotasAcertadas = std::stack<std::pair<int, sf::Time>>(); // Limpa a stack
         for (auto &entrada : jogador2.pistaPermiteAcertoNotaCurta) entrada.second = true;
@@ -935,8 +3884,8 @@ private:
         notasJ2.clear();
 
         // Limpa queues de partículas
-        particulasAtivas = std::queue<Particula>();
-        particulasReutilizaveis = std::queue<Particula>();
+        particulasAtivas = decltype(particulasAtivas)();
+        particulasReutilizaveis = decltype(particulasReutilizaveis)();
 
         // Cria instâncias das notas para o jogo
         for (const auto &notaModelo : todasNotasMusicaMestre) {
@@ -956,20 +3905,91 @@ private:
         };
         std::ranges::sort(notasJ1, ordenarPorTempo);
         std::ranges::sort(notasJ2, ordenarPorTempo);
+        janelaNotasJ1.reiniciar();
+        janelaNotasJ2.reiniciar();
+
+        estatisticasTravamento.reiniciar();
 
         // Inicia jogo
         jogoIniciado = true;
         jogoRodando = true;
+        estadoPausa = EstadoPausa::Jogando;
         mensagemStatus = utf8ParaSfString("Tocando...");
 
+        // Notas cedo demais para descer a pista inteira: a música começa em tempo negativo, com silêncio
+        // tocado pelo próprio fluxo, então o relógio passa pelo zero sem trocar de fonte
+        auto primeiraNotaSec = ESPERA_PRIMEIRA_NOTA_SEC;
+        for (const auto *notas : {&notasJ1, &notasJ2}) {
+            if (!notas->empty()) primeiraNotaSec = std::min(primeiraNotaSec, notas->front().timestampSec);
+        }
+        const auto antecedenciaSec = ESPERA_PRIMEIRA_NOTA_SEC - primeiraNotaSec;
+
         musica.stop();
-        musica.setPlayingOffset(sf::Time::Zero);
+        musica.setPlayingOffset(sf::seconds(static_cast<float>(-antecedenciaSec)));
         musica.play();
+        registroMetricas.registrarMusicaTocada();
+        gravadorVoo.registrarEvento("inicio_musica");
 
         relogioLoopJogo.restart();
         tempoDesdeUltimaAtualizacao = sf::Time::Zero;
     }
 
+    /**
+     * @brief Pausa a partida: o áudio para na posição audível e a simulação congela
+     *
+     * Uma pausa durante a contagem mantém o ponto da pausa original.
+     */
+    /**
+     * @brief Esquece as teclas seguradas; sustains precisam ser pegos de novo
+     */
+    void soltarTeclas() {
+        for (auto *jogador : {&jogador1, &jogador2}) {
+            jogador->teclasPresionadas.clear();
+            for (auto &entrada : jogador->pistaPermiteAcertoNotaCurta) entrada.second = true;
+        }
+    }
+
+    void pausarJogo() {
+        musica.pause();
+        if (estadoPausa != EstadoPausa::Contagem) posicaoPausaSec = musica.posicaoSegundos(); // Já congelada
+        estadoPausa = EstadoPausa::Pausado;
+
+        // As teclas soltas durante a pausa não chegariam
+        soltarTeclas();
+        mensagemStatus = utf8ParaSfString("Pausado. Pressione ESC para continuar.");
+        gravadorVoo.registrarEvento("pausa");
+    }
+
+    /**
+     * @brief Continua a partida com pré-rolagem
+     *
+     * O áudio volta CONTAGEM_RETOMADA_SEC e toca; as notas sobem e descem de
+     * novo na pista, sem julgamento, até o relógio do áudio chegar ao ponto da
+     * pausa. O fim da contagem sai do mesmo relógio que julga as notas, então
+     * nenhuma nota é julgada duas vezes nem pulada.
+     */
+    void continuarJogo() {
+        // Perto do início a pré-rolagem cai na antecedência em silêncio
+        const auto retomadaSec = posicaoPausaSec - CONTAGEM_RETOMADA_SEC;
+        musica.setPlayingOffset(sf::seconds(static_cast<float>(retomadaSec)));
+        // As notas voltam para onde estavam no ponto da retomada, e não para onde a pausa as deixou
+        janelaNotasJ1.reposicionar(notasJ1, retomadaSec + OFFSET_LATENCIA_AUDIO_SEC);
+        janelaNotasJ2.reposicionar(notasJ2, retomadaSec + OFFSET_LATENCIA_AUDIO_SEC);
+        musica.play();
+        estadoPausa = EstadoPausa::Contagem;
+        tempoDesdeUltimaAtualizacao = sf::Time::Zero;
+        mensagemStatus = utf8ParaSfString("Preparar...");
+        gravadorVoo.registrarEvento("continuacao");
+    }
+
+    void alternarPausa() {
+        if (estadoPausa == EstadoPausa::Pausado) {
+            continuarJogo();
+        } else if (musica.getStatus() == sf::SoundSource::Status::Playing) {
+            pausarJogo();
+        }
+    }
+
     /**
      * @brief Obtém uma partícula da pool ou cria uma nova usando queue
      */
@@ -1063,7 +4083,7 @@ private:
                 textoLinha.setPosition({std::round(x - larguraMaxima / 2.f), std::round(yAtual)});
             }
 
-            janela.draw(textoLinha);
+            desenhar(textoLinha);
             yAtual += limites.size.y + 2.f;
             alturaTotal += limites.size.y + 2.f;
         }
@@ -1075,16 +4095,201 @@ private:
      * @brief Processa eventos de entrada
      */
     void processarEventos() {
+#if defined(__linux__)
+        // Com evdev ativo as teclas vêm do kernel; os eventos de teclado da janela são ignorados
+        const bool teclasViaJanela = !entradaEvdev.has_value();
+#else
+        constexpr bool teclasViaJanela = true;
+#endif
+
         std::optional<sf::Event> eventoOpt;
         while ((eventoOpt = janela.pollEvent())) {
             if (eventoOpt->is<sf::Event::Closed>()) {
                 janela.close();
-            } else if (const auto *teclaPress = eventoOpt->getIf<sf::Event::KeyPressed>()) {
+            } else if (const auto *teclaPress = eventoOpt->getIf<sf::Event::KeyPressed>(); teclaPress && editor) {
+                // O editor sempre usa o teclado da janela
+                processarTeclaEditor(*teclaPress);
+            } else if (const auto *rolagem = eventoOpt->getIf<sf::Event::MouseWheelScrolled>(); rolagem && editor) {
+                editor->moverCursor(rolagem->delta > 0 ? 1 : -1);
+            } else if (teclaPress && teclasViaJanela) {
                 processarTeclaPress(teclaPress->code);
-            } else if (const auto *teclaRelease = eventoOpt->getIf<sf::Event::KeyReleased>()) {
+            } else if (const auto *teclaRelease = eventoOpt->getIf<sf::Event::KeyReleased>(); teclaRelease && teclasViaJanela) {
                 processarTeclaRelease(teclaRelease->code);
             }
+            else if (eventoOpt->is<sf::Event::FocusLost>()) {
+                // Teclas soltas sem foco não chegam (nem pelo evdev, ignorado sem foco) e ficariam presas
+                soltarTeclas();
+#if defined(__linux__)
+                janelaComFoco = false;
+#endif
+            }
+#if defined(__linux__)
+            else if (eventoOpt->is<sf::Event::FocusGained>()) {
+                janelaComFoco = true;
+            }
+#endif
+        }
+
+#if defined(__linux__)
+        if (entradaEvdev) {
+            processarEventosEvdev();
+        }
+#endif
+    }
+
+#if defined(__linux__)
+    /**
+     * @brief Processa as teclas lidas pela thread evdev desde o último quadro
+     *
+     * O atraso entre o timestamp do kernel e agora é descontado do tempo da
+     * música, então o acerto é julgado no instante real em que a tecla foi
+     * pressionada, e não quando o quadro drenou a fila.
+     */
+    void processarEventosEvdev() {
+        entradaEvdev->drenar(eventosEvdev);
+        if (!janelaComFoco || editor) return;
+
+        const auto agoraUs = EntradaEvdev::agoraMonotonicoUs();
+        for (const auto &evento : eventosEvdev) {
+            const auto indiceJogador = entradaEvdev->indiceJogadorDoDispositivo(evento.dispositivo);
+            Jogador *somenteJogador = indiceJogador == 0 ? &jogador1 : indiceJogador == 1 ? &jogador2 : nullptr;
+
+            const auto atrasoUs = std::max<std::int64_t>(0, agoraUs - evento.timestampUs);
+            estatisticasTravamento.registrarAtrasoEntrada(sf::microseconds(atrasoUs));
+
+            if (evento.pressionada) {
+                const auto atrasoSec = static_cast<double>(atrasoUs) / 1'000'000.0;
+                processarTeclaPress(evento.tecla, atrasoSec, somenteJogador);
+            } else {
+                processarTeclaRelease(evento.tecla, somenteJogador);
+            }
+        }
+    }
+#endif
+
+    /**
+     * @brief Abre o editor sobre o chart carregado
+     */
+    void abrirEditor() {
+        editor.emplace(*dadosChartOpt, *calculadoraTempoOpt);
+        mensagemStatus = sf::String();
+        Log::info("Editor aberto com ", editor->notas().tamanho(), " notas");
+    }
+
+    /**
+     * @brief Fecha o editor e reconverte as notas para a próxima partida
+     */
+    void fecharEditor() {
+        musica.stop();
+        editor->concluir();
+        const bool modificado = editor->foiModificado();
+        editor.reset();
+        if (modificado) converterNotas();
+        mensagemStatus = utf8ParaSfString("Pressione ESPAÇO para Iniciar!");
+    }
+
+    /**
+     * @brief Grava o chart editado por cima do original (Ctrl+S)
+     *
+     * O texto original é repassado ao escritor para que outras dificuldades,
+     * eventos e star power continuem no arquivo. O [Song] gravado é o do
+     * próprio chart: o song.ini aplicado na carga não vai parar no arquivo.
+     */
+    void gravarChartEditor() {
+        const auto caminhoChart = diretorioMusica / CAMINHO_ARQUIVO_CHART;
+        editor->concluir();
+        auto paraGravar = editor->dados();
+        static_cast<Chart::MetadadosMusica &>(paraGravar) = metadadosChart;
+        if (Chart::EscritorChart::gravar(caminhoChart, paraGravar, lerArquivoUtf8(caminhoChart.string()))) {
+            editor->marcarGravado();
+            mensagemStatus = utf8ParaSfString("Chart gravado em " + caminhoChart.string());
+            Log::info("Chart gravado: ", caminhoChart.string(), " (", editor->notas().tamanho(), " notas)");
+        } else {
+            mensagemStatus = utf8ParaSfString("Erro: Não foi possível gravar " + caminhoChart.string());
+        }
+    }
+
+    /**
+     * @brief Toca o áudio a partir do cursor, ou pausa e encaixa o cursor na grade
+     */
+    void alternarReproducaoEditor() {
+        if (musica.getStatus() == sf::SoundSource::Status::Playing) {
+            musica.pause();
+            editor->encaixarNaGrade();
+            return;
         }
+        const auto segundos = editor->tempo().ticksParaSegundos(editor->cursor()) - OFFSET_LATENCIA_AUDIO_SEC;
+        musica.setPlayingOffset(sf::seconds(static_cast<float>(std::max(0.0, segundos))));
+        musica.play();
+    }
+
+    /**
+     * @brief Teclas do editor
+     *
+     * Setas movem o cursor pela grade (Ctrl move as notas do cursor), esquerda e
+     * direita mudam a grade, 1 a 5 colocam ou tiram notas, + e - mudam o sustain,
+     * [ e ] mudam o BPM (Shift: 0,1), vírgula e ponto mudam o compasso, Delete
+     * remove marcadores, Ctrl+Z/Ctrl+Y desfazem e refazem, Ctrl+S grava, Espaço
+     * toca, F4 liga o metrônomo e F2 sai.
+     */
+    void processarTeclaEditor(const sf::Event::KeyPressed &tecla) {
+        using Key = sf::Keyboard::Key;
+        const auto passoBpm = tecla.shift ? 100 : 1000;
+        bool temposMudaram = false; // Só então as batidas do metrônomo são recalculadas
+
+        switch (tecla.code) {
+            case Key::F2: fecharEditor(); break;
+            case Key::F3: painelDesempenhoVisivel = !painelDesempenhoVisivel; break;
+            case Key::F4: alternarMetronomo(); break;
+            case Key::Space: alternarReproducaoEditor(); break;
+            case Key::Up: tecla.control ? editor->moverNotasNoCursor(1) : editor->moverCursor(1); break;
+            case Key::Down: tecla.control ? editor->moverNotasNoCursor(-1) : editor->moverCursor(-1); break;
+            case Key::PageUp: editor->moverCursorCompasso(1); break;
+            case Key::PageDown: editor->moverCursorCompasso(-1); break;
+            case Key::Home: editor->posicionarCursor(0); break;
+            case Key::Right: editor->alterarDivisao(1); break;
+            case Key::Left: editor->alterarDivisao(-1); break;
+            case Key::Num1: editor->alternarNota(0); break;
+            case Key::Num2: editor->alternarNota(1); break;
+            case Key::Num3: editor->alternarNota(2); break;
+            case Key::Num4: editor->alternarNota(3); break;
+            case Key::Num5: editor->alternarNota(4); break;
+            case Key::Equal: editor->ajustarSustain(1); break;
+            case Key::Hyphen: editor->ajustarSustain(-1); break;
+            case Key::RBracket:
+                editor->ajustarBpm(passoBpm);
+                temposMudaram = true;
+                break;
+            case Key::LBracket:
+                editor->ajustarBpm(-passoBpm);
+                temposMudaram = true;
+                break;
+            case Key::Period:
+                editor->ajustarNumeradorAssinatura(1);
+                temposMudaram = true;
+                break;
+            case Key::Comma:
+                editor->ajustarNumeradorAssinatura(-1);
+                temposMudaram = true;
+                break;
+            case Key::Delete:
+                editor->removerMarcadoresNoCursor();
+                temposMudaram = true;
+                break;
+            case Key::Z:
+                // Desfazer e refazer podem trazer de volta um tempo ou compasso
+                if (tecla.control) temposMudaram = tecla.shift ? editor->refazer() : editor->desfazer();
+                break;
+            case Key::Y:
+                if (tecla.control) temposMudaram = editor->refazer();
+                break;
+            case Key::S:
+                if (tecla.control) gravarChartEditor();
+                break;
+            default: break;
+        }
+
+        if (temposMudaram && editor && metronomoAtivo) atualizarMetronomo();
     }
 
     /**
@@ -1095,24 +4300,34 @@ private:
         if (!jogoRodando) return;
 
         const auto dtSec = dt.asSeconds();
-        const auto tempoAudioBruto = musica.getPlayingOffset();
-        const auto tempoAtualMusicaSec = tempoAudioBruto.asSeconds() + OFFSET_LATENCIA_AUDIO_SEC;
-
-        atualizarLogicaJogador(notasJ1, tempoAtualMusicaSec, dtSec);
-        atualizarLogicaJogador(notasJ2, tempoAtualMusicaSec, dtSec);
-        atualizarSustainParaJogador(jogador1, notasJ1, tempoAtualMusicaSec, dt);
-        atualizarSustainParaJogador(jogador2, notasJ2, tempoAtualMusicaSec, dt);
+        const auto tempoAudioSec = musica.posicaoSegundos();
+        if (estadoPausa == EstadoPausa::Contagem && tempoAudioSec >= posicaoPausaSec) {
+            estadoPausa = EstadoPausa::Jogando;
+            mensagemStatus = utf8ParaSfString("Tocando...");
+        }
+        const auto tempoAtualMusicaSec = tempoAudioSec + OFFSET_LATENCIA_AUDIO_SEC;
+
+        atualizarLogicaJogador(notasJ1, janelaNotasJ1, tempoAtualMusicaSec, dtSec);
+        atualizarLogicaJogador(notasJ2, janelaNotasJ2, tempoAtualMusicaSec, dtSec);
+        // Na pré-rolagem o trecho antes da pausa já pontuou
+        if (estadoPausa == EstadoPausa::Jogando) {
+            atualizarSustainParaJogador(jogador1, notasJ1, janelaNotasJ1, tempoAtualMusicaSec, dt);
+            atualizarSustainParaJogador(jogador2, notasJ2, janelaNotasJ2, tempoAtualMusicaSec, dt);
+        }
         atualizarParticulas(dt);
 
         // Verifica fim da música
         if (musica.getStatus() != sf::SoundSource::Status::Playing && jogoIniciado) {
-            const auto temNotasAtivas = [](const std::vector<Nota> &notas) {
-                return std::ranges::any_of(notas, [](const Nota &nota) {
-                    return nota.naTela && !nota.acertada && !nota.perdida;
+            const auto temNotasAtivas = [](const VetorNotas &notas, const JanelaNotas &janelaNotas) {
+                bool encontrou = false;
+                janelaNotas.paraCadaNota([&](const std::size_t indice) {
+                    const auto &nota = notas[indice];
+                    encontrou = encontrou || (nota.naTela && !nota.acertada && !nota.perdida);
                 });
+                return encontrou;
             };
 
-            if (!temNotasAtivas(notasJ1) && !temNotasAtivas(notasJ2)) {
+            if (!temNotasAtivas(notasJ1, janelaNotasJ1) && !temNotasAtivas(notasJ2, janelaNotasJ2)) {
                 jogoRodando = false;
             }
         }
@@ -1121,12 +4336,18 @@ private:
     /**
      * @brief Atualiza lógica das notas de um jogador
      * @param notasJogador Notas do jogador
+     * @param janelaNotas Janela de notas relevantes do jogador
      * @param tempoMusicaSec Tempo atual da música em segundos
      * @param dtSec Delta time em segundos (não usado)
      */
-    void atualizarLogicaJogador(std::vector<Nota> &notasJogador, const double tempoMusicaSec,
-                               const float /*dtSec_naoUsado*/) {
-        for (auto &nota : notasJogador) {
+    void atualizarLogicaJogador(VetorNotas &notasJogador, JanelaNotas &janelaNotas,
+                               const double tempoMusicaSec, const float /*dtSec_naoUsado*/) {
+        janelaNotas.avancar(notasJogador, tempoMusicaSec);
+
+        janelaNotas.paraCadaNota([&](const std::size_t indice) {
+            auto &nota = notasJogador[indice];
+            ++notasProcessadasQuadro;
+
             // Sempre atualiza posição para que notas continuem caindo naturalmente
             const auto tempoAteAcerto = nota.timestampSec - tempoMusicaSec;
             const auto yAlvo = static_cast<float>(Y_ZONA_ACERTO - (tempoAteAcerto * VELOCIDADE_QUEDA_NOTA_PPS));
@@ -1135,7 +4356,7 @@ private:
             // Pula lógica para notas perdidas, mas ainda atualiza visibilidade
             if (nota.perdida) {
                 atualizarVisibilidadeNota(nota);
-                continue;
+                return;
             }
 
             atualizarVisibilidadeNota(nota);
@@ -1143,7 +4364,9 @@ private:
             if (nota.naTela && !nota.acertada) {
                 verificarNotaPerdida(nota, tempoMusicaSec);
             }
-        }
+        });
+
+        janelaNotas.descartarNotasQueSairam(notasJogador);
     }
 
     /**
@@ -1195,7 +4418,7 @@ private:
      * @param nota Nota a verificar
      * @param tempoMusicaSec Tempo atual da música
      */
-    void verificarNotaPerdida(Nota &nota, const double tempoMusicaSec) const {
+    void verificarNotaPerdida(Nota &nota, const double tempoMusicaSec) {
         constexpr float raioCapeca = ALTURA_NOTA / 2.f;
 
         if (!nota.ehNotaLonga && nota.posicaoY > Y_ZONA_ACERTO + ALTURA_ZONA_ACERTO + raioCapeca) {
@@ -1204,6 +4427,7 @@ private:
             // Quebra combo quando perde uma nota
             if (nota.dono && !nota.acertada) {
                 nota.dono->quebrarCombo();
+                registroMetricas.registrarJulgamento(Metricas::Julgamento::Erro);
             }
         } else if (nota.ehNotaLonga && tempoMusicaSec > nota.tempoFimSustainSec +
                   (static_cast<double>(TOLERANCIA_ACERTO_MS) / 1000.0)) {
@@ -1212,6 +4436,7 @@ private:
             // Quebra combo quando perde uma nota longa
             if (nota.dono && !nota.acertada) {
                 nota.dono->quebrarCombo();
+                registroMetricas.registrarJulgamento(Metricas::Julgamento::Erro);
             }
         }
     }
@@ -1220,15 +4445,17 @@ private:
      * @brief Atualiza sistema de sustain para um jogador
      * @param jogador Jogador
      * @param notas Notas do jogador
+     * @param janelaNotas Janela de notas relevantes do jogador
      * @param tempoMusicaSec Tempo atual da música
      * @param dt Delta time
      */
-    void atualizarSustainParaJogador(Jogador &jogador, std::vector<Nota> &notas,
+    void atualizarSustainParaJogador(Jogador &jogador, VetorNotas &notas, const JanelaNotas &janelaNotas,
                                     const double tempoMusicaSec, const sf::Time dt) {
-        for (auto &nota : notas) {
+        janelaNotas.paraCadaNota([&](const std::size_t indice) {
+            auto &nota = notas[indice];
             if (!nota.ehNotaLonga || nota.sustainCompleto || nota.perdida ||
                 !nota.naTela || !nota.acertada) {
-                continue;
+                return;
             }
 
             const bool teclaPresionadaParaPista = std::ranges::any_of(
@@ -1257,7 +4484,7 @@ private:
                 nota.sustainAtivo = false;
                 jogador.adicionarPontuacao(20);
             }
-        }
+        });
     }
 
     /**
@@ -1357,25 +4584,51 @@ private:
     /**
      * @brief Processa tecla pressionada
      * @param tecla Tecla que foi pressionada
+     * @param atrasoSec Há quanto tempo a tecla foi de fato pressionada
+     * @param somenteJogador Se não for nulo, a tecla só vale para este jogador
      */
-    void processarTeclaPress(const sf::Keyboard::Key tecla) {
+    void processarTeclaPress(const sf::Keyboard::Key tecla, const double atrasoSec = 0.0,
+                             const Jogador *somenteJogador = nullptr) {
         if (tecla == sf::Keyboard::Key::Space && !jogoIniciado && chartCarregado) {
             iniciarJogo();
             return;
         }
 
+        if (tecla == sf::Keyboard::Key::F3) {
+            painelDesempenhoVisivel = !painelDesempenhoVisivel;
+            return;
+        }
+
+        if (tecla == sf::Keyboard::Key::F4) {
+            alternarMetronomo();
+            return;
+        }
+
+        if (tecla == sf::Keyboard::Key::F2 && !jogoIniciado && chartCarregado) {
+            abrirEditor();
+            return;
+        }
+
         if (!jogoRodando) return;
 
-        const auto processarTeclaPressJogador = [&](Jogador &jogador, std::vector<Nota> &notasJogador) {
+        if (tecla == sf::Keyboard::Key::Escape) {
+            alternarPausa();
+            return;
+        }
+
+        const auto processarTeclaPressJogador = [&](Jogador &jogador, VetorNotas &notasJogador,
+                                                    const JanelaNotas &janelaNotas) {
+            if (somenteJogador && somenteJogador != &jogador) return;
+
             const auto it = jogador.mapeamentoTeclaPista.find(tecla);
             if (it != jogador.mapeamentoTeclaPista.end()) {
                 jogador.teclasPresionadas.insert(tecla);
                 const int pista = it->second;
 
-                if (jogador.pistaPermiteAcertoNotaCurta[pista]) {
-                    const auto tempoAudioBruto = musica.getPlayingOffset();
-                    const auto tempoAtualMusicaSec = tempoAudioBruto.asSeconds() + OFFSET_LATENCIA_AUDIO_SEC;
-                    const bool notaCurtaFoiAcertada = verificarAcertoNota(jogador, notasJogador,
+                // Na pausa e na contagem a tecla só fica registrada (pode segurar um sustain na volta)
+                if (jogador.pistaPermiteAcertoNotaCurta[pista] && estadoPausa == EstadoPausa::Jogando) {
+                    const auto tempoAtualMusicaSec = musica.posicaoSegundos() + OFFSET_LATENCIA_AUDIO_SEC - atrasoSec;
+                    const bool notaCurtaFoiAcertada = verificarAcertoNota(jogador, notasJogador, janelaNotas,
                                                                         pista, tempoAtualMusicaSec);
                     if (notaCurtaFoiAcertada) {
                         jogador.pistaPermiteAcertoNotaCurta[pista] = false;
@@ -1384,18 +4637,21 @@ private:
             }
         };
 
-        processarTeclaPressJogador(jogador1, notasJ1);
-        processarTeclaPressJogador(jogador2, notasJ2);
+        processarTeclaPressJogador(jogador1, notasJ1, janelaNotasJ1);
+        processarTeclaPressJogador(jogador2, notasJ2, janelaNotasJ2);
     }
 
     /**
      * @brief Processa tecla liberada
      * @param tecla Tecla que foi liberada
+     * @param somenteJogador Se não for nulo, a tecla só vale para este jogador
      */
-    void processarTeclaRelease(const sf::Keyboard::Key tecla) {
+    void processarTeclaRelease(const sf::Keyboard::Key tecla, const Jogador *somenteJogador = nullptr) {
         if (!jogoRodando) return;
 
         const auto processarTeclaReleaseJogador = [&](Jogador &jogador) {
+            if (somenteJogador && somenteJogador != &jogador) return;
+
             const auto it = jogador.mapeamentoTeclaPista.find(tecla);
             if (it != jogador.mapeamentoTeclaPista.end()) {
                 jogador.teclasPresionadas.erase(tecla);
@@ -1411,19 +4667,26 @@ private:
      * @brief Verifica se uma nota foi acertada e atualiza o sistema de combo
      * @param jogador Jogador que tentou acertar
      * @param notas Notas do jogador
+     * @param janelaNotas Janela de notas relevantes do jogador
      * @param pistaAlvo Pista da tecla pressionada
      * @param tempoMusicaSec Tempo atual da música
      * @return True se alguma nota foi acertada
      */
-    bool verificarAcertoNota(Jogador &jogador, std::vector<Nota> &notas,
+    bool verificarAcertoNota(Jogador &jogador, VetorNotas &notas, const JanelaNotas &janelaNotas,
                            const int pistaAlvo, const double tempoMusicaSec) {
-        for (auto &nota : notas) {
-            if (nota.pista == pistaAlvo && !nota.acertada && !nota.perdida && nota.naTela &&
+        bool notaJaAcertada = false;
+
+        janelaNotas.paraCadaNota([&](const std::size_t indice) {
+            auto &nota = notas[indice];
+            if (!notaJaAcertada && nota.pista == pistaAlvo && !nota.acertada && !nota.perdida && nota.naTela &&
                 nota.posicaoY >= (Y_ZONA_ACERTO - ALTURA_NOTA) &&
                 nota.posicaoY <= (Y_ZONA_ACERTO + ALTURA_ZONA_ACERTO + ALTURA_NOTA) &&
                 (std::abs(nota.timestampSec - tempoMusicaSec) * 1000.0) <= TOLERANCIA_ACERTO_MS) {
 
                 nota.acertada = true;
+                notaJaAcertada = true;
+                registroMetricas.registrarJulgamento(
+                    Metricas::julgarAcerto(std::abs(nota.timestampSec - tempoMusicaSec) * 1000.0));
 
                 // Registra nota acertada na stack para sistema de combo
                 jogador.registrarNotaAcertada(nota.pista, sf::seconds(tempoMusicaSec));
@@ -1437,10 +4700,8 @@ private:
                 } else {
                     jogador.adicionarPontuacao(10);
                 }
-
-                return false;
             }
-        }
+        });
 
         return false;
     }
@@ -1449,24 +4710,60 @@ private:
      * @brief Renderiza todos os elementos do jogo
      */
     void renderizar() {
+        using Rastreamento::Passo;
+        const Rastreamento::ZonaTempo zonaRenderizacao(gravadorVoo, "renderizacao");
+        temporizadorGpu.iniciarQuadro(gravadorVoo);
+        {
+            const Rastreamento::ZonaTempo zona(gravadorVoo, "envio_capas");
+            cacheCapas.enviarPendentes(ENVIOS_CAPAS_POR_QUADRO);
+        }
         janela.clear(sf::Color::Black);
 
         // Desenha fundo com shader se disponível
-        if (shadersDisponiveis && shaderFundo.getNativeHandle() != 0) {
-            shaderFundo.setUniform(UNIFORM_RESOLUCAO, sf::Glsl::Vec2{LARGURA_JANELA, ALTURA_JANELA});
-            shaderFundo.setUniform(UNIFORM_TEMPO, relogioAnimacaoShader.getElapsedTime().asSeconds());
-            janela.draw(formaPreenchimentoFundo, &shaderFundo);
-        } else {
-            janela.draw(formaPreenchimentoFundo);
+        {
+            const Rastreamento::EscopoPasso passo(gravadorVoo, temporizadorGpu, Passo::Fundo);
+            if (shadersDisponiveis && shaderFundo.getNativeHandle() != 0) {
+                shaderFundo.setUniform(UNIFORM_RESOLUCAO, sf::Glsl::Vec2{LARGURA_JANELA, ALTURA_JANELA});
+                shaderFundo.setUniform(UNIFORM_TEMPO, relogioAnimacaoShader.getElapsedTime().asSeconds());
+                desenhar(formaPreenchimentoFundo, &shaderFundo);
+            } else {
+                desenhar(formaPreenchimentoFundo);
+            }
         }
 
-        if (chartCarregado && dadosChartOpt) {
-            desenharAreaJogador(jogador1, notasJ1);
-            desenharAreaJogador(jogador2, notasJ2);
+        if (editor) {
+            const Rastreamento::EscopoPasso passo(gravadorVoo, temporizadorGpu, Passo::Notas);
+            desenharEditor();
+        } else if (chartCarregado && dadosChartOpt) {
+            const Rastreamento::EscopoPasso passo(gravadorVoo, temporizadorGpu, Passo::Notas);
+            desenharAreaJogador(jogador1, notasJ1, janelaNotasJ1);
+            desenharAreaJogador(jogador2, notasJ2, janelaNotasJ2);
+        }
+
+        {
+            const Rastreamento::EscopoPasso passo(gravadorVoo, temporizadorGpu, Passo::Texto);
+            if (editor) {
+                desenharPainelEditor();
+            } else {
+                desenharPainelCentral();
+            }
+        }
+        {
+            const Rastreamento::EscopoPasso passo(gravadorVoo, temporizadorGpu, Passo::Particulas);
+            desenharParticulas();
+        }
+        if (jogoRodando && estadoPausa != EstadoPausa::Jogando) {
+            const Rastreamento::EscopoPasso passo(gravadorVoo, temporizadorGpu, Passo::Texto);
+            desenharPausa();
+        }
+        if (painelDesempenhoVisivel) {
+            const Rastreamento::EscopoPasso passo(gravadorVoo, temporizadorGpu, Passo::Painel);
+            desenharPainelDesempenho();
         }
+        temporizadorGpu.concluirQuadro();
 
-        desenharPainelCentral();
-        desenharParticulas();
+        // Inclui a espera do vsync
+        const Rastreamento::ZonaTempo zonaApresentacao(gravadorVoo, "apresentacao");
         janela.display();
     }
 
@@ -1474,10 +4771,12 @@ private:
      * @brief Desenha área de um jogador (brasteado + notas)
      * @param jogador Jogador
      * @param notas Notas do jogador
+     * @param janelaNotas Janela de notas relevantes do jogador
      */
-    void desenharAreaJogador(const Jogador &jogador, const std::vector<Nota> &notas) {
+    void desenharAreaJogador(const Jogador &jogador, const VetorNotas &notas,
+                             const JanelaNotas &janelaNotas) {
         desenharBrasteado(jogador);
-        desenharNotasJogo(notas, jogador);
+        desenharNotasJogo(notas, janelaNotas, jogador);
     }
 
     /**
@@ -1498,7 +4797,7 @@ private:
         fundoPainel.setFillColor(sf::Color(20, 20, 30, 200));
         fundoPainel.setOutlineColor(sf::Color(128, 128, 128));  // Borda cinza
         fundoPainel.setOutlineThickness(2.f);
-        janela.draw(fundoPainel);
+        desenhar(fundoPainel);
 
         auto yAtual = std::round(yPainel + 20.f);
         const auto xCentroTexto = std::round(xPainel + larguraPainel / 2.f);
@@ -1507,6 +4806,19 @@ private:
         if (chartCarregado && dadosChartOpt) {
             const float larguraMaxTexto = larguraPainel - 20.f; // Margem de 10px de cada lado
 
+            // Capa do álbum (aparece quando a miniatura fica pronta)
+            if (!caminhoCapa.empty()) {
+                if (const auto *texturaCapa = cacheCapas.obter(caminhoCapa)) {
+                    const auto tamanho = texturaCapa->getSize();
+                    const auto escala = LADO_CAPA_PAINEL / static_cast<float>(std::max(tamanho.x, tamanho.y));
+                    sf::Sprite capa(*texturaCapa);
+                    capa.setScale({escala, escala});
+                    capa.setPosition({std::round(xCentroTexto - tamanho.x * escala / 2.f), yAtual});
+                    desenhar(capa);
+                }
+                yAtual += LADO_CAPA_PAINEL + 12.f; // Espaço reservado: o texto não pula quando a capa chega
+            }
+
             // Título da música (2x maior)
             yAtual += desenharTextoQuebrado(dadosChartOpt->nome, sf::Color::White, 28,
                                           xCentroTexto, yAtual, larguraMaxTexto);
@@ -1549,10 +4861,15 @@ private:
             } else {
                 yAtual += 15.f;
             }
+
+            // Música inteira (espaço reservado, como o da capa), com a posição de reprodução
+            const auto tocando = musica.getStatus() == sf::SoundSource::Status::Playing;
+            desenharVisaoGeralOnda(yAtual, tocando ? musica.posicaoSegundos() : -1.0);
+            yAtual += ALTURA_VISAO_GERAL_ONDA + 15.f;
         }
 
         // Função auxiliar para formatar pontuação com vírgulas
-        auto formatarPontuacao = [](int pontuacao) -> std::string {
+        auto formatarPontuacao = [](const std::int64_t pontuacao) -> std::string {
             std::string str = std::to_string(pontuacao);
             std::string resultado;
             int contador = 0;
@@ -1575,7 +4892,7 @@ private:
         const auto limitesP1 = pontuacaoP1.getLocalBounds();
         pontuacaoP1.setOrigin({limitesP1.position.x + limitesP1.size.x / 2.f, limitesP1.position.y});
         pontuacaoP1.setPosition({xCentroTexto, yAtual});
-        janela.draw(pontuacaoP1);
+        desenhar(pontuacaoP1);
         yAtual += limitesP1.size.y + 8.f;
 
         // Desenha combo e multiplicador para jogador 1
@@ -1586,7 +4903,7 @@ private:
         const auto limitesComboP1 = comboP1.getLocalBounds();
         comboP1.setOrigin({limitesComboP1.position.x + limitesComboP1.size.x / 2.f, limitesComboP1.position.y});
         comboP1.setPosition({xCentroTexto, yAtual});
-        janela.draw(comboP1);
+        desenhar(comboP1);
         yAtual += limitesComboP1.size.y + 20.f;
 
         const sf::String textoP2 = jogador2.nome + utf8ParaSfString("\n" + formatarPontuacao(jogador2.pontuacao));
@@ -1595,7 +4912,7 @@ private:
         const auto limitesP2 = pontuacaoP2.getLocalBounds();
         pontuacaoP2.setOrigin({limitesP2.position.x + limitesP2.size.x / 2.f, limitesP2.position.y});
         pontuacaoP2.setPosition({xCentroTexto, yAtual});
-        janela.draw(pontuacaoP2);
+        desenhar(pontuacaoP2);
         yAtual += limitesP2.size.y + 8.f;
 
         // Desenha combo e multiplicador para jogador 2
@@ -1606,7 +4923,7 @@ private:
         const auto limitesComboP2 = comboP2.getLocalBounds();
         comboP2.setOrigin({limitesComboP2.position.x + limitesComboP2.size.x / 2.f, limitesComboP2.position.y});
         comboP2.setPosition({xCentroTexto, yAtual});
-        janela.draw(comboP2);
+        desenhar(comboP2);
         yAtual += limitesComboP2.size.y + 25.f;
 
         // Desenha maior combo dos jogadores
@@ -1618,14 +4935,13 @@ private:
             const auto limitesMaiorCombo = maiorCombo.getLocalBounds();
             maiorCombo.setOrigin({limitesMaiorCombo.position.x + limitesMaiorCombo.size.x / 2.f, limitesMaiorCombo.position.y});
             maiorCombo.setPosition({xCentroTexto, yAtual});
-            janela.draw(maiorCombo);
+            desenhar(maiorCombo);
             yAtual += limitesMaiorCombo.size.y + 25.f;
         }
 
         // Desenha tempo da música se estiver tocando
         if ((musica.getStatus() == sf::SoundSource::Status::Playing || jogoIniciado) && chartCarregado) {
-            const auto tempoAudioBruto = musica.getPlayingOffset();
-            const auto tempoEfetivoMusicaSec = tempoAudioBruto.asSeconds() + OFFSET_LATENCIA_AUDIO_SEC;
+            const auto tempoEfetivoMusicaSec = musica.posicaoSegundos() + OFFSET_LATENCIA_AUDIO_SEC;
             std::stringstream streamTempo;
             streamTempo << "Tempo: " << std::fixed << std::setprecision(1) << tempoEfetivoMusicaSec << "s";
 
@@ -1634,7 +4950,7 @@ private:
             const auto limitesTempo = textoTempo.getLocalBounds();
             textoTempo.setOrigin({limitesTempo.position.x + limitesTempo.size.x / 2.f, limitesTempo.position.y});
             textoTempo.setPosition({xCentroTexto, yAtual});
-            janela.draw(textoTempo);
+            desenhar(textoTempo);
             yAtual += limitesTempo.size.y + 35.f;
         }
 
@@ -1674,7 +4990,7 @@ private:
             tituloControles.setOrigin({limitesTituloCtrl.position.x + limitesTituloCtrl.size.x / 2.f,
                                      limitesTituloCtrl.position.y});
             tituloControles.setPosition({xCentroTexto, yControles});
-            janela.draw(tituloControles);
+            desenhar(tituloControles);
 
             float yControlesAtual = yControles + limitesTituloCtrl.size.y + 12.f;
 
@@ -1684,7 +5000,7 @@ private:
             controlesP1.setOrigin({limitesCtrlP1.position.x + limitesCtrlP1.size.x / 2.f,
                                  limitesCtrlP1.position.y});
             controlesP1.setPosition({xCentroTexto, yControlesAtual});
-            janela.draw(controlesP1);
+            desenhar(controlesP1);
             yControlesAtual += limitesCtrlP1.size.y + 8.f;
 
             sf::Text controlesP2(fonte, utf8ParaSfString("J2: J K L ; '"), 18);
@@ -1693,8 +5009,309 @@ private:
             controlesP2.setOrigin({limitesCtrlP2.position.x + limitesCtrlP2.size.x / 2.f,
                                  limitesCtrlP2.position.y});
             controlesP2.setPosition({xCentroTexto, yControlesAtual});
-            janela.draw(controlesP2);
+            desenhar(controlesP2);
+        }
+    }
+
+    /**
+     * @brief Desenha a forma de onda de um trecho do áudio numa faixa da tela
+     *
+     * Cada coluna de pixels vira uma linha do mínimo ao máximo e outra, mais
+     * clara, de -RMS a +RMS; tudo vai para a GPU numa chamada só.
+     * @param vertical Tempo crescendo de baixo para cima (pista) em vez de da esquerda para a direita
+     */
+    void desenharFormaOnda(const FormaOnda::Piramide &piramide, const double inicioSeg, const double fimSeg,
+                           const sf::FloatRect &area, const bool vertical, const sf::Color cor) {
+        const auto colunas = static_cast<std::size_t>(std::max(1.f, vertical ? area.size.y : area.size.x));
+        colunasOnda.resize(colunas);
+        piramide.consultar(inicioSeg, fimSeg, colunasOnda);
+
+        const auto meiaAmplitude = (vertical ? area.size.x : area.size.y) / 2.f;
+        const auto centro = (vertical ? area.position.x : area.position.y) + meiaAmplitude;
+        const auto clarear = [](const std::uint8_t canal) { return static_cast<std::uint8_t>(std::min(255, canal + 80)); };
+        const sf::Color corRms(clarear(cor.r), clarear(cor.g), clarear(cor.b), cor.a);
+
+        // Valores positivos vão para a direita na vertical e para cima na horizontal
+        const auto ponto = [&](const std::size_t coluna, const float valor) {
+            if (vertical) {
+                return sf::Vector2f{centro + valor * meiaAmplitude, area.position.y + area.size.y - coluna - 0.5f};
+            }
+            return sf::Vector2f{area.position.x + coluna + 0.5f, centro - valor * meiaAmplitude};
+        };
+
+        verticesOnda.resize(colunas * 4);
+        for (std::size_t c = 0; c < colunas; ++c) {
+            const auto &resumo = colunasOnda[c];
+            const auto rms = std::min(resumo.rms(), 1.f);
+            const std::array<std::pair<float, sf::Color>, 4> extremos = {{
+                {resumo.minimo / 32768.f, cor}, {resumo.maximo / 32768.f, cor}, {-rms, corRms}, {rms, corRms}}};
+            for (std::size_t k = 0; k < extremos.size(); ++k) {
+                auto &vertice = verticesOnda[4 * c + k];
+                vertice.position = ponto(c, extremos[k].first);
+                vertice.color = extremos[k].second;
+            }
+        }
+        desenhar(verticesOnda);
+    }
+
+    /**
+     * @brief Música inteira numa faixa do painel central, com uma posição marcada
+     * @param posicaoSeg Posição no áudio; negativa para não marcar
+     */
+    void desenharVisaoGeralOnda(const float y, const double posicaoSeg) {
+        const auto piramide = cargaOnda.obter();
+        if (!piramide || piramide->duracaoSegundos() <= 0.0) return;
+
+        const sf::FloatRect area({std::round(LARGURA_BRASTEADO + 20.f), y},
+                                 {LARGURA_PAINEL_CENTRAL - 40.f, ALTURA_VISAO_GERAL_ONDA});
+        sf::RectangleShape fundo(area.size);
+        fundo.setPosition(area.position);
+        fundo.setFillColor(sf::Color(10, 10, 18));
+        desenhar(fundo);
+        desenharFormaOnda(*piramide, 0.0, piramide->duracaoSegundos(), area, false, sf::Color(90, 110, 160));
+
+        if (posicaoSeg >= 0.0) {
+            const auto fracao = static_cast<float>(std::min(1.0, posicaoSeg / piramide->duracaoSegundos()));
+            sf::RectangleShape marcador({2.f, area.size.y});
+            marcador.setPosition({std::round(area.position.x + fracao * area.size.x) - 1.f, y});
+            marcador.setFillColor(sf::Color::White);
+            desenhar(marcador);
+        }
+    }
+
+    /**
+     * @brief Desenha a pista do editor: grade, marcadores, notas e cursor
+     *
+     * Só as notas dentro do intervalo visível são convertidas para segundos.
+     */
+    void desenharEditor() {
+        const auto &sessao = *editor;
+        const auto &tempo = sessao.tempo();
+        const auto &chart = sessao.dados();
+        const auto xOffset = static_cast<float>(jogador1.offsetAreaJogadorX);
+        constexpr auto yCursor = Y_ZONA_ACERTO + ALTURA_ZONA_ACERTO / 2.f;
+
+        desenharBrasteado(jogador1);
+
+        const auto segundosCursor = tempo.ticksParaSegundos(sessao.cursor());
+        const auto yDe = [&](const int tick) {
+            return static_cast<float>(yCursor - (tempo.ticksParaSegundos(tick) - segundosCursor) * VELOCIDADE_QUEDA_NOTA_PPS);
+        };
+        const auto tickInicio = static_cast<int>(
+            tempo.segundosParaTicks(segundosCursor - (ALTURA_JANELA - yCursor) / VELOCIDADE_QUEDA_NOTA_PPS));
+        const auto tickFim = static_cast<int>(
+            std::ceil(tempo.segundosParaTicks(segundosCursor + yCursor / VELOCIDADE_QUEDA_NOTA_PPS))) + 1;
+
+        // Forma de onda atrás da grade, na escala de tempo da pista
+        if (const auto piramide = cargaOnda.obter()) {
+            const auto inicioSeg = segundosCursor - OFFSET_LATENCIA_AUDIO_SEC -
+                                   (ALTURA_JANELA - yCursor) / VELOCIDADE_QUEDA_NOTA_PPS;
+            desenharFormaOnda(*piramide, inicioSeg, inicioSeg + ALTURA_JANELA / VELOCIDADE_QUEDA_NOTA_PPS,
+                              {{xOffset, 0.f}, {static_cast<float>(LARGURA_BRASTEADO), static_cast<float>(ALTURA_JANELA)}},
+                              true, sf::Color(70, 90, 130, 120));
+        }
+
+        // Grade: compassos, batidas e subdivisões
+        sf::RectangleShape linha;
+        const auto passo = sessao.passoGrade();
+        const auto resolucao = std::max(1, chart.resolucao);
+        for (auto tick = (tickInicio + passo - 1) / passo * passo; tick < tickFim; tick += passo) {
+            const bool compasso = sessao.ehInicioCompasso(tick);
+            const auto espessura = compasso ? 3.f : 1.f;
+            linha.setSize({static_cast<float>(LARGURA_BRASTEADO), espessura});
+            linha.setPosition({xOffset, yDe(tick) - espessura / 2.f});
+            linha.setFillColor(compasso ? sf::Color(230, 230, 230)
+                               : tick % resolucao == 0 ? sf::Color(140, 140, 140) : sf::Color(70, 70, 70));
+            desenhar(linha);
+        }
+
+        // Notas (a busca começa antes para pegar sustains que começam fora da tela)
+        const auto larguraCabeca = static_cast<float>(LARGURA_PISTA - 12);
+        constexpr auto alturaCabeca = ALTURA_NOTA / 3.f;
+        sf::RectangleShape forma;
+        sessao.notas().paraCadaNoIntervalo(
+            std::max(0, tickInicio - sessao.notas().comprimentoMaximo()), tickFim, [&](const Chart::NotaChart &nota) {
+                if (nota.traste >= NUMERO_PISTAS) return;
+                const auto xCabeca = xOffset + static_cast<float>(nota.traste * LARGURA_PISTA) + 6.f;
+                const auto yCabeca = yDe(nota.tick);
+                const auto cor = corDaPista(nota.traste);
+
+                if (nota.comprimento > 0) {
+                    const auto yFimSustain = yDe(nota.tick + nota.comprimento);
+                    const auto larguraCalda = larguraCabeca * 0.4f;
+                    forma.setSize({larguraCalda, yCabeca - yFimSustain});
+                    forma.setPosition({xCabeca + (larguraCabeca - larguraCalda) / 2.f, yFimSustain});
+                    forma.setFillColor(sf::Color(cor.r, cor.g, cor.b, 140));
+                    desenhar(forma);
+                }
+
+                forma.setSize({larguraCabeca, alturaCabeca});
+                forma.setPosition({xCabeca, yCabeca - alturaCabeca / 2.f});
+                forma.setFillColor(cor);
+                desenhar(forma);
+            });
+
+        // Cursor
+        linha.setSize({static_cast<float>(LARGURA_BRASTEADO), 2.f});
+        linha.setPosition({xOffset, yCursor - 1.f});
+        linha.setFillColor(sf::Color::White);
+        desenhar(linha);
+
+        // Marcadores de tempo e assinatura, à direita da pista
+        if (fonte.getInfo().family.empty()) return;
+        sf::Text rotulo(fonte, "", 12);
+        const auto desenharRotulo = [&](const int tick, const std::string &texto, const sf::Color cor, const float dx) {
+            rotulo.setString(utf8ParaSfString(texto));
+            rotulo.setFillColor(cor);
+            rotulo.setPosition({xOffset + LARGURA_BRASTEADO - 60.f + dx, yDe(tick) - 16.f});
+            desenhar(rotulo);
+        };
+        for (auto it = chart.mudancasTempo.lower_bound(tickInicio);
+             it != chart.mudancasTempo.end() && it->first < tickFim; ++it) {
+            std::ostringstream bpm;
+            bpm << std::fixed << std::setprecision(1) << it->second.obterBPM();
+            desenharRotulo(it->first, bpm.str(), sf::Color(255, 200, 100), 0.f);
+        }
+        for (auto it = chart.assinaturasTempo.lower_bound(tickInicio);
+             it != chart.assinaturasTempo.end() && it->first < tickFim; ++it) {
+            desenharRotulo(it->first, std::to_string(it->second.numerador) + "/" + std::to_string(it->second.denominador),
+                           sf::Color(150, 200, 255), -40.f);
+        }
+    }
+
+    /**
+     * @brief Painel central do editor: posição, tempo, grade, histórico e atalhos
+     */
+    void desenharPainelEditor() {
+        if (fonte.getInfo().family.empty()) return;
+
+        constexpr auto xPainel = static_cast<float>(LARGURA_BRASTEADO);
+        constexpr auto larguraPainel = static_cast<float>(LARGURA_PAINEL_CENTRAL);
+        sf::RectangleShape fundoPainel({larguraPainel, static_cast<float>(ALTURA_JANELA)});
+        fundoPainel.setPosition({xPainel, 0.f});
+        fundoPainel.setFillColor(sf::Color(20, 20, 30, 200));
+        fundoPainel.setOutlineColor(sf::Color(128, 128, 128));
+        fundoPainel.setOutlineThickness(2.f);
+        desenhar(fundoPainel);
+
+        const auto &sessao = *editor;
+        const auto cursor = sessao.cursor();
+        const auto [numerador, denominador] = sessao.assinaturaEm(cursor);
+
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(3)
+            << "Editor de chart" << (sessao.temAlteracoesNaoGravadas() ? " *" : "") << "\n\n"
+            << "Tick: " << cursor << "\n"
+            << "Tempo: " << sessao.tempo().ticksParaSegundos(cursor) << " s\n"
+            << "BPM: " << sessao.tempo().mudancaEm(cursor).obterBPM() << "\n"
+            << "Compasso: " << numerador << "/" << denominador << "\n"
+            << "Grade: 1/" << sessao.divisao() << "\n"
+            << "Notas: " << sessao.notas().tamanho() << "\n"
+            << "Desfazer: " << sessao.edicoesParaDesfazer() << "  Refazer: " << sessao.edicoesParaRefazer() << "\n\n"
+            << "Setas: cursor (Ctrl: mover notas)\n"
+            << "PgUp/PgDn: compasso  Esq/Dir: grade\n"
+            << "1-5: nota  +/-: sustain\n"
+            << "[ ]: BPM (Shift: 0,1)  , .: compasso\n"
+            << "Del: remove marcadores\n"
+            << "Ctrl+Z / Ctrl+Y: desfazer / refazer\n"
+            << "Ctrl+S: gravar\n"
+            << "Espaço: tocar  F4: metrônomo  F2: sair";
+
+        sf::Text texto(fonte, utf8ParaSfString(oss.str()), 16);
+        texto.setFillColor(sf::Color(220, 220, 220));
+        texto.setPosition({std::round(xPainel + 20.f), 20.f});
+        desenhar(texto);
+
+        // Resultado da última gravação
+        const auto mensagemUtf8 = sfStringParaUtf8(mensagemStatus);
+        const auto corMensagem = mensagemUtf8.starts_with("Erro") ? sf::Color::Red : sf::Color::Green;
+        const auto limites = texto.getLocalBounds();
+        desenharTextoQuebrado(mensagemStatus, corMensagem, 16, xPainel + larguraPainel / 2.f,
+                              20.f + limites.position.y + limites.size.y + 30.f, larguraPainel - 20.f);
+
+        // Música inteira, com o cursor marcado
+        desenharVisaoGeralOnda(ALTURA_JANELA - ALTURA_VISAO_GERAL_ONDA - 20.f,
+                               std::max(0.0, sessao.tempo().ticksParaSegundos(cursor) - OFFSET_LATENCIA_AUDIO_SEC));
+    }
+
+    /**
+     * @brief Desenha o painel de desempenho (tempos do quadro e memória por subsistema)
+     */
+    void desenharPainelDesempenho() {
+        if (fonte.getInfo().family.empty()) return;
+
+        // Atlas de glifos dos tamanhos de fonte usados na interface (RGBA na GPU)
+        std::int64_t bytesTexto = 0;
+        for (const unsigned tamanho : {14u, 15u, 16u, 18u, 20u, 22u, 28u}) {
+            const auto tamanhoAtlas = fonte.getTexture(tamanho).getSize();
+            bytesTexto += static_cast<std::int64_t>(tamanhoAtlas.x) * tamanhoAtlas.y * 4;
+        }
+        Memoria::definir(Memoria::Subsistema::Texto, bytesTexto);
+
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2)
+            << "Quadro: " << ultimoTempoQuadro.asMicroseconds() / 1000.0 << " ms\n"
+            << "Atualização: " << ultimoTempoAtualizacao.asMicroseconds() / 1000.0 << " ms\n"
+            << "Partículas: " << particulasAtivas.size() << "\n"
+            << "Áudio: " << musica.taxaArquivo() << " -> " << musica.getSampleRate() << " Hz, bloco "
+            << musica.quadrosPorBloco() << (metronomoAtivo ? ", metrônomo" : "") << "\n"
+            << "Latência: " << musica.latenciaSegundos() * 1000.0 << " ms  Deriva: "
+            << musica.derivaSegundos() * 1000.0 << " ms\n"
+            << "Passo            CPU ms   GPU ms\n";
+        for (size_t i = 0; i < Rastreamento::QUANTIDADE_PASSOS; ++i) {
+            const auto passo = static_cast<Rastreamento::Passo>(i);
+            oss << std::left << std::setw(12) << Rastreamento::NOMES_PASSOS[i] << std::right
+                << std::setw(9) << temporizadorGpu.cpuMs(passo);
+            if (temporizadorGpu.ativo()) {
+                oss << std::setw(9) << temporizadorGpu.gpuMs(passo) << "\n";
+            } else {
+                oss << std::setw(9) << "-" << "\n";
+            }
+        }
+        oss << std::setprecision(1)
+            << "Memória (KiB)    atual     pico\n";
+        for (size_t i = 0; i < Memoria::NOMES_SUBSISTEMAS.size(); ++i) {
+            const auto subsistema = static_cast<Memoria::Subsistema>(i);
+            oss << std::left << std::setw(12) << Memoria::NOMES_SUBSISTEMAS[i] << std::right
+                << std::setw(10) << Memoria::atual(subsistema) / 1024.0
+                << std::setw(10) << Memoria::pico(subsistema) / 1024.0 << "\n";
+        }
+
+        sf::Text texto(fonte, utf8ParaSfString(oss.str()), 12);
+        texto.setFillColor(sf::Color(200, 255, 200));
+        texto.setPosition({8.f, 8.f});
+
+        const auto limites = texto.getLocalBounds();
+        sf::RectangleShape fundo({limites.size.x + 12.f, limites.size.y + 12.f});
+        fundo.setPosition({2.f, 2.f});
+        fundo.setFillColor(sf::Color(0, 0, 0, 180));
+
+        desenhar(fundo);
+        desenhar(texto);
+    }
+
+    /**
+     * @brief Escurece a tela na pausa e mostra a contagem na volta
+     */
+    void desenharPausa() {
+        if (fonte.getInfo().family.empty()) return;
+
+        std::string texto = "PAUSADO";
+        if (estadoPausa == EstadoPausa::Contagem) {
+            const auto restante = posicaoPausaSec - musica.posicaoSegundos();
+            texto = std::to_string(std::max(1, static_cast<int>(std::ceil(restante))));
+        } else {
+            sf::RectangleShape sombra({static_cast<float>(LARGURA_JANELA), static_cast<float>(ALTURA_JANELA)});
+            sombra.setFillColor(sf::Color(0, 0, 0, 150));
+            desenhar(sombra);
         }
+
+        sf::Text textoPausa(fonte, utf8ParaSfString(texto), 64);
+        textoPausa.setFillColor(sf::Color::White);
+        const auto limites = textoPausa.getLocalBounds();
+        textoPausa.setOrigin({limites.position.x + limites.size.x / 2.f, limites.position.y + limites.size.y / 2.f});
+        textoPausa.setPosition({LARGURA_JANELA / 2.f, ALTURA_JANELA / 2.f});
+        desenhar(textoPausa);
     }
 
     /**
@@ -1709,7 +5326,7 @@ private:
             sf::RectangleShape linhaPista({1.f, static_cast<float>(ALTURA_JANELA)});
             linhaPista.setPosition({xOffset + i * LARGURA_PISTA, 0.f});
             linhaPista.setFillColor(sf::Color(100, 100, 100));
-            janela.draw(linhaPista);
+            desenhar(linhaPista);
         }
 
         // Desenha zona de acerto
@@ -1719,7 +5336,7 @@ private:
         preenchimentoZonaAcerto.setFillColor(sf::Color(200, 200, 200, 100));
         preenchimentoZonaAcerto.setOutlineColor(sf::Color::White);
         preenchimentoZonaAcerto.setOutlineThickness(1.f);
-        janela.draw(preenchimentoZonaAcerto);
+        desenhar(preenchimentoZonaAcerto);
 
         // Desenha feedback visual para teclas pressionadas
         for (const auto &[tecla, pista] : jogador.mapeamentoTeclaPista) {
@@ -1729,7 +5346,7 @@ private:
                 preenchimentoFeedbackTecla.setPosition({xOffset + pista * LARGURA_PISTA,
                                                        static_cast<float>(Y_ZONA_ACERTO)});
                 preenchimentoFeedbackTecla.setFillColor(sf::Color(255, 255, 255, 80));
-                janela.draw(preenchimentoFeedbackTecla);
+                desenhar(preenchimentoFeedbackTecla);
             }
         }
     }
@@ -1744,7 +5361,7 @@ private:
             Particula p = particulasAtivas.front();
             particulasAtivas.pop();
 
-            janela.draw(p.forma);
+            desenhar(p.forma);
 
             particulasAtivas.push(p); // Volta para a fila
         }
@@ -1753,9 +5370,11 @@ private:
     /**
      * @brief Desenha notas do jogo para um jogador
      * @param notas Notas a desenhar
+     * @param janelaNotas Janela de notas relevantes do jogador
      * @param jogador Jogador dono das notas
      */
-    void desenharNotasJogo(const std::vector<Nota> &notas, const Jogador &jogador) {
+    void desenharNotasJogo(const VetorNotas &notas, const JanelaNotas &janelaNotas,
+                           const Jogador &jogador) {
         sf::RectangleShape formaRetangulo;
         sf::Text marcacaoCompleto(fonte, utf8ParaSfString("✓"), 15);
 
@@ -1766,8 +5385,9 @@ private:
             estadosRenderizacaoNota.shader = &shaderNota;
         }
 
-        for (const auto &nota : notas) {
-            if (!nota.naTela) continue;
+        janelaNotas.paraCadaNota([&](const std::size_t indice) {
+            const auto &nota = notas[indice];
+            if (!nota.naTela) return;
 
             const auto xBaseNota = static_cast<float>(jogador.offsetAreaJogadorX + nota.pista * LARGURA_PISTA);
             const auto yCentroCapeca = nota.posicaoY;
@@ -1810,7 +5430,7 @@ private:
                         shaderNota.setUniform(UNIFORM_ALTURA_RETANGULO, formaRetangulo.getSize().y);
                     }
 
-                    janela.draw(formaRetangulo, estadosRenderizacaoNota);
+                    desenhar(formaRetangulo, estadosRenderizacaoNota);
                 }
             }
 
@@ -1840,7 +5460,7 @@ private:
                     shaderNota.setUniform(UNIFORM_ALTURA_RETANGULO, formaRetangulo.getSize().y);
                 }
 
-                janela.draw(formaRetangulo, estadosRenderizacaoNota);
+                desenhar(formaRetangulo, estadosRenderizacaoNota);
 
                 // Desenha marcação de completo para notas longas
                 if (nota.ehNotaLonga && nota.acertada && nota.sustainCompleto) {
@@ -1854,10 +5474,10 @@ private:
                         xVisualCapeca + larguraVisualCapeca / 2.f,
                         yCentroCapeca
                     });
-                    janela.draw(marcacaoCompleto);
+                    desenhar(marcacaoCompleto);
                 }
             }
-        }
+        });
     }
 };
 
@@ -0,0 +1,276 @@
+/**
+ * @file medicao.hpp
+ * @brief Ponderação K e sonoridade integrada (ITU-R BS.1770), sem dependência do SFML
+ *
+ * Separado de sonoridade.hpp para que o medidor seja testado sem decodificar
+ * arquivos: os testes alimentam amostras sintéticas direto no Medidor.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <numbers>
+#include <optional>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Sonoridade {
+    constexpr double ALVO_LUFS = -16.0;
+    constexpr double LIMIAR_ABSOLUTO_LUFS = -70.0;
+    constexpr double LIMIAR_RELATIVO_LU = -10.0;
+    constexpr int SUBBLOCOS_POR_BLOCO = 4; // Blocos de 400 ms a cada 100 ms (75% de sobreposição)
+
+    /**
+     * @brief Filtro de segunda ordem (forma direta transposta II), com a0 = 1
+     */
+    struct Biquad {
+        double b0, b1, b2, a1, a2;
+    };
+
+    /**
+     * @brief Os dois estágios da ponderação K para uma taxa de amostragem qualquer
+     *
+     * Prateleira de agudos (efeito da cabeça) seguida do passa-altas RLB, pela
+     * transformação bilinear dos protótipos analógicos da BS.1770; a 48 kHz os
+     * coeficientes coincidem com os da tabela da norma.
+     */
+    inline std::array<Biquad, 2> coeficientesPonderacaoK(const double taxa) {
+        constexpr double F0_PRATELEIRA = 1681.974450955533;
+        constexpr double GANHO_PRATELEIRA_DB = 3.999843853973347;
+        constexpr double Q_PRATELEIRA = 0.7071752369554196;
+        constexpr double F0_PASSA_ALTAS = 38.13547087602444;
+        constexpr double Q_PASSA_ALTAS = 0.5003270373238773;
+
+        auto k = std::tan(std::numbers::pi * F0_PRATELEIRA / taxa);
+        const auto vh = std::pow(10.0, GANHO_PRATELEIRA_DB / 20.0);
+        const auto vb = std::pow(vh, 0.4996667741545416);
+        auto a0 = 1.0 + k / Q_PRATELEIRA + k * k;
+        const Biquad prateleira{(vh + vb * k / Q_PRATELEIRA + k * k) / a0, 2.0 * (k * k - vh) / a0,
+                                (vh - vb * k / Q_PRATELEIRA + k * k) / a0, 2.0 * (k * k - 1.0) / a0,
+                                (1.0 - k / Q_PRATELEIRA + k * k) / a0};
+
+        k = std::tan(std::numbers::pi * F0_PASSA_ALTAS / taxa);
+        a0 = 1.0 + k / Q_PASSA_ALTAS + k * k;
+        const Biquad passaAltas{1.0, -2.0, 1.0, 2.0 * (k * k - 1.0) / a0, (1.0 - k / Q_PASSA_ALTAS + k * k) / a0};
+        return {prateleira, passaAltas};
+    }
+
+    /**
+     * @brief Sonoridade (LUFS) de uma energia média ponderada
+     */
+    inline double lufsDeEnergia(const double energia) {
+        return -0.691 + 10.0 * std::log10(energia);
+    }
+
+    /**
+     * @brief Peso de um canal na soma (BS.1770): LFE fica de fora, surrounds valem +1,5 dB
+     */
+    inline double pesoCanal(const unsigned canal, const unsigned canais) {
+        if (canais < 6) return 1.0;
+        if (canal == 3) return 0.0;
+        return canal >= 4 ? 1.41 : 1.0;
+    }
+
+    /**
+     * @brief Acumula a energia ponderada K de um áudio em sub-blocos de 100 ms
+     *
+     * Em estéreo com SSE2, os dois canais passam pelos filtros juntos, um em
+     * cada metade do registrador; os outros formatos usam o laço escalar. Os
+     * dois caminhos fazem as mesmas operações na mesma ordem.
+     */
+    class Medidor {
+    private:
+        std::array<Biquad, 2> filtros;
+        unsigned canais;
+        std::size_t quadrosSubBloco;
+        std::vector<double> pesos;
+        std::vector<std::array<double, 4>> estados; // s1 e s2 dos dois estágios, por canal
+        std::vector<double> energiaCanais;          // Soma dos quadrados no sub-bloco atual
+        std::size_t quadrosNoSubBloco = 0;
+        std::vector<double> subBlocos;               // Energia ponderada média de cada sub-bloco
+        double picoAmostra = 0.0;
+        bool simd;
+
+        static constexpr double ESCALA_AMOSTRA = 1.0 / 32768.0;
+
+        void fecharSubBloco() {
+            double energia = 0.0;
+            for (unsigned c = 0; c < canais; ++c) {
+                energia += pesos[c] * energiaCanais[c];
+                energiaCanais[c] = 0.0;
+            }
+            subBlocos.push_back(energia / static_cast<double>(quadrosSubBloco));
+            quadrosNoSubBloco = 0;
+        }
+
+        void filtrarEscalar(const std::int16_t *amostras, const std::size_t quadros) {
+            const auto &[p, h] = filtros;
+            for (unsigned c = 0; c < canais; ++c) {
+                auto [s1p, s2p, s1h, s2h] = estados[c];
+                double energia = 0.0;
+                double pico = picoAmostra;
+                for (std::size_t i = 0; i < quadros; ++i) {
+                    const auto x = amostras[i * canais + c] * ESCALA_AMOSTRA;
+                    pico = std::max(pico, std::abs(x));
+                    const auto y = p.b0 * x + s1p;
+                    s1p = p.b1 * x - p.a1 * y + s2p;
+                    s2p = p.b2 * x - p.a2 * y;
+                    const auto z = h.b0 * y + s1h;
+                    s1h = h.b1 * y - h.a1 * z + s2h;
+                    s2h = h.b2 * y - h.a2 * z;
+                    energia += z * z;
+                }
+                estados[c] = {s1p, s2p, s1h, s2h};
+                energiaCanais[c] += energia;
+                picoAmostra = pico;
+            }
+        }
+
+#if defined(__SSE2__)
+        void filtrarEstereo(const std::int16_t *amostras, const std::size_t quadros) {
+            const auto &[p, h] = filtros;
+            const auto pb0 = _mm_set1_pd(p.b0), pb1 = _mm_set1_pd(p.b1), pb2 = _mm_set1_pd(p.b2);
+            const auto pa1 = _mm_set1_pd(p.a1), pa2 = _mm_set1_pd(p.a2);
+            const auto hb0 = _mm_set1_pd(h.b0), hb1 = _mm_set1_pd(h.b1), hb2 = _mm_set1_pd(h.b2);
+            const auto ha1 = _mm_set1_pd(h.a1), ha2 = _mm_set1_pd(h.a2);
+            const auto escala = _mm_set1_pd(ESCALA_AMOSTRA);
+            const auto semSinal = _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFF));
+
+            // Cada registrador guarda {esquerdo, direito}
+            auto s1p = _mm_set_pd(estados[1][0], estados[0][0]);
+            auto s2p = _mm_set_pd(estados[1][1], estados[0][1]);
+            auto s1h = _mm_set_pd(estados[1][2], estados[0][2]);
+            auto s2h = _mm_set_pd(estados[1][3], estados[0][3]);
+            auto energia = _mm_setzero_pd();
+            auto pico = _mm_set1_pd(picoAmostra);
+
+            for (std::size_t i = 0; i < quadros; ++i) {
+                std::int32_t par;
+                std::memcpy(&par, amostras + 2 * i, sizeof(par));
+                const auto inteiros = _mm_cvtsi32_si128(par);
+                const auto estendidos = _mm_srai_epi32(_mm_unpacklo_epi16(inteiros, inteiros), 16);
+                const auto x = _mm_mul_pd(_mm_cvtepi32_pd(estendidos), escala);
+                pico = _mm_max_pd(pico, _mm_and_pd(x, semSinal));
+
+                const auto y = _mm_add_pd(_mm_mul_pd(pb0, x), s1p);
+                s1p = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(pb1, x), _mm_mul_pd(pa1, y)), s2p);
+                s2p = _mm_sub_pd(_mm_mul_pd(pb2, x), _mm_mul_pd(pa2, y));
+                const auto z = _mm_add_pd(_mm_mul_pd(hb0, y), s1h);
+                s1h = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(hb1, y), _mm_mul_pd(ha1, z)), s2h);
+                s2h = _mm_sub_pd(_mm_mul_pd(hb2, y), _mm_mul_pd(ha2, z));
+                energia = _mm_add_pd(energia, _mm_mul_pd(z, z));
+            }
+
+            const auto guardar = [&](const __m128d registrador, const std::size_t indice) {
+                std::array<double, 2> faixas{};
+                _mm_storeu_pd(faixas.data(), registrador);
+                estados[0][indice] = faixas[0];
+                estados[1][indice] = faixas[1];
+            };
+            guardar(s1p, 0);
+            guardar(s2p, 1);
+            guardar(s1h, 2);
+            guardar(s2h, 3);
+
+            std::array<double, 2> faixas{};
+            _mm_storeu_pd(faixas.data(), energia);
+            energiaCanais[0] += faixas[0];
+            energiaCanais[1] += faixas[1];
+            _mm_storeu_pd(faixas.data(), pico);
+            picoAmostra = std::max(faixas[0], faixas[1]);
+        }
+#endif
+
+    public:
+        /**
+         * @param permitirSimd False força o laço escalar (os testes comparam os dois caminhos)
+         */
+        Medidor(const double taxa, const unsigned quantidadeCanais, const bool permitirSimd = true)
+            : filtros(coeficientesPonderacaoK(taxa)), canais(quantidadeCanais),
+              quadrosSubBloco(std::max<std::size_t>(1, static_cast<std::size_t>(std::lround(taxa / 10.0)))),
+              pesos(quantidadeCanais), estados(quantidadeCanais, std::array<double, 4>{}),
+              energiaCanais(quantidadeCanais, 0.0), simd(permitirSimd) {
+            for (unsigned c = 0; c < canais; ++c) pesos[c] = pesoCanal(c, canais);
+        }
+
+        /**
+         * @brief Filtra quadros intercalados de 16 bits
+         */
+        void adicionar(const std::int16_t *amostras, std::size_t quadros) {
+            while (quadros > 0) {
+                const auto n = std::min(quadros, quadrosSubBloco - quadrosNoSubBloco);
+#if defined(__SSE2__)
+                if (simd && canais == 2) {
+                    filtrarEstereo(amostras, n);
+                } else {
+                    filtrarEscalar(amostras, n);
+                }
+#else
+                filtrarEscalar(amostras, n);
+#endif
+                amostras += n * canais;
+                quadros -= n;
+                quadrosNoSubBloco += n;
+                if (quadrosNoSubBloco == quadrosSubBloco) fecharSubBloco();
+            }
+        }
+
+        /**
+         * @brief Sonoridade integrada com as comportas absoluta (-70 LUFS) e relativa (-10 LU)
+         *
+         * O sub-bloco final incompleto fica de fora, como na norma.
+         * @return Vazio se nenhum bloco passa pela comporta absoluta (silêncio ou áudio curto demais)
+         */
+        [[nodiscard]] std::optional<double> integrada() const {
+            if (subBlocos.size() < SUBBLOCOS_POR_BLOCO) return std::nullopt;
+
+            std::vector<double> blocos(subBlocos.size() - SUBBLOCOS_POR_BLOCO + 1);
+            for (std::size_t j = 0; j < blocos.size(); ++j) {
+                double soma = 0.0;
+                for (int k = 0; k < SUBBLOCOS_POR_BLOCO; ++k) soma += subBlocos[j + k];
+                blocos[j] = soma / SUBBLOCOS_POR_BLOCO;
+            }
+
+            const auto mediaAcima = [&](const double limiarLufs) -> std::optional<double> {
+                double soma = 0.0;
+                std::size_t quantidade = 0;
+                for (const auto energia : blocos) {
+                    if (energia > 0.0 && lufsDeEnergia(energia) > limiarLufs) {
+                        soma += energia;
+                        ++quantidade;
+                    }
+                }
+                if (quantidade == 0) return std::nullopt;
+                return soma / static_cast<double>(quantidade);
+            };
+
+            const auto acimaAbsoluto = mediaAcima(LIMIAR_ABSOLUTO_LUFS);
+            if (!acimaAbsoluto) return std::nullopt;
+            const auto limiarRelativo = std::max(LIMIAR_ABSOLUTO_LUFS, lufsDeEnergia(*acimaAbsoluto) + LIMIAR_RELATIVO_LU);
+            return lufsDeEnergia(mediaAcima(limiarRelativo).value_or(*acimaAbsoluto));
+        }
+
+        /**
+         * @brief Maior amostra em módulo (1 = fundo de escala)
+         */
+        [[nodiscard]] double pico() const {
+            return picoAmostra;
+        }
+    };
+
+    /**
+     * @brief Ganho linear que leva a música ao alvo sem passar do fundo de escala no pico
+     */
+    inline double ganho(const double integradaLufs, const double pico, const double alvoLufs = ALVO_LUFS) {
+        if (integradaLufs <= LIMIAR_ABSOLUTO_LUFS) return 1.0; // Silêncio: nada a corrigir
+        const auto ganhoAlvo = std::pow(10.0, (alvoLufs - integradaLufs) / 20.0);
+        return pico > 0.0 ? std::min(ganhoAlvo, 1.0 / pico) : ganhoAlvo;
+    }
+}
@@ -0,0 +1,110 @@
+/**
+ * @file memoria.hpp
+ * @brief Contabilidade de memória por subsistema
+ *
+ * Contêineres dos subsistemas usam Memoria::Alocador, que contabiliza cada
+ * alocação na etiqueta do subsistema. Recursos alocados dentro da SFML
+ * (texturas, atlas de fonte, buffer de streaming de áudio) entram como
+ * estimativas definidas com Memoria::definir.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <queue>
+#include <string_view>
+#include <vector>
+
+namespace Memoria {
+    enum class Subsistema { Chart, Notas, Particulas, Texto, Texturas, Audio, Caches, Quantidade };
+    constexpr std::array<std::string_view, static_cast<std::size_t>(Subsistema::Quantidade)> NOMES_SUBSISTEMAS = {
+        "chart", "notas", "particulas", "texto", "texturas", "audio", "caches"
+    };
+
+    struct Contador {
+        std::atomic<std::int64_t> atual{0};
+        std::atomic<std::int64_t> pico{0};
+    };
+
+    inline std::array<Contador, NOMES_SUBSISTEMAS.size()> contadores;
+
+    inline void atualizarPico(Contador &contador, const std::int64_t valor) {
+        auto pico = contador.pico.load(std::memory_order_relaxed);
+        while (valor > pico && !contador.pico.compare_exchange_weak(pico, valor, std::memory_order_relaxed)) {}
+    }
+
+    inline void registrarAlocacao(const Subsistema subsistema, const std::int64_t bytes) {
+        auto &contador = contadores[static_cast<std::size_t>(subsistema)];
+        atualizarPico(contador, contador.atual.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+    }
+
+    inline void registrarLiberacao(const Subsistema subsistema, const std::int64_t bytes) {
+        contadores[static_cast<std::size_t>(subsistema)].atual.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Substitui o valor atual de um subsistema estimado
+     */
+    inline void definir(const Subsistema subsistema, const std::int64_t bytes) {
+        auto &contador = contadores[static_cast<std::size_t>(subsistema)];
+        contador.atual.store(bytes, std::memory_order_relaxed);
+        atualizarPico(contador, bytes);
+    }
+
+    [[nodiscard]] inline auto atual(const Subsistema subsistema) -> std::int64_t {
+        return contadores[static_cast<std::size_t>(subsistema)].atual.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] inline auto pico(const Subsistema subsistema) -> std::int64_t {
+        return contadores[static_cast<std::size_t>(subsistema)].pico.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Alocador padrão que contabiliza os bytes na etiqueta do subsistema
+     */
+    template <typename T, Subsistema S>
+    struct Alocador {
+        using value_type = T;
+
+        template <typename U>
+        struct rebind {
+            using other = Alocador<U, S>;
+        };
+
+        Alocador() noexcept = default;
+
+        template <typename U>
+        Alocador(const Alocador<U, S> &) noexcept {}
+
+        [[nodiscard]] T *allocate(const std::size_t quantidade) {
+            T *ponteiro = std::allocator<T>{}.allocate(quantidade);
+            registrarAlocacao(S, static_cast<std::int64_t>(quantidade * sizeof(T)));
+            return ponteiro;
+        }
+
+        void deallocate(T *ponteiro, const std::size_t quantidade) noexcept {
+            registrarLiberacao(S, static_cast<std::int64_t>(quantidade * sizeof(T)));
+            std::allocator<T>{}.deallocate(ponteiro, quantidade);
+        }
+
+        friend bool operator==(const Alocador &, const Alocador &) noexcept {
+            return true;
+        }
+    };
+
+    template <typename T, Subsistema S>
+    using Vetor = std::vector<T, Alocador<T, S>>;
+
+    template <typename T, Subsistema S>
+    using Fila = std::queue<T, std::deque<T, Alocador<T, S>>>;
+
+    template <typename Chave, typename Valor, Subsistema S>
+    using Mapa = std::map<Chave, Valor, std::less<Chave>, Alocador<std::pair<const Chave, Valor>, S>>;
+}
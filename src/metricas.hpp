@@ -0,0 +1,97 @@
+/**
+ * @file metricas.hpp
+ * @brief Endpoint HTTP mínimo que serve as métricas no formato texto do Prometheus
+ *
+ * Uma thread própria aceita cada conexão, lê a requisição (qualquer caminho
+ * serve) e responde com o texto gerado na hora. Por padrão só a própria
+ * máquina alcança o endpoint; outra interface precisa ser pedida. Todas as esperas têm limite:
+ * um cliente que conecta e não manda nada é descartado depois de
+ * INTERVALO_ESPERA_METRICAS, e a thread sempre volta a olhar o pedido de
+ * parada, então o jogo fecha sem esperar por ninguém.
+ */
+
+#pragma once
+
+#include <SFML/Network.hpp>
+
+#include <array>
+#include <functional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace Metricas {
+    constexpr auto INTERVALO_ESPERA_METRICAS = sf::milliseconds(200);
+
+    /**
+     * @brief Servidor HTTP mínimo que responde cada conexão com as métricas
+     */
+    class Servidor {
+    private:
+        sf::TcpListener ouvinte;
+        std::function<std::string()> gerarCorpo;
+        std::jthread threadServidor;
+
+        /**
+         * @brief Laço da thread do servidor
+         */
+        void atender(const std::stop_token &parar) {
+            sf::SocketSelector seletor;
+            seletor.add(ouvinte);
+
+            while (!parar.stop_requested()) {
+                // Espera com limite para conseguir parar junto com o jogo
+                if (!seletor.wait(INTERVALO_ESPERA_METRICAS)) continue;
+
+                sf::TcpSocket cliente;
+                if (ouvinte.accept(cliente) != sf::Socket::Status::Done) continue;
+
+                // Sem requisição dentro do intervalo, o cliente é descartado em vez de prender a thread
+                sf::SocketSelector seletorCliente;
+                seletorCliente.add(cliente);
+                if (!seletorCliente.wait(INTERVALO_ESPERA_METRICAS)) {
+                    cliente.disconnect();
+                    continue;
+                }
+
+                // Descarta a requisição; qualquer caminho devolve as métricas
+                std::array<char, 1024> requisicao{};
+                std::size_t recebidos = 0;
+                if (cliente.receive(requisicao.data(), requisicao.size(), recebidos) != sf::Socket::Status::Done) {
+                    continue;
+                }
+
+                const auto corpo = gerarCorpo();
+                const auto resposta = "HTTP/1.0 200 OK\r\n"
+                                      "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                                      "Content-Length: " + std::to_string(corpo.size()) + "\r\n"
+                                      "Connection: close\r\n\r\n" + corpo;
+                (void)cliente.send(resposta.data(), resposta.size());
+                cliente.disconnect();
+            }
+        }
+
+    public:
+        /**
+         * @brief Começa a escutar e inicia a thread do servidor
+         * @param porta Porta TCP (0 escolhe uma livre; veja porta())
+         * @param gerador Gera o corpo da resposta, na thread do servidor
+         * @param endereco Interface em que escutar (sf::IpAddress::Any expõe à rede)
+         * @return True se a porta foi aberta
+         */
+        bool iniciar(const unsigned short porta, std::function<std::string()> gerador,
+                     const sf::IpAddress endereco = sf::IpAddress::LocalHost) {
+            if (ouvinte.listen(porta, endereco) != sf::Socket::Status::Done) {
+                return false;
+            }
+            gerarCorpo = std::move(gerador);
+            threadServidor = std::jthread([this](const std::stop_token &parar) { atender(parar); });
+            return true;
+        }
+
+        [[nodiscard]] unsigned short porta() const {
+            return ouvinte.getLocalPort();
+        }
+    };
+}
@@ -0,0 +1,217 @@
+/**
+ * @file reamostragem.hpp
+ * @brief Conversão de taxa de amostragem polifásica (sinc com janela de Kaiser)
+ *
+ * A razão entre as taxas vira L/M, reduzida pelo MDC. Cada quadro de saída
+ * cai numa das L fases do filtro, e cada fase é um produto escalar de
+ * TAPS_POR_FASE amostras de entrada (proporcionalmente mais quando a taxa
+ * desce), feito com SSE2 quando disponível. O
+ * filtro é centrado, sem atraso: o quadro k da saída é o instante
+ * k / taxaSaida da entrada, então o relógio da música não muda.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <numeric>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Reamostragem {
+    constexpr std::size_t TAPS_POR_FASE = 64; // Na taxa menor; múltiplo de 8 (dois acumuladores SSE2)
+    constexpr std::uint32_t MAXIMO_FASES = 4096; // Acima disso a tabela de coeficientes não compensa
+    constexpr std::uint32_t MAXIMA_REDUCAO = 48; // 384 kHz para 8 kHz; a janela cresce na mesma proporção
+    constexpr double ATENUACAO_DB = 80.0; // Rejeição fora da banda
+    constexpr float ESCALA_AMOSTRA = 1.f / 32768.f;
+
+    /**
+     * @brief Função de Bessel modificada de ordem zero (série de potências)
+     */
+    inline double besselI0(const double x) {
+        double soma = 1.0;
+        double termo = 1.0;
+        for (int k = 1; k < 64 && termo > 1e-12 * soma; ++k) {
+            const auto fator = x / (2.0 * k);
+            termo *= fator * fator;
+            soma += termo;
+        }
+        return soma;
+    }
+
+    inline float produtoEscalarSemSimd(const float *amostras, const float *filtro, const std::size_t taps) {
+        float soma = 0.f;
+        for (std::size_t i = 0; i < taps; ++i) soma += amostras[i] * filtro[i];
+        return soma;
+    }
+
+    /**
+     * @brief Uma fase do filtro aplicada a `taps` amostras consecutivas (múltiplo de 8)
+     */
+    inline float produtoEscalar(const float *amostras, const float *filtro, const std::size_t taps) {
+#if defined(__SSE2__)
+        auto somaA = _mm_setzero_ps();
+        auto somaB = _mm_setzero_ps();
+        for (std::size_t i = 0; i < taps; i += 8) {
+            somaA = _mm_add_ps(somaA, _mm_mul_ps(_mm_loadu_ps(amostras + i), _mm_loadu_ps(filtro + i)));
+            somaB = _mm_add_ps(somaB, _mm_mul_ps(_mm_loadu_ps(amostras + i + 4), _mm_loadu_ps(filtro + i + 4)));
+        }
+        auto soma = _mm_add_ps(somaA, somaB);
+        soma = _mm_add_ps(soma, _mm_movehl_ps(soma, soma));
+        soma = _mm_add_ss(soma, _mm_shuffle_ps(soma, soma, 1));
+        return _mm_cvtss_f32(soma);
+#else
+        return produtoEscalarSemSimd(amostras, filtro, taps);
+#endif
+    }
+
+    /**
+     * @brief Conversor de taxa em fluxo, para áudio intercalado de 16 bits
+     *
+     * A entrada é empurrada em pedaços de qualquer tamanho e a saída extraída
+     * conforme há amostras suficientes à frente; o histórico de cada canal
+     * guarda só a janela do filtro e o pedaço ainda não consumido.
+     */
+    class Conversor {
+    private:
+        unsigned canais;
+        std::uint32_t interpolacao; // L
+        std::uint32_t decimacao; // M
+        std::size_t taps = TAPS_POR_FASE;
+        std::vector<float> coeficientes; // L fases de `taps`
+        std::vector<std::vector<float>> historico;
+        std::size_t inicio = 0; // Primeira amostra da janela do próximo quadro
+        std::uint32_t fase = 0;
+
+        /**
+         * @brief Coeficientes de todas as fases, cada uma normalizada para ganho 1 em DC
+         *
+         * O corte fica meia banda de transição abaixo do Nyquist da menor taxa,
+         * com a largura da banda dada pela fórmula de Kaiser para ATENUACAO_DB.
+         * Quando a taxa desce, a janela cresce na mesma proporção, e a banda
+         * de transição fica do mesmo tamanho em relação à saída.
+         */
+        void montarFiltro() {
+            const auto razao = std::min(1.0, static_cast<double>(interpolacao) / decimacao);
+            taps = (static_cast<std::size_t>(std::ceil(TAPS_POR_FASE / razao)) + 7) / 8 * 8;
+            const auto transicao = (ATENUACAO_DB - 7.95) / (14.36 * static_cast<double>(taps));
+            const auto corte = 0.5 * razao - transicao / 2.0; // Em ciclos por amostra de entrada
+            const auto beta = 0.1102 * (ATENUACAO_DB - 8.7);
+            const auto meio = static_cast<double>(taps) / 2.0;
+
+            coeficientes.resize(static_cast<std::size_t>(interpolacao) * taps);
+            std::vector<double> valores(taps);
+            for (std::uint32_t p = 0; p < interpolacao; ++p) {
+                auto *filtro = coeficientes.data() + static_cast<std::size_t>(p) * taps;
+                double soma = 0.0;
+                for (std::size_t j = 0; j < taps; ++j) {
+                    // Distância entre o instante de saída e a amostra j da janela
+                    const auto tau = static_cast<double>(p) / interpolacao + meio - 1.0 - static_cast<double>(j);
+                    const auto x = 2.0 * corte * tau;
+                    const auto sinc = x == 0.0 ? 1.0 : std::sin(std::numbers::pi * x) / (std::numbers::pi * x);
+                    const auto r = tau / meio;
+                    const auto janela = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / besselI0(beta);
+                    valores[j] = 2.0 * corte * sinc * janela;
+                    soma += valores[j];
+                }
+                for (std::size_t j = 0; j < taps; ++j) filtro[j] = static_cast<float>(valores[j] / soma);
+            }
+        }
+
+    public:
+        Conversor(const unsigned quantidadeCanais, const unsigned taxaEntrada, const unsigned taxaSaida)
+            : canais(quantidadeCanais), historico(quantidadeCanais) {
+            const auto divisor = std::gcd(taxaEntrada, taxaSaida);
+            interpolacao = divisor == 0 ? 1 : taxaSaida / divisor;
+            decimacao = divisor == 0 ? 1 : taxaEntrada / divisor;
+            // Inválido (taxa de saída 0, por exemplo) fica sem filtro nem estado; só valido() é consultado
+            if (!valido()) return;
+            montarFiltro();
+            reposicionar(0);
+        }
+
+        /**
+         * @brief False se a razão entre as taxas pede fases demais ou uma janela longa demais
+         */
+        [[nodiscard]] bool valido() const {
+            return canais > 0 && interpolacao <= MAXIMO_FASES &&
+                   decimacao <= static_cast<std::uint64_t>(interpolacao) * MAXIMA_REDUCAO;
+        }
+
+        /**
+         * @brief Descarta o histórico e recomeça num quadro de saída (busca)
+         * @return Quadro de entrada a partir do qual a entrada deve ser empurrada
+         */
+        std::uint64_t reposicionar(const std::uint64_t quadroSaida) {
+            if (!valido()) return 0;
+            const auto posicao = quadroSaida * decimacao;
+            fase = static_cast<std::uint32_t>(posicao % interpolacao);
+            inicio = 0;
+            // Zeros antes da primeira amostra: a janela do primeiro quadro já é centrada nela
+            for (auto &amostras : historico) amostras.assign(taps / 2 - 1, 0.f);
+            return posicao / interpolacao;
+        }
+
+        /**
+         * @brief Acrescenta quadros intercalados de entrada
+         */
+        void empurrar(const std::int16_t *amostras, const std::size_t quadros) {
+            // O que ficou para trás da janela sai antes de crescer (todos os canais têm o mesmo tamanho)
+            const auto consumidas = historico.empty() ? 0 : std::min(inicio, historico[0].size());
+            for (unsigned c = 0; c < canais; ++c) {
+                auto &destino = historico[c];
+                destino.erase(destino.begin(), destino.begin() + static_cast<std::ptrdiff_t>(consumidas));
+                const auto base = destino.size();
+                destino.resize(base + quadros);
+                for (std::size_t i = 0; i < quadros; ++i) {
+                    destino[base + i] = static_cast<float>(amostras[i * canais + c]) * ESCALA_AMOSTRA;
+                }
+            }
+            inicio -= consumidas;
+        }
+
+        /**
+         * @brief Fim da entrada: completa a janela dos últimos quadros com silêncio
+         */
+        void finalizar() {
+            for (auto &amostras : historico) amostras.resize(amostras.size() + taps / 2, 0.f);
+        }
+
+        /**
+         * @brief Gera quadros de saída enquanto houver entrada à frente
+         * @return Quadros escritos em `saida` (intercalados)
+         */
+        std::size_t extrair(std::int16_t *saida, const std::size_t maximoQuadros) {
+            if (historico.empty()) return 0;
+            const auto disponiveis = historico[0].size();
+            std::size_t produzidos = 0;
+            while (produzidos < maximoQuadros && inicio + taps <= disponiveis) {
+                const auto *filtro = coeficientes.data() + static_cast<std::size_t>(fase) * taps;
+                for (unsigned c = 0; c < canais; ++c) {
+                    const auto valor = produtoEscalar(historico[c].data() + inicio, filtro, taps) * 32768.f;
+                    saida[produzidos * canais + c] =
+                        static_cast<std::int16_t>(std::clamp(std::lrint(valor), -32768L, 32767L));
+                }
+                ++produzidos;
+                fase += decimacao;
+                inicio += fase / interpolacao;
+                fase %= interpolacao;
+            }
+            return produzidos;
+        }
+
+        /**
+         * @brief Memória da tabela de coeficientes e do histórico
+         */
+        [[nodiscard]] std::size_t bytes() const {
+            std::size_t total = coeficientes.capacity() * sizeof(float);
+            for (const auto &amostras : historico) total += amostras.capacity() * sizeof(float);
+            return total;
+        }
+    };
+}
@@ -0,0 +1,307 @@
+/**
+ * @file relogio.hpp
+ * @brief Relógio da música contado em quadros entregues, sem dependência do SFML
+ *
+ * Tudo o que o Reprodutor de audio.hpp usa para transformar entregas ao mixer
+ * em posição audível: a âncora publicada sem trava, a medição de latência e
+ * deriva, as épocas de play e busca e a antecedência em silêncio antes do
+ * quadro 0. Os instantes chegam de fora, então os testes dirigem o relógio
+ * com um dispositivo falso em tempo simulado.
+ */
+
+#pragma once
+
+#include "log.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace Audio {
+    constexpr double INICIO_MEDICAO_LATENCIA_SEC = 0.1; // Ignora o enchimento inicial dos buffers
+    constexpr double FIM_MEDICAO_LATENCIA_SEC = 0.6;
+    constexpr double CONSTANTE_TEMPO_DERIVA_SEC = 1.0;
+
+    using Relogio = std::chrono::steady_clock;
+
+    inline std::int64_t agoraNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Relogio::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @brief Âncora do relógio da música, publicada pela thread de áudio
+     *
+     * Posição em T = quadroInicio / taxa + (T - instanteInicio) + adiantamento - latencia.
+     * `adiantamento` é a média de quanto áudio já foi entregue além do tempo de
+     * parede desde a âncora; `latencia` é essa mesma média medida logo depois
+     * da primeira âncora. A diferença entre as duas é a deriva do dispositivo.
+     */
+    struct Ancora {
+        std::uint32_t epoca = 0;
+        std::int64_t quadroInicio = 0; // Negativo durante a antecedência
+        std::int64_t instanteInicio = 0;
+        double adiantamento = 0.0;
+        double latencia = 0.0;
+    };
+
+    /**
+     * @brief Troca a âncora entre a thread de áudio (escritora única) e a principal, sem trava
+     *
+     * Seqlock: a versão fica ímpar durante a escrita; quem lê tenta de novo se
+     * ela mudou no meio.
+     */
+    class AncoraPublicada {
+    private:
+        std::atomic<std::uint32_t> versao{0};
+        std::atomic<std::uint32_t> epoca{0};
+        std::atomic<std::int64_t> quadroInicio{0};
+        std::atomic<std::int64_t> instanteInicio{0};
+        std::atomic<double> adiantamento{0.0};
+        std::atomic<double> latencia{0.0};
+
+    public:
+        void publicar(const Ancora &ancora) {
+            const auto v = versao.load(std::memory_order_relaxed);
+            versao.store(v + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            epoca.store(ancora.epoca, std::memory_order_relaxed);
+            quadroInicio.store(ancora.quadroInicio, std::memory_order_relaxed);
+            instanteInicio.store(ancora.instanteInicio, std::memory_order_relaxed);
+            adiantamento.store(ancora.adiantamento, std::memory_order_relaxed);
+            latencia.store(ancora.latencia, std::memory_order_relaxed);
+            versao.store(v + 2, std::memory_order_release);
+        }
+
+        [[nodiscard]] Ancora ler() const {
+            while (true) {
+                const auto antes = versao.load(std::memory_order_acquire);
+                Ancora ancora{epoca.load(std::memory_order_relaxed), quadroInicio.load(std::memory_order_relaxed),
+                              instanteInicio.load(std::memory_order_relaxed), adiantamento.load(std::memory_order_relaxed),
+                              latencia.load(std::memory_order_relaxed)};
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if ((antes & 1u) == 0 && versao.load(std::memory_order_relaxed) == antes) return ancora;
+            }
+        }
+    };
+
+    /**
+     * @brief Estima adiantamento e latência a partir de cada entrega ao mixer (thread de áudio)
+     */
+    class MedidorEntregas {
+    private:
+        Ancora ancora;
+        bool latenciaMedida = false;
+        double somaAquecimento = 0.0;
+        std::uint64_t amostrasAquecimento = 0;
+        std::int64_t quadroAnterior = 0;
+
+    public:
+        /**
+         * @brief Começa uma época nova: o próximo quadro entregue é `quadro`, agora
+         */
+        void ancorar(const std::uint32_t epoca, const std::int64_t quadro, const std::int64_t instante) {
+            ancora.epoca = epoca;
+            ancora.quadroInicio = quadro;
+            ancora.instanteInicio = instante;
+            ancora.adiantamento = latenciaMedida ? ancora.latencia : 0.0;
+            quadroAnterior = quadro;
+            if (!latenciaMedida) {
+                somaAquecimento = 0.0;
+                amostrasAquecimento = 0;
+            }
+        }
+
+        /**
+         * @brief Registra uma entrega
+         * @param quadro Primeiro quadro do bloco que vai ser entregue
+         */
+        void registrar(const std::int64_t quadro, const unsigned taxa, const std::int64_t instante) {
+            const auto decorrido = (instante - ancora.instanteInicio) / 1e9;
+            const auto adiantamento = static_cast<double>(quadro - ancora.quadroInicio) / taxa - decorrido;
+
+            if (!latenciaMedida) {
+                // Até a medição fechar, o relógio segue o tempo de parede desde a âncora
+                if (decorrido >= INICIO_MEDICAO_LATENCIA_SEC) {
+                    somaAquecimento += adiantamento;
+                    ++amostrasAquecimento;
+                }
+                if (decorrido >= FIM_MEDICAO_LATENCIA_SEC && amostrasAquecimento > 0) {
+                    ancora.latencia = somaAquecimento / static_cast<double>(amostrasAquecimento);
+                    latenciaMedida = true;
+                    Log::info("Latência de saída medida: ", ancora.latencia * 1000.0, " ms");
+                }
+                ancora.adiantamento = ancora.latencia;
+            } else {
+                // Média exponencial pesada pelo áudio entregue, não pelo tempo de parede: o mixer pede
+                // em rajadas, e pesar pelo intervalo favoreceria o primeiro pedido de cada rajada
+                const auto entregue = static_cast<double>(quadro - quadroAnterior) / taxa;
+                const auto alfa = 1.0 - std::exp(-entregue / CONSTANTE_TEMPO_DERIVA_SEC);
+                ancora.adiantamento += alfa * (adiantamento - ancora.adiantamento);
+            }
+            quadroAnterior = quadro;
+        }
+
+        [[nodiscard]] const Ancora &atual() const {
+            return ancora;
+        }
+    };
+
+    /**
+     * @brief Épocas, antecedência e posição audível de uma música
+     *
+     * Os métodos do lado da entrega (reiniciar, tocar, pedirBusca, aplicarBusca,
+     * entregar, avancar) mexem no estado que a thread de áudio usa e são
+     * chamados com a trava de quem guarda o arquivo. Os da posição (posicao,
+     * pausar, parar) são só da thread principal e leem a âncora sem trava.
+     */
+    class RelogioMusica {
+    private:
+        // Lado da entrega, sob a trava do dono
+        std::int64_t proximoQuadro = 0;       // Do arquivo; negativo na antecedência, que sai em silêncio
+        std::int64_t quadrosAntecedencia = 0; // Silêncio antes do quadro buscado, até aplicarBusca consumir a busca
+        std::uint32_t ultimaEpoca = 0;        // Gerador: toda época nova sai daqui
+        std::uint32_t epoca = 0;              // A que a próxima âncora leva
+        std::uint32_t epocaAncorada = 0;
+        std::uint32_t epocaBusca = 0;         // Criada por pedirBusca, assumida por aplicarBusca
+        bool buscaPendente = false;
+        MedidorEntregas medidor;
+
+        AncoraPublicada ancoraPublicada;
+
+        // Thread principal
+        std::uint32_t epocaEsperada = 0;
+        double posicaoCongelada = 0.0;
+
+    public:
+        /**
+         * @brief Volta ao quadro 0 de um arquivo recém-aberto, parado
+         */
+        void reiniciar() {
+            proximoQuadro = 0;
+            buscaPendente = false;
+            quadrosAntecedencia = 0;
+            epocaEsperada = epoca = ++ultimaEpoca;
+            posicaoCongelada = 0.0;
+        }
+
+        /**
+         * @brief Play saindo de parado ou pausado; o primeiro pedido do mixer depois disso ancora
+         *
+         * Com uma busca ainda não aplicada, a época dela já serve: o primeiro
+         * pedido depois da busca é o primeiro pedido depois do play.
+         */
+        void tocar() {
+            if (!buscaPendente) epocaEsperada = epoca = ++ultimaEpoca;
+        }
+
+        /**
+         * @brief Registra uma busca pedida pela thread principal, antes de repassá-la ao mixer
+         *
+         * Uma posição negativa vira silêncio antes do quadro 0, guardado até
+         * aplicarBusca, junto com a época da busca. Até a âncora dessa época
+         * chegar, a posição fica congelada em `segundos`.
+         */
+        void pedirBusca(const double segundos, const unsigned taxa) {
+            quadrosAntecedencia = segundos < 0.0 ? std::llround(-segundos * taxa) : 0;
+            epocaBusca = ++ultimaEpoca;
+            buscaPendente = true;
+            epocaEsperada = epocaBusca;
+            posicaoCongelada = segundos;
+        }
+
+        /**
+         * @brief Aplica uma busca que chegou ao fluxo (onSeek), já posicionado em `quadro`
+         *
+         * A antecedência só vale para a busca pedida em pedirBusca, que pode chegar
+         * aqui depois dela. As buscas da própria SFML (parada) abrem uma época que
+         * ninguém espera, e a posição fica congelada até o próximo play.
+         */
+        void aplicarBusca(const std::uint64_t quadro) {
+            proximoQuadro = static_cast<std::int64_t>(quadro) - (buscaPendente ? quadrosAntecedencia : 0);
+            quadrosAntecedencia = 0;
+            epoca = buscaPendente ? epocaBusca : ++ultimaEpoca;
+            buscaPendente = false;
+        }
+
+        /**
+         * @brief Conta um pedido do mixer e publica a âncora
+         *
+         * O primeiro pedido depois de play ou busca ancora: o quadro seguinte sai
+         * agora. O arquivo entra no quadro 0 no meio da antecedência sem âncora
+         * nova, então a posição passa por zero sem degrau.
+         * @return Quadros de silêncio no começo deste bloco (antecedência)
+         */
+        std::size_t entregar(const std::int64_t instante, const unsigned taxa, const std::size_t quadrosBloco) {
+            if (epocaAncorada != epoca) {
+                epocaAncorada = epoca;
+                medidor.ancorar(epoca, proximoQuadro, instante);
+            }
+            medidor.registrar(proximoQuadro, taxa, instante);
+            ancoraPublicada.publicar(medidor.atual());
+            return proximoQuadro < 0 ? std::min(quadrosBloco, static_cast<std::size_t>(-proximoQuadro)) : std::size_t{0};
+        }
+
+        /**
+         * @brief Quadro do arquivo da primeira amostra do próximo bloco (negativo na antecedência)
+         */
+        [[nodiscard]] std::int64_t quadroAtual() const {
+            return proximoQuadro;
+        }
+
+        /**
+         * @brief Soma os quadros efetivamente entregues no bloco, silêncio incluído
+         */
+        void avancar(const std::size_t quadros) {
+            proximoQuadro += static_cast<std::int64_t>(quadros);
+        }
+
+        /**
+         * @brief Posição audível, em segundos (negativa na antecedência)
+         *
+         * É a do quadro que sai do dispositivo, supondo que a saída começa no
+         * primeiro pedido do mixer. Entre entregas a posição avança pelo relógio
+         * da CPU e a média das entregas corrige a deriva. Parada, pausada ou à
+         * espera do primeiro pedido depois de play ou busca, ela fica congelada
+         * e nunca volta para trás sem uma busca.
+         */
+        [[nodiscard]] double posicao(const bool tocando, const unsigned taxa, const std::int64_t agora) {
+            if (!tocando || taxa == 0) return posicaoCongelada;
+            const auto ancora = ancoraPublicada.ler();
+            if (ancora.epoca != epocaEsperada) return posicaoCongelada;
+
+            const auto atual = static_cast<double>(ancora.quadroInicio) / taxa + (agora - ancora.instanteInicio) / 1e9 +
+                               ancora.adiantamento - ancora.latencia;
+            posicaoCongelada = std::max(posicaoCongelada, atual);
+            return posicaoCongelada;
+        }
+
+        /**
+         * @brief Congela a posição do instante da pausa
+         */
+        void pausar(const bool tocando, const unsigned taxa, const std::int64_t agora) {
+            posicaoCongelada = posicao(tocando, taxa, agora);
+        }
+
+        void parar() {
+            posicaoCongelada = 0.0;
+        }
+
+        /**
+         * @brief Quanto o mixer lê adiantado, medido no início da reprodução
+         */
+        [[nodiscard]] double latenciaSegundos() const {
+            return ancoraPublicada.ler().latencia;
+        }
+
+        /**
+         * @brief Quanto o relógio do dispositivo se afastou do relógio da CPU desde a âncora
+         */
+        [[nodiscard]] double derivaSegundos() const {
+            const auto ancora = ancoraPublicada.ler();
+            return ancora.adiantamento - ancora.latencia;
+        }
+    };
+}
@@ -0,0 +1,417 @@
+/**
+ * @file riff_convert.cpp
+ * @brief Converte bibliotecas inteiras entre .chart, MIDI e o cache binário
+ *
+ * Cada chart da árvore de origem (notes.chart, notes.mid ou notes.rhc) é uma
+ * tarefa. Um número fixo de threads pega as tarefas em sequência; leituras e
+ * gravações passam por um semáforo com poucas vagas, para que as threads não
+ * disputem o disco, enquanto o parsing e a formatação rodam em paralelo. Cada
+ * resultado é lido de volta e comparado com o que deveria conter antes de ir
+ * para o disco. No fim são impressos a vazão e o tempo gasto em E/S e em
+ * conversão.
+ *
+ * O destino espelha a árvore da origem e pode ser a própria origem, para gerar
+ * os caches ao lado dos charts antes de instalar a biblioteca. Caches que já
+ * correspondem ao chart atual são pulados. Um .chart ou .mid que já existe no
+ * formato de destino nunca é sobrescrito, porque pode ter sido feito à mão
+ * (com --forcar ele é regerado). O MIDI não guarda metadados: ao
+ * ler um, o song.ini da pasta é aplicado, e ao gravar um, os metadados do
+ * chart vão para um song.ini novo se a pasta ainda não tem um.
+ *
+ * Uso: riff-convert [--forcar] <chart|mid|cache> <origem> [destino] [threads] [operacoes_es]
+ */
+
+#include "chart.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <semaphore>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr int OPERACOES_ES_PADRAO = 2;
+    constexpr auto NOME_SONG_INI = "song.ini";
+    constexpr std::string_view OPCAO_FORCAR = "--forcar";
+
+    enum class Formato { Chart, Midi, Cache };
+
+    constexpr std::array<std::string_view, 3> EXTENSOES = {".chart", ".mid", Chart::CacheBinario::EXTENSAO};
+
+    std::string_view extensao(const Formato formato) {
+        return EXTENSOES[static_cast<std::size_t>(formato)];
+    }
+
+    std::optional<Formato> formatoPorNome(const std::string_view nome) {
+        if (nome == "chart") return Formato::Chart;
+        if (nome == "mid" || nome == "midi") return Formato::Midi;
+        if (nome == "cache") return Formato::Cache;
+        return std::nullopt;
+    }
+
+    std::optional<Formato> formatoPorExtensao(const std::filesystem::path &caminho) {
+        const auto texto = Arquivos::normalizarNome(caminho.extension().string());
+        for (std::size_t i = 0; i < EXTENSOES.size(); ++i) {
+            if (texto == EXTENSOES[i]) return static_cast<Formato>(i);
+        }
+        return std::nullopt;
+    }
+
+    struct Tarefa {
+        std::filesystem::path origem;
+        std::filesystem::path destino;
+        Formato formatoOrigem;
+    };
+
+    /**
+     * @brief Contadores compartilhados pelas threads (tempos em nanossegundos, somados)
+     */
+    struct Estatisticas {
+        std::atomic<std::size_t> convertidos{0};
+        std::atomic<std::size_t> atualizados{0};
+        std::atomic<std::size_t> falhas{0};
+        std::atomic<std::uint64_t> bytesLidos{0};
+        std::atomic<std::uint64_t> bytesGravados{0};
+        std::atomic<std::int64_t> tempoEsperaEs{0};
+        std::atomic<std::int64_t> tempoEs{0};
+        std::atomic<std::int64_t> tempoConversao{0};
+    };
+
+    std::int64_t nanossegundosDesde(const std::chrono::steady_clock::time_point inicio) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - inicio).count();
+    }
+
+    /**
+     * @brief Uma vaga de E/S, mantida enquanto o objeto existe
+     */
+    class VagaEs {
+    private:
+        std::counting_semaphore<> &semaforo;
+        Estatisticas &estatisticas;
+        std::chrono::steady_clock::time_point inicio;
+
+    public:
+        VagaEs(std::counting_semaphore<> &s, Estatisticas &e) : semaforo(s), estatisticas(e) {
+            const auto pedido = std::chrono::steady_clock::now();
+            semaforo.acquire();
+            estatisticas.tempoEsperaEs += nanossegundosDesde(pedido);
+            inicio = std::chrono::steady_clock::now();
+        }
+
+        ~VagaEs() {
+            estatisticas.tempoEs += nanossegundosDesde(inicio);
+            semaforo.release();
+        }
+
+        VagaEs(const VagaEs &) = delete;
+        VagaEs &operator=(const VagaEs &) = delete;
+    };
+
+    bool gravarArquivo(const std::filesystem::path &caminho, const std::string_view conteudo) {
+        std::error_code erro;
+        std::filesystem::create_directories(caminho.parent_path(), erro);
+        auto temporario = caminho;
+        temporario += ".tmp";
+        {
+            std::ofstream arquivo(temporario, std::ios::binary | std::ios::trunc);
+            arquivo.write(conteudo.data(), static_cast<std::streamsize>(conteudo.size()));
+            if (!arquivo) return false;
+        }
+        std::filesystem::rename(temporario, caminho, erro);
+        if (erro) std::filesystem::remove(temporario, erro);
+        return !erro;
+    }
+
+    std::optional<Chart::DadosChart> interpretar(const Formato formato, std::string_view bytes) {
+        switch (formato) {
+            case Formato::Chart:
+                if (bytes.starts_with("\xEF\xBB\xBF")) bytes.remove_prefix(3);
+                return Chart::ParserChart::fazerParsingConteudo(std::string(bytes));
+            case Formato::Midi:
+                return Chart::ConversorMidi::ler(bytes);
+            case Formato::Cache:
+                return Chart::CacheBinario::ler(bytes);
+        }
+        return std::nullopt;
+    }
+
+    bool mesmosMetadados(const Chart::MetadadosMusica &a, const Chart::MetadadosMusica &b) {
+        return a.nome == b.nome && a.artista == b.artista && a.streamMusica == b.streamMusica &&
+               a.criadorChart == b.criadorChart && a.album == b.album && a.ano == b.ano && a.genero == b.genero &&
+               a.tipoMidia == b.tipoMidia && a.offset == b.offset && a.dificuldade == b.dificuldade &&
+               a.inicioPreview == b.inicioPreview && a.fimPreview == b.fimPreview && a.jogador2 == b.jogador2;
+    }
+
+    /**
+     * @brief Compara dois charts; sem metadados, só o nome conta (é o que o MIDI guarda)
+     */
+    bool mesmoChart(const Chart::DadosChart &a, const Chart::DadosChart &b, const bool comMetadados) {
+        if (comMetadados ? !mesmosMetadados(a, b) : a.nome != b.nome) return false;
+        return a.resolucao == b.resolucao &&
+               std::ranges::equal(a.mudancasTempo, b.mudancasTempo, [](const auto &x, const auto &y) {
+                   return x.first == y.first && x.second.valorBruto == y.second.valorBruto;
+               }) &&
+               std::ranges::equal(a.assinaturasTempo, b.assinaturasTempo, [](const auto &x, const auto &y) {
+                   return x.first == y.first && x.second.numerador == y.second.numerador &&
+                          x.second.denominador == y.second.denominador;
+               }) &&
+               std::ranges::equal(a.notas, b.notas, [](const auto &x, const auto &y) {
+                   return x.tick == y.tick && x.traste == y.traste && x.comprimento == y.comprimento;
+               });
+    }
+
+    /**
+     * @brief song.ini com os metadados que o MIDI não guarda
+     */
+    std::string gerarSongIni(const Chart::MetadadosMusica &m) {
+        std::ostringstream texto;
+        texto << "[song]\n";
+        const auto campo = [&](const std::string_view chave, const sf::String &valor) {
+            if (!valor.isEmpty()) texto << chave << " = " << sfStringParaUtf8(valor) << "\n";
+        };
+        campo("name", m.nome);
+        campo("artist", m.artista);
+        campo("album", m.album);
+        campo("genre", m.genero);
+        campo("year", m.ano);
+        campo("charter", m.criadorChart);
+        if (m.offset != 0.0) texto << "delay = " << std::llround(m.offset * 1000.0) << "\n";
+        if (m.inicioPreview != 0.0) texto << "preview_start_time = " << std::llround(m.inicioPreview * 1000.0) << "\n";
+        if (m.fimPreview != 0.0) texto << "preview_end_time = " << std::llround(m.fimPreview * 1000.0) << "\n";
+        if (m.dificuldade != 0) texto << "diff_guitar = " << m.dificuldade << "\n";
+        return texto.str();
+    }
+
+    class Conversor {
+    private:
+        Formato formatoDestino;
+        std::counting_semaphore<> semaforoEs;
+        Estatisticas estatisticas;
+        std::mutex mutexSaida;
+
+        void relatarFalha(const Tarefa &tarefa, const std::string_view motivo) {
+            ++estatisticas.falhas;
+            const std::scoped_lock trava(mutexSaida);
+            std::cerr << "Erro: " << tarefa.origem.string() << ": " << motivo << std::endl;
+        }
+
+        void executar(const Tarefa &tarefa) {
+            const auto pastaOrigem = tarefa.origem.parent_path();
+            const auto songIniDestino = tarefa.destino.parent_path() / NOME_SONG_INI;
+            std::string bytes, songIni, cacheExistente;
+            bool songIniNoDestino = false;
+            {
+                const VagaEs vaga(semaforoEs, estatisticas);
+                bytes = lerArquivoBruto(tarefa.origem.string());
+                songIni = lerArquivoUtf8((pastaOrigem / NOME_SONG_INI).string());
+                std::error_code erro;
+                songIniNoDestino = std::filesystem::exists(songIniDestino, erro);
+                if (formatoDestino == Formato::Cache) cacheExistente = lerArquivoBruto(tarefa.destino.string());
+            }
+            estatisticas.bytesLidos += bytes.size();
+            if (bytes.empty()) {
+                relatarFalha(tarefa, "não foi possível ler");
+                return;
+            }
+
+            const auto inicioConversao = std::chrono::steady_clock::now();
+            const auto hashOrigem = hashConteudo(bytes);
+            if (formatoDestino == Formato::Cache && Chart::CacheBinario::hashOrigem(cacheExistente) == hashOrigem) {
+                ++estatisticas.atualizados;
+                estatisticas.tempoConversao += nanossegundosDesde(inicioConversao);
+                return;
+            }
+
+            auto dados = interpretar(tarefa.formatoOrigem, bytes);
+            if (!dados) {
+                relatarFalha(tarefa, "arquivo inválido");
+                return;
+            }
+            // Um MIDI não traz metadados; como no jogo, eles vêm do song.ini
+            if (tarefa.formatoOrigem == Formato::Midi && !songIni.empty()) {
+                Chart::LeitorMetadados::aplicarSongIni(songIni, *dados);
+            }
+
+            std::optional<std::string> saida;
+            switch (formatoDestino) {
+                case Formato::Chart: saida = Chart::EscritorChart::serializar(*dados); break;
+                case Formato::Midi: saida = Chart::ConversorMidi::escrever(*dados); break;
+                case Formato::Cache: saida = Chart::CacheBinario::escrever(*dados, hashOrigem); break;
+            }
+            if (!saida) {
+                relatarFalha(tarefa, "não representável no formato de destino");
+                return;
+            }
+
+            // Confere o resultado contra o que o formato de destino consegue guardar
+            const bool midi = formatoDestino == Formato::Midi;
+            const auto esperado = midi ? Chart::ConversorMidi::representavel(*dados) : *dados;
+            const auto relido = interpretar(formatoDestino, *saida);
+            if (!relido || !mesmoChart(*relido, esperado, !midi)) {
+                relatarFalha(tarefa, "o resultado lido de volta não confere");
+                return;
+            }
+            const auto novoSongIni = midi && songIni.empty() && !songIniNoDestino ? gerarSongIni(*dados) : std::string();
+            estatisticas.tempoConversao += nanossegundosDesde(inicioConversao);
+
+            {
+                const VagaEs vaga(semaforoEs, estatisticas);
+                if (!gravarArquivo(tarefa.destino, *saida) ||
+                    (!novoSongIni.empty() && !gravarArquivo(songIniDestino, novoSongIni))) {
+                    relatarFalha(tarefa, "não foi possível gravar " + tarefa.destino.string());
+                    return;
+                }
+            }
+            estatisticas.bytesGravados += saida->size() + novoSongIni.size();
+            ++estatisticas.convertidos;
+        }
+
+    public:
+        Conversor(const Formato destino, const int operacoesEs) : formatoDestino(destino), semaforoEs(operacoesEs) {}
+
+        /**
+         * @brief Uma tarefa por chart da árvore; quando a mesma pasta tem mais de um, vale o .chart
+         *
+         * Pastas que já têm o chart no formato de destino (.chart ou .mid), na
+         * origem ou no destino, ficam de fora: esse arquivo é o que o jogo usa e
+         * pode ter sido editado à mão.
+         * @param sobrescrever Regera também esses arquivos (--forcar)
+         */
+        [[nodiscard]] std::vector<Tarefa> listar(const std::filesystem::path &origem, const std::filesystem::path &destino,
+                                                 const bool sobrescrever) const {
+            std::map<std::filesystem::path, Tarefa> porDestino;
+            std::set<std::filesystem::path> jaNoFormato;
+            std::error_code erro;
+            for (auto it = std::filesystem::recursive_directory_iterator(
+                     origem, std::filesystem::directory_options::skip_permission_denied, erro);
+                 it != std::filesystem::recursive_directory_iterator(); it.increment(erro)) {
+                if (erro) break;
+                const auto formato = formatoPorExtensao(it->path());
+                if (!formato || !it->is_regular_file(erro)) continue;
+
+                auto caminhoDestino = destino / std::filesystem::relative(it->path(), origem, erro);
+                caminhoDestino.replace_extension(extensao(formatoDestino));
+                if (*formato == formatoDestino) {
+                    // O cache é derivado e sempre pode ser regerado; .chart e .mid não
+                    if (formatoDestino != Formato::Cache) jaNoFormato.insert(caminhoDestino);
+                    continue;
+                }
+                const auto [existente, inserida] = porDestino.try_emplace(caminhoDestino, Tarefa{it->path(), caminhoDestino, *formato});
+                if (!inserida && *formato < existente->second.formatoOrigem) {
+                    existente->second = Tarefa{it->path(), caminhoDestino, *formato};
+                }
+            }
+
+            if (!sobrescrever) {
+                // O destino pode ser outra árvore, com charts próprios que a origem não tem
+                const auto mantidos = std::erase_if(porDestino, [&](const auto &par) {
+                    std::error_code erroDestino;
+                    return formatoDestino != Formato::Cache &&
+                           (jaNoFormato.contains(par.first) || std::filesystem::exists(par.first, erroDestino));
+                });
+                if (mantidos > 0) {
+                    std::cout << mantidos << " charts já existem em " << extensao(formatoDestino)
+                              << " e foram mantidos (" << OPCAO_FORCAR << " para regerar)" << std::endl;
+                }
+            }
+
+            std::vector<Tarefa> tarefas;
+            tarefas.reserve(porDestino.size());
+            for (auto &tarefa : porDestino | std::views::values) tarefas.push_back(std::move(tarefa));
+            return tarefas;
+        }
+
+        /**
+         * @brief Executa as tarefas e imprime o resumo
+         * @return True se nenhuma falhou
+         */
+        bool converter(const std::vector<Tarefa> &tarefas, const int quantidadeThreads) {
+            const auto inicio = std::chrono::steady_clock::now();
+            std::atomic<std::size_t> proxima{0};
+            {
+                std::vector<std::jthread> threads;
+                const auto quantidade = std::min<std::size_t>(static_cast<std::size_t>(quantidadeThreads), tarefas.size());
+                for (std::size_t i = 0; i < quantidade; ++i) {
+                    threads.emplace_back([&] {
+                        for (auto indice = proxima++; indice < tarefas.size(); indice = proxima++) {
+                            executar(tarefas[indice]);
+                        }
+                    });
+                }
+            }
+            const std::chrono::duration<double> duracao = std::chrono::steady_clock::now() - inicio;
+
+            const auto segundos = std::max(duracao.count(), 1e-6);
+            const auto mib = [](const std::uint64_t bytes) { return bytes / (1024.0 * 1024.0); };
+            const auto somaSegundos = [](const std::int64_t nanossegundos) { return nanossegundos / 1e9; };
+            std::cout << std::fixed << std::setprecision(1)
+                      << estatisticas.convertidos << " convertidos, " << estatisticas.atualizados << " já atualizados, "
+                      << estatisticas.falhas << " falhas em " << std::setprecision(2) << segundos << " s ("
+                      << std::setprecision(0) << tarefas.size() / segundos << " arquivos/s)\n"
+                      << std::setprecision(1) << "Lidos " << mib(estatisticas.bytesLidos) << " MiB ("
+                      << mib(estatisticas.bytesLidos) / segundos << " MiB/s), gravados "
+                      << mib(estatisticas.bytesGravados) << " MiB (" << mib(estatisticas.bytesGravados) / segundos
+                      << " MiB/s)\n"
+                      << std::setprecision(2) << "Tempo somado das threads: conversão "
+                      << somaSegundos(estatisticas.tempoConversao) << " s, E/S " << somaSegundos(estatisticas.tempoEs)
+                      << " s, espera por vaga de E/S " << somaSegundos(estatisticas.tempoEsperaEs) << " s" << std::endl;
+            return estatisticas.falhas == 0;
+        }
+    };
+}
+
+int main(const int argc, char **argv) {
+    // --forcar pode vir em qualquer posição; o resto é posicional
+    std::vector<std::string> argumentos;
+    bool forcar = false;
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i] == OPCAO_FORCAR) {
+            forcar = true;
+        } else {
+            argumentos.emplace_back(argv[i]);
+        }
+    }
+    if (argumentos.size() < 2) {
+        std::cerr << "Uso: riff-convert [--forcar] <chart|mid|cache> <origem> [destino] [threads] [operacoes_es]"
+                  << std::endl;
+        return 1;
+    }
+
+    const auto formato = formatoPorNome(argumentos[0]);
+    if (!formato) {
+        std::cerr << "Erro: Formato desconhecido (esperado chart, mid ou cache): " << argumentos[0] << std::endl;
+        return 1;
+    }
+    const std::filesystem::path origem = argumentos[1];
+    const std::filesystem::path destino = argumentos.size() > 2 ? argumentos[2] : argumentos[1];
+    const int threads = argumentos.size() > 3 ? std::max(1, std::atoi(argumentos[3].c_str()))
+                                              : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const int operacoesEs = argumentos.size() > 4 ? std::max(1, std::atoi(argumentos[4].c_str())) : OPERACOES_ES_PADRAO;
+
+    std::error_code erro;
+    if (!std::filesystem::is_directory(origem, erro)) {
+        std::cerr << "Erro: Origem não é uma pasta: " << origem << std::endl;
+        return 1;
+    }
+
+    Conversor conversor(*formato, operacoesEs);
+    const auto tarefas = conversor.listar(origem, destino, forcar);
+    std::cout << tarefas.size() << " charts para " << extensao(*formato) << " com " << threads << " threads e "
+              << operacoesEs << " operações de E/S simultâneas" << std::endl;
+    return conversor.converter(tarefas, threads) ? 0 : 1;
+}
@@ -0,0 +1,362 @@
+/**
+ * @file riff_import.cpp
+ * @brief Importa pacotes de músicas de um espelho HTTP para a biblioteca
+ *
+ * O espelho serve um manifesto (manifest.txt) com uma linha por pacote:
+ *
+ *     <sha256> <tamanho_em_bytes> <arquivo.zip|arquivo.sng>
+ *
+ * Cada pacote é baixado em pedaços por várias conexões em paralelo (pedidos
+ * com cabeçalho Range) e gravado direto na biblioteca com extensão .parcial; o
+ * jogo lê .zip/.sng sem extrair, então não há passo de extração. Um arquivo
+ * .progresso ao lado marca os pedaços completos, e uma importação interrompida
+ * continua de onde parou. No fim o SHA-256 é conferido e o arquivo é renomeado.
+ *
+ * Uso: riff-import <url_espelho> [diretorio_biblioteca] [conexoes]
+ */
+
+#include "sha256.hpp"
+
+#include <SFML/Network.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr std::uint64_t TAMANHO_PEDACO = 4ull * 1024 * 1024;
+    constexpr int CONEXOES_PADRAO = 4;
+    constexpr int TENTATIVAS_POR_PEDACO = 4;
+    constexpr auto TEMPO_LIMITE_PEDIDO = sf::seconds(60.f);
+    constexpr auto NOME_MANIFESTO = "manifest.txt";
+
+    struct Url {
+        std::string host;
+        unsigned short porta = 80;
+        std::string caminho; // Sempre termina em '/'
+    };
+
+    struct EntradaManifesto {
+        std::string resumoHex;
+        std::uint64_t tamanho = 0;
+        std::string nome;
+    };
+
+    /**
+     * @brief Interpreta "http://host[:porta]/caminho"
+     */
+    std::optional<Url> interpretarUrl(std::string_view texto) {
+        constexpr std::string_view prefixo = "http://";
+        if (!texto.starts_with(prefixo)) return std::nullopt;
+        texto.remove_prefix(prefixo.size());
+
+        Url url;
+        const auto barra = texto.find('/');
+        auto autoridade = texto.substr(0, barra);
+        url.caminho = barra == std::string_view::npos ? "/" : std::string(texto.substr(barra));
+        if (!url.caminho.ends_with('/')) url.caminho += '/';
+
+        if (const auto doisPontos = autoridade.find(':'); doisPontos != std::string_view::npos) {
+            const auto porta = autoridade.substr(doisPontos + 1);
+            if (std::from_chars(porta.data(), porta.data() + porta.size(), url.porta).ec != std::errc()) {
+                return std::nullopt;
+            }
+            autoridade = autoridade.substr(0, doisPontos);
+        }
+        url.host = std::string(autoridade);
+        if (url.host.empty()) return std::nullopt;
+        return url;
+    }
+
+    /**
+     * @brief Codifica um nome de arquivo para a URI (espaços e acentos são comuns em pacotes)
+     */
+    std::string codificarUri(const std::string_view nome) {
+        constexpr char hex[] = "0123456789ABCDEF";
+        std::string codificado;
+        for (const char caractere : nome) {
+            const auto byte = static_cast<unsigned char>(caractere);
+            if (std::isalnum(byte) || caractere == '-' || caractere == '_' || caractere == '.' ||
+                caractere == '~' || caractere == '/') {
+                codificado += caractere;
+            } else {
+                codificado += '%';
+                codificado += hex[byte >> 4];
+                codificado += hex[byte & 0xF];
+            }
+        }
+        return codificado;
+    }
+
+    /**
+     * @brief Lê o manifesto; ignora linhas vazias e comentários (#)
+     */
+    std::vector<EntradaManifesto> interpretarManifesto(const std::string &texto) {
+        std::vector<EntradaManifesto> entradas;
+        std::istringstream linhas(texto);
+        std::string linha;
+        while (std::getline(linhas, linha)) {
+            if (!linha.empty() && linha.back() == '\r') linha.pop_back();
+            if (linha.empty() || linha.front() == '#') continue;
+
+            std::istringstream campos(linha);
+            EntradaManifesto entrada;
+            campos >> entrada.resumoHex >> entrada.tamanho >> std::ws;
+            std::getline(campos, entrada.nome);
+
+            // O nome vira caminho local: nada de sair da biblioteca
+            const std::filesystem::path caminho(entrada.nome);
+            const bool seguro = !entrada.nome.empty() && caminho.is_relative() &&
+                                std::ranges::none_of(caminho, [](const auto &parte) { return parte == ".."; });
+            // Espelhos publicam o resumo em maiúsculas ou minúsculas; paraHex gera minúsculas
+            std::ranges::transform(entrada.resumoHex, entrada.resumoHex.begin(),
+                                   [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            const bool resumoValido = entrada.resumoHex.size() == 64 &&
+                                      std::ranges::all_of(entrada.resumoHex, [](const unsigned char c) {
+                                          return std::isxdigit(c) != 0;
+                                      });
+            if (!resumoValido || !seguro) {
+                std::cerr << "Aviso: Linha inválida no manifesto: " << linha << std::endl;
+                continue;
+            }
+            entradas.push_back(std::move(entrada));
+        }
+        return entradas;
+    }
+
+    std::optional<std::string> resumoArquivo(const std::filesystem::path &caminho) {
+        std::ifstream arquivo(caminho, std::ios::binary);
+        if (!arquivo) return std::nullopt;
+
+        Sha256::Calculadora calculadora;
+        std::vector<char> buffer(1 << 20);
+        while (arquivo) {
+            arquivo.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            calculadora.atualizar(buffer.data(), static_cast<std::size_t>(arquivo.gcount()));
+        }
+        return Sha256::paraHex(calculadora.finalizar());
+    }
+
+    /**
+     * @brief Baixa um pacote em pedaços paralelos, com retomada
+     */
+    class Download {
+    private:
+        const Url &url;
+        const EntradaManifesto &entrada;
+        std::filesystem::path caminhoFinal;
+        std::filesystem::path caminhoParcial;
+        std::filesystem::path caminhoProgresso;
+        std::size_t quantidadePedacos;
+
+        std::mutex mutexProgresso;
+        std::string pedacosCompletos; // '1' por pedaço completo
+        std::atomic<std::size_t> proximoPedaco{0};
+        std::atomic<std::uint64_t> bytesBaixados{0};
+        std::atomic<bool> falhou{false};
+
+        void carregarProgresso() {
+            pedacosCompletos.assign(quantidadePedacos, '0');
+            std::ifstream arquivo(caminhoProgresso);
+            std::string salvo;
+            std::error_code erro;
+            if (arquivo >> salvo && salvo.size() == quantidadePedacos &&
+                std::filesystem::file_size(caminhoParcial, erro) == entrada.tamanho) {
+                pedacosCompletos = salvo;
+            }
+        }
+
+        void marcarCompleto(const std::size_t pedaco) {
+            std::lock_guard trava(mutexProgresso);
+            pedacosCompletos[pedaco] = '1';
+            std::ofstream(caminhoProgresso, std::ios::trunc) << pedacosCompletos;
+        }
+
+        /**
+         * @brief Busca um pedaço; devolve os bytes ou nulo se o servidor falhou
+         */
+        std::optional<std::string> buscarPedaco(sf::Http &http, const std::uint64_t inicio, const std::uint64_t fim) {
+            sf::Http::Request pedido(url.caminho + codificarUri(entrada.nome), sf::Http::Request::Method::Get);
+            pedido.setField("Range", "bytes=" + std::to_string(inicio) + "-" + std::to_string(fim - 1));
+
+            const auto resposta = http.sendRequest(pedido, TEMPO_LIMITE_PEDIDO);
+            if (resposta.getStatus() == sf::Http::Response::Status::PartialContent &&
+                resposta.getBody().size() == fim - inicio) {
+                return resposta.getBody();
+            }
+            // Servidor sem suporte a Range: só serve se o pacote inteiro é um pedaço só
+            if (resposta.getStatus() == sf::Http::Response::Status::Ok && inicio == 0 &&
+                resposta.getBody().size() == entrada.tamanho && fim == entrada.tamanho) {
+                return resposta.getBody();
+            }
+            return std::nullopt;
+        }
+
+        void executarConexao() {
+            sf::Http http("http://" + url.host, url.porta);
+            std::fstream arquivo(caminhoParcial, std::ios::binary | std::ios::in | std::ios::out);
+            if (!arquivo) {
+                falhou = true;
+                return;
+            }
+
+            while (!falhou) {
+                const auto pedaco = proximoPedaco.fetch_add(1);
+                if (pedaco >= quantidadePedacos) return;
+                {
+                    std::lock_guard trava(mutexProgresso);
+                    if (pedacosCompletos[pedaco] == '1') continue;
+                }
+
+                const auto inicio = pedaco * TAMANHO_PEDACO;
+                const auto fim = std::min(inicio + TAMANHO_PEDACO, entrada.tamanho);
+                std::optional<std::string> corpo;
+                for (int tentativa = 0; tentativa < TENTATIVAS_POR_PEDACO && !corpo; ++tentativa) {
+                    if (tentativa > 0) std::this_thread::sleep_for(std::chrono::milliseconds(500 << tentativa));
+                    corpo = buscarPedaco(http, inicio, fim);
+                }
+                if (!corpo) {
+                    std::cerr << "Erro: Pedaço " << pedaco << " de " << entrada.nome << " falhou." << std::endl;
+                    falhou = true;
+                    return;
+                }
+
+                arquivo.seekp(static_cast<std::streamoff>(inicio));
+                arquivo.write(corpo->data(), static_cast<std::streamsize>(corpo->size()));
+                arquivo.flush();
+                if (!arquivo) {
+                    falhou = true;
+                    return;
+                }
+                bytesBaixados += corpo->size();
+                marcarCompleto(pedaco);
+            }
+        }
+
+    public:
+        Download(const Url &u, const EntradaManifesto &e, const std::filesystem::path &biblioteca)
+            : url(u), entrada(e), caminhoFinal(biblioteca / e.nome),
+              quantidadePedacos(static_cast<std::size_t>((e.tamanho + TAMANHO_PEDACO - 1) / TAMANHO_PEDACO)) {
+            caminhoParcial = caminhoFinal;
+            caminhoParcial += ".parcial";
+            caminhoProgresso = caminhoFinal;
+            caminhoProgresso += ".progresso";
+        }
+
+        /**
+         * @brief Baixa, confere e instala o pacote
+         * @return Bytes transferidos, ou nulo em caso de falha
+         */
+        std::optional<std::uint64_t> executar(const int conexoes) {
+            std::error_code erro;
+            std::filesystem::create_directories(caminhoFinal.parent_path(), erro);
+
+            carregarProgresso();
+            if (std::ranges::find(pedacosCompletos, '1') == pedacosCompletos.end()) {
+                std::ofstream(caminhoParcial, std::ios::binary | std::ios::trunc);
+                std::filesystem::resize_file(caminhoParcial, entrada.tamanho, erro);
+                if (erro) {
+                    std::cerr << "Erro: Não foi possível criar " << caminhoParcial << ": " << erro.message() << std::endl;
+                    return std::nullopt;
+                }
+            } else {
+                std::cout << "  retomando " << std::ranges::count(pedacosCompletos, '1') << "/"
+                          << quantidadePedacos << " pedaços" << std::endl;
+            }
+
+            // Pacote vazio não tem pedaços: nenhum pedido (o fim do Range daria a volta em "bytes=0-")
+            {
+                std::vector<std::jthread> threads;
+                const auto quantidadeThreads = std::min<std::size_t>(static_cast<std::size_t>(conexoes), quantidadePedacos);
+                for (std::size_t i = 0; i < quantidadeThreads; ++i) {
+                    threads.emplace_back([this] { executarConexao(); });
+                }
+            }
+            if (falhou) return std::nullopt; // .parcial e .progresso ficam para a próxima tentativa
+
+            const auto resumo = resumoArquivo(caminhoParcial);
+            if (!resumo || *resumo != entrada.resumoHex) {
+                std::cerr << "Erro: SHA-256 de " << entrada.nome << " não confere; descartando." << std::endl;
+                std::filesystem::remove(caminhoParcial, erro);
+                std::filesystem::remove(caminhoProgresso, erro);
+                return std::nullopt;
+            }
+
+            std::filesystem::rename(caminhoParcial, caminhoFinal, erro);
+            if (erro) {
+                std::cerr << "Erro: Não foi possível instalar " << caminhoFinal << ": " << erro.message() << std::endl;
+                return std::nullopt;
+            }
+            std::filesystem::remove(caminhoProgresso, erro);
+            return bytesBaixados.load();
+        }
+    };
+}
+
+int main(const int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Uso: riff-import <url_espelho> [diretorio_biblioteca] [conexoes]" << std::endl;
+        return 1;
+    }
+
+    const auto url = interpretarUrl(argv[1]);
+    if (!url) {
+        std::cerr << "Erro: URL inválida (esperado http://host[:porta]/caminho): " << argv[1] << std::endl;
+        return 1;
+    }
+    const std::filesystem::path biblioteca = argc > 2 ? argv[2] : "biblioteca";
+    const int conexoes = argc > 3 ? std::max(1, std::atoi(argv[3])) : CONEXOES_PADRAO;
+
+    sf::Http http("http://" + url->host, url->porta);
+    const auto respostaManifesto = http.sendRequest(sf::Http::Request(url->caminho + NOME_MANIFESTO), TEMPO_LIMITE_PEDIDO);
+    if (respostaManifesto.getStatus() != sf::Http::Response::Status::Ok) {
+        std::cerr << "Erro: Não foi possível obter o manifesto (status "
+                  << static_cast<int>(respostaManifesto.getStatus()) << ")" << std::endl;
+        return 1;
+    }
+    const auto entradas = interpretarManifesto(respostaManifesto.getBody());
+
+    int falhas = 0;
+    std::uint64_t totalBytes = 0;
+    const auto inicio = std::chrono::steady_clock::now();
+    for (const auto &entrada : entradas) {
+        const auto destino = biblioteca / entrada.nome;
+        std::error_code erro;
+        if (std::filesystem::file_size(destino, erro) == entrada.tamanho && resumoArquivo(destino) == entrada.resumoHex) {
+            std::cout << entrada.nome << ": já presente" << std::endl;
+            continue;
+        }
+
+        std::cout << entrada.nome << " (" << entrada.tamanho / (1024.0 * 1024.0) << " MiB)" << std::endl;
+        const auto inicioPacote = std::chrono::steady_clock::now();
+        const auto bytes = Download(*url, entrada, biblioteca).executar(conexoes);
+        if (!bytes) {
+            ++falhas;
+            continue;
+        }
+
+        const std::chrono::duration<double> duracao = std::chrono::steady_clock::now() - inicioPacote;
+        totalBytes += *bytes;
+        std::cout << "  ok, " << std::fixed << std::setprecision(1)
+                  << *bytes / (1024.0 * 1024.0) / std::max(duracao.count(), 1e-6) << " MiB/s" << std::endl;
+    }
+
+    const std::chrono::duration<double> duracao = std::chrono::steady_clock::now() - inicio;
+    std::cout << entradas.size() - falhas << "/" << entradas.size() << " pacotes, " << std::fixed << std::setprecision(1)
+              << totalBytes / (1024.0 * 1024.0) << " MiB em " << duracao.count() << " s" << std::endl;
+    return falhas == 0 ? 0 : 1;
+}
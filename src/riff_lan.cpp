@@ -0,0 +1,139 @@
+/**
+ * @file riff_lan.cpp
+ * @brief Lobby na rede local sem abrir o jogo: hospeda, procura e baixa músicas
+ *
+ * Vários processos na mesma máquina conversam normalmente: um hospeda e os
+ * outros entram pelo endereço 127.0.0.1. A procura por broadcast escuta uma
+ * porta fixa, então só um processo por máquina pode procurar ao mesmo tempo.
+ *
+ * Uso:
+ *   riff-lan hospedar <pasta_musica|pacote> [nome_lobby] [porta]
+ *   riff-lan procurar [segundos]
+ *   riff-lan entrar <pasta_destino> [endereco[:porta]]
+ */
+
+#include "lan.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+    constexpr auto DURACAO_PROCURA_PADRAO = std::chrono::seconds(3);
+    constexpr int TENTATIVAS_CONEXAO = 5;
+    constexpr auto INTERVALO_PROGRESSO = std::chrono::milliseconds(250);
+
+    void imprimirLobby(const Lan::Lobby &lobby) {
+        std::cout << lobby.endereco.toString() << ":" << lobby.porta << "  \"" << lobby.nome << "\"  "
+                  << lobby.artista << " - " << lobby.nomeMusica << "  [" << lobby.identificadorMusica.substr(0, 12)
+                  << "]" << std::endl;
+    }
+
+    int hospedar(const int argc, char **argv) {
+        if (argc < 3) {
+            std::cerr << "Uso: riff-lan hospedar <pasta_musica|pacote> [nome_lobby] [porta]" << std::endl;
+            return 1;
+        }
+        const std::filesystem::path origem = argv[2];
+        const std::string nome = argc > 3 ? argv[3] : "Riff Hero";
+        const auto porta = argc > 4 ? static_cast<unsigned short>(std::atoi(argv[4])) : Lan::PORTA_TRANSFERENCIA_PADRAO;
+
+        Lan::Anfitriao anfitriao;
+        if (!anfitriao.iniciar(origem, nome, origem.filename().string(), "", porta)) {
+            std::cerr << "Erro: Não foi possível abrir a porta " << porta << std::endl;
+            return 1;
+        }
+        std::cout << "Hospedando " << origem << " na porta " << porta << " (Ctrl+C para sair)" << std::endl;
+        while (true) std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+
+    int procurar(const int argc, char **argv) {
+        const auto duracao = argc > 2 ? std::chrono::seconds(std::atoi(argv[2])) : DURACAO_PROCURA_PADRAO;
+        const auto lobbies = Lan::procurarLobbies(duracao);
+        if (lobbies.empty()) {
+            std::cout << "Nenhum lobby encontrado." << std::endl;
+            return 1;
+        }
+        for (const auto &lobby : lobbies) imprimirLobby(lobby);
+        return 0;
+    }
+
+    int entrar(const int argc, char **argv) {
+        if (argc < 3) {
+            std::cerr << "Uso: riff-lan entrar <pasta_destino> [endereco[:porta]]" << std::endl;
+            return 1;
+        }
+
+        Lan::Lobby lobby;
+        if (argc > 3) {
+            std::string endereco = argv[3];
+            if (const auto doisPontos = endereco.find(':'); doisPontos != std::string::npos) {
+                lobby.porta = static_cast<unsigned short>(std::atoi(endereco.c_str() + doisPontos + 1));
+                endereco.resize(doisPontos);
+            }
+            const auto resolvido = sf::IpAddress::resolve(endereco);
+            if (!resolvido) {
+                std::cerr << "Erro: Endereço inválido: " << endereco << std::endl;
+                return 1;
+            }
+            lobby.endereco = *resolvido;
+        } else {
+            const auto lobbies = Lan::procurarLobbies(DURACAO_PROCURA_PADRAO);
+            if (lobbies.empty()) {
+                std::cerr << "Erro: Nenhum lobby encontrado." << std::endl;
+                return 1;
+            }
+            lobby = lobbies.front();
+            imprimirLobby(lobby);
+        }
+
+        Lan::Receptor receptor(argv[2]);
+        bool concluido = false;
+        for (int tentativa = 0; tentativa < TENTATIVAS_CONEXAO && !concluido; ++tentativa) {
+            if (tentativa > 0) {
+                std::cout << "Conexão perdida; retomando..." << std::endl;
+                std::this_thread::sleep_for(std::chrono::seconds(tentativa));
+            }
+
+            // A transferência roda em outra thread, como rodaria dentro do jogo
+            bool avisouPronto = receptor.prontoParaIniciar();
+            std::atomic<bool> terminou{false};
+            std::jthread transferencia([&] {
+                concluido = receptor.executar(lobby.endereco, lobby.porta);
+                terminou = true;
+            });
+            while (!terminou) {
+                std::this_thread::sleep_for(INTERVALO_PROGRESSO);
+                if (!avisouPronto && receptor.prontoParaIniciar()) {
+                    std::cout << "Pronto para iniciar (" << receptor.recebidos() / 1024 << " KiB recebidos)" << std::endl;
+                    avisouPronto = true;
+                }
+            }
+        }
+
+        if (!concluido) {
+            std::cerr << "Erro: Transferência não concluída; rode de novo para continuar." << std::endl;
+            return 1;
+        }
+        std::cout << "Concluído: " << std::fixed << std::setprecision(1)
+                  << receptor.total() / (1024.0 * 1024.0) << " MiB em " << argv[2] << std::endl;
+        return 0;
+    }
+}
+
+int main(const int argc, char **argv) {
+    const std::string comando = argc > 1 ? argv[1] : "";
+    if (comando == "hospedar") return hospedar(argc, argv);
+    if (comando == "procurar") return procurar(argc, argv);
+    if (comando == "entrar") return entrar(argc, argv);
+
+    std::cerr << "Uso:\n"
+                 "  riff-lan hospedar <pasta_musica|pacote> [nome_lobby] [porta]\n"
+                 "  riff-lan procurar [segundos]\n"
+                 "  riff-lan entrar <pasta_destino> [endereco[:porta]]"
+              << std::endl;
+    return 1;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file riff_monitor.cpp
+ * @brief Leitor dos contadores ao vivo publicados pelo Riff Hero
+ *
+ * Mapeia o segmento de telemetria somente para leitura e imprime uma linha por
+ * intervalo. Não escreve nada no segmento, então não interfere no jogo.
+ *
+ * Uso: riff-monitor [intervalo_ms] [nome_segmento]
+ */
+
+#include "telemetria.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+int main(const int argc, char **argv) {
+#if RIFF_HERO_TELEMETRIA_DISPONIVEL
+    int intervaloMs = 500;
+    if (argc > 1) {
+        const std::string texto = argv[1];
+        const auto [fim, erro] = std::from_chars(texto.data(), texto.data() + texto.size(), intervaloMs);
+        if (erro != std::errc() || fim != texto.data() + texto.size() || intervaloMs <= 0) {
+            std::cerr << "Uso: riff-monitor [intervalo_ms] [nome_segmento]" << std::endl;
+            return 1;
+        }
+    }
+    const std::string nome = argc > 2 ? argv[2] : Telemetria::NOME_SEGMENTO_PADRAO;
+
+    const int descritor = shm_open(nome.c_str(), O_RDONLY, 0);
+    if (descritor < 0) {
+        std::cerr << "Erro: Segmento " << nome << " não encontrado. O jogo está rodando?" << std::endl;
+        return 1;
+    }
+
+    void *mapeamento = mmap(nullptr, sizeof(Telemetria::Bloco), PROT_READ, MAP_SHARED, descritor, 0);
+    close(descritor);
+    if (mapeamento == MAP_FAILED) {
+        std::cerr << "Erro: Não foi possível mapear " << nome << std::endl;
+        return 1;
+    }
+
+    const auto &bloco = *static_cast<const Telemetria::Bloco *>(mapeamento);
+
+    std::cout << std::setw(10) << "quadro" << std::setw(12) << "quadro_us" << std::setw(12) << "atualiz_us"
+              << std::setw(10) << "desenhos" << std::setw(11) << "particulas" << std::setw(8) << "notas"
+              << std::setw(12) << "deriva_us" << std::setw(12) << "alocacoes" << std::endl;
+
+    Telemetria::Amostra amostra;
+    while (true) {
+        const auto leitura = Telemetria::ler(bloco, amostra);
+        if (leitura == Telemetria::Leitura::Incompativel) {
+            std::cerr << "Erro: Segmento com layout incompatível." << std::endl;
+            return 1;
+        }
+        if (leitura == Telemetria::Leitura::Interrompida) {
+            std::cerr << "Erro: Escrita no segmento nunca terminou. O jogo parou no meio dela?" << std::endl;
+            return 1;
+        }
+
+        std::cout << std::setw(10) << amostra.numeroQuadro << std::setw(12) << amostra.tempoQuadroUs
+                  << std::setw(12) << amostra.tempoAtualizacaoUs << std::setw(10) << amostra.chamadasDesenho
+                  << std::setw(11) << amostra.particulasAtivas << std::setw(8) << amostra.notasProcessadas
+                  << std::setw(12) << amostra.derivaRelogioAudioUs << std::setw(12) << amostra.alocacoes
+                  << std::endl;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(intervaloMs));
+    }
+#else
+    (void)argc;
+    (void)argv;
+    std::cerr << "Erro: Memória compartilhada POSIX não disponível nesta plataforma." << std::endl;
+    return 1;
+#endif
+}
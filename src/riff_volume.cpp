@@ -0,0 +1,179 @@
+/**
+ * @file riff_volume.cpp
+ * @brief Mede a sonoridade integrada (EBU R128) de todos os áudios de uma biblioteca
+ *
+ * Cada arquivo de áudio da árvore, também dentro de pacotes .zip e .sng, é uma
+ * tarefa; um número fixo de threads pega as tarefas em sequência, decodifica e
+ * mede. O resultado vai para sonoridade.idx na raiz da biblioteca, indexado
+ * pelo hash do conteúdo: o jogo procura ali o áudio que vai tocar e ajusta o
+ * volume sem analisar nada. Áudios que já estão no índice são pulados, e os
+ * que sumiram da biblioteca saem dele.
+ *
+ * Uso: riff-volume <biblioteca> [threads]
+ */
+
+#include "sonoridade.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    bool ehAudio(const std::filesystem::path &caminho) {
+        const auto extensao = Arquivos::normalizarNome(caminho.extension().string());
+        return std::ranges::find(Sonoridade::EXTENSOES_AUDIO, extensao) != Sonoridade::EXTENSOES_AUDIO.end();
+    }
+
+    class Analisador {
+    private:
+        std::filesystem::path raiz;
+        Sonoridade::Indice anterior;
+        Sonoridade::Indice novo;
+        std::mutex mutex;
+
+        std::atomic<std::size_t> medidos{0};
+        std::atomic<std::size_t> jaNoIndice{0};
+        std::atomic<std::size_t> falhas{0};
+        std::atomic<std::int64_t> milissegundosAudio{0};
+
+        void executar(const std::filesystem::path &caminho) {
+            const auto relativo = std::filesystem::relative(caminho, raiz).generic_string();
+            const auto bytes = lerArquivoBruto(caminho.string());
+            if (bytes.empty()) {
+                ++falhas;
+                const std::scoped_lock trava(mutex);
+                std::cerr << "Erro: " << relativo << ": não foi possível ler" << std::endl;
+                return;
+            }
+
+            const auto hash = hashConteudo(bytes);
+            if (const auto *entrada = anterior.procurar(hash)) {
+                ++jaNoIndice;
+                auto copia = *entrada;
+                copia.caminho = relativo;
+                const std::scoped_lock trava(mutex);
+                novo.definir(hash, std::move(copia));
+                return;
+            }
+
+            sf::InputSoundFile arquivo;
+            std::optional<Sonoridade::Medida> medida;
+            if (arquivo.openFromMemory(bytes.data(), bytes.size())) medida = Sonoridade::medir(arquivo);
+
+            const std::scoped_lock trava(mutex);
+            if (!medida) {
+                ++falhas;
+                std::cerr << "Erro: " << relativo << ": formato de áudio não suportado" << std::endl;
+                return;
+            }
+            ++medidos;
+            milissegundosAudio += std::llround(medida->duracaoSegundos * 1000.0);
+            novo.definir(hash, {medida->integradaLufs, medida->pico, relativo});
+
+            const auto ganho = Sonoridade::ganho(medida->integradaLufs, medida->pico);
+            std::cout << std::fixed << std::setprecision(1) << std::setw(6) << medida->integradaLufs << " LUFS  pico "
+                      << std::setw(5) << 20.0 * std::log10(std::max(medida->pico, 1e-9)) << " dBFS  ganho "
+                      << std::showpos << std::setw(5) << 20.0 * std::log10(ganho) << std::noshowpos << " dB  "
+                      << relativo << std::endl;
+        }
+
+    public:
+        explicit Analisador(std::filesystem::path r) : raiz(std::move(r)) {
+            anterior.carregar(raiz / Sonoridade::NOME_INDICE);
+        }
+
+        /**
+         * @brief Áudios da árvore, incluindo os de dentro de pacotes
+         */
+        [[nodiscard]] std::vector<std::filesystem::path> listar() const {
+            std::vector<std::filesystem::path> audios;
+            std::error_code erro;
+            for (auto it = std::filesystem::recursive_directory_iterator(
+                     raiz, std::filesystem::directory_options::skip_permission_denied, erro);
+                 it != std::filesystem::recursive_directory_iterator(); it.increment(erro)) {
+                if (erro) break;
+                if (!it->is_regular_file(erro)) continue;
+                const auto &caminho = it->path();
+                if (ehAudio(caminho)) {
+                    audios.push_back(caminho);
+                    continue;
+                }
+
+                const auto extensao = Arquivos::normalizarNome(caminho.extension().string());
+                if (extensao != ".zip" && extensao != ".sng") continue;
+                // localizar() só abre o pacote quando o caminho continua dentro dele
+                if (const auto local = Arquivos::sistemaArquivos().localizar(caminho / Sonoridade::NOME_INDICE)) {
+                    for (const auto &entrada : local->first->listar()) {
+                        if (ehAudio(entrada.nome)) audios.push_back(caminho / entrada.nome);
+                    }
+                }
+            }
+            return audios;
+        }
+
+        /**
+         * @brief Mede tudo, grava o índice e imprime o resumo
+         * @return True se nada falhou
+         */
+        bool analisar(const std::vector<std::filesystem::path> &audios, const int quantidadeThreads) {
+            const auto inicio = std::chrono::steady_clock::now();
+            std::atomic<std::size_t> proxima{0};
+            {
+                std::vector<std::jthread> threads;
+                const auto quantidade = std::min<std::size_t>(static_cast<std::size_t>(quantidadeThreads), audios.size());
+                for (std::size_t i = 0; i < quantidade; ++i) {
+                    threads.emplace_back([&] {
+                        for (auto indice = proxima++; indice < audios.size(); indice = proxima++) {
+                            executar(audios[indice]);
+                        }
+                    });
+                }
+            }
+            const std::chrono::duration<double> duracao = std::chrono::steady_clock::now() - inicio;
+
+            const auto caminhoIndice = raiz / Sonoridade::NOME_INDICE;
+            if (!novo.gravar(caminhoIndice)) {
+                std::cerr << "Erro: Não foi possível gravar " << caminhoIndice.string() << std::endl;
+                return false;
+            }
+
+            const auto segundos = std::max(duracao.count(), 1e-6);
+            const auto segundosAudio = milissegundosAudio / 1000.0;
+            std::cout << std::fixed << std::setprecision(2) << medidos << " medidos, " << jaNoIndice
+                      << " já no índice, " << falhas << " falhas em " << segundos << " s (" << std::setprecision(0)
+                      << segundosAudio / 60.0 << " min de áudio, " << segundosAudio / segundos << "x o tempo real)\n"
+                      << "Índice: " << caminhoIndice.string() << " (" << novo.tamanho() << " músicas)" << std::endl;
+            return falhas == 0;
+        }
+    };
+}
+
+int main(const int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Uso: riff-volume <biblioteca> [threads]" << std::endl;
+        return 1;
+    }
+
+    const std::filesystem::path raiz = argv[1];
+    const int threads = argc > 2 ? std::max(1, std::atoi(argv[2]))
+                                 : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::error_code erro;
+    if (!std::filesystem::is_directory(raiz, erro)) {
+        std::cerr << "Erro: Biblioteca não é uma pasta: " << raiz << std::endl;
+        return 1;
+    }
+
+    Analisador analisador(raiz);
+    const auto audios = analisador.listar();
+    std::cout << audios.size() << " áudios com " << threads << " threads" << std::endl;
+    return analisador.analisar(audios, threads) ? 0 : 1;
+}
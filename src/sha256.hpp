@@ -0,0 +1,144 @@
+/**
+ * @file sha256.hpp
+ * @brief SHA-256 (FIPS 180-4) para verificar pacotes e pedaços transferidos
+ *
+ * Implementação direta, sem dependências, em streaming: o conteúdo pode ser
+ * entregue em pedaços de qualquer tamanho.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace Sha256 {
+    using Resumo = std::array<std::uint8_t, 32>;
+
+    class Calculadora {
+    private:
+        static constexpr std::array<std::uint32_t, 64> K = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+        std::array<std::uint32_t, 8> estado = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                               0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+        std::array<std::uint8_t, 64> bloco{};
+        std::size_t ocupados = 0;
+        std::uint64_t totalBytes = 0;
+
+        static constexpr std::uint32_t rotacionar(const std::uint32_t x, const int n) {
+            return (x >> n) | (x << (32 - n));
+        }
+
+        void comprimir(const std::uint8_t *dados) {
+            std::array<std::uint32_t, 64> w{};
+            for (int i = 0; i < 16; ++i) {
+                w[i] = (static_cast<std::uint32_t>(dados[i * 4]) << 24) |
+                       (static_cast<std::uint32_t>(dados[i * 4 + 1]) << 16) |
+                       (static_cast<std::uint32_t>(dados[i * 4 + 2]) << 8) | dados[i * 4 + 3];
+            }
+            for (int i = 16; i < 64; ++i) {
+                const auto s0 = rotacionar(w[i - 15], 7) ^ rotacionar(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                const auto s1 = rotacionar(w[i - 2], 17) ^ rotacionar(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+
+            auto [a, b, c, d, e, f, g, h] = estado;
+            for (int i = 0; i < 64; ++i) {
+                const auto s1 = rotacionar(e, 6) ^ rotacionar(e, 11) ^ rotacionar(e, 25);
+                const auto escolha = (e & f) ^ (~e & g);
+                const auto t1 = h + s1 + escolha + K[i] + w[i];
+                const auto s0 = rotacionar(a, 2) ^ rotacionar(a, 13) ^ rotacionar(a, 22);
+                const auto maioria = (a & b) ^ (a & c) ^ (b & c);
+                const auto t2 = s0 + maioria;
+                h = g;
+                g = f;
+                f = e;
+                e = d + t1;
+                d = c;
+                c = b;
+                b = a;
+                a = t1 + t2;
+            }
+            estado[0] += a;
+            estado[1] += b;
+            estado[2] += c;
+            estado[3] += d;
+            estado[4] += e;
+            estado[5] += f;
+            estado[6] += g;
+            estado[7] += h;
+        }
+
+    public:
+        void atualizar(const void *dados, std::size_t tamanho) {
+            const auto *bytes = static_cast<const std::uint8_t *>(dados);
+            totalBytes += tamanho;
+
+            if (ocupados > 0) {
+                const auto copiar = std::min(tamanho, bloco.size() - ocupados);
+                std::memcpy(bloco.data() + ocupados, bytes, copiar);
+                ocupados += copiar;
+                bytes += copiar;
+                tamanho -= copiar;
+                if (ocupados < bloco.size()) return;
+                comprimir(bloco.data());
+                ocupados = 0;
+            }
+            for (; tamanho >= bloco.size(); bytes += bloco.size(), tamanho -= bloco.size()) {
+                comprimir(bytes);
+            }
+            std::memcpy(bloco.data(), bytes, tamanho);
+            ocupados = tamanho;
+        }
+
+        void atualizar(const std::string_view texto) {
+            atualizar(texto.data(), texto.size());
+        }
+
+        [[nodiscard]] Resumo finalizar() {
+            const std::uint64_t totalBits = totalBytes * 8;
+            const std::uint8_t marcador = 0x80;
+            atualizar(&marcador, 1);
+            const std::array<std::uint8_t, 64> zeros{};
+            atualizar(zeros.data(), (ocupados <= 56 ? 56 : 120) - ocupados);
+
+            std::array<std::uint8_t, 8> comprimento{};
+            for (int i = 0; i < 8; ++i) comprimento[i] = static_cast<std::uint8_t>(totalBits >> (56 - 8 * i));
+            atualizar(comprimento.data(), comprimento.size());
+
+            Resumo resumo{};
+            for (int i = 0; i < 8; ++i) {
+                for (int j = 0; j < 4; ++j) resumo[i * 4 + j] = static_cast<std::uint8_t>(estado[i] >> (24 - 8 * j));
+            }
+            return resumo;
+        }
+    };
+
+    inline Resumo calcular(const std::string_view dados) {
+        Calculadora calculadora;
+        calculadora.atualizar(dados);
+        return calculadora.finalizar();
+    }
+
+    inline std::string paraHex(const Resumo &resumo) {
+        constexpr char hex[] = "0123456789abcdef";
+        std::string texto;
+        texto.reserve(64);
+        for (const auto byte : resumo) {
+            texto += hex[byte >> 4];
+            texto += hex[byte & 0xF];
+        }
+        return texto;
+    }
+}
@@ -0,0 +1,157 @@
+/**
+ * @file sonoridade.hpp
+ * @brief Sonoridade integrada no estilo EBU R128 (ITU-R BS.1770) e o índice por biblioteca
+ *
+ * O riff-volume mede as músicas e grava o índice; o jogo só consulta o índice
+ * e ajusta o volume, sem analisar nada durante a partida.
+ */
+
+#pragma once
+
+#include "medicao.hpp"
+#include "texto.hpp"
+
+#include <SFML/Audio.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Sonoridade {
+    constexpr std::size_t QUADROS_POR_LEITURA = 16384;
+    constexpr auto NOME_INDICE = "sonoridade.idx";
+    constexpr std::string_view CABECALHO_INDICE = "# riff-hero sonoridade 1: hash lufs pico caminho";
+    constexpr std::array<std::string_view, 5> EXTENSOES_AUDIO = {".ogg", ".wav", ".flac", ".mp3", ".opus"};
+
+    /**
+     * @brief Resultado da medição de um arquivo
+     */
+    struct Medida {
+        double integradaLufs = LIMIAR_ABSOLUTO_LUFS; // Silêncio fica no limiar absoluto
+        double pico = 0.0;
+        double duracaoSegundos = 0.0;
+    };
+
+    /**
+     * @brief Decodifica o arquivo inteiro e mede
+     * @return Vazio se o arquivo não tem canais ou taxa
+     */
+    inline std::optional<Medida> medir(sf::InputSoundFile &arquivo) {
+        const auto canais = arquivo.getChannelCount();
+        const auto taxa = arquivo.getSampleRate();
+        if (canais == 0 || taxa == 0) return std::nullopt;
+
+        Medidor medidor(taxa, canais);
+        std::vector<std::int16_t> amostras(QUADROS_POR_LEITURA * canais);
+        std::uint64_t quadros = 0;
+        while (const auto lidas = arquivo.read(amostras.data(), amostras.size())) {
+            medidor.adicionar(amostras.data(), static_cast<std::size_t>(lidas / canais));
+            quadros += lidas / canais;
+        }
+
+        Medida medida;
+        medida.integradaLufs = medidor.integrada().value_or(LIMIAR_ABSOLUTO_LUFS);
+        medida.pico = medidor.pico();
+        medida.duracaoSegundos = static_cast<double>(quadros) / taxa;
+        return medida;
+    }
+
+    /**
+     * @brief Uma música medida
+     */
+    struct Entrada {
+        double integradaLufs = LIMIAR_ABSOLUTO_LUFS;
+        double pico = 0.0;
+        std::string caminho; // Relativo à raiz da biblioteca, só para quem lê o arquivo
+    };
+
+    /**
+     * @brief Índice de sonoridade da biblioteca, por hash do conteúdo do áudio
+     *
+     * Texto, uma música por linha: hash (hex), LUFS, pico e caminho. O hash
+     * mantém a entrada válida quando a pasta muda de nome ou vai para um pacote.
+     */
+    class Indice {
+    private:
+        std::map<std::uint64_t, Entrada> entradas;
+
+    public:
+        /**
+         * @brief Lê o índice; linhas malformadas são ignoradas
+         * @return False se o arquivo não existe
+         */
+        bool carregar(const std::filesystem::path &caminho) {
+            std::ifstream arquivo(caminho);
+            if (!arquivo) return false;
+
+            std::string linha;
+            while (std::getline(arquivo, linha)) {
+                if (linha.empty() || linha.front() == '#') continue;
+                const char *p = linha.data();
+                const char *fim = p + linha.size();
+
+                std::uint64_t hash = 0;
+                Entrada entrada;
+                auto resultado = std::from_chars(p, fim, hash, 16);
+                if (resultado.ec != std::errc() || resultado.ptr == fim) continue;
+                resultado = std::from_chars(resultado.ptr + 1, fim, entrada.integradaLufs);
+                if (resultado.ec != std::errc() || resultado.ptr == fim) continue;
+                resultado = std::from_chars(resultado.ptr + 1, fim, entrada.pico);
+                if (resultado.ec != std::errc()) continue;
+                if (resultado.ptr != fim) entrada.caminho.assign(resultado.ptr + 1, fim);
+                entradas.insert_or_assign(hash, std::move(entrada));
+            }
+            return true;
+        }
+
+        /**
+         * @brief Grava em arquivo temporário e renomeia, para o jogo nunca ler um índice pela metade
+         */
+        [[nodiscard]] bool gravar(const std::filesystem::path &caminho) const {
+            std::ostringstream saida;
+            saida << CABECALHO_INDICE << '\n' << std::fixed;
+            for (const auto &[hash, entrada] : entradas) {
+                std::array<char, 17> hex{};
+                std::to_chars(hex.data(), hex.data() + 16, hash, 16);
+                saida << hex.data() << ' ' << std::setprecision(2) << entrada.integradaLufs << ' '
+                      << std::setprecision(6) << entrada.pico << ' ' << entrada.caminho << '\n';
+            }
+
+            auto temporario = caminho;
+            temporario += ".tmp";
+            {
+                std::ofstream arquivo(temporario, std::ios::binary | std::ios::trunc);
+                const auto texto = saida.str();
+                arquivo.write(texto.data(), static_cast<std::streamsize>(texto.size()));
+                if (!arquivo) return false;
+            }
+            std::error_code erro;
+            std::filesystem::rename(temporario, caminho, erro);
+            return !erro;
+        }
+
+        [[nodiscard]] const Entrada *procurar(const std::uint64_t hash) const {
+            const auto it = entradas.find(hash);
+            return it == entradas.end() ? nullptr : &it->second;
+        }
+
+        void definir(const std::uint64_t hash, Entrada entrada) {
+            entradas.insert_or_assign(hash, std::move(entrada));
+        }
+
+        [[nodiscard]] std::size_t tamanho() const {
+            return entradas.size();
+        }
+    };
+}
@@ -0,0 +1,192 @@
+/**
+ * @file telemetria.hpp
+ * @brief Contadores ao vivo publicados em memória compartilhada POSIX
+ *
+ * O jogo escreve uma amostra por quadro em um bloco de layout fixo; ferramentas
+ * externas (riff-monitor) mapeiam o mesmo segmento somente para leitura. A
+ * consistência usa um seqlock: o escritor nunca espera pelo leitor e o leitor
+ * repete a leitura se pegar uma escrita pela metade.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define RIFF_HERO_TELEMETRIA_DISPONIVEL 1
+#else
+#define RIFF_HERO_TELEMETRIA_DISPONIVEL 0
+#endif
+
+namespace Telemetria {
+    constexpr auto NOME_SEGMENTO_PADRAO = "/riff-hero";
+    constexpr std::uint32_t MAGICA = 0x52494646; // "RIFF"
+    constexpr std::uint32_t VERSAO = 1;
+    // Sequência ímpar por mais que isso: o jogo morreu no meio de uma escrita. Medido em tempo, não em
+    // tentativas, para que um escritor apenas preemptado pelo sistema não pareça morto
+    constexpr auto LIMITE_LEITURA = std::chrono::milliseconds(500);
+    constexpr auto ESPERA_ESCRITA = std::chrono::microseconds(100);
+
+    /**
+     * @brief Valores de um quadro, fora da memória compartilhada
+     */
+    struct Amostra {
+        std::int64_t numeroQuadro = 0;
+        std::int64_t tempoQuadroUs = 0;
+        std::int64_t tempoAtualizacaoUs = 0;
+        std::int64_t chamadasDesenho = 0;
+        std::int64_t particulasAtivas = 0;
+        std::int64_t notasProcessadas = 0;
+        std::int64_t derivaRelogioAudioUs = 0;
+        std::int64_t alocacoes = 0;
+    };
+
+    /**
+     * @brief Layout fixo do segmento compartilhado
+     *
+     * Os campos são atômicos (sem trava, portanto independentes de endereço)
+     * para que leitor e escritor em processos diferentes não tenham data race.
+     */
+    struct Bloco {
+        std::uint32_t magica;
+        std::uint32_t versao;
+        std::atomic<std::uint32_t> sequencia;
+        std::uint32_t reservado;
+        std::atomic<std::int64_t> numeroQuadro;
+        std::atomic<std::int64_t> tempoQuadroUs;
+        std::atomic<std::int64_t> tempoAtualizacaoUs;
+        std::atomic<std::int64_t> chamadasDesenho;
+        std::atomic<std::int64_t> particulasAtivas;
+        std::atomic<std::int64_t> notasProcessadas;
+        std::atomic<std::int64_t> derivaRelogioAudioUs;
+        std::atomic<std::int64_t> alocacoes;
+    };
+
+    static_assert(std::atomic<std::int64_t>::is_always_lock_free);
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+
+    /**
+     * @brief Escreve uma amostra no bloco (lado do jogo)
+     */
+    inline void escrever(Bloco &bloco, const Amostra &amostra) {
+        const auto sequencia = bloco.sequencia.load(std::memory_order_relaxed);
+        bloco.sequencia.store(sequencia + 1, std::memory_order_relaxed); // Ímpar: escrita em andamento
+        std::atomic_thread_fence(std::memory_order_release);
+
+        bloco.numeroQuadro.store(amostra.numeroQuadro, std::memory_order_relaxed);
+        bloco.tempoQuadroUs.store(amostra.tempoQuadroUs, std::memory_order_relaxed);
+        bloco.tempoAtualizacaoUs.store(amostra.tempoAtualizacaoUs, std::memory_order_relaxed);
+        bloco.chamadasDesenho.store(amostra.chamadasDesenho, std::memory_order_relaxed);
+        bloco.particulasAtivas.store(amostra.particulasAtivas, std::memory_order_relaxed);
+        bloco.notasProcessadas.store(amostra.notasProcessadas, std::memory_order_relaxed);
+        bloco.derivaRelogioAudioUs.store(amostra.derivaRelogioAudioUs, std::memory_order_relaxed);
+        bloco.alocacoes.store(amostra.alocacoes, std::memory_order_relaxed);
+
+        bloco.sequencia.store(sequencia + 2, std::memory_order_release);
+    }
+
+    enum class Leitura { Ok, Incompativel, Interrompida };
+
+    /**
+     * @brief Lê uma amostra consistente do bloco (lado do monitor)
+     * @param bloco Bloco mapeado
+     * @param amostra Saída
+     * @return Incompativel se o bloco não foi inicializado pelo jogo; Interrompida
+     *         se nenhuma leitura consistente saiu em LIMITE_LEITURA
+     */
+    inline Leitura ler(const Bloco &bloco, Amostra &amostra) {
+        if (bloco.magica != MAGICA || bloco.versao != VERSAO) return Leitura::Incompativel;
+
+        const auto prazo = std::chrono::steady_clock::now() + LIMITE_LEITURA;
+        while (std::chrono::steady_clock::now() < prazo) {
+            const auto antes = bloco.sequencia.load(std::memory_order_acquire);
+            if (antes & 1u) {
+                // Dorme em vez de girar: o escritor pode estar esperando esta mesma CPU
+                std::this_thread::sleep_for(ESPERA_ESCRITA);
+                continue;
+            }
+
+            amostra.numeroQuadro = bloco.numeroQuadro.load(std::memory_order_relaxed);
+            amostra.tempoQuadroUs = bloco.tempoQuadroUs.load(std::memory_order_relaxed);
+            amostra.tempoAtualizacaoUs = bloco.tempoAtualizacaoUs.load(std::memory_order_relaxed);
+            amostra.chamadasDesenho = bloco.chamadasDesenho.load(std::memory_order_relaxed);
+            amostra.particulasAtivas = bloco.particulasAtivas.load(std::memory_order_relaxed);
+            amostra.notasProcessadas = bloco.notasProcessadas.load(std::memory_order_relaxed);
+            amostra.derivaRelogioAudioUs = bloco.derivaRelogioAudioUs.load(std::memory_order_relaxed);
+            amostra.alocacoes = bloco.alocacoes.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (bloco.sequencia.load(std::memory_order_relaxed) == antes) return Leitura::Ok;
+        }
+        return Leitura::Interrompida;
+    }
+
+    /**
+     * @brief Cria o segmento e publica amostras (lado do jogo)
+     */
+    class Publicador {
+    private:
+        Bloco *bloco = nullptr;
+        std::string nomeSegmento;
+
+    public:
+        Publicador() = default;
+        Publicador(const Publicador &) = delete;
+        Publicador &operator=(const Publicador &) = delete;
+
+        ~Publicador() {
+#if RIFF_HERO_TELEMETRIA_DISPONIVEL
+            if (bloco) {
+                munmap(bloco, sizeof(Bloco));
+                shm_unlink(nomeSegmento.c_str());
+            }
+#endif
+        }
+
+        /**
+         * @brief Cria (ou recria) o segmento compartilhado
+         * @param nome Nome POSIX do segmento (começa com '/')
+         * @return True se o segmento está pronto para publicação
+         */
+        bool abrir(const std::string &nome) {
+#if RIFF_HERO_TELEMETRIA_DISPONIVEL
+            const int descritor = shm_open(nome.c_str(), O_CREAT | O_RDWR, 0644);
+            if (descritor < 0) return false;
+
+            if (ftruncate(descritor, sizeof(Bloco)) != 0) {
+                close(descritor);
+                return false;
+            }
+
+            void *mapeamento = mmap(nullptr, sizeof(Bloco), PROT_READ | PROT_WRITE, MAP_SHARED, descritor, 0);
+            close(descritor);
+            if (mapeamento == MAP_FAILED) return false;
+
+            bloco = new (mapeamento) Bloco{};
+            bloco->magica = MAGICA;
+            bloco->versao = VERSAO;
+            nomeSegmento = nome;
+            return true;
+#else
+            (void)nome;
+            return false;
+#endif
+        }
+
+        void publicar(const Amostra &amostra) {
+            if (bloco) escrever(*bloco, amostra);
+        }
+
+        [[nodiscard]] bool ativo() const {
+            return bloco != nullptr;
+        }
+    };
+}
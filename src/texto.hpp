@@ -0,0 +1,168 @@
+/**
+ * @file texto.hpp
+ * @brief Conversões UTF-8, leitura de arquivos (também de dentro de pacotes) e leitor INI
+ */
+
+#pragma once
+
+#include "arquivos.hpp"
+
+#include <SFML/System.hpp>
+
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Converte string UTF-8 para sf::String (UTF-32)
+ * @param utf8Str String em UTF-8
+ * @return sf::String em UTF-32
+ */
+inline sf::String utf8ParaSfString(const std::string_view utf8Str) {
+    return sf::String::fromUtf8(utf8Str.begin(), utf8Str.end());
+}
+
+/**
+ * @brief Converte std::wstring para sf::String (UTF-32)
+ * @param wideStr String wide
+ * @return sf::String em UTF-32
+ */
+inline sf::String wstringParaSfString(const std::wstring& wideStr) {
+    return sf::String(wideStr);
+}
+
+/**
+ * @brief Converte sf::String para std::string UTF-8
+ * @param sfStr sf::String em UTF-32
+ * @return String em UTF-8
+ */
+inline std::string sfStringParaUtf8(const sf::String& sfStr) {
+    std::string utf8Str;
+    sf::Utf32::toUtf8(sfStr.begin(), sfStr.end(), std::back_inserter(utf8Str));
+    return utf8Str;
+}
+
+/**
+ * @brief Lê um arquivo inteiro, de disco ou de dentro de um pacote
+ * @param caminhoArquivo Caminho, possivelmente atravessando um .zip/.sng
+ * @return Bytes do arquivo (vazio se não existe)
+ */
+inline std::string lerArquivoBruto(const std::string& caminhoArquivo) {
+    if (auto conteudoPacote = Arquivos::sistemaArquivos().lerTudo(caminhoArquivo)) {
+        return std::move(*conteudoPacote);
+    }
+
+    std::ifstream arquivo(caminhoArquivo, std::ios::binary);
+    if (!arquivo.is_open()) {
+        return "";
+    }
+    return std::string((std::istreambuf_iterator<char>(arquivo)), std::istreambuf_iterator<char>());
+}
+
+/**
+ * @brief Lê arquivo texto com suporte a UTF-8
+ * @param caminhoArquivo Caminho para o arquivo
+ * @return Conteúdo do arquivo em UTF-8
+ */
+inline std::string lerArquivoUtf8(const std::string& caminhoArquivo) {
+    std::string conteudo = lerArquivoBruto(caminhoArquivo);
+
+    // Remove BOM UTF-8 se presente
+    if (conteudo.size() >= 3 &&
+        static_cast<unsigned char>(conteudo[0]) == 0xEF &&
+        static_cast<unsigned char>(conteudo[1]) == 0xBB &&
+        static_cast<unsigned char>(conteudo[2]) == 0xBF) {
+        conteudo.erase(0, 3);
+    }
+
+    return conteudo;
+}
+
+/**
+ * @brief Hash FNV-1a de 64 bits do conteúdo (chave de caches em disco)
+ */
+inline std::uint64_t hashConteudo(const std::string_view dados) {
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    for (const char byte : dados) {
+        hash = (hash ^ static_cast<unsigned char>(byte)) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief Varredura de arquivos INI sem alocação
+ *
+ * Seções, chaves e valores são entregues como std::string_view apontando para o
+ * texto original; nada é copiado. Comentários começam com ';' ou '#'.
+ */
+namespace Ini {
+    /**
+     * @brief Remove espaços e tabulações das pontas
+     */
+    constexpr std::string_view aparar(std::string_view texto) {
+        while (!texto.empty() && (texto.front() == ' ' || texto.front() == '\t')) texto.remove_prefix(1);
+        while (!texto.empty() && (texto.back() == ' ' || texto.back() == '\t' || texto.back() == '\r')) {
+            texto.remove_suffix(1);
+        }
+        return texto;
+    }
+
+    /**
+     * @brief Compara ignorando maiúsculas (ASCII)
+     */
+    constexpr bool iguaisSemCaixa(const std::string_view a, const std::string_view b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            const auto minuscula = [](const char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; };
+            if (minuscula(a[i]) != minuscula(b[i])) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Converte um valor numérico sem alocar
+     * @return False se o valor não é um número
+     */
+    template <typename T>
+    bool lerNumero(std::string_view texto, T &valor) {
+        texto = aparar(texto);
+        if (texto.starts_with('+')) texto.remove_prefix(1);
+        const auto resultado = std::from_chars(texto.data(), texto.data() + texto.size(), valor);
+        return resultado.ec == std::errc();
+    }
+
+    /**
+     * @brief Percorre todas as linhas "chave = valor" do texto
+     * @param texto Conteúdo do arquivo
+     * @param visitante Chamado como visitante(secao, chave, valor); retorna false para parar
+     */
+    template <typename Visitante>
+    void percorrer(const std::string_view texto, Visitante &&visitante) {
+        std::string_view secao;
+        size_t inicio = 0;
+        while (inicio < texto.size()) {
+            auto fim = texto.find('\n', inicio);
+            if (fim == std::string_view::npos) fim = texto.size();
+            const auto linha = aparar(texto.substr(inicio, fim - inicio));
+            inicio = fim + 1;
+
+            if (linha.empty() || linha.front() == ';' || linha.front() == '#') continue;
+            if (linha.front() == '[') {
+                const auto fechamento = linha.find(']');
+                secao = aparar(linha.substr(1, fechamento == std::string_view::npos ? std::string_view::npos : fechamento - 1));
+                continue;
+            }
+
+            const auto igual = linha.find('=');
+            if (igual == std::string_view::npos) continue;
+            auto valor = aparar(linha.substr(igual + 1));
+            if (valor.size() >= 2 && valor.front() == '"' && valor.back() == '"') {
+                valor = valor.substr(1, valor.size() - 2);
+            }
+            if (!visitante(secao, aparar(linha.substr(0, igual)), valor)) return;
+        }
+    }
+}
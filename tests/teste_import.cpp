@@ -0,0 +1,316 @@
+/**
+ * @file teste_import.cpp
+ * @brief Roda o riff-import contra um espelho HTTP local que serve um manifesto e pacotes
+ *
+ * O espelho atende pedidos com Range, como um servidor de arquivos comum. O
+ * manifesto traz um pacote de vários pedaços (resumo em maiúsculas, nome com
+ * espaço) e um pacote vazio, que precisa ser instalado sem pedido nenhum. Uma
+ * importação interrompida (.parcial e .progresso já na biblioteca) só pede os
+ * pedaços que faltam, e um pacote cujos bytes não batem com o resumo do
+ * manifesto falha sem ser instalado.
+ *
+ * Uso: teste-import <caminho_riff_import>
+ */
+
+#include "sha256.hpp"
+
+#include <SFML/Network.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+    constexpr auto INTERVALO_ESPERA = sf::milliseconds(100);
+    constexpr auto PREFIXO = "/espelho/";
+    constexpr auto NOME_GRANDE = "pacote grande.zip";
+    constexpr auto NOME_VAZIO = "vazio.sng";
+    constexpr auto NOME_RETOMADO = "retomado.zip";
+    constexpr auto NOME_CORROMPIDO = "corrompido.sng";
+    constexpr std::size_t TAMANHO_PEDACO = 4u * 1024 * 1024; // O mesmo do riff-import
+    // Um pouco mais que dois pedaços de 4 MiB, para o último sair curto
+    constexpr std::size_t TAMANHO_GRANDE = 9u * 1024 * 1024 + 17;
+    constexpr std::size_t TAMANHO_CORROMPIDO = 70000;
+
+    /**
+     * @brief Pedido recebido pelo espelho; `faixa` é o valor do Range sem "bytes=" (vazio se não veio)
+     */
+    struct Pedido {
+        std::string caminho;
+        std::string faixa;
+    };
+
+    /**
+     * @brief Espelho HTTP/1.0 mínimo; cada conexão recebe uma resposta e é fechada
+     */
+    class Espelho {
+    private:
+        sf::TcpListener ouvinte;
+        std::map<std::string, std::string> arquivos;
+        std::mutex mutexPedidos;
+        std::vector<Pedido> pedidos;
+        std::jthread thread;
+
+        static std::string decodificarUri(const std::string &uri) {
+            std::string nome;
+            for (std::size_t i = 0; i < uri.size(); ++i) {
+                if (uri[i] == '%' && i + 2 < uri.size()) {
+                    nome += static_cast<char>(std::stoi(uri.substr(i + 1, 2), nullptr, 16));
+                    i += 2;
+                } else {
+                    nome += uri[i];
+                }
+            }
+            return nome;
+        }
+
+        static std::string responder(const int status, const std::string &motivo, const std::string &corpo,
+                                     const std::string &extras = "") {
+            return "HTTP/1.0 " + std::to_string(status) + " " + motivo + "\r\n" + extras +
+                   "Content-Length: " + std::to_string(corpo.size()) + "\r\nConnection: close\r\n\r\n" + corpo;
+        }
+
+        std::string montarResposta(const std::string &cabecalho) {
+            std::istringstream linhas(cabecalho);
+            std::string metodo, uri;
+            linhas >> metodo >> uri;
+            const auto caminho = decodificarUri(uri);
+            std::string faixa;
+            std::string linha;
+            while (std::getline(linhas, linha)) {
+                if (linha.starts_with("Range: bytes=")) faixa = linha.substr(13, linha.find_last_not_of('\r') - 12);
+            }
+            {
+                std::lock_guard trava(mutexPedidos);
+                pedidos.push_back({caminho, faixa});
+            }
+
+            const auto arquivo = caminho.starts_with(PREFIXO) ? arquivos.find(caminho.substr(std::string(PREFIXO).size()))
+                                                              : arquivos.end();
+            if (metodo != "GET" || arquivo == arquivos.end()) return responder(404, "Not Found", "");
+            const auto &conteudo = arquivo->second;
+            if (faixa.empty()) return responder(200, "OK", conteudo);
+
+            std::uint64_t inicio = 0, fim = 0;
+            char traco = 0;
+            std::istringstream(faixa) >> inicio >> traco >> fim;
+            if (inicio > fim || fim >= conteudo.size()) return responder(416, "Range Not Satisfiable", "");
+            return responder(206, "Partial Content", conteudo.substr(inicio, fim - inicio + 1),
+                             "Content-Range: bytes " + std::to_string(inicio) + "-" + std::to_string(fim) + "/" +
+                             std::to_string(conteudo.size()) + "\r\n");
+        }
+
+        void atender(const std::stop_token &parar) {
+            sf::SocketSelector seletor;
+            seletor.add(ouvinte);
+            while (!parar.stop_requested()) {
+                if (!seletor.wait(INTERVALO_ESPERA)) continue;
+                sf::TcpSocket cliente;
+                if (ouvinte.accept(cliente) != sf::Socket::Status::Done) continue;
+
+                sf::SocketSelector seletorCliente;
+                seletorCliente.add(cliente);
+                std::string cabecalho;
+                std::array<char, 4096> buffer{};
+                std::size_t recebidos = 0;
+                while (cabecalho.find("\r\n\r\n") == std::string::npos && seletorCliente.wait(sf::seconds(2)) &&
+                       cliente.receive(buffer.data(), buffer.size(), recebidos) == sf::Socket::Status::Done) {
+                    cabecalho.append(buffer.data(), recebidos);
+                }
+                if (cabecalho.find("\r\n\r\n") == std::string::npos) continue;
+
+                const auto resposta = montarResposta(cabecalho);
+                (void)cliente.send(resposta.data(), resposta.size());
+                cliente.disconnect();
+            }
+        }
+
+    public:
+        explicit Espelho(std::map<std::string, std::string> conteudo) : arquivos(std::move(conteudo)) {}
+
+        bool iniciar() {
+            if (ouvinte.listen(0, sf::IpAddress::LocalHost) != sf::Socket::Status::Done) return false;
+            thread = std::jthread([this](const std::stop_token &parar) { atender(parar); });
+            return true;
+        }
+
+        [[nodiscard]] unsigned short porta() const {
+            return ouvinte.getLocalPort();
+        }
+
+        std::vector<Pedido> pedidosFeitos() {
+            std::lock_guard trava(mutexPedidos);
+            return std::exchange(pedidos, {});
+        }
+    };
+
+    std::string resumoHex(const std::string &conteudo) {
+        Sha256::Calculadora calculadora;
+        calculadora.atualizar(conteudo.data(), conteudo.size());
+        return Sha256::paraHex(calculadora.finalizar());
+    }
+
+    std::string lerArquivo(const std::filesystem::path &caminho) {
+        std::ifstream arquivo(caminho, std::ios::binary);
+        return {std::istreambuf_iterator<char>(arquivo), std::istreambuf_iterator<char>()};
+    }
+
+    bool falhar(const std::string &mensagem) {
+        std::cerr << "Erro: " << mensagem << std::endl;
+        return false;
+    }
+
+    std::string gerarConteudo(const std::size_t tamanho, const std::uint32_t semente) {
+        std::string conteudo(tamanho, '\0');
+        for (std::size_t i = 0; i < conteudo.size(); ++i) {
+            conteudo[i] = static_cast<char>(((i + semente) * 2654435761u) >> 13);
+        }
+        return conteudo;
+    }
+
+    std::string linhaManifesto(const std::string &resumo, const std::string &conteudo, const std::string &nome) {
+        return resumo + " " + std::to_string(conteudo.size()) + " " + nome + "\n";
+    }
+
+    std::filesystem::path prepararBiblioteca(const std::string &caso, const Espelho &espelho) {
+        const auto biblioteca = std::filesystem::temp_directory_path() /
+                                ("riff-hero-teste-import-" + caso + "-" + std::to_string(espelho.porta()));
+        std::filesystem::remove_all(biblioteca);
+        return biblioteca;
+    }
+
+    std::string comandoImport(const std::string &riffImport, const Espelho &espelho,
+                              const std::filesystem::path &biblioteca) {
+        return "\"" + riffImport + "\" http://127.0.0.1:" + std::to_string(espelho.porta()) + "/espelho \"" +
+               biblioteca.string() + "\" 3";
+    }
+
+    std::vector<Pedido> pedidosPara(const std::vector<Pedido> &pedidos, const std::string &nome) {
+        std::vector<Pedido> filtrados;
+        std::ranges::copy_if(pedidos, std::back_inserter(filtrados),
+                             [&](const Pedido &pedido) { return pedido.caminho == PREFIXO + nome; });
+        return filtrados;
+    }
+
+    bool sobrouParcial(const std::filesystem::path &biblioteca, const std::string &nome) {
+        for (const auto &resto : {".parcial", ".progresso"}) {
+            if (std::filesystem::exists(biblioteca / (nome + resto))) return true;
+        }
+        return false;
+    }
+
+    bool testarImportacao(const std::string &riffImport) {
+        const auto grande = gerarConteudo(TAMANHO_GRANDE, 0);
+        auto resumoGrande = resumoHex(grande);
+        std::ranges::transform(resumoGrande, resumoGrande.begin(),
+                               [](const unsigned char c) { return static_cast<char>(std::toupper(c)); });
+        const auto manifesto = "# espelho de teste\n" + resumoGrande + " " + std::to_string(grande.size()) + " " +
+                               NOME_GRANDE + "\r\n" + resumoHex("") + " 0 " + NOME_VAZIO + "\n";
+
+        Espelho espelho({{"manifest.txt", manifesto}, {NOME_GRANDE, grande}, {NOME_VAZIO, ""}});
+        if (!espelho.iniciar()) return falhar("Não foi possível escutar numa porta local");
+
+        const auto biblioteca = prepararBiblioteca("completo", espelho);
+        const auto comando = comandoImport(riffImport, espelho, biblioteca);
+
+        if (std::system(comando.c_str()) != 0) return falhar("riff-import falhou: " + comando);
+        if (lerArquivo(biblioteca / NOME_GRANDE) != grande) return falhar("Pacote grande instalado com conteúdo errado");
+        if (!std::filesystem::is_regular_file(biblioteca / NOME_VAZIO) ||
+            std::filesystem::file_size(biblioteca / NOME_VAZIO) != 0) {
+            return falhar("Pacote vazio não foi instalado");
+        }
+        if (sobrouParcial(biblioteca, NOME_GRANDE)) return falhar("Sobrou .parcial ou .progresso do pacote grande");
+
+        const auto pedidos = espelho.pedidosFeitos();
+        if (!pedidosPara(pedidos, NOME_VAZIO).empty()) return falhar("Pacote vazio gerou pedido ao espelho");
+        if (const auto quantidade = pedidosPara(pedidos, NOME_GRANDE).size(); quantidade != 3) {
+            return falhar("Esperados 3 pedaços do pacote grande, houve " + std::to_string(quantidade));
+        }
+
+        // Segunda rodada: tudo já presente, só o manifesto é pedido
+        if (std::system(comando.c_str()) != 0) return falhar("Segunda rodada do riff-import falhou");
+        const auto pedidosRepetidos = espelho.pedidosFeitos();
+        if (pedidosRepetidos.size() != 1) return falhar("Segunda rodada baixou pacotes já presentes");
+
+        std::filesystem::remove_all(biblioteca);
+        return true;
+    }
+
+    /**
+     * @brief Importação interrompida com os pedaços 0 e 2 prontos: só o Range do pedaço 1 pode ser pedido
+     */
+    bool testarRetomada(const std::string &riffImport) {
+        const auto conteudo = gerarConteudo(TAMANHO_GRANDE, 7);
+        Espelho espelho({{"manifest.txt", linhaManifesto(resumoHex(conteudo), conteudo, NOME_RETOMADO)},
+                         {NOME_RETOMADO, conteudo}});
+        if (!espelho.iniciar()) return falhar("Não foi possível escutar numa porta local");
+
+        const auto biblioteca = prepararBiblioteca("retomada", espelho);
+        std::filesystem::create_directories(biblioteca);
+        auto parcial = conteudo;
+        std::fill_n(parcial.begin() + TAMANHO_PEDACO, TAMANHO_PEDACO, '\0'); // Pedaço 1 nunca chegou
+        std::ofstream(biblioteca / (std::string(NOME_RETOMADO) + ".parcial"), std::ios::binary) << parcial;
+        std::ofstream(biblioteca / (std::string(NOME_RETOMADO) + ".progresso")) << "101";
+
+        const auto comando = comandoImport(riffImport, espelho, biblioteca);
+        if (std::system(comando.c_str()) != 0) return falhar("riff-import falhou na retomada: " + comando);
+        if (lerArquivo(biblioteca / NOME_RETOMADO) != conteudo) return falhar("Pacote retomado com conteúdo errado");
+        if (sobrouParcial(biblioteca, NOME_RETOMADO)) return falhar("Sobrou .parcial ou .progresso da retomada");
+
+        const auto pedidos = pedidosPara(espelho.pedidosFeitos(), NOME_RETOMADO);
+        const auto faixaEsperada = std::to_string(TAMANHO_PEDACO) + "-" + std::to_string(2 * TAMANHO_PEDACO - 1);
+        if (pedidos.size() != 1 || pedidos.front().faixa != faixaEsperada) {
+            std::string feitos;
+            for (const auto &pedido : pedidos) feitos += " [" + pedido.faixa + "]";
+            return falhar("Retomada devia pedir só bytes=" + faixaEsperada + ", pediu" + feitos);
+        }
+
+        std::filesystem::remove_all(biblioteca);
+        return true;
+    }
+
+    /**
+     * @brief Espelho serve bytes que não batem com o resumo do manifesto: falha e nada é instalado
+     */
+    bool testarResumoErrado(const std::string &riffImport) {
+        const auto conteudo = gerarConteudo(TAMANHO_CORROMPIDO, 3);
+        auto servido = conteudo;
+        servido[servido.size() / 2] ^= 0x40;
+        Espelho espelho({{"manifest.txt", linhaManifesto(resumoHex(conteudo), conteudo, NOME_CORROMPIDO)},
+                         {NOME_CORROMPIDO, servido}});
+        if (!espelho.iniciar()) return falhar("Não foi possível escutar numa porta local");
+
+        const auto biblioteca = prepararBiblioteca("resumo", espelho);
+        const auto comando = comandoImport(riffImport, espelho, biblioteca);
+        if (std::system(comando.c_str()) == 0) return falhar("riff-import aceitou um pacote com resumo errado");
+        if (std::filesystem::exists(biblioteca / NOME_CORROMPIDO)) return falhar("Pacote com resumo errado foi instalado");
+        if (sobrouParcial(biblioteca, NOME_CORROMPIDO)) return falhar("Sobrou .parcial ou .progresso do pacote corrompido");
+
+        std::filesystem::remove_all(biblioteca);
+        return true;
+    }
+}
+
+int main(const int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Uso: teste-import <caminho_riff_import>" << std::endl;
+        return 1;
+    }
+    const bool importacao = testarImportacao(argv[1]);
+    const bool retomada = testarRetomada(argv[1]);
+    const bool resumo = testarResumoErrado(argv[1]);
+    return importacao && retomada && resumo ? 0 : 1;
+}
@@ -0,0 +1,272 @@
+/**
+ * @file teste_lan.cpp
+ * @brief Lobby e transferência pela interface de loopback
+ *
+ * Um Anfitriao de verdade serve uma pasta de música; o lobby precisa aparecer
+ * na descoberta e o Receptor precisa baixar tudo, pedaço a pedaço, igual ao
+ * original. Um anfitrião falso, que fala o mesmo protocolo, manda um manifesto
+ * com caminho para fora da pasta de destino e pedaços que não conferem com o
+ * resumo: nos dois casos o Receptor desiste sem gravar o que não devia.
+ *
+ * Uso: teste-lan
+ */
+
+#include "lan.hpp"
+
+#include <SFML/Network.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+    constexpr auto DURACAO_PROCURA = std::chrono::milliseconds(3000);
+    // Vários pedaços, com o último curto
+    constexpr std::size_t TAMANHO_AUDIO = 3 * Lan::TAMANHO_PEDACO + 1234;
+    constexpr std::uint32_t PEDACO_CORROMPIDO = 1;
+
+    std::string gerarConteudo(const std::size_t tamanho, const std::uint32_t semente) {
+        std::string conteudo(tamanho, '\0');
+        for (std::size_t i = 0; i < conteudo.size(); ++i) {
+            conteudo[i] = static_cast<char>(((i + semente) * 2654435761u) >> 13);
+        }
+        return conteudo;
+    }
+
+    void gravarArquivo(const std::filesystem::path &caminho, const std::string &conteudo) {
+        std::ofstream(caminho, std::ios::binary) << conteudo;
+    }
+
+    std::string lerArquivo(const std::filesystem::path &caminho) {
+        std::ifstream arquivo(caminho, std::ios::binary);
+        return {std::istreambuf_iterator<char>(arquivo), std::istreambuf_iterator<char>()};
+    }
+
+    std::filesystem::path pastaTemporaria(const std::string &caso) {
+        const auto pasta = std::filesystem::temp_directory_path() / ("riff-hero-teste-lan-" + caso);
+        std::filesystem::remove_all(pasta);
+        std::filesystem::create_directories(pasta);
+        return pasta;
+    }
+
+    bool falhar(const std::string &mensagem) {
+        std::cerr << "Erro: " << mensagem << std::endl;
+        return false;
+    }
+
+    Lan::ArquivoManifesto descrever(const std::string &nome, const std::string &conteudo) {
+        Lan::ArquivoManifesto arquivo{nome, conteudo.size(), {}};
+        for (std::size_t i = 0; i < arquivo.quantidadePedacos(); ++i) {
+            arquivo.resumos.push_back(
+                Sha256::calcular(std::string_view(conteudo).substr(arquivo.inicioPedaco(i), arquivo.tamanhoPedaco(i))));
+        }
+        return arquivo;
+    }
+
+    /**
+     * @brief Fala o protocolo do Anfitriao, mas serve o manifesto e os bytes que o teste manda
+     */
+    class AnfitriaoFalso {
+    private:
+        sf::TcpListener ouvinte;
+        Lan::Manifesto manifesto;
+        std::vector<std::string> conteudos; // Servidos como estão, mesmo que não confiram com o manifesto
+        std::mutex mutexPedidos;
+        std::map<std::pair<std::uint32_t, std::uint32_t>, int> pedidos;
+        std::jthread thread;
+
+        void atender(const std::stop_token &parar) {
+            sf::SocketSelector seletor;
+            seletor.add(ouvinte);
+            while (!parar.stop_requested()) {
+                if (!seletor.wait(Lan::INTERVALO_ESPERA)) continue;
+                sf::TcpSocket cliente;
+                if (ouvinte.accept(cliente) != sf::Socket::Status::Done) continue;
+
+                sf::Packet pedido;
+                while (cliente.receive(pedido) == sf::Socket::Status::Done) {
+                    std::uint8_t tipo = 0;
+                    pedido >> tipo;
+                    sf::Packet resposta;
+                    if (static_cast<Lan::TipoMensagem>(tipo) == Lan::TipoMensagem::PedirManifesto) {
+                        resposta << static_cast<std::uint8_t>(Lan::TipoMensagem::Manifesto);
+                        manifesto.escrever(resposta);
+                    } else if (static_cast<Lan::TipoMensagem>(tipo) == Lan::TipoMensagem::PedirPedaco) {
+                        std::uint32_t indice = 0;
+                        std::uint32_t pedaco = 0;
+                        pedido >> indice >> pedaco;
+                        {
+                            std::lock_guard trava(mutexPedidos);
+                            ++pedidos[{indice, pedaco}];
+                        }
+                        const auto &arquivo = manifesto.arquivos[indice];
+                        resposta << static_cast<std::uint8_t>(Lan::TipoMensagem::Pedaco) << indice << pedaco;
+                        resposta.append(conteudos[indice].data() + arquivo.inicioPedaco(pedaco), arquivo.tamanhoPedaco(pedaco));
+                    } else {
+                        break;
+                    }
+                    if (cliente.send(resposta) != sf::Socket::Status::Done) break;
+                }
+            }
+        }
+
+    public:
+        AnfitriaoFalso(Lan::Manifesto m, std::vector<std::string> c) : manifesto(std::move(m)), conteudos(std::move(c)) {}
+
+        bool iniciar() {
+            if (ouvinte.listen(0, sf::IpAddress::LocalHost) != sf::Socket::Status::Done) return false;
+            thread = std::jthread([this](const std::stop_token &parar) { atender(parar); });
+            return true;
+        }
+
+        [[nodiscard]] unsigned short porta() const {
+            return ouvinte.getLocalPort();
+        }
+
+        int pedidosDe(const std::uint32_t indice, const std::uint32_t pedaco) {
+            std::lock_guard trava(mutexPedidos);
+            const auto it = pedidos.find({indice, pedaco});
+            return it == pedidos.end() ? 0 : it->second;
+        }
+
+        int totalPedidos() {
+            std::lock_guard trava(mutexPedidos);
+            int total = 0;
+            for (const auto &[pedido, quantidade] : pedidos) total += quantidade;
+            return total;
+        }
+    };
+
+    bool testarNomes() {
+        bool ok = true;
+        for (const std::string nome : {"notes.chart", "song.ini", "guitar.ogg", "..ogg", "álbum.png"}) {
+            if (!Lan::nomeSeguro(nome)) ok = falhar("Nome simples recusado: " + nome);
+        }
+        const std::string inseguros[] = {"",           ".",          "..",          "../fora.txt", "sub/notes.chart",
+                                         "..\\fora.txt", "C:fora.txt", "/etc/passwd", std::string("a\0b", 3)};
+        for (const auto &nome : inseguros) {
+            if (Lan::nomeSeguro(nome)) ok = falhar("Nome com caminho aceito: " + nome);
+        }
+        return ok;
+    }
+
+    /**
+     * @brief Descoberta do lobby e transferência completa pelo Anfitriao de verdade
+     */
+    bool testarTransferencia() {
+        const auto origem = pastaTemporaria("origem");
+        const auto destino = pastaTemporaria("destino");
+        const std::map<std::string, std::string> arquivos = {
+            {"notes.chart", gerarConteudo(5000, 1)},
+            {"song.ini", "[song]\nname = Teste\n"},
+            {"song.ogg", gerarConteudo(TAMANHO_AUDIO, 2)},
+            {"guitar.ogg", gerarConteudo(Lan::TAMANHO_PEDACO, 3)},
+            {"album.png", gerarConteudo(300, 4)},
+        };
+        for (const auto &[nome, conteudo] : arquivos) gravarArquivo(origem / nome, conteudo);
+
+        const auto nomeLobby = "Teste " + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        Lan::Anfitriao anfitriao;
+        if (!anfitriao.iniciar(origem, nomeLobby, "Música", "Artista", 0)) return falhar("Anfitrião não abriu a porta");
+
+        const auto lobbies = Lan::procurarLobbies(DURACAO_PROCURA);
+        const auto lobby = std::ranges::find(lobbies, nomeLobby, &Lan::Lobby::nome);
+        if (lobby == lobbies.end()) return falhar("Lobby não apareceu na descoberta");
+        if (lobby->nomeMusica != "Música" || lobby->artista != "Artista" || lobby->identificadorMusica.size() != 64) {
+            return falhar("Anúncio do lobby com campos errados");
+        }
+
+        Lan::Receptor receptor(destino);
+        if (!receptor.executar(lobby->endereco, lobby->porta)) return falhar("Transferência falhou");
+        bool ok = true;
+        if (!receptor.prontoParaIniciar()) ok = falhar("Receptor não ficou pronto para iniciar");
+        if (receptor.recebidos() != receptor.total()) ok = falhar("Bytes recebidos não batem com o total");
+        for (const auto &[nome, conteudo] : arquivos) {
+            if (lerArquivo(destino / nome) != conteudo) ok = falhar("Arquivo diferente do original: " + nome);
+            if (std::filesystem::exists(destino / (nome + ".progresso"))) ok = falhar("Sobrou o progresso de " + nome);
+        }
+
+        std::filesystem::remove_all(origem);
+        std::filesystem::remove_all(destino);
+        return ok;
+    }
+
+    /**
+     * @brief Manifesto com "../": o Receptor recusa antes de criar qualquer arquivo
+     */
+    bool testarCaminhoInseguro() {
+        const auto base = pastaTemporaria("caminho");
+        const auto destino = base / "destino";
+        const auto conteudo = gerarConteudo(1000, 5);
+        Lan::Manifesto manifesto;
+        manifesto.arquivos = {descrever("notes.chart", conteudo), descrever("../fora.txt", conteudo)};
+
+        AnfitriaoFalso anfitriao(manifesto, {conteudo, conteudo});
+        if (!anfitriao.iniciar()) return falhar("Anfitrião falso não abriu a porta");
+
+        Lan::Receptor receptor(destino);
+        bool ok = true;
+        if (receptor.executar(sf::IpAddress::LocalHost, anfitriao.porta())) ok = falhar("Manifesto com \"../\" aceito");
+        if (std::filesystem::exists(base / "fora.txt")) ok = falhar("Arquivo gravado fora da pasta de destino");
+        if (std::filesystem::exists(destino)) ok = falhar("Pasta de destino criada para um manifesto inválido");
+        if (anfitriao.totalPedidos() != 0) ok = falhar("Pedaços pedidos de um manifesto inválido");
+
+        std::filesystem::remove_all(base);
+        return ok;
+    }
+
+    /**
+     * @brief Pedaço que não confere com o resumo: pedido de novo até o limite, nunca gravado
+     */
+    bool testarResumoErrado() {
+        const auto destino = pastaTemporaria("resumo");
+        const auto conteudo = gerarConteudo(TAMANHO_AUDIO, 6);
+        auto servido = conteudo;
+        servido[Lan::TAMANHO_PEDACO * PEDACO_CORROMPIDO + 10] ^= 0x20;
+        Lan::Manifesto manifesto;
+        manifesto.arquivos = {descrever("song.ogg", conteudo)};
+
+        AnfitriaoFalso anfitriao(manifesto, {servido});
+        if (!anfitriao.iniciar()) return falhar("Anfitrião falso não abriu a porta");
+
+        Lan::Receptor receptor(destino);
+        bool ok = true;
+        if (receptor.executar(sf::IpAddress::LocalHost, anfitriao.porta())) ok = falhar("Pedaço corrompido aceito");
+        if (const auto pedidos = anfitriao.pedidosDe(0, PEDACO_CORROMPIDO); pedidos != Lan::TENTATIVAS_POR_PEDACO) {
+            ok = falhar("Pedaço corrompido pedido " + std::to_string(pedidos) + " vezes, esperado " +
+                        std::to_string(Lan::TENTATIVAS_POR_PEDACO));
+        }
+
+        // O progresso guardado não pode marcar o pedaço ruim, e o arquivo não pode ter os bytes dele
+        std::string progresso;
+        std::ifstream(destino / "song.ogg.progresso") >> progresso;
+        if (progresso.size() <= PEDACO_CORROMPIDO || progresso[PEDACO_CORROMPIDO] != '0') {
+            ok = falhar("Progresso marca o pedaço corrompido: \"" + progresso + "\"");
+        }
+        const auto gravado = lerArquivo(destino / "song.ogg");
+        if (gravado.compare(Lan::TAMANHO_PEDACO * PEDACO_CORROMPIDO, Lan::TAMANHO_PEDACO,
+                            servido, Lan::TAMANHO_PEDACO * PEDACO_CORROMPIDO, Lan::TAMANHO_PEDACO) == 0) {
+            ok = falhar("Bytes do pedaço corrompido foram gravados");
+        }
+
+        std::filesystem::remove_all(destino);
+        return ok;
+    }
+}
+
+int main() {
+    const bool nomes = testarNomes();
+    const bool transferencia = testarTransferencia();
+    const bool caminho = testarCaminhoInseguro();
+    const bool resumo = testarResumoErrado();
+    return nomes && transferencia && caminho && resumo ? 0 : 1;
+}
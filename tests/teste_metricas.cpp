@@ -0,0 +1,94 @@
+/**
+ * @file teste_metricas.cpp
+ * @brief Raspagem local do endpoint de métricas, com um cliente mudo conectado antes
+ *
+ * O cliente mudo conecta e não manda nada; a raspagem seguinte precisa ser
+ * respondida mesmo assim, e o servidor precisa parar sem esperar por ele.
+ */
+
+#include "metricas.hpp"
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace {
+    using Relogio = std::chrono::steady_clock;
+    constexpr double LIMITE_SEGUNDOS = 2.0;
+    constexpr auto CORPO = "# TYPE riff_hero_teste counter\nriff_hero_teste 42\n";
+
+    double segundosDesde(const Relogio::time_point inicio) {
+        return std::chrono::duration<double>(Relogio::now() - inicio).count();
+    }
+
+    /**
+     * @brief GET completo; a resposta termina quando o servidor fecha a conexão
+     */
+    std::optional<std::string> raspar(const unsigned short porta) {
+        sf::TcpSocket socket;
+        if (socket.connect(sf::IpAddress::LocalHost, porta, sf::seconds(2)) != sf::Socket::Status::Done) {
+            return std::nullopt;
+        }
+        const std::string requisicao = "GET /metrics HTTP/1.0\r\nHost: localhost\r\n\r\n";
+        if (socket.send(requisicao.data(), requisicao.size()) != sf::Socket::Status::Done) return std::nullopt;
+
+        std::string resposta;
+        std::array<char, 4096> buffer{};
+        std::size_t recebidos = 0;
+        while (socket.receive(buffer.data(), buffer.size(), recebidos) == sf::Socket::Status::Done) {
+            resposta.append(buffer.data(), recebidos);
+        }
+        return resposta;
+    }
+
+    bool falhar(const std::string &mensagem) {
+        std::cerr << "Erro: " << mensagem << std::endl;
+        return false;
+    }
+
+    bool testar() {
+        std::optional<Metricas::Servidor> servidor;
+        servidor.emplace();
+        if (!servidor->iniciar(0, [] { return std::string(CORPO); })) {
+            return falhar("Não foi possível escutar numa porta local");
+        }
+        const auto porta = servidor->porta();
+
+        sf::TcpSocket mudo;
+        if (mudo.connect(sf::IpAddress::LocalHost, porta, sf::seconds(2)) != sf::Socket::Status::Done) {
+            return falhar("Cliente mudo não conectou");
+        }
+
+        const auto inicioRaspagem = Relogio::now();
+        const auto resposta = raspar(porta);
+        const auto segundosRaspagem = segundosDesde(inicioRaspagem);
+        std::cout << "Raspagem com cliente mudo conectado: " << segundosRaspagem * 1000.0 << " ms" << std::endl;
+        if (!resposta || !resposta->starts_with("HTTP/1.0 200 OK\r\n")) {
+            return falhar("Resposta inválida: " + resposta.value_or("(nenhuma)"));
+        }
+        const std::string corpo = CORPO;
+        if (!resposta->ends_with("\r\n\r\n" + corpo) ||
+            resposta->find("Content-Length: " + std::to_string(corpo.size()) + "\r\n") == std::string::npos) {
+            return falhar("Corpo ou Content-Length errado:\n" + *resposta);
+        }
+        if (segundosRaspagem > LIMITE_SEGUNDOS) return falhar("Raspagem esperou demais pelo cliente mudo");
+
+        // Outro mudo conectado na hora de parar: o jogo não pode travar no fechamento
+        sf::TcpSocket mudoNaParada;
+        (void)mudoNaParada.connect(sf::IpAddress::LocalHost, porta, sf::seconds(2));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        const auto inicioParada = Relogio::now();
+        servidor.reset();
+        const auto segundosParada = segundosDesde(inicioParada);
+        std::cout << "Parada com cliente mudo conectado: " << segundosParada * 1000.0 << " ms" << std::endl;
+        if (segundosParada > LIMITE_SEGUNDOS) return falhar("Servidor demorou a parar");
+        return true;
+    }
+}
+
+int main() {
+    return testar() ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file teste_reamostragem.cpp
+ * @brief Qualidade e vazão do conversor de taxa
+ *
+ * Cada conversão recebe senoides em pedaços de tamanhos variados, como na
+ * thread de áudio, e a saída é comparada com as mesmas senoides calculadas
+ * direto na taxa de saída. Um tom acima do Nyquist da saída precisa sumir.
+ * No fim é medida a vazão em amostras de saída por segundo.
+ *
+ * Uso: teste-reamostragem [segundos_de_audio_na_vazao]
+ */
+
+#include "reamostragem.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numbers>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr unsigned CANAIS = 2;
+    constexpr double DURACAO_SEC = 2.0;
+    constexpr double AMPLITUDE = 0.5;
+    constexpr double MARGEM_SEC = 0.05; // As bordas têm a janela incompleta
+    constexpr double SNR_MINIMO_DB = 75.0;
+    constexpr double REJEICAO_MINIMA_DB = 70.0;
+    constexpr double SEGUNDOS_VAZAO_PADRAO = 30.0;
+
+    double senoide(const double frequencia, const double segundos, const unsigned canal) {
+        // Canais defasados: um erro de intercalação aparece como ruído
+        return AMPLITUDE * std::sin(2.0 * std::numbers::pi * frequencia * segundos + canal * 0.7);
+    }
+
+    std::vector<std::int16_t> gerar(const unsigned taxa, const double frequencia, const double duracao) {
+        const auto quadros = static_cast<std::size_t>(duracao * taxa);
+        std::vector<std::int16_t> amostras(quadros * CANAIS);
+        for (std::size_t i = 0; i < quadros; ++i) {
+            for (unsigned c = 0; c < CANAIS; ++c) {
+                amostras[i * CANAIS + c] =
+                    static_cast<std::int16_t>(std::lrint(senoide(frequencia, static_cast<double>(i) / taxa, c) * 32767.0));
+            }
+        }
+        return amostras;
+    }
+
+    /**
+     * @brief Converte tudo, empurrando em pedaços de tamanhos variados
+     */
+    std::vector<std::int16_t> converter(Reamostragem::Conversor &conversor, const std::vector<std::int16_t> &entrada,
+                                        const unsigned taxaEntrada, const unsigned taxaSaida) {
+        std::vector<std::int16_t> saida(
+            (entrada.size() / CANAIS * static_cast<std::size_t>(taxaSaida) / taxaEntrada + 64) * CANAIS);
+        const auto quadrosEntrada = entrada.size() / CANAIS;
+        std::size_t lidos = 0;
+        std::size_t escritos = 0;
+        for (std::size_t pedaco = 1; lidos < quadrosEntrada; pedaco = pedaco * 7 % 997 + 1) {
+            const auto quantidade = std::min(pedaco, quadrosEntrada - lidos);
+            conversor.empurrar(entrada.data() + lidos * CANAIS, quantidade);
+            lidos += quantidade;
+            escritos += conversor.extrair(saida.data() + escritos * CANAIS, saida.size() / CANAIS - escritos);
+        }
+        conversor.finalizar();
+        escritos += conversor.extrair(saida.data() + escritos * CANAIS, saida.size() / CANAIS - escritos);
+        saida.resize(escritos * CANAIS);
+        return saida;
+    }
+
+    /**
+     * @brief Razão entre a senoide esperada e o erro, longe das bordas
+     * @param esperada Frequência esperada na saída (0: silêncio, mede o que vazou)
+     * @return SNR em dB, ou o nível do que vazou em dB abaixo da amplitude
+     */
+    double medirDb(const std::vector<std::int16_t> &saida, const unsigned taxa, const double esperada) {
+        const auto margem = static_cast<std::size_t>(MARGEM_SEC * taxa);
+        double sinal = 0.0;
+        double erro = 0.0;
+        for (std::size_t i = margem; i + margem < saida.size() / CANAIS; ++i) {
+            for (unsigned c = 0; c < CANAIS; ++c) {
+                const auto referencia = esperada > 0.0 ? senoide(esperada, static_cast<double>(i) / taxa, c) : 0.0;
+                const auto diferenca = saida[i * CANAIS + c] / 32768.0 - referencia;
+                sinal += esperada > 0.0 ? referencia * referencia : AMPLITUDE * AMPLITUDE / 2.0;
+                erro += diferenca * diferenca;
+            }
+        }
+        return 10.0 * std::log10(sinal / std::max(erro, 1e-30));
+    }
+
+    bool falhar(const std::string &mensagem) {
+        std::cerr << "Erro: " << mensagem << std::endl;
+        return false;
+    }
+
+    struct Caso {
+        unsigned taxaEntrada;
+        unsigned taxaSaida;
+        double frequencia;
+    };
+
+    bool testarQualidade() {
+        constexpr Caso casos[] = {
+            {44100, 48000, 1000.0}, {44100, 48000, 15000.0}, {48000, 44100, 1000.0},
+            {22050, 48000, 5000.0}, {96000, 44100, 9000.0},  {384000, 8000, 1000.0},
+        };
+        bool ok = true;
+        std::cout << std::fixed << std::setprecision(1);
+        for (const auto &caso : casos) {
+            Reamostragem::Conversor conversor(CANAIS, caso.taxaEntrada, caso.taxaSaida);
+            if (!conversor.valido()) {
+                ok = falhar("Conversão de " + std::to_string(caso.taxaEntrada) + " para " +
+                            std::to_string(caso.taxaSaida) + " Hz recusada");
+                continue;
+            }
+            const auto saida = converter(conversor, gerar(caso.taxaEntrada, caso.frequencia, DURACAO_SEC),
+                                         caso.taxaEntrada, caso.taxaSaida);
+            const auto snr = medirDb(saida, caso.taxaSaida, caso.frequencia);
+            std::cout << caso.taxaEntrada << " -> " << caso.taxaSaida << " Hz, " << caso.frequencia
+                      << " Hz: SNR " << snr << " dB" << std::endl;
+            if (snr < SNR_MINIMO_DB) ok = falhar("SNR abaixo de " + std::to_string(SNR_MINIMO_DB) + " dB");
+        }
+
+        // 23 kHz não existe a 44,1 kHz: o que sair é dobra de espectro
+        Reamostragem::Conversor conversor(CANAIS, 48000, 44100);
+        const auto rejeicao = medirDb(converter(conversor, gerar(48000, 23000.0, DURACAO_SEC), 48000, 44100), 44100, 0.0);
+        std::cout << "48000 -> 44100 Hz, 23000 Hz: rejeição " << rejeicao << " dB" << std::endl;
+        if (rejeicao < REJEICAO_MINIMA_DB) ok = falhar("Rejeição abaixo de " + std::to_string(REJEICAO_MINIMA_DB) + " dB");
+        return ok;
+    }
+
+    bool testarLimites() {
+        bool ok = true;
+        if (Reamostragem::Conversor(CANAIS, 44100, 1).valido()) ok = falhar("Redução extrema aceita (44100 -> 1 Hz)");
+        if (Reamostragem::Conversor(CANAIS, 44100, 0).valido()) ok = falhar("Taxa de saída 0 aceita");
+        if (Reamostragem::Conversor(CANAIS, 44100, 44099).valido()) ok = falhar("Fases demais aceitas (44100 -> 44099 Hz)");
+        return ok;
+    }
+
+    void medirVazao(const double segundos) {
+        const auto entrada = gerar(44100, 1000.0, segundos);
+        Reamostragem::Conversor conversor(CANAIS, 44100, 48000);
+        const auto inicio = std::chrono::steady_clock::now();
+        const auto saida = converter(conversor, entrada, 44100, 48000);
+        const std::chrono::duration<double> duracao = std::chrono::steady_clock::now() - inicio;
+        const auto segundosGastos = std::max(duracao.count(), 1e-9);
+        std::cout << "Vazão 44100 -> 48000 Hz: " << static_cast<double>(saida.size()) / segundosGastos / 1e6
+                  << " milhões de amostras/s (" << segundos / segundosGastos << "x tempo real)" << std::endl;
+    }
+}
+
+int main(const int argc, char **argv) {
+    const auto segundosVazao = argc > 1 ? std::max(1.0, std::atof(argv[1])) : SEGUNDOS_VAZAO_PADRAO;
+    const bool limites = testarLimites();
+    const bool qualidade = testarQualidade();
+    medirVazao(segundosVazao);
+    return limites && qualidade ? 0 : 1;
+}
@@ -0,0 +1,320 @@
+/**
+ * @file teste_relogio.cpp
+ * @brief Relógio da música contra um dispositivo falso, em tempo simulado
+ *
+ * O dispositivo consome quadros no ritmo da taxa (com deriva opcional), pede
+ * blocos para manter a fila cheia como o mixer e aplica as buscas com atraso,
+ * como a thread de áudio da SFML. O jogo lê a posição a cada milissegundo; ela
+ * precisa acompanhar o quadro que está tocando, passar pelo quadro 0 da
+ * antecedência sem degrau, congelar na pausa e nunca voltar sem uma busca.
+ *
+ * Uso: teste-relogio
+ */
+
+#include "relogio.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+
+namespace {
+    constexpr unsigned TAXA = 48000;
+    constexpr std::size_t QUADROS_BLOCO = 512;
+    constexpr double FILA_QUADROS = 3 * QUADROS_BLOCO; // O que o mixer mantém entregue além do que tocou
+    constexpr std::int64_t PASSO_NS = 1'000'000;        // Um quadro do jogo por milissegundo
+    constexpr std::int64_t ATRASO_BUSCA_NS = 30'000'000;
+    constexpr double TOLERANCIA_SEC = 0.001;
+
+    bool falhar(const std::string &mensagem) {
+        std::cerr << "Erro: " << mensagem << std::endl;
+        return false;
+    }
+
+    /**
+     * @brief Mixer falso: os mesmos passos que o Reprodutor faz em torno do RelogioMusica
+     */
+    class Dispositivo {
+    private:
+        double tocados = 0.0; // Quadros que já saíram desde o início do fluxo atual
+        double entregues = 0.0;
+        bool fluxoNovo = true;
+        std::optional<double> origemSec; // Posição do primeiro quadro entregue no fluxo atual
+        std::optional<std::uint64_t> buscaPendente;
+        std::int64_t instanteBusca = 0;
+
+        void reiniciarFluxo() {
+            tocados = 0.0;
+            entregues = 0.0;
+            fluxoNovo = true;
+            origemSec.reset();
+        }
+
+        void aplicarBusca(const std::uint64_t quadro) {
+            relogio.aplicarBusca(quadro);
+            reiniciarFluxo();
+        }
+
+    public:
+        Audio::RelogioMusica relogio;
+        std::int64_t agora = 1'000'000'000;
+        double deriva = 0.0; // Quanto o dispositivo anda mais rápido que a CPU
+        bool tocando = false;
+        std::int64_t atrasoBusca = 0;
+        std::size_t silencioEntregue = 0;
+        bool arquivoEntrouNoQuadroZero = true;
+
+        Dispositivo() {
+            relogio.reiniciar();
+        }
+
+        void play() {
+            if (tocando) return;
+            relogio.tocar();
+            tocando = true;
+            reiniciarFluxo();
+        }
+
+        void pause() {
+            relogio.pausar(tocando, TAXA, agora);
+            tocando = false;
+        }
+
+        void stop() {
+            // A SFML busca o começo ao parar, sem pedido da thread principal
+            tocando = false;
+            buscaPendente.reset();
+            aplicarBusca(0);
+            relogio.parar();
+        }
+
+        /**
+         * @brief setPlayingOffset: a busca chega ao fluxo na hora ou, como na thread de áudio, depois do atraso
+         */
+        void buscar(const double segundos) {
+            relogio.pedirBusca(segundos, TAXA);
+            const auto quadro = static_cast<std::uint64_t>(std::llround(std::max(0.0, segundos) * TAXA));
+            if (atrasoBusca == 0) {
+                aplicarBusca(quadro);
+                return;
+            }
+            buscaPendente = quadro;
+            instanteBusca = agora;
+        }
+
+        void avancar() {
+            agora += PASSO_NS;
+            if (buscaPendente && agora - instanteBusca >= atrasoBusca) {
+                aplicarBusca(*buscaPendente);
+                buscaPendente.reset();
+            }
+            if (!tocando) return;
+
+            if (fluxoNovo) {
+                fluxoNovo = false; // O fluxo começa a tocar agora
+            } else {
+                tocados += PASSO_NS / 1e9 * TAXA * (1.0 + deriva);
+            }
+            while (entregues < tocados + FILA_QUADROS) {
+                if (!origemSec) origemSec = static_cast<double>(relogio.quadroAtual()) / TAXA;
+                const auto silencio = relogio.entregar(agora, TAXA, QUADROS_BLOCO);
+                silencioEntregue += silencio;
+                if (silencio > 0 && silencio < QUADROS_BLOCO &&
+                    relogio.quadroAtual() + static_cast<std::int64_t>(silencio) != 0) {
+                    arquivoEntrouNoQuadroZero = false;
+                }
+                relogio.avancar(QUADROS_BLOCO);
+                entregues += QUADROS_BLOCO;
+            }
+        }
+
+        /**
+         * @brief Posição do quadro que está saindo agora
+         *
+         * Vazia antes da primeira entrega do fluxo e com uma busca pendente: o
+         * que toca até ela chegar é do fluxo antigo, e a posição fica no destino.
+         */
+        [[nodiscard]] std::optional<double> verdade() const {
+            if (!origemSec || buscaPendente) return std::nullopt;
+            return *origemSec + tocados / TAXA;
+        }
+
+        [[nodiscard]] double posicao() {
+            return relogio.posicao(tocando, TAXA, agora);
+        }
+    };
+
+    /**
+     * @brief Lê a posição a cada passo e confere erro, retrocesso e degrau
+     */
+    struct Observador {
+        double maiorErro = 0.0;
+        double maiorDegrau = 0.0; // Diferença entre o avanço da posição e o do tempo
+        bool voltou = false;
+        std::optional<double> anterior;
+
+        void reiniciar() {
+            anterior.reset();
+        }
+
+        double observar(Dispositivo &dispositivo, const bool conferirVerdade = true) {
+            const auto posicao = dispositivo.posicao();
+            if (anterior) {
+                if (posicao < *anterior) voltou = true;
+                if (dispositivo.tocando && posicao != *anterior) {
+                    maiorDegrau = std::max(maiorDegrau, std::abs(posicao - *anterior - PASSO_NS / 1e9));
+                }
+            }
+            anterior = posicao;
+            if (const auto verdade = dispositivo.verdade(); conferirVerdade && verdade && dispositivo.tocando) {
+                maiorErro = std::max(maiorErro, std::abs(posicao - *verdade));
+            }
+            return posicao;
+        }
+    };
+
+    void rodar(Dispositivo &dispositivo, Observador &observador, const double segundos) {
+        const auto passos = std::llround(segundos * 1e9 / PASSO_NS);
+        for (long long i = 0; i < passos; ++i) {
+            dispositivo.avancar();
+            observador.observar(dispositivo);
+        }
+    }
+
+    bool conferir(const std::string &nome, const Observador &observador) {
+        std::cout << nome << ": erro " << observador.maiorErro * 1000.0 << " ms, degrau "
+                  << observador.maiorDegrau * 1000.0 << " ms" << std::endl;
+        bool ok = true;
+        if (observador.voltou) ok = falhar(nome + ": a posição voltou sem busca");
+        if (observador.maiorErro > TOLERANCIA_SEC) ok = falhar(nome + ": posição longe do quadro que toca");
+        if (observador.maiorDegrau > TOLERANCIA_SEC) ok = falhar(nome + ": degrau na posição");
+        return ok;
+    }
+
+    /**
+     * @brief Antecedência de 1 s: silêncio exato, arquivo no quadro 0 e posição passando por zero sem degrau
+     */
+    bool testarAntecedencia(const std::int64_t atraso) {
+        const auto nome = "Antecedência, busca com atraso de " + std::to_string(atraso / 1'000'000) + " ms";
+        Dispositivo dispositivo;
+        dispositivo.atrasoBusca = atraso;
+        Observador observador;
+
+        dispositivo.stop();
+        dispositivo.buscar(-1.0);
+        dispositivo.play();
+        if (dispositivo.posicao() != -1.0) return falhar(nome + ": posição não começou na busca");
+        observador.observar(dispositivo);
+
+        // Degrau no quadro 0: avanço da posição no passo em que ela cruza zero
+        double degrauZero = -1.0;
+        for (int i = 0; i < 2500; ++i) {
+            const auto antes = *observador.anterior;
+            dispositivo.avancar();
+            const auto depois = observador.observar(dispositivo);
+            if (antes < 0.0 && depois >= 0.0) degrauZero = std::abs(depois - antes - PASSO_NS / 1e9);
+        }
+
+        bool ok = conferir(nome, observador);
+        if (dispositivo.silencioEntregue != TAXA) {
+            ok = falhar(nome + ": " + std::to_string(dispositivo.silencioEntregue) + " quadros de silêncio, esperado " +
+                        std::to_string(TAXA));
+        }
+        if (!dispositivo.arquivoEntrouNoQuadroZero) ok = falhar(nome + ": o arquivo não entrou no quadro 0");
+        if (degrauZero < 0.0) {
+            ok = falhar(nome + ": a posição não passou por zero");
+        } else if (degrauZero > TOLERANCIA_SEC) {
+            ok = falhar(nome + ": degrau de " + std::to_string(degrauZero * 1000.0) + " ms no quadro 0");
+        }
+        return ok;
+    }
+
+    /**
+     * @brief Buscas tocando: congelada no destino até a âncora nova, sem passar pelo fluxo antigo
+     */
+    bool testarBusca() {
+        const std::string nome = "Busca tocando";
+        Dispositivo dispositivo;
+        dispositivo.atrasoBusca = ATRASO_BUSCA_NS;
+        Observador observador;
+        dispositivo.play();
+        rodar(dispositivo, observador, 1.0);
+
+        bool ok = true;
+        for (const auto destino : {5.0, 2.0}) {
+            dispositivo.buscar(destino);
+            observador.reiniciar(); // Uma busca pode voltar
+            if (dispositivo.posicao() != destino) ok = falhar(nome + ": posição não foi para o destino na hora");
+            // Até o dispositivo aplicar a busca, o fluxo antigo continua tocando e não pode mover a posição
+            for (int i = 0; i < 1000 && dispositivo.posicao() == destino; ++i) {
+                dispositivo.avancar();
+                if (observador.observar(dispositivo, false) < destino) ok = falhar(nome + ": posição antes do destino");
+            }
+            rodar(dispositivo, observador, 1.0);
+        }
+        return conferir(nome, observador) && ok;
+    }
+
+    /**
+     * @brief Pausa congela; a retomada (busca para a posição da pausa e play, como no jogo) continua dali
+     */
+    bool testarPausa() {
+        const std::string nome = "Pausa e retomada";
+        Dispositivo dispositivo;
+        dispositivo.atrasoBusca = ATRASO_BUSCA_NS;
+        Observador observador;
+        dispositivo.play();
+        rodar(dispositivo, observador, 1.5);
+
+        dispositivo.pause();
+        const auto pausada = dispositivo.posicao();
+        bool ok = true;
+        for (int i = 0; i < 500; ++i) {
+            dispositivo.avancar();
+            if (observador.observar(dispositivo) != pausada) ok = falhar(nome + ": posição andou na pausa");
+        }
+
+        dispositivo.buscar(pausada);
+        dispositivo.play();
+        double primeira = pausada;
+        for (int i = 0; i < 200 && primeira == pausada; ++i) {
+            dispositivo.avancar();
+            primeira = observador.observar(dispositivo);
+        }
+        if (primeira - pausada > PASSO_NS / 1e9 + TOLERANCIA_SEC) ok = falhar(nome + ": salto na retomada");
+        rodar(dispositivo, observador, 1.0);
+        return conferir(nome, observador) && ok;
+    }
+
+    /**
+     * @brief Dispositivo 500 ppm mais rápido que a CPU: a média das entregas acompanha
+     */
+    bool testarDeriva() {
+        const std::string nome = "Deriva de 500 ppm";
+        Dispositivo dispositivo;
+        dispositivo.deriva = 500e-6;
+        Observador observador;
+        dispositivo.play();
+        rodar(dispositivo, observador, 10.0);
+
+        bool ok = conferir(nome, observador);
+        const auto deriva = dispositivo.relogio.derivaSegundos();
+        if (deriva <= 0.0) ok = falhar(nome + ": deriva não medida (" + std::to_string(deriva * 1000.0) + " ms)");
+        return ok;
+    }
+}
+
+int main() {
+    Log::registrador().definirNivelMinimo(Log::Nivel::Aviso);
+    std::cout << std::fixed << std::setprecision(3);
+    bool ok = true;
+    ok &= testarAntecedencia(0);
+    ok &= testarAntecedencia(ATRASO_BUSCA_NS);
+    ok &= testarBusca();
+    ok &= testarPausa();
+    ok &= testarDeriva();
+    return ok ? 0 : 1;
+}
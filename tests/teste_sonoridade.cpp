@@ -0,0 +1,139 @@
+/**
+ * @file teste_sonoridade.cpp
+ * @brief Medidor de sonoridade contra os casos da EBU Tech 3341
+ *
+ * Senoides de 1 kHz em estéreo, geradas em 16 bits como as que o riff-volume
+ * decodifica, passam pelo Medidor em pedaços de tamanhos variados. A leitura
+ * precisa cair a 0,1 LU do esperado, e o caminho SSE2 precisa dar o mesmo
+ * resultado do laço escalar.
+ *
+ * Uso: teste-sonoridade
+ */
+
+#include "medicao.hpp"
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numbers>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr unsigned CANAIS = 2;
+    constexpr double FREQUENCIA = 1000.0;
+    constexpr double TOLERANCIA_LU = 0.1;
+    constexpr double TOLERANCIA_SIMD = 1e-9;
+    constexpr double TOLERANCIA_COEFICIENTE = 1e-9;
+
+    /**
+     * @brief Trecho de senoide com nível de pico em dBFS
+     */
+    struct Trecho {
+        double dbfs;
+        double segundos;
+    };
+
+    std::vector<std::int16_t> gerar(const unsigned taxa, const std::vector<Trecho> &trechos) {
+        std::vector<std::int16_t> amostras;
+        std::size_t i = 0;
+        for (const auto &trecho : trechos) {
+            const auto amplitude = std::pow(10.0, trecho.dbfs / 20.0) * 32767.0;
+            const auto quadros = static_cast<std::size_t>(std::lround(trecho.segundos * taxa));
+            for (std::size_t fim = i + quadros; i < fim; ++i) {
+                const auto valor = static_cast<std::int16_t>(
+                    std::lrint(amplitude * std::sin(2.0 * std::numbers::pi * FREQUENCIA * static_cast<double>(i) / taxa)));
+                for (unsigned c = 0; c < CANAIS; ++c) amostras.push_back(valor);
+            }
+        }
+        return amostras;
+    }
+
+    /**
+     * @brief Mede tudo, empurrando em pedaços de tamanhos variados como a leitura do arquivo
+     */
+    std::optional<double> medir(const std::vector<std::int16_t> &amostras, const unsigned taxa, const bool simd) {
+        Sonoridade::Medidor medidor(taxa, CANAIS, simd);
+        const auto quadros = amostras.size() / CANAIS;
+        std::size_t lidos = 0;
+        for (std::size_t pedaco = 1; lidos < quadros; pedaco = pedaco * 7 % 9973 + 1) {
+            const auto quantidade = std::min(pedaco, quadros - lidos);
+            medidor.adicionar(amostras.data() + lidos * CANAIS, quantidade);
+            lidos += quantidade;
+        }
+        return medidor.integrada();
+    }
+
+    bool falhar(const std::string &mensagem) {
+        std::cerr << "Erro: " << mensagem << std::endl;
+        return false;
+    }
+
+    struct Caso {
+        const char *nome;
+        unsigned taxa;
+        std::vector<Trecho> trechos;
+        double esperadoLufs;
+    };
+
+    bool testarCasos() {
+        const Caso casos[] = {
+            {"1 kHz a -23 dBFS", 48000, {{-23.0, 20.0}}, -23.0},
+            {"1 kHz a -33 dBFS", 48000, {{-33.0, 20.0}}, -33.0},
+            {"1 kHz a -23 dBFS, 44,1 kHz", 44100, {{-23.0, 20.0}}, -23.0},
+            {"Comporta relativa", 48000, {{-36.0, 10.0}, {-23.0, 60.0}, {-36.0, 10.0}}, -23.0},
+            {"Comportas absoluta e relativa", 48000,
+             {{-72.0, 10.0}, {-36.0, 10.0}, {-23.0, 60.0}, {-36.0, 10.0}, {-72.0, 10.0}}, -23.0},
+            {"Média pelo tempo", 48000, {{-26.0, 20.0}, {-20.0, 20.1}, {-26.0, 20.0}}, -23.0},
+        };
+        bool ok = true;
+        std::cout << std::fixed << std::setprecision(3);
+        for (const auto &caso : casos) {
+            const auto amostras = gerar(caso.taxa, caso.trechos);
+            const auto simd = medir(amostras, caso.taxa, true);
+            const auto escalar = medir(amostras, caso.taxa, false);
+            if (!simd || !escalar) {
+                ok = falhar(std::string(caso.nome) + ": nenhum bloco passou pela comporta");
+                continue;
+            }
+            std::cout << caso.nome << ": " << *simd << " LUFS (escalar " << *escalar << ")" << std::endl;
+            if (std::abs(*simd - caso.esperadoLufs) > TOLERANCIA_LU) {
+                ok = falhar(std::string(caso.nome) + ": esperado " + std::to_string(caso.esperadoLufs) + " LUFS");
+            }
+            if (std::abs(*simd - *escalar) > TOLERANCIA_SIMD) {
+                ok = falhar(std::string(caso.nome) + ": SSE2 e escalar divergem");
+            }
+        }
+        return ok;
+    }
+
+    bool testarSilencio() {
+        const std::vector<std::int16_t> silencio(48000 * 5 * CANAIS, 0);
+        if (medir(silencio, 48000, true)) return falhar("Silêncio produziu uma leitura");
+        // Menos de um bloco de 400 ms também não tem leitura
+        if (medir(gerar(48000, {{-23.0, 0.3}}), 48000, true)) return falhar("Áudio curto demais produziu uma leitura");
+        return true;
+    }
+
+    bool testarCoeficientes() {
+        // Tabela 1 e 2 da ITU-R BS.1770 (48 kHz)
+        const auto [prateleira, passaAltas] = Sonoridade::coeficientesPonderacaoK(48000.0);
+        const double esperados[] = {1.53512485958697,  -2.69169618940638, 1.19839281085285, -1.69065929318241,
+                                    0.73248077421585,  -1.99004745483398, 0.99007225036621};
+        const double obtidos[] = {prateleira.b0, prateleira.b1, prateleira.b2, prateleira.a1,
+                                  prateleira.a2, passaAltas.a1, passaAltas.a2};
+        for (std::size_t i = 0; i < std::size(esperados); ++i) {
+            if (std::abs(esperados[i] - obtidos[i]) > TOLERANCIA_COEFICIENTE) {
+                return falhar("Coeficiente " + std::to_string(i) + " a 48 kHz fora da tabela da norma");
+            }
+        }
+        return true;
+    }
+}
+
+int main() {
+    const bool coeficientes = testarCoeficientes();
+    const bool silencio = testarSilencio();
+    const bool casos = testarCasos();
+    return coeficientes && silencio && casos ? 0 : 1;
+}